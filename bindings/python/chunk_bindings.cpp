@@ -224,6 +224,18 @@ PYBIND11_MODULE(chunking_cpp, m) {
              &chunk_metrics::ChunkQualityAnalyzer<double>::compute_size_metrics)
         .def("clear_cache", &chunk_metrics::ChunkQualityAnalyzer<double>::clear_cache);
 
+    using MetricsAccumulator = chunk_metrics::ChunkMetricsAccumulator<double>;
+    py::class_<MetricsAccumulator>(m, "ChunkMetricsAccumulator")
+        .def(py::init<size_t>(), py::arg("separation_sample") = 4096)
+        .def("add", py::overload_cast<const std::vector<double>&>(&MetricsAccumulator::add))
+        .def("chunk_count", &MetricsAccumulator::chunk_count)
+        .def("cohesion", &MetricsAccumulator::cohesion)
+        .def("separation", &MetricsAccumulator::separation)
+        .def("separation_is_exact", &MetricsAccumulator::separation_is_exact)
+        .def("quality_score", &MetricsAccumulator::quality_score)
+        .def("size_metrics", &MetricsAccumulator::size_metrics)
+        .def("reset", &MetricsAccumulator::reset);
+
     // Chunk Visualization
     py::class_<chunk_viz::ChunkVisualizer<double>>(m, "ChunkVisualizer")
         .def(py::init<const std::vector<double>&, const std::string&>())
@@ -235,9 +247,38 @@ PYBIND11_MODULE(chunking_cpp, m) {
     // Chunk Serialization
     py::class_<chunk_serialization::ChunkSerializer<double>>(m, "ChunkSerializer")
         .def(py::init<>())
-        .def("to_json", &chunk_serialization::ChunkSerializer<double>::to_json)
-        .def("to_protobuf", &chunk_serialization::ChunkSerializer<double>::to_protobuf)
-        .def("to_msgpack", &chunk_serialization::ChunkSerializer<double>::to_msgpack);
+        .def(
+            "to_json",
+            [](chunk_serialization::ChunkSerializer<double>& self,
+               const std::vector<std::vector<double>>& chunks, bool pretty) {
+                chunk_serialization::JsonOptions options;
+                options.pretty = pretty;
+                return self.to_json(chunks, options);
+            },
+            py::arg("chunks"), py::arg("pretty") = false)
+        .def_static("from_json",
+                    [](const std::string& data) {
+                        return chunk_serialization::ChunkSerializer<double>::from_json(data);
+                    })
+        .def("to_protobuf",
+             [](chunk_serialization::ChunkSerializer<double>& self,
+                const std::vector<std::vector<double>>& chunks) {
+                 return py::bytes(self.to_protobuf(chunks));
+             })
+        .def_static("from_protobuf",
+                    [](const py::bytes& data) {
+                        return chunk_serialization::ChunkSerializer<double>::from_protobuf(
+                            static_cast<std::string>(data));
+                    })
+        .def("to_msgpack",
+             [](chunk_serialization::ChunkSerializer<double>& self,
+                const std::vector<std::vector<double>>& chunks) {
+                 return py::bytes(self.to_msgpack(chunks));
+             })
+        .def_static("from_msgpack", [](const py::bytes& data) {
+            return chunk_serialization::ChunkSerializer<double>::from_msgpack(
+                static_cast<std::string>(data));
+        });
 
     // Database Integration
 #ifdef HAVE_POSTGRESQL
@@ -270,15 +311,29 @@ PYBIND11_MODULE(chunking_cpp, m) {
 #endif
 
     // Benchmark bindings
-    py::class_<chunk_benchmark::BenchmarkResult>(m, "BenchmarkResult")
-        .def_readwrite("execution_time_ms", &chunk_benchmark::BenchmarkResult::execution_time_ms)
-        .def_readwrite("memory_usage_bytes", &chunk_benchmark::BenchmarkResult::memory_usage_bytes)
-        .def_readwrite("num_chunks", &chunk_benchmark::BenchmarkResult::num_chunks)
-        .def_readwrite("strategy_name", &chunk_benchmark::BenchmarkResult::strategy_name);
+    using chunk_benchmark::BenchmarkResult;
+    py::class_<BenchmarkResult>(m, "BenchmarkResult")
+        .def_readwrite("execution_time_ms", &BenchmarkResult::execution_time_ms)
+        .def_readwrite("memory_usage_bytes", &BenchmarkResult::memory_usage_bytes)
+        .def_readwrite("num_chunks", &BenchmarkResult::num_chunks)
+        .def_readwrite("strategy_name", &BenchmarkResult::strategy_name)
+        .def_readonly("iterations", &BenchmarkResult::iterations)
+        .def_readonly("samples_ns", &BenchmarkResult::samples_ns)
+        .def_readonly("mean_ns", &BenchmarkResult::mean_ns)
+        .def_readonly("median_ns", &BenchmarkResult::median_ns)
+        .def_readonly("p90_ns", &BenchmarkResult::p90_ns)
+        .def_readonly("p99_ns", &BenchmarkResult::p99_ns)
+        .def_readonly("stddev_ns", &BenchmarkResult::stddev_ns)
+        .def_readonly("elements_per_second", &BenchmarkResult::elements_per_second)
+        .def_readonly("bytes_per_second", &BenchmarkResult::bytes_per_second)
+        .def_readonly("memory_tracked", &BenchmarkResult::memory_tracked)
+        .def_readonly("allocations_per_run", &BenchmarkResult::allocations_per_run)
+        .def_readonly("allocated_bytes_per_run", &BenchmarkResult::allocated_bytes_per_run);
 
     py::class_<chunk_benchmark::ChunkBenchmark<double>>(m, "ChunkBenchmark")
         .def(py::init<const std::vector<double>&, size_t>())
-        .def("add_strategy", &chunk_benchmark::ChunkBenchmark<double>::add_strategy)
+        .def("add_strategy", &chunk_benchmark::ChunkBenchmark<double>::add_strategy,
+             py::arg("strategy"), py::arg("name") = "")
         .def("benchmark_chunking", &chunk_benchmark::ChunkBenchmark<double>::benchmark_chunking)
         .def("save_results", &chunk_benchmark::ChunkBenchmark<double>::save_results);
 
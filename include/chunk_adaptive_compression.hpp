@@ -0,0 +1,496 @@
+/**
+ * @file chunk_adaptive_compression.hpp
+ * @brief Per-chunk codec selection over the ChunkCompressor codecs
+ *
+ * AdaptiveCompressor encodes a sample of each chunk with every applicable
+ * codec, extrapolates the encoded sizes, and keeps the cheapest codec,
+ * optionally penalizing codecs that decode slowly. The choice is stored in a
+ * two-byte header in front of the codec's own payload, and decoding jumps
+ * through a table indexed by that byte.
+ */
+
+#pragma once
+
+#include "chunk_compression.hpp"
+#include "chunk_errors.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace chunk_compression {
+
+/**
+ * @brief Codecs the adaptive front end chooses from; values are stored in the header
+ */
+enum class Codec : uint8_t {
+    Raw = 0,
+    RunLength = 1,
+    BitPack = 2,
+    DeltaBitPack = 3,
+    Dictionary = 4,
+    Xor = 5,
+};
+
+/// Number of Codec values
+constexpr size_t CODEC_COUNT = 6;
+
+inline const char* codec_name(Codec codec) {
+    switch (codec) {
+    case Codec::Raw:
+        return "raw";
+    case Codec::RunLength:
+        return "rle";
+    case Codec::BitPack:
+        return "bitpack";
+    case Codec::DeltaBitPack:
+        return "delta-bitpack";
+    case Codec::Dictionary:
+        return "dictionary";
+    case Codec::Xor:
+        return "xor";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Relative decode cost per encoded byte, used to weight size estimates
+ *
+ * A heuristic ordering, not measured ratios: raw copies are free, block
+ * unpacking is SIMD, dictionary decoding gathers, RLE and XOR are serial.
+ * Tune speed_weight against real decode timings rather than these values.
+ */
+inline double codec_decode_cost(Codec codec) {
+    switch (codec) {
+    case Codec::Raw:
+        return 0.0;
+    case Codec::BitPack:
+        return 0.1;
+    case Codec::DeltaBitPack:
+        return 0.15;
+    case Codec::Dictionary:
+        return 0.25;
+    case Codec::RunLength:
+        return 0.3;
+    case Codec::Xor:
+        return 1.0;
+    }
+    return 1.0;
+}
+
+/**
+ * @brief Tuning for AdaptiveCompressor
+ */
+struct AdaptiveOptions {
+    /// Values sampled per chunk (in 128-value windows); chunks this small are encoded in full
+    size_t sample_size = 1024;
+    /// 0 picks the smallest output; larger values trade size for decode speed
+    double speed_weight = 0.0;
+};
+
+/**
+ * @brief Size estimate of one codec for a chunk
+ */
+struct CodecEstimate {
+    Codec codec;
+    size_t estimated_bytes;
+    double cost; ///< estimated_bytes weighted by decode cost
+};
+
+/**
+ * @brief Chooses and applies the cheapest codec for each chunk
+ * @tparam T Arithmetic value type
+ */
+template <typename T>
+class AdaptiveCompressor {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "AdaptiveCompressor requires an arithmetic value type");
+
+public:
+    using Compressor = ChunkCompressor<T>;
+
+    /// Codecs considered for T, in Codec order
+    using CandidateList = std::array<Codec, std::is_integral<T>::value ? 5 : 4>;
+
+    /// One estimate per candidate
+    using EstimateList = std::array<CodecEstimate, std::tuple_size<CandidateList>::value>;
+
+    /**
+     * @brief Buffers reused between chunks by estimate(), choose() and compress_to()
+     *
+     * Keep one per thread: selection and encoding then allocate only while
+     * these buffers grow, not once per chunk.
+     */
+    struct Scratch {
+        std::vector<T> sample;
+        std::vector<uint8_t> payload; ///< Sample payloads sized by estimate()
+        std::vector<uint8_t> stream;  ///< XOR streams, copied out once encoded
+        DictionaryScratch<T> dictionary;
+    };
+
+    explicit AdaptiveCompressor(AdaptiveOptions options = {}) : options_(options) {}
+
+    /**
+     * @brief Codecs considered for T
+     */
+    static constexpr CandidateList candidates() {
+        if constexpr (std::is_integral<T>::value) {
+            return {{Codec::Raw, Codec::RunLength, Codec::BitPack, Codec::DeltaBitPack,
+                     Codec::Dictionary}};
+        } else {
+            return {{Codec::Raw, Codec::RunLength, Codec::Dictionary, Codec::Xor}};
+        }
+    }
+
+    /**
+     * @brief Estimate every candidate's encoded size for a chunk, cheapest first
+     */
+    std::vector<CodecEstimate> estimate(const T* data, size_t n) const {
+        Scratch scratch;
+        const EstimateList estimates = estimate(data, n, scratch);
+        return {estimates.begin(), estimates.end()};
+    }
+
+    /**
+     * @brief estimate() with caller-owned buffers
+     */
+    EstimateList estimate(const T* data, size_t n, Scratch& scratch) const {
+        const T* sample = data;
+        size_t sample_n = n;
+        if (n > options_.sample_size && options_.sample_size > 0) {
+            take_sample(data, n, scratch.sample);
+            sample = scratch.sample.data();
+            sample_n = scratch.sample.size();
+        }
+
+        const CandidateList codecs = candidates();
+        EstimateList estimates;
+        for (size_t c = 0; c < codecs.size(); ++c) {
+            const Codec codec = codecs[c];
+            const size_t capacity = max_payload_size(codec, sample_n);
+            if (scratch.payload.size() < capacity) {
+                scratch.payload.resize(capacity);
+            }
+            const size_t sample_bytes =
+                put_payload(codec, sample, sample_n, scratch.payload.data(), scratch);
+            const size_t bytes =
+                sample_n == n ? sample_bytes
+                              : static_cast<size_t>(static_cast<double>(sample_bytes) *
+                                                    static_cast<double>(n) / sample_n);
+            const double cost =
+                bytes * (1.0 + options_.speed_weight * codec_decode_cost(codec));
+            estimates[c] = {codec, bytes, cost};
+        }
+        // Candidates are in Codec order, so this keeps ties in candidate order like a
+        // stable sort, without the temporary buffer std::stable_sort allocates
+        std::sort(estimates.begin(), estimates.end(),
+                  [](const CodecEstimate& a, const CodecEstimate& b) {
+                      return a.cost < b.cost || (a.cost == b.cost && a.codec < b.codec);
+                  });
+        return estimates;
+    }
+
+    /**
+     * @brief Codec compress() would use for a chunk
+     */
+    Codec choose(const T* data, size_t n) const {
+        Scratch scratch;
+        return choose(data, n, scratch);
+    }
+
+    Codec choose(const T* data, size_t n, Scratch& scratch) const {
+        return estimate(data, n, scratch).front().codec;
+    }
+
+    /**
+     * @brief Compress a chunk with the codec chosen for it
+     * @param chunk Input chunk
+     * @return Header (codec, value size) followed by the codec payload
+     */
+    std::vector<uint8_t> compress(const std::vector<T>& chunk) const {
+        return compress_with(choose(chunk.data(), chunk.size()), chunk.data(), chunk.size());
+    }
+
+    /**
+     * @brief Compress a chunk with a given codec, bypassing selection
+     * @throws std::invalid_argument if the codec does not apply to T
+     */
+    static std::vector<uint8_t> compress_with(Codec codec, const T* data, size_t n) {
+        std::vector<uint8_t> out;
+        compress_into(codec, data, n, out);
+        return out;
+    }
+
+    /**
+     * @brief Append a chunk compressed with a given codec to a buffer
+     *
+     * Raw, run-length and bit-packed payloads are written in place, so
+     * reusing one buffer for many chunks only allocates when it grows;
+     * compress_to() also reuses the dictionary and XOR buffers.
+     * @return Number of bytes appended
+     * @throws std::invalid_argument if the codec does not apply to T
+     */
+    static size_t compress_into(Codec codec, const T* data, size_t n, std::vector<uint8_t>& out) {
+        check_codec(codec);
+        Scratch scratch;
+        const size_t start = out.size();
+        out.resize(start + max_compressed_size(codec, n));
+        const size_t bytes = compress_to(codec, data, n, out.data() + start, scratch);
+        out.resize(start + bytes);
+        return bytes;
+    }
+
+    /**
+     * @brief Largest compress_to() output for n values
+     */
+    static size_t max_compressed_size(Codec codec, size_t n) {
+        return HEADER_SIZE + max_payload_size(codec, n);
+    }
+
+    /**
+     * @brief Write a chunk compressed with a given codec into a caller-provided buffer
+     *
+     * The codec is not validated, so a caller compressing many chunks with
+     * one codec checks it once with check_codec().
+     * @param codec One of candidates()
+     * @param data Input values
+     * @param n Number of values
+     * @param out Buffer of at least max_compressed_size(codec, n) bytes
+     * @param scratch Buffers reused between calls
+     * @return Number of bytes written
+     */
+    static size_t compress_to(Codec codec, const T* data, size_t n, uint8_t* out,
+                              Scratch& scratch) {
+        out[0] = static_cast<uint8_t>(codec);
+        out[1] = static_cast<uint8_t>(sizeof(T));
+        return HEADER_SIZE + put_payload(codec, data, n, out + HEADER_SIZE, scratch);
+    }
+
+    /**
+     * @throws std::invalid_argument if the codec does not apply to T
+     */
+    static void check_codec(Codec codec) {
+        constexpr CandidateList allowed = candidates();
+        if (std::find(allowed.begin(), allowed.end(), codec) == allowed.end()) {
+            throw std::invalid_argument(std::string("Codec ") + codec_name(codec) +
+                                        " does not apply to this value type");
+        }
+    }
+
+    /**
+     * @brief Codec recorded in a compressed chunk
+     * @throws chunk_processing::SerializationError if the header is invalid
+     */
+    static Codec codec_of(const uint8_t* data, size_t size) {
+        if (size < HEADER_SIZE || data[0] >= CODEC_COUNT || data[1] != sizeof(T)) {
+            throw chunk_processing::SerializationError("Invalid adaptive chunk header");
+        }
+        return static_cast<Codec>(data[0]);
+    }
+
+    /**
+     * @brief Decompress a chunk produced by compress()
+     * @param data Compressed chunk
+     * @param size Number of bytes
+     * @param max_values Largest chunk to produce. Runs and one-entry
+     *        dictionaries expand a few bytes into many values, so untrusted
+     *        input is bounded by this rather than by its own size.
+     * @throws chunk_processing::SerializationError if the chunk is malformed or
+     *         decodes to more than max_values values
+     */
+    static std::vector<T> decompress(const uint8_t* data, size_t size,
+                                     uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        const Codec codec = codec_of(data, size);
+        return decoders()[static_cast<size_t>(codec)](data + HEADER_SIZE, size - HEADER_SIZE,
+                                                      max_values);
+    }
+
+    static std::vector<T> decompress(const std::vector<uint8_t>& encoded,
+                                     uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        return decompress(encoded.data(), encoded.size(), max_values);
+    }
+
+private:
+    static constexpr size_t HEADER_SIZE = 2;
+    static constexpr size_t WINDOW = BITPACK_BLOCK_SIZE;
+
+    using Decoder = std::vector<T> (*)(const uint8_t*, size_t, uint64_t);
+
+    // Evenly spaced contiguous windows keep runs and deltas representative
+    void take_sample(const T* data, size_t n, std::vector<T>& sample) const {
+        const size_t windows = std::max<size_t>(1, options_.sample_size / WINDOW);
+        const size_t stride = n / windows;
+        sample.clear();
+        for (size_t w = 0; w < windows; ++w) {
+            const size_t first = w * stride;
+            const size_t last = std::min(n, first + WINDOW);
+            sample.insert(sample.end(), data + first, data + last);
+        }
+    }
+
+    static size_t max_payload_size(Codec codec, size_t n) {
+        switch (codec) {
+        case Codec::Raw:
+            return n * sizeof(T);
+        case Codec::RunLength:
+            return detail::varint_max_bytes(64) * (n + 1) + n * sizeof(T);
+        case Codec::BitPack:
+        case Codec::DeltaBitPack:
+            if constexpr (std::is_integral<T>::value) {
+                return Compressor::bitpack_max_encoded_size(n);
+            }
+            return 0;
+        case Codec::Dictionary:
+            return DictionaryChunk<T>::max_encoded_size(n);
+        case Codec::Xor:
+            if constexpr (std::is_floating_point<T>::value) {
+                return Compressor::xor_max_encoded_size(n);
+            }
+            return 0;
+        }
+        return 0;
+    }
+
+    // Writes the codec payload to out (max_payload_size bytes) and returns its size
+    static size_t put_payload(Codec codec, const T* data, size_t n, uint8_t* out,
+                              Scratch& scratch) {
+        switch (codec) {
+        case Codec::Raw:
+            if (n > 0) {
+                std::memcpy(out, data, n * sizeof(T));
+            }
+            return n * sizeof(T);
+        case Codec::RunLength:
+            return put_runs(data, n, out);
+        case Codec::BitPack:
+        case Codec::DeltaBitPack:
+            if constexpr (std::is_integral<T>::value) {
+                return Compressor::bitpack_encode(data, n, out, codec == Codec::DeltaBitPack);
+            }
+            return 0;
+        case Codec::Dictionary:
+            return DictionaryChunk<T>::encode(data, n, out, scratch.dictionary);
+        case Codec::Xor:
+            if constexpr (std::is_floating_point<T>::value) {
+                scratch.stream.clear();
+                const size_t bytes = Compressor::xor_encode(data, n, scratch.stream);
+                std::memcpy(out, scratch.stream.data(), bytes);
+                return bytes;
+            }
+            return 0;
+        }
+        return 0;
+    }
+
+    // Runs as (raw value, LEB128 length) pairs after a LEB128 run count
+    static size_t put_runs(const T* data, size_t n, uint8_t* out) {
+        auto run_end = [&](size_t i) {
+            size_t j = i + 1;
+            while (j < n && std::memcmp(data + j, data + i, sizeof(T)) == 0) {
+                ++j;
+            }
+            return j;
+        };
+        size_t runs = 0;
+        for (size_t i = 0; i < n; i = run_end(i)) {
+            ++runs;
+        }
+
+        size_t pos = detail::varint_put(runs, out);
+        for (size_t i = 0; i < n;) {
+            const size_t j = run_end(i);
+            std::memcpy(out + pos, data + i, sizeof(T));
+            pos += sizeof(T);
+            pos += detail::varint_put(j - i, out + pos);
+            i = j;
+        }
+        return pos;
+    }
+
+    static void check_limit(uint64_t count, uint64_t max_values) {
+        if (count > max_values) {
+            throw chunk_processing::SerializationError("Chunk exceeds the decoded value limit");
+        }
+    }
+
+    static std::vector<T> decode_raw(const uint8_t* data, size_t size, uint64_t max_values) {
+        check_limit(size / sizeof(T), max_values);
+        if (size % sizeof(T) != 0) {
+            throw chunk_processing::SerializationError("Invalid raw chunk size");
+        }
+        std::vector<T> out(size / sizeof(T));
+        if (size > 0) {
+            std::memcpy(out.data(), data, size);
+        }
+        return out;
+    }
+
+    static std::vector<T> decode_runs(const uint8_t* data, size_t size, uint64_t max_values) {
+        const uint8_t* end = data + size;
+        uint64_t runs;
+        const uint8_t* p = detail::varint_get(data, end, runs);
+        std::vector<T> out;
+        uint64_t total = 0;
+        for (uint64_t r = 0; r < runs; ++r) {
+            if (static_cast<size_t>(end - p) < sizeof(T)) {
+                throw chunk_processing::SerializationError("Run-length chunk is truncated");
+            }
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            uint64_t length;
+            p = detail::varint_get(p + sizeof(T), end, length);
+            if (length > std::numeric_limits<uint32_t>::max()) {
+                throw chunk_processing::SerializationError("Invalid run length");
+            }
+            total += length;
+            check_limit(total, max_values);
+            out.insert(out.end(), static_cast<size_t>(length), value);
+        }
+        return out;
+    }
+
+    static std::vector<T> decode_bitpack(const uint8_t* data, size_t size,
+                                         [[maybe_unused]] uint64_t max_values) {
+        if constexpr (std::is_integral<T>::value) {
+            check_limit(Compressor::bitpack_value_count(data, size), max_values);
+            std::vector<T> out(Compressor::bitpack_value_count(data, size));
+            Compressor::bitpack_decode(data, size, out.data());
+            return out;
+        } else {
+            throw chunk_processing::SerializationError("Bit-packing applies to integers only");
+        }
+    }
+
+    static std::vector<T> decode_dictionary(const uint8_t* data, size_t size,
+                                            uint64_t max_values) {
+        return DictionaryChunk<T>::deserialize(data, size, max_values).decode();
+    }
+
+    static std::vector<T> decode_xor(const uint8_t* data, size_t size,
+                                     [[maybe_unused]] uint64_t max_values) {
+        if constexpr (std::is_floating_point<T>::value) {
+            std::vector<T> out(Compressor::xor_value_count(data, size, max_values));
+            Compressor::xor_decode(data, size, out.data(), nullptr, max_values);
+            return out;
+        } else {
+            throw chunk_processing::SerializationError(
+                "XOR coding applies to floating point only");
+        }
+    }
+
+    // Indexed by Codec; the bit-packed stream header records whether deltas are used
+    static const Decoder* decoders() {
+        static const Decoder table[CODEC_COUNT] = {&decode_raw,    &decode_runs,
+                                                   &decode_bitpack, &decode_bitpack,
+                                                   &decode_dictionary, &decode_xor};
+        return table;
+    }
+
+    AdaptiveOptions options_;
+};
+
+} // namespace chunk_compression
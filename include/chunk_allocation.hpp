@@ -0,0 +1,178 @@
+/**
+ * @file chunk_allocation.hpp
+ * @brief Process-wide heap allocation counters for benchmarks and tests
+ *
+ * The counters are fed by the replaceable global operator new/delete in
+ * src/allocation_hooks.cpp. Only executables that compile that file in
+ * (benchmark_exe and the test runner) are instrumented; elsewhere
+ * AllocationTracker::installed() is false and every counter stays zero.
+ *
+ * ScopedAllocationCounter reports allocations, bytes allocated and peak live
+ * bytes for a region of code; the benchmark harness wraps every timed run in
+ * one.
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace chunk_benchmark {
+
+/**
+ * @brief Heap activity over some interval
+ */
+struct AllocationStats {
+    uint64_t allocations = 0;     ///< Calls to operator new
+    uint64_t deallocations = 0;   ///< Calls to operator delete
+    uint64_t bytes_allocated = 0; ///< Bytes requested from operator new
+    uint64_t peak_bytes = 0;      ///< Highest live heap bytes above the starting level
+};
+
+namespace detail {
+
+struct AllocationCounters {
+    std::atomic<bool> installed{false};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<int64_t> peak_bytes{0};
+};
+
+// Constant-initialized, so operator new may use it before any dynamic initialization
+inline AllocationCounters allocation_counters;
+
+} // namespace detail
+
+/**
+ * @brief Global allocation counters shared by all threads
+ */
+class CHUNK_EXPORT AllocationTracker {
+public:
+    /// True when the operator new/delete hooks are linked into this executable
+    static bool installed() {
+        return detail::allocation_counters.installed.load(std::memory_order_relaxed);
+    }
+
+    /// Called by the hooks once at startup
+    static void mark_installed() noexcept {
+        detail::allocation_counters.installed.store(true, std::memory_order_relaxed);
+    }
+
+    static void record_allocation(size_t size) noexcept {
+        auto& c = detail::allocation_counters;
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+        const int64_t live =
+            c.live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+            static_cast<int64_t>(size);
+        int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak &&
+               !c.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void record_deallocation(size_t size) noexcept {
+        auto& c = detail::allocation_counters;
+        c.deallocations.fetch_add(1, std::memory_order_relaxed);
+        c.live_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+
+    /// Heap bytes currently allocated through operator new
+    static int64_t live_bytes() {
+        return detail::allocation_counters.live_bytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Restart peak tracking from the current live level
+     * @return The current live level, to subtract from peak_live_bytes() later
+     */
+    static int64_t reset_peak() {
+        auto& c = detail::allocation_counters;
+        const int64_t live = c.live_bytes.load(std::memory_order_relaxed);
+        c.peak_bytes.store(live, std::memory_order_relaxed);
+        return live;
+    }
+
+    /// Highest live level since the last reset_peak()
+    static int64_t peak_live_bytes() {
+        return detail::allocation_counters.peak_bytes.load(std::memory_order_relaxed);
+    }
+
+    /// Raise the tracked peak to at least level (restores a peak saved before reset_peak())
+    static void raise_peak(int64_t level) {
+        auto& c = detail::allocation_counters;
+        int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+        while (level > peak &&
+               !c.peak_bytes.compare_exchange_weak(peak, level, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Counters since program start; peak_bytes is the highest live level since reset_peak()
+     */
+    static AllocationStats totals() {
+        auto& c = detail::allocation_counters;
+        AllocationStats stats;
+        stats.allocations = c.allocations.load(std::memory_order_relaxed);
+        stats.deallocations = c.deallocations.load(std::memory_order_relaxed);
+        stats.bytes_allocated = c.bytes_allocated.load(std::memory_order_relaxed);
+        stats.peak_bytes = static_cast<uint64_t>(c.peak_bytes.load(std::memory_order_relaxed));
+        return stats;
+    }
+};
+
+/**
+ * @brief Heap activity from construction to stats(), e.g. around one strategy call
+ *
+ * Counts are process-wide, so allocations made by other threads during the
+ * scope (such as thread pool workers) are included. Scopes nest: an inner
+ * scope restarts peak tracking and, when it ends, restores the peak of the
+ * enclosing scope. All counts are zero unless AllocationTracker::installed().
+ *
+ * @code
+ * ScopedAllocationCounter counter;
+ * auto chunks = strategy.apply(data);
+ * AllocationStats stats = counter.stats();
+ * @endcode
+ */
+class CHUNK_EXPORT ScopedAllocationCounter {
+public:
+    ScopedAllocationCounter()
+        : start_(AllocationTracker::totals()), outer_peak_(AllocationTracker::peak_live_bytes()),
+          baseline_(AllocationTracker::reset_peak()) {}
+
+    ScopedAllocationCounter(const ScopedAllocationCounter&) = delete;
+    ScopedAllocationCounter& operator=(const ScopedAllocationCounter&) = delete;
+
+    ~ScopedAllocationCounter() {
+        AllocationTracker::raise_peak(outer_peak_);
+    }
+
+    /**
+     * @brief Activity since construction
+     *
+     * peak_bytes is the highest live heap level above the level at
+     * construction, so memory freed later in the scope still counts.
+     */
+    AllocationStats stats() const {
+        const AllocationStats now = AllocationTracker::totals();
+        AllocationStats stats;
+        stats.allocations = now.allocations - start_.allocations;
+        stats.deallocations = now.deallocations - start_.deallocations;
+        stats.bytes_allocated = now.bytes_allocated - start_.bytes_allocated;
+        const int64_t peak = AllocationTracker::peak_live_bytes() - baseline_;
+        stats.peak_bytes = peak > 0 ? static_cast<uint64_t>(peak) : 0;
+        return stats;
+    }
+
+private:
+    AllocationStats start_;
+    int64_t outer_peak_;
+    int64_t baseline_;
+};
+
+} // namespace chunk_benchmark
@@ -0,0 +1,462 @@
+/**
+ * @file chunk_arrow.hpp
+ * @brief Apache Arrow layout and IPC stream export for chunk sets, without the Arrow library
+ *
+ * A chunk set maps onto one Arrow column of type List<T> (int32 offsets) or
+ * LargeList<T> (int64 offsets): chunk i holds values[offsets[i],
+ * offsets[i + 1]). ArrowChunkArray builds those buffers once, 64-byte
+ * aligned, in a single arena that is also the body of an IPC record batch,
+ * so writing the stream copies nothing further. Chunk sets have no nulls,
+ * so both validity bitmaps are omitted (zero-length buffers), as the Arrow
+ * format allows for arrays with a null count of zero.
+ *
+ * The IPC stream is: Schema message, one RecordBatch message, end-of-stream
+ * marker. Message metadata is FlatBuffers-encoded (Arrow format version 5)
+ * by a small forward-building writer in this file.
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include "chunk_errors.hpp"
+#include "chunk_file.hpp"
+#include "chunk_io.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace chunk_serialization {
+
+/// Alignment of every buffer in the arena and of the record batch body in a stream
+constexpr size_t ARROW_ALIGNMENT = 64;
+
+namespace detail {
+
+// Enum values from Arrow's format/Schema.fbs and format/Message.fbs
+constexpr int16_t ARROW_METADATA_V5 = 4;
+constexpr uint8_t ARROW_HEADER_SCHEMA = 1;
+constexpr uint8_t ARROW_HEADER_RECORD_BATCH = 3;
+constexpr uint8_t ARROW_TYPE_INT = 2;
+constexpr uint8_t ARROW_TYPE_FLOATING_POINT = 3;
+constexpr uint8_t ARROW_TYPE_LIST = 12;
+constexpr uint8_t ARROW_TYPE_LARGE_LIST = 21;
+constexpr int16_t ARROW_PRECISION_SINGLE = 1;
+constexpr int16_t ARROW_PRECISION_DOUBLE = 2;
+constexpr uint32_t ARROW_CONTINUATION = 0xFFFFFFFFu;
+
+/**
+ * @brief Minimal FlatBuffers writer that lays objects out front to back
+ *
+ * FlatBuffers only requires that uoffsets point forward and that scalars are
+ * naturally aligned, so each object can be written before its children and
+ * its offset fields patched once the children exist. Each vtable is written
+ * just before its table.
+ */
+class FlatBufferWriter {
+public:
+    struct Field {
+        uint16_t id;
+        uint8_t size; ///< 1, 2, 4 or 8 bytes; 4 for offsets, patched with link()
+        uint64_t value;
+    };
+
+    FlatBufferWriter() {
+        push<uint32_t>(0); // root table offset
+    }
+
+    /**
+     * @brief Write a table and return the absolute position of each field, in argument order
+     */
+    std::vector<size_t> table(const std::vector<Field>& fields) {
+        std::vector<size_t> order(fields.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return fields[a].size > fields[b].size; });
+        std::vector<uint16_t> slot(fields.size());
+        size_t table_size = 4;
+        uint16_t field_count = 0;
+        for (size_t i : order) {
+            table_size = static_cast<size_t>(chunk_io::align_up(table_size, fields[i].size));
+            slot[i] = static_cast<uint16_t>(table_size);
+            table_size += fields[i].size;
+            field_count = std::max<uint16_t>(field_count, static_cast<uint16_t>(fields[i].id + 1));
+        }
+
+        align(2);
+        const size_t vtable = buffer_.size();
+        push<uint16_t>(static_cast<uint16_t>(4 + 2 * field_count));
+        push<uint16_t>(static_cast<uint16_t>(table_size));
+        std::vector<uint16_t> entries(field_count, 0);
+        for (size_t i = 0; i < fields.size(); ++i) {
+            entries[fields[i].id] = slot[i];
+        }
+        for (uint16_t entry : entries) {
+            push<uint16_t>(entry);
+        }
+
+        align(8);
+        const size_t table = buffer_.size();
+        buffer_.resize(table + table_size, 0);
+        put<int32_t>(table, static_cast<int32_t>(table - vtable));
+        std::vector<size_t> positions(fields.size());
+        for (size_t i = 0; i < fields.size(); ++i) {
+            positions[i] = table + slot[i];
+            std::memcpy(buffer_.data() + positions[i], &fields[i].value, fields[i].size);
+        }
+        if (table_ == 0) {
+            link(0, table);
+        }
+        table_ = table;
+        return positions;
+    }
+
+    /// Position of the table written last
+    size_t last_table() const {
+        return table_;
+    }
+
+    size_t string(const std::string& s) {
+        align(4);
+        const size_t pos = push<uint32_t>(static_cast<uint32_t>(s.size()));
+        buffer_.insert(buffer_.end(), s.begin(), s.end());
+        buffer_.push_back(0);
+        return pos;
+    }
+
+    /// Vector of uoffsets; element i lives at returned position + 4 + 4 * i
+    size_t offset_vector(size_t n) {
+        align(4);
+        const size_t pos = push<uint32_t>(static_cast<uint32_t>(n));
+        buffer_.resize(buffer_.size() + 4 * n, 0);
+        return pos;
+    }
+
+    /// Vector of 8-byte aligned structs copied from data
+    size_t struct_vector(const void* data, size_t n, size_t struct_size) {
+        align(4);
+        if (buffer_.size() % 8 != 4) {
+            push<uint32_t>(0);
+        }
+        const size_t pos = push<uint32_t>(static_cast<uint32_t>(n));
+        const size_t bytes = n * struct_size;
+        buffer_.resize(buffer_.size() + bytes);
+        if (bytes > 0) {
+            std::memcpy(buffer_.data() + pos + 4, data, bytes);
+        }
+        return pos;
+    }
+
+    /// Point the uoffset stored at slot to target
+    void link(size_t slot, size_t target) {
+        put<uint32_t>(slot, static_cast<uint32_t>(target - slot));
+    }
+
+    std::vector<uint8_t> finish() {
+        align(8);
+        return std::move(buffer_);
+    }
+
+private:
+    void align(size_t alignment) {
+        buffer_.resize(static_cast<size_t>(chunk_io::align_up(buffer_.size(), alignment)), 0);
+    }
+
+    template <typename V>
+    void put(size_t pos, V value) {
+        std::memcpy(buffer_.data() + pos, &value, sizeof(V));
+    }
+
+    template <typename V>
+    size_t push(V value) {
+        const size_t pos = buffer_.size();
+        buffer_.resize(pos + sizeof(V));
+        put(pos, value);
+        return pos;
+    }
+
+    std::vector<uint8_t> buffer_;
+    size_t table_ = 0;
+};
+
+/// Arrow FieldNode and Buffer structs (format/Message.fbs)
+struct ArrowFieldNode {
+    int64_t length;
+    int64_t null_count;
+};
+
+struct ArrowBufferRef {
+    int64_t offset;
+    int64_t length;
+};
+
+/**
+ * @brief Owning byte buffer with 64-byte alignment
+ */
+class AlignedBytes {
+public:
+    AlignedBytes() = default;
+
+    explicit AlignedBytes(size_t size) : size_(size) {
+        if (size_ > 0) {
+            data_ = static_cast<uint8_t*>(::operator new(size_, std::align_val_t(ARROW_ALIGNMENT)));
+            std::memset(data_, 0, size_);
+        }
+    }
+
+    AlignedBytes(const AlignedBytes&) = delete;
+    AlignedBytes& operator=(const AlignedBytes&) = delete;
+
+    AlignedBytes(AlignedBytes&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    AlignedBytes& operator=(AlignedBytes&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~AlignedBytes() {
+        if (data_) {
+            ::operator delete(data_, std::align_val_t(ARROW_ALIGNMENT));
+        }
+    }
+
+    uint8_t* data() {
+        return data_;
+    }
+    const uint8_t* data() const {
+        return data_;
+    }
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief A chunk set in Arrow List/LargeList memory layout
+ *
+ * @tparam T Value type: float, double, or an 8- to 64-bit integer
+ * @tparam Offset int32_t for Arrow List, int64_t for LargeList
+ */
+template <typename T, typename Offset = int32_t>
+class CHUNK_EXPORT ArrowChunkArray {
+    static_assert(std::is_same<Offset, int32_t>::value || std::is_same<Offset, int64_t>::value,
+                  "Arrow list offsets are int32_t (List) or int64_t (LargeList)");
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                      (std::is_integral<T>::value || sizeof(T) == 4 || sizeof(T) == 8),
+                  "Arrow chunk values must be float, double or an integer type");
+
+public:
+    /**
+     * @brief Lay out a chunk set; the values are copied once, into the arena
+     * @throws std::invalid_argument if int32 offsets cannot address every value
+     */
+    explicit ArrowChunkArray(const std::vector<std::vector<T>>& chunks)
+        : chunk_count_(chunks.size()) {
+        for (const auto& chunk : chunks) {
+            value_count_ += chunk.size();
+        }
+        if (value_count_ > static_cast<uint64_t>(std::numeric_limits<Offset>::max())) {
+            throw std::invalid_argument("Too many values for 32-bit Arrow offsets; use int64_t");
+        }
+        const size_t offsets_bytes = (chunk_count_ + 1) * sizeof(Offset);
+        values_offset_ = static_cast<size_t>(chunk_io::align_up(offsets_bytes, ARROW_ALIGNMENT));
+        arena_ = detail::AlignedBytes(static_cast<size_t>(
+            chunk_io::align_up(values_offset_ + value_count_ * sizeof(T), ARROW_ALIGNMENT)));
+
+        auto* offsets = reinterpret_cast<Offset*>(arena_.data());
+        auto* values = reinterpret_cast<T*>(arena_.data() + values_offset_);
+        Offset position = 0;
+        offsets[0] = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (!chunks[i].empty()) {
+                std::memcpy(values + position, chunks[i].data(), chunks[i].size() * sizeof(T));
+            }
+            position += static_cast<Offset>(chunks[i].size());
+            offsets[i + 1] = position;
+        }
+    }
+
+    /// Number of chunks (list length)
+    size_t size() const {
+        return chunk_count_;
+    }
+
+    /// Number of values across all chunks (child array length)
+    size_t value_count() const {
+        return value_count_;
+    }
+
+    /// chunk_count + 1 offsets into values(), 64-byte aligned
+    const Offset* offsets() const {
+        return reinterpret_cast<const Offset*>(arena_.data());
+    }
+
+    /// Child values, 64-byte aligned
+    const T* values() const {
+        return reinterpret_cast<const T*>(arena_.data() + values_offset_);
+    }
+
+    /**
+     * @throws std::out_of_range if i >= size()
+     */
+    chunk_io::ChunkView<T> chunk(size_t i) const {
+        if (i >= chunk_count_) {
+            throw std::out_of_range("Chunk index out of range");
+        }
+        return chunk_io::ChunkView<T>(values() + offsets()[i],
+                                      static_cast<size_t>(offsets()[i + 1] - offsets()[i]));
+    }
+
+    /**
+     * @brief Write an Arrow IPC stream holding the chunk set as one record batch
+     *
+     * The single column is named column_name. If the stream starts at a
+     * 64-byte aligned position (e.g. the start of a file), every body buffer
+     * is 64-byte aligned in it, so a reader that maps the file uses the
+     * buffers in place.
+     *
+     * @throws chunk_processing::SerializationError if the stream fails
+     */
+    void write_ipc_stream(std::ostream& os, const std::string& column_name = "chunks") const {
+        size_t position = 0;
+        write_message(os, position, schema_message(column_name), nullptr, 0);
+        write_message(os, position, record_batch_message(), arena_.data(), arena_.size());
+        const uint32_t end_of_stream[2] = {detail::ARROW_CONTINUATION, 0};
+        write_bytes(os, end_of_stream, sizeof(end_of_stream));
+    }
+
+    /**
+     * @brief The Arrow IPC stream as a byte string
+     */
+    std::string to_ipc_stream(const std::string& column_name = "chunks") const {
+        std::ostringstream os;
+        write_ipc_stream(os, column_name);
+        return os.str();
+    }
+
+private:
+    static constexpr bool large = std::is_same<Offset, int64_t>::value;
+
+    std::vector<uint8_t> schema_message(const std::string& column_name) const {
+        using Field = detail::FlatBufferWriter::Field;
+        detail::FlatBufferWriter fb;
+        // Message { version, header_type, header, bodyLength }
+        auto message = fb.table({{0, 2, static_cast<uint16_t>(detail::ARROW_METADATA_V5)},
+                                 {1, 1, detail::ARROW_HEADER_SCHEMA},
+                                 {2, 4, 0},
+                                 {3, 8, 0}});
+        // Schema { endianness = Little, fields }
+        auto schema = fb.table({{0, 2, 0}, {1, 4, 0}});
+        fb.link(message[2], fb.last_table());
+        const size_t fields = fb.offset_vector(1);
+        fb.link(schema[1], fields);
+
+        // Field { name, nullable, type_type, type, children }
+        const uint8_t list_type = large ? detail::ARROW_TYPE_LARGE_LIST : detail::ARROW_TYPE_LIST;
+        auto list = fb.table({{0, 4, 0},
+                              {1, 1, 0},
+                              {2, 1, list_type},
+                              {3, 4, 0},
+                              {5, 4, 0}});
+        fb.link(fields + 4, fb.last_table());
+        fb.link(list[0], fb.string(column_name));
+        fb.table({}); // List and LargeList tables are empty
+        fb.link(list[3], fb.last_table());
+        const size_t children = fb.offset_vector(1);
+        fb.link(list[4], children);
+
+        auto item = fb.table({{0, 4, 0}, {1, 1, 0}, {2, 1, value_type_id()}, {3, 4, 0}, {5, 4, 0}});
+        fb.link(children + 4, fb.last_table());
+        fb.link(item[0], fb.string("item"));
+        if (std::is_floating_point<T>::value) {
+            const uint16_t precision = sizeof(T) == 4 ? detail::ARROW_PRECISION_SINGLE
+                                                      : detail::ARROW_PRECISION_DOUBLE;
+            fb.table({Field{0, 2, precision}});
+        } else {
+            // Int { bitWidth, is_signed }
+            fb.table({{0, 4, sizeof(T) * 8}, {1, 1, std::is_signed<T>::value ? 1u : 0u}});
+        }
+        fb.link(item[3], fb.last_table());
+        fb.link(item[4], fb.offset_vector(0));
+        return fb.finish();
+    }
+
+    std::vector<uint8_t> record_batch_message() const {
+        detail::FlatBufferWriter fb;
+        auto message = fb.table({{0, 2, static_cast<uint16_t>(detail::ARROW_METADATA_V5)},
+                                 {1, 1, detail::ARROW_HEADER_RECORD_BATCH},
+                                 {2, 4, 0},
+                                 {3, 8, arena_.size()}});
+        // RecordBatch { length, nodes, buffers }
+        auto batch = fb.table({{0, 8, chunk_count_}, {1, 4, 0}, {2, 4, 0}});
+        fb.link(message[2], fb.last_table());
+
+        const detail::ArrowFieldNode nodes[2] = {
+            {static_cast<int64_t>(chunk_count_), 0}, {static_cast<int64_t>(value_count_), 0}};
+        fb.link(batch[1], fb.struct_vector(nodes, 2, sizeof(detail::ArrowFieldNode)));
+        // List validity, list offsets, item validity, item values
+        const detail::ArrowBufferRef buffers[4] = {
+            {0, 0},
+            {0, static_cast<int64_t>((chunk_count_ + 1) * sizeof(Offset))},
+            {0, 0},
+            {static_cast<int64_t>(values_offset_), static_cast<int64_t>(value_count_ * sizeof(T))}};
+        fb.link(batch[2], fb.struct_vector(buffers, 4, sizeof(detail::ArrowBufferRef)));
+        return fb.finish();
+    }
+
+    static uint8_t value_type_id() {
+        return std::is_floating_point<T>::value ? detail::ARROW_TYPE_FLOATING_POINT
+                                                : detail::ARROW_TYPE_INT;
+    }
+
+    /// Encapsulated message: continuation, metadata length, metadata padded so the body is aligned
+    static void write_message(std::ostream& os, size_t& position,
+                              const std::vector<uint8_t>& metadata, const uint8_t* body,
+                              size_t body_size) {
+        const size_t padded = static_cast<size_t>(
+            chunk_io::align_up(position + 8 + metadata.size(), ARROW_ALIGNMENT) - position - 8);
+        const uint32_t prefix[2] = {detail::ARROW_CONTINUATION, static_cast<uint32_t>(padded)};
+        static const char zeros[ARROW_ALIGNMENT] = {};
+        write_bytes(os, prefix, sizeof(prefix));
+        write_bytes(os, metadata.data(), metadata.size());
+        write_bytes(os, zeros, padded - metadata.size());
+        write_bytes(os, body, body_size);
+        position += 8 + padded + body_size;
+    }
+
+    static void write_bytes(std::ostream& os, const void* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        os.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!os) {
+            throw chunk_processing::SerializationError("Failed to write Arrow IPC stream");
+        }
+    }
+
+    size_t chunk_count_ = 0;
+    size_t value_count_ = 0;
+    size_t values_offset_ = 0;
+    detail::AlignedBytes arena_;
+};
+
+} // namespace chunk_serialization
@@ -0,0 +1,277 @@
+/**
+ * @file chunk_backend.hpp
+ * @brief Runtime selection between scalar, SIMD, multithreaded and CUDA kernels
+ *
+ * Each chunking kernel owns a Kernel object listing the variants it was
+ * built with. Host capabilities are probed once (CPUID on x86, device count
+ * for CUDA) and "auto" resolves to the most capable variant the host can
+ * run, so a single binary runs well across different machines. Setting the
+ * CHUNK_BACKEND environment variable (e.g. CHUNK_BACKEND=scalar) overrides
+ * what "auto" picks, which is useful when comparing backends in production.
+ * A CHUNK_BACKEND value that is unknown, or names a backend a kernel does not
+ * have or the host cannot run, is ignored with a warning on stderr, so one
+ * setting can be rolled out across a mixed fleet.
+ *
+ * Registered kernels: the windowed-variance boundary rule
+ * (gpu_chunking.boundaries, gpu_chunking.boundary_range) and the codec
+ * kernels of ChunkCompressor (delta coding, bit-packing, rANS decoding).
+ * The strategies in chunk_strategies.hpp, sub_chunk_strategies.hpp and
+ * sophisticated_chunking.hpp decide each boundary from state reset at the
+ * previous one, so they have no independent per-position work to vectorize
+ * or split and are not routed through this layer.
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include "chunk_thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CHUNK_HAS_X86_DISPATCH 1
+#include <immintrin.h>
+// Compile a wrapper (and everything inlined into it) for a specific ISA
+#define CHUNK_TARGET_SSE2 __attribute__((target("sse2"), flatten))
+#define CHUNK_TARGET_AVX2 __attribute__((target("avx2"), flatten))
+#define CHUNK_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl"), flatten))
+#else
+#define CHUNK_HAS_X86_DISPATCH 0
+#endif
+
+namespace chunk_backend {
+
+/**
+ * @brief Kernel variants, in increasing order of preference for "auto"
+ */
+enum class Backend { Auto, Scalar, SSE2, AVX2, AVX512, Threaded, CUDA };
+
+inline const char* backend_name(Backend backend) {
+    switch (backend) {
+    case Backend::Auto:
+        return "auto";
+    case Backend::Scalar:
+        return "scalar";
+    case Backend::SSE2:
+        return "sse2";
+    case Backend::AVX2:
+        return "avx2";
+    case Backend::AVX512:
+        return "avx512";
+    case Backend::Threaded:
+        return "threaded";
+    case Backend::CUDA:
+        return "cuda";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parse a backend name as accepted by backend_name
+ * @throws std::invalid_argument for unknown names
+ */
+inline Backend parse_backend(const std::string& name) {
+    for (Backend b : {Backend::Auto, Backend::Scalar, Backend::SSE2, Backend::AVX2,
+                      Backend::AVX512, Backend::Threaded, Backend::CUDA}) {
+        if (name == backend_name(b)) {
+            return b;
+        }
+    }
+    throw std::invalid_argument("Unknown compute backend: " + name);
+}
+
+/**
+ * @brief Instruction-set extensions of the host CPU, detected once
+ */
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512 = false;
+
+    static const CpuFeatures& host() {
+        static const CpuFeatures features = detect();
+        return features;
+    }
+
+private:
+    static CpuFeatures detect() {
+        CpuFeatures f;
+#if CHUNK_HAS_X86_DISPATCH
+        __builtin_cpu_init();
+        f.sse2 = __builtin_cpu_supports("sse2");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                   __builtin_cpu_supports("avx512vl");
+#endif
+        return f;
+    }
+};
+
+/**
+ * @brief Whether the host can run a CPU backend
+ *
+ * CUDA availability is decided per kernel by the predicate it registers.
+ */
+inline bool host_supports(Backend backend) {
+    switch (backend) {
+    case Backend::Scalar:
+        return true;
+    case Backend::SSE2:
+        return CpuFeatures::host().sse2;
+    case Backend::AVX2:
+        return CpuFeatures::host().avx2;
+    case Backend::AVX512:
+        return CpuFeatures::host().avx512;
+    case Backend::Threaded:
+        return chunk_processing::ThreadPool::shared().concurrency() > 1;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Set of interchangeable implementations of one kernel
+ * @tparam Signature Function type shared by all variants, e.g. void(const int*, size_t)
+ */
+template <typename Signature>
+class Kernel;
+
+template <typename R, typename... Args>
+class Kernel<R(Args...)> {
+public:
+    using Function = R (*)(Args...);
+    using Predicate = bool (*)();
+
+    explicit Kernel(std::string name) : name_(std::move(name)) {}
+
+    Kernel(const Kernel& other) : name_(other.name_), variants_(other.variants_) {}
+
+    /**
+     * @brief Register a variant
+     * @param backend Which backend the variant implements
+     * @param fn Implementation
+     * @param available Optional availability check; defaults to host_supports(backend)
+     */
+    void add(Backend backend, Function fn, Predicate available = nullptr) {
+        if (backend == Backend::Auto || fn == nullptr) {
+            throw std::invalid_argument("Invalid variant for kernel " + name_);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        variants_.erase(std::remove_if(variants_.begin(), variants_.end(),
+                                       [&](const Variant& v) { return v.backend == backend; }),
+                        variants_.end());
+        variants_.push_back({backend, fn, available});
+        std::sort(variants_.begin(), variants_.end(),
+                  [](const Variant& a, const Variant& b) { return a.backend > b.backend; });
+        auto_choice_.store(nullptr);
+    }
+
+    /**
+     * @brief Implementation for a backend
+     * @param backend Requested backend; Auto picks the best available one
+     * @throws std::runtime_error if the backend is not registered or not usable on this host
+     */
+    Function resolve(Backend backend = Backend::Auto) const {
+        if (backend == Backend::Auto) {
+            Function cached = auto_choice_.load();
+            if (!cached) {
+                cached = resolve_auto();
+                auto_choice_.store(cached);
+            }
+            return cached;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& v : variants_) {
+            if (v.backend == backend) {
+                if (!v.usable()) {
+                    throw std::runtime_error(std::string("Backend ") + backend_name(backend) +
+                                             " is not available on this host for " + name_);
+                }
+                return v.fn;
+            }
+        }
+        throw std::runtime_error(std::string("Backend ") + backend_name(backend) +
+                                 " is not registered for " + name_);
+    }
+
+    /**
+     * @brief Backend that Auto resolves to
+     */
+    Backend auto_backend() const {
+        Function fn = resolve();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& v : variants_) {
+            if (v.fn == fn) {
+                return v.backend;
+            }
+        }
+        return Backend::Scalar;
+    }
+
+    /**
+     * @brief Registered backends that can run on this host, best first
+     */
+    std::vector<Backend> available() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Backend> result;
+        for (const auto& v : variants_) {
+            if (v.usable()) {
+                result.push_back(v.backend);
+            }
+        }
+        return result;
+    }
+
+    R operator()(Args... args) const {
+        return resolve()(args...);
+    }
+
+    const std::string& name() const {
+        return name_;
+    }
+
+private:
+    struct Variant {
+        Backend backend;
+        Function fn;
+        Predicate available;
+
+        bool usable() const {
+            return available ? available() : host_supports(backend);
+        }
+    };
+
+    Function resolve_auto() const {
+        if (const char* forced = std::getenv("CHUNK_BACKEND")) {
+            try {
+                Backend backend = parse_backend(forced);
+                if (backend != Backend::Auto) {
+                    return resolve(backend);
+                }
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "chunk_backend: ignoring CHUNK_BACKEND=%s for %s (%s)\n",
+                             forced, name_.c_str(), e.what());
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& v : variants_) {
+            if (v.usable()) {
+                return v.fn;
+            }
+        }
+        throw std::runtime_error("No usable backend registered for " + name_);
+    }
+
+    std::string name_;
+    std::vector<Variant> variants_;
+    mutable std::mutex mutex_;
+    mutable std::atomic<Function> auto_choice_{nullptr};
+};
+
+} // namespace chunk_backend
@@ -0,0 +1,215 @@
+/**
+ * @file chunk_batch_compression.hpp
+ * @brief Parallel compression of whole chunk sets into a single arena
+ *
+ * BatchCompressor splits a chunk set into contiguous ranges, a few per pool
+ * thread. A first pass picks each chunk's codec; the arena is then sized
+ * once from the codecs' worst-case sizes, each range encodes its chunks
+ * straight into its part of the arena, and the ranges are moved together.
+ * Every range reuses one AdaptiveCompressor::Scratch for sampling and for
+ * the dictionary and XOR encoders, so the allocation count depends on the
+ * number of ranges, not the number of chunks, for every codec.
+ */
+
+#pragma once
+
+#include "chunk_adaptive_compression.hpp"
+#include "chunk_errors.hpp"
+#include "chunk_thread_pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace chunk_compression {
+
+/**
+ * @brief Compressed chunks stored back to back with an offsets index
+ *
+ * Chunk i occupies arena[offsets[i], offsets[i + 1]) and is an
+ * AdaptiveCompressor chunk: a codec header followed by the payload.
+ */
+struct CompressedBatch {
+    std::vector<uint8_t> arena;
+    std::vector<size_t> offsets{0};
+
+    /// Number of chunks in the batch
+    size_t size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @throws std::out_of_range if i >= size()
+     */
+    const uint8_t* chunk_data(size_t i) const {
+        check_index(i);
+        return arena.data() + offsets[i];
+    }
+
+    /**
+     * @throws std::out_of_range if i >= size()
+     */
+    size_t chunk_size(size_t i) const {
+        check_index(i);
+        return offsets[i + 1] - offsets[i];
+    }
+
+private:
+    void check_index(size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("Batch chunk index out of range");
+        }
+    }
+};
+
+/**
+ * @brief Compresses and decompresses chunk sets on a thread pool
+ * @tparam T Arithmetic value type
+ */
+template <typename T>
+class BatchCompressor {
+public:
+    using Adaptive = AdaptiveCompressor<T>;
+
+    /**
+     * @param options Codec selection tuning for compress() without a codec
+     * @param pool Pool to run on (nullptr uses ThreadPool::shared())
+     */
+    explicit BatchCompressor(AdaptiveOptions options = {},
+                             chunk_processing::ThreadPool* pool = nullptr)
+        : adaptive_(options), pool_(pool ? pool : &chunk_processing::ThreadPool::shared()) {}
+
+    /**
+     * @brief Compress every chunk with the codec chosen for it
+     */
+    CompressedBatch compress(const std::vector<std::vector<T>>& chunks) const {
+        return compress_impl(chunks, [&](const std::vector<T>& chunk, Scratch& scratch) {
+            return adaptive_.choose(chunk.data(), chunk.size(), scratch);
+        });
+    }
+
+    /**
+     * @brief Compress every chunk with one codec
+     * @throws std::invalid_argument if the codec does not apply to T
+     */
+    CompressedBatch compress(const std::vector<std::vector<T>>& chunks, Codec codec) const {
+        Adaptive::check_codec(codec);
+        return compress_impl(chunks, [codec](const std::vector<T>&, Scratch&) { return codec; });
+    }
+
+    /**
+     * @brief Decompress every chunk of a batch
+     * @throws chunk_processing::SerializationError if a chunk is malformed
+     */
+    std::vector<std::vector<T>> decompress(const CompressedBatch& batch) const {
+        check_offsets(batch);
+        std::vector<std::vector<T>> chunks(batch.size());
+        pool_->parallel_for(0, batch.size(), 1, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                chunks[i] = Adaptive::decompress(batch.arena.data() + batch.offsets[i],
+                                                 batch.offsets[i + 1] - batch.offsets[i]);
+            }
+        });
+        return chunks;
+    }
+
+    /**
+     * @brief Decompress a single chunk of a batch
+     */
+    static std::vector<T> decompress(const CompressedBatch& batch, size_t i) {
+        return Adaptive::decompress(batch.chunk_data(i), batch.chunk_size(i));
+    }
+
+private:
+    using Scratch = typename Adaptive::Scratch;
+
+    // Pick is called as pick(chunk, scratch) and returns one of Adaptive::candidates()
+    template <typename Pick>
+    CompressedBatch compress_impl(const std::vector<std::vector<T>>& chunks, Pick pick) const {
+        const size_t n = chunks.size();
+        CompressedBatch batch;
+        batch.offsets.assign(n + 1, 0);
+        if (n == 0) {
+            return batch;
+        }
+
+        const size_t ranges = std::min(n, pool_->concurrency() * 4);
+        auto range_begin = [&](size_t r) { return n * r / ranges; };
+        std::vector<Scratch> scratch(ranges);
+        std::vector<Codec> codecs(n);
+
+        // Pick codecs; the worst-case size of chunk i lands in offsets[i + 1]
+        pool_->parallel_for(0, ranges, 1, [&](size_t lo, size_t hi) {
+            for (size_t r = lo; r < hi; ++r) {
+                for (size_t i = range_begin(r); i < range_begin(r + 1); ++i) {
+                    codecs[i] = pick(chunks[i], scratch[r]);
+                    batch.offsets[i + 1] =
+                        Adaptive::max_compressed_size(codecs[i], chunks[i].size());
+                }
+            }
+        });
+
+        // Range r encodes from the worst-case offset of its first chunk
+        std::vector<size_t> range_start(ranges);
+        for (size_t i = 0; i < n; ++i) {
+            batch.offsets[i + 1] += batch.offsets[i];
+        }
+        for (size_t r = 0; r < ranges; ++r) {
+            range_start[r] = batch.offsets[range_begin(r)];
+        }
+        batch.arena.resize(batch.offsets[n]);
+
+        // Actual chunk sizes land in offsets[i + 1]
+        pool_->parallel_for(0, ranges, 1, [&](size_t lo, size_t hi) {
+            for (size_t r = lo; r < hi; ++r) {
+                uint8_t* out = batch.arena.data() + range_start[r];
+                for (size_t i = range_begin(r); i < range_begin(r + 1); ++i) {
+                    const auto& chunk = chunks[i];
+                    const size_t bytes = Adaptive::compress_to(codecs[i], chunk.data(),
+                                                               chunk.size(), out, scratch[r]);
+                    batch.offsets[i + 1] = bytes;
+                    out += bytes;
+                }
+            }
+        });
+
+        // Ranges only move towards the front, so moving them in order overwrites nothing unread
+        size_t end = 0;
+        for (size_t r = 0; r < ranges; ++r) {
+            size_t bytes = 0;
+            for (size_t i = range_begin(r); i < range_begin(r + 1); ++i) {
+                bytes += batch.offsets[i + 1];
+                batch.offsets[i + 1] += batch.offsets[i];
+            }
+            if (bytes > 0 && range_start[r] != end) {
+                std::memmove(batch.arena.data() + end, batch.arena.data() + range_start[r],
+                             bytes);
+            }
+            end += bytes;
+        }
+        batch.arena.resize(end);
+        return batch;
+    }
+
+    static void check_offsets(const CompressedBatch& batch) {
+        if (batch.offsets.empty() || batch.offsets.front() != 0 ||
+            batch.offsets.back() != batch.arena.size()) {
+            throw chunk_processing::SerializationError("Invalid batch offsets");
+        }
+        for (size_t i = 1; i < batch.offsets.size(); ++i) {
+            if (batch.offsets[i] < batch.offsets[i - 1]) {
+                throw chunk_processing::SerializationError("Invalid batch offsets");
+            }
+        }
+    }
+
+    AdaptiveCompressor<T> adaptive_;
+    chunk_processing::ThreadPool* pool_;
+};
+
+} // namespace chunk_compression
@@ -7,59 +7,386 @@
 
 #pragma once
 
+#include "chunk_allocation.hpp"
 #include "chunk_common.hpp"
+#include "chunk_errors.hpp"
+#include "chunk_perf_counters.hpp"
 #include "chunk_strategies.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <typeinfo>
+#include <utility>
 #include <vector>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
 
 namespace chunk_benchmark {
 
+/**
+ * @brief How many times each benchmark runs
+ */
+struct BenchmarkOptions {
+    size_t warmup_iterations = 3; ///< Untimed runs to warm caches, allocators and branch predictors
+    size_t iterations = 100;      ///< Timed runs, one sample each
+    bool perf_counters = false;   ///< Also collect hardware counters (Linux perf_event_open)
+};
+
 struct BenchmarkResult {
-    double execution_time_ms;
-    size_t memory_usage_bytes;
-    size_t num_chunks;
+    double execution_time_ms = 0.0; ///< Total time of the timed runs
+    size_t memory_usage_bytes = 0;  ///< Peak heap growth during one run (0 unless tracked)
+    size_t num_chunks = 0;          ///< Chunks produced by the last run
     std::string strategy_name;
+
+    size_t iterations = 0;
+    size_t elements = 0; ///< Input elements per run
+    size_t bytes = 0;    ///< Input bytes per run
+    std::vector<double> samples_ns;
+    double mean_ns = 0.0;
+    double median_ns = 0.0;
+    double p90_ns = 0.0;
+    double p99_ns = 0.0;
+    double stddev_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+    double elements_per_second = 0.0;     ///< At the median time
+    double bytes_per_second = 0.0;        ///< At the median time
+    bool memory_tracked = false;          ///< Whether the allocation counters were measured
+    double allocations_per_run = 0.0;     ///< Mean operator new calls per timed run
+    double allocated_bytes_per_run = 0.0; ///< Mean bytes requested per timed run
+    /// Hardware counts per input element (per run if elements is 0); NaN when not collected
+    PerfCounterValues counters_per_element;
 };
 
+namespace detail {
+
+/// Linearly interpolated quantile of sorted samples, q in [0, 1]
+inline double quantile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const double rank = q * static_cast<double>(sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(rank);
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - static_cast<double>(lo));
+}
+
+/// Readable class name of a polymorphic object
+template <typename U>
+std::string type_name(const U& object) {
+    const char* mangled = typeid(object).name();
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        std::string name(demangled);
+        std::free(demangled);
+        return name;
+    }
+#endif
+    return mangled;
+}
+
+inline std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static const char hex[] = "0123456789abcdef";
+            out += "\\u00";
+            out += hex[(c >> 4) & 0xF];
+            out += hex[c & 0xF];
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+inline std::string csv_escape(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        return s;
+    }
+    std::string out = "\"";
+    for (char c : s) {
+        out += c;
+        if (c == '"') {
+            out += '"';
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace detail
+
+/**
+ * @brief Fill the summary fields of a result from its samples_ns
+ * @param result Result with samples_ns, elements and bytes set
+ */
+inline void summarize(BenchmarkResult& result) {
+    std::vector<double> sorted = result.samples_ns;
+    std::sort(sorted.begin(), sorted.end());
+    result.iterations = sorted.size();
+    if (sorted.empty()) {
+        return;
+    }
+    double total = 0.0;
+    for (double s : sorted) {
+        total += s;
+    }
+    result.mean_ns = total / static_cast<double>(sorted.size());
+    double squares = 0.0;
+    for (double s : sorted) {
+        squares += (s - result.mean_ns) * (s - result.mean_ns);
+    }
+    result.stddev_ns =
+        sorted.size() > 1 ? std::sqrt(squares / static_cast<double>(sorted.size() - 1)) : 0.0;
+    result.min_ns = sorted.front();
+    result.max_ns = sorted.back();
+    result.median_ns = detail::quantile(sorted, 0.5);
+    result.p90_ns = detail::quantile(sorted, 0.9);
+    result.p99_ns = detail::quantile(sorted, 0.99);
+    result.execution_time_ms = total / 1e6;
+    if (result.median_ns > 0) {
+        result.elements_per_second = static_cast<double>(result.elements) * 1e9 / result.median_ns;
+        result.bytes_per_second = static_cast<double>(result.bytes) * 1e9 / result.median_ns;
+    }
+}
+
+/**
+ * @brief Time a callable: warmup runs, then one nanosecond sample per timed run
+ *
+ * When the allocation hooks are linked in, each timed run is wrapped in a
+ * ScopedAllocationCounter: memory_usage_bytes is the largest heap growth seen
+ * within a single run and allocations_per_run / allocated_bytes_per_run are
+ * averaged over the runs. With options.perf_counters, hardware
+ * counters of the calling thread are summed over the timed runs; counting is
+ * paused outside the timed region.
+ *
+ * @param name Name reported for the benchmark
+ * @param elements Input elements processed per run (for throughput)
+ * @param bytes Input bytes processed per run (for throughput)
+ * @param run Callable returning the number of chunks it produced
+ * @param options Warmup and timed iteration counts
+ */
+inline BenchmarkResult run_benchmark(const std::string& name, size_t elements, size_t bytes,
+                                     const std::function<size_t()>& run,
+                                     const BenchmarkOptions& options = {}) {
+    using clock = std::chrono::steady_clock;
+    BenchmarkResult result;
+    result.strategy_name = name;
+    result.elements = elements;
+    result.bytes = bytes;
+    result.memory_tracked = AllocationTracker::installed();
+
+    for (size_t i = 0; i < options.warmup_iterations; ++i) {
+        run();
+    }
+    std::unique_ptr<PerfCounters> counters;
+    if (options.perf_counters) {
+        counters = std::make_unique<PerfCounters>();
+        counters->start();
+        counters->stop();
+    }
+    result.samples_ns.reserve(options.iterations);
+    AllocationStats allocations;
+    for (size_t i = 0; i < options.iterations; ++i) {
+        ScopedAllocationCounter allocation_counter;
+        if (counters) {
+            counters->resume();
+        }
+        const auto start = clock::now();
+        result.num_chunks = run();
+        const auto end = clock::now();
+        if (counters) {
+            counters->stop();
+        }
+        const AllocationStats run_allocations = allocation_counter.stats();
+        allocations.allocations += run_allocations.allocations;
+        allocations.bytes_allocated += run_allocations.bytes_allocated;
+        allocations.peak_bytes = std::max(allocations.peak_bytes, run_allocations.peak_bytes);
+        result.samples_ns.push_back(
+            std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    if (result.memory_tracked && options.iterations > 0) {
+        const double runs = static_cast<double>(options.iterations);
+        result.memory_usage_bytes = static_cast<size_t>(allocations.peak_bytes);
+        result.allocations_per_run = static_cast<double>(allocations.allocations) / runs;
+        result.allocated_bytes_per_run = static_cast<double>(allocations.bytes_allocated) / runs;
+    }
+    if (counters && options.iterations > 0) {
+        const double units = static_cast<double>(options.iterations) *
+                             static_cast<double>(std::max<size_t>(elements, 1));
+        result.counters_per_element = counters->read();
+        for (double& value : result.counters_per_element.values) {
+            value /= units;
+        }
+    }
+    summarize(result);
+    return result;
+}
+
+/**
+ * @brief Write results as CSV, one row per benchmark (samples omitted)
+ */
+inline void write_csv(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    const auto precision = os.precision(12);
+    os << "name,iterations,elements,bytes,num_chunks,mean_ns,median_ns,p90_ns,p99_ns,"
+          "stddev_ns,min_ns,max_ns,elements_per_second,bytes_per_second,peak_memory_bytes,"
+          "allocations_per_run,allocated_bytes_per_run";
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        os << ',' << perf_event_name(static_cast<PerfEvent>(e)) << "_per_element";
+    }
+    os << '\n';
+    for (const auto& r : results) {
+        os << detail::csv_escape(r.strategy_name) << ',' << r.iterations << ',' << r.elements
+           << ',' << r.bytes << ',' << r.num_chunks << ',' << r.mean_ns << ',' << r.median_ns
+           << ',' << r.p90_ns << ',' << r.p99_ns << ',' << r.stddev_ns << ',' << r.min_ns << ','
+           << r.max_ns << ',' << r.elements_per_second << ',' << r.bytes_per_second << ',';
+        if (r.memory_tracked) {
+            os << r.memory_usage_bytes << ',' << r.allocations_per_run << ','
+               << r.allocated_bytes_per_run;
+        } else {
+            os << ",,";
+        }
+        for (double value : r.counters_per_element.values) {
+            os << ',';
+            if (!std::isnan(value)) {
+                os << value;
+            }
+        }
+        os << '\n';
+    }
+    os.precision(precision);
+}
+
+/**
+ * @brief Write results as a JSON array of objects, including the raw samples
+ */
+inline void write_json(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    const auto precision = os.precision(12);
+    os << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << (i ? ",\n " : "\n ") << "{\"name\": \"" << detail::json_escape(r.strategy_name)
+           << "\", \"iterations\": " << r.iterations << ", \"elements\": " << r.elements
+           << ", \"bytes\": " << r.bytes << ", \"num_chunks\": " << r.num_chunks
+           << ", \"mean_ns\": " << r.mean_ns << ", \"median_ns\": " << r.median_ns
+           << ", \"p90_ns\": " << r.p90_ns << ", \"p99_ns\": " << r.p99_ns
+           << ", \"stddev_ns\": " << r.stddev_ns << ", \"min_ns\": " << r.min_ns
+           << ", \"max_ns\": " << r.max_ns << ", \"elements_per_second\": "
+           << r.elements_per_second << ", \"bytes_per_second\": " << r.bytes_per_second
+           << ", \"peak_memory_bytes\": ";
+        if (r.memory_tracked) {
+            os << r.memory_usage_bytes << ", \"allocations_per_run\": " << r.allocations_per_run
+               << ", \"allocated_bytes_per_run\": " << r.allocated_bytes_per_run;
+        } else {
+            os << "null, \"allocations_per_run\": null, \"allocated_bytes_per_run\": null";
+        }
+        for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+            const double value = r.counters_per_element.values[e];
+            os << ", \"" << perf_event_name(static_cast<PerfEvent>(e)) << "_per_element\": ";
+            if (std::isnan(value)) {
+                os << "null";
+            } else {
+                os << value;
+            }
+        }
+        os << ", \"samples_ns\": [";
+        for (size_t k = 0; k < r.samples_ns.size(); ++k) {
+            os << (k ? ", " : "") << r.samples_ns[k];
+        }
+        os << "]}";
+    }
+    os << (results.empty() ? "]\n" : "\n]\n");
+    os.precision(precision);
+}
+
+/**
+ * @brief Benchmarks named chunking strategies on one input
+ */
 template <typename T>
 class ChunkBenchmark {
 private:
     std::vector<T> test_data;
-    std::vector<std::shared_ptr<chunk_processing::ChunkStrategy<T>>> strategies;
-    size_t iterations;
+    std::vector<std::pair<std::string, std::shared_ptr<chunk_processing::ChunkStrategy<T>>>>
+        strategies;
+    BenchmarkOptions options;
+    std::vector<BenchmarkResult> results;
 
 public:
     explicit ChunkBenchmark(const std::vector<T>& data, size_t num_iterations = 100)
-        : test_data(data), iterations(num_iterations) {}
-
-    void add_strategy(std::shared_ptr<chunk_processing::ChunkStrategy<T>> strategy) {
-        strategies.push_back(strategy);
+        : test_data(data) {
+        options.iterations = num_iterations;
     }
 
-    std::vector<BenchmarkResult> benchmark_chunking() {
-        std::vector<BenchmarkResult> results;
-        for (const auto& strategy : strategies) {
-            auto start = std::chrono::high_resolution_clock::now();
-
-            size_t total_chunks = 0;
-            for (size_t i = 0; i < iterations; ++i) {
-                auto chunks = strategy->apply(test_data);
-                total_chunks += chunks.size();
-            }
+    ChunkBenchmark(const std::vector<T>& data, const BenchmarkOptions& benchmark_options)
+        : test_data(data), options(benchmark_options) {}
 
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    /**
+     * @brief Add a strategy to benchmark
+     * @param strategy Strategy to run on the benchmark data
+     * @param name Name to report (defaults to the strategy's class name)
+     */
+    void add_strategy(std::shared_ptr<chunk_processing::ChunkStrategy<T>> strategy,
+                      const std::string& name = "") {
+        if (!strategy) {
+            throw std::invalid_argument("Strategy must not be null");
+        }
+        strategies.emplace_back(name.empty() ? detail::type_name(*strategy) : name,
+                                std::move(strategy));
+    }
 
-            results.push_back({static_cast<double>(duration.count()), sizeof(T) * test_data.size(),
-                               total_chunks / iterations, "Strategy"});
+    /**
+     * @brief Run every strategy and return one result per strategy, in insertion order
+     */
+    std::vector<BenchmarkResult> benchmark_chunking() {
+        results.clear();
+        for (const auto& [name, strategy] : strategies) {
+            const auto* chunk_strategy = strategy.get();
+            results.push_back(run_benchmark(
+                name, test_data.size(), test_data.size() * sizeof(T),
+                [&]() { return chunk_strategy->apply(test_data).size(); }, options));
         }
         return results;
     }
 
+    /// Results of the last benchmark_chunking() call
+    const std::vector<BenchmarkResult>& last_results() const {
+        return results;
+    }
+
+    /**
+     * @brief Save the last results; the format follows the extension (.json, otherwise CSV)
+     * @throws chunk_processing::ChunkingError if the file cannot be written
+     */
     void save_results(const std::string& filename) const {
-        // Implementation for saving results to file
+        std::ofstream out(filename);
+        if (!out) {
+            throw chunk_processing::ChunkingError("Failed to create results file: " + filename);
+        }
+        const bool json =
+            filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+        if (json) {
+            write_json(out, results);
+        } else {
+            write_csv(out, results);
+        }
+        if (!out) {
+            throw chunk_processing::ChunkingError("Failed to write results file: " + filename);
+        }
     }
 };
 
-} // namespace chunk_benchmark
\ No newline at end of file
+} // namespace chunk_benchmark
@@ -0,0 +1,378 @@
+/**
+ * @file chunk_bitpacking.hpp
+ * @brief Frame-of-reference bit-packing and varint primitives for integer chunks
+ *
+ * Bit-packed blocks hold 128 values in the SIMD-BP128 layout: value i goes
+ * to lane i % 4, and each lane's 32 values are packed LSB-first into
+ * bit_width 32-bit words, interleaved so that word j of lane l is stored at
+ * position 4 * j + l. One SSE2 register therefore unpacks four consecutive
+ * values per step. Words are little-endian.
+ */
+
+#pragma once
+
+#include "chunk_backend.hpp"
+#include "chunk_errors.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace chunk_compression {
+
+/// Values per bit-packed block
+constexpr size_t BITPACK_BLOCK_SIZE = 128;
+
+/// Magic bytes at the start of a bit-packed stream
+constexpr char BITPACK_MAGIC[4] = {'C', 'B', 'P', 'K'};
+
+/// Current bit-packed stream version
+constexpr uint8_t BITPACK_VERSION = 1;
+
+/// Stream flag: blocks hold frame-of-reference coded deltas
+constexpr uint8_t BITPACK_FLAG_DELTA = 0x01;
+
+/// Default limit on the number of values decoded from untrusted bytes. Some
+/// encodings spend no bits per value (a one-entry dictionary, a run), so
+/// their headers alone could otherwise demand arbitrarily large outputs.
+constexpr uint64_t DEFAULT_MAX_DECODED_VALUES = uint64_t{1} << 28;
+
+/**
+ * @brief Header of a bit-packed stream
+ *
+ * Followed by block_count 32-bit block offsets (from the start of the
+ * stream) and the blocks themselves, so any block can be decoded on its own.
+ */
+struct BitPackHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t value_size; ///< sizeof(T) of the encoded values
+    uint8_t flags;
+    uint8_t reserved;
+    uint64_t value_count;
+    uint32_t block_count;
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(BitPackHeader) == 24, "BitPackHeader layout must stay fixed");
+
+/**
+ * @brief Header of one block
+ *
+ * Followed by the reference value (value_size bytes), the block's first
+ * value when the stream is delta coded, padding to 4 bytes, and
+ * 16 * bit_width bytes of packed words.
+ */
+struct BitPackBlockHeader {
+    uint8_t bit_width;
+    uint8_t count; ///< 1..128 values
+    uint16_t reserved;
+};
+
+namespace detail {
+
+/**
+ * @brief Number of bits needed to represent value (0 for 0)
+ */
+template <typename U>
+unsigned bits_required(U value) {
+    static_assert(std::is_unsigned<U>::value, "bits_required expects an unsigned type");
+    unsigned bits = 0;
+    uint64_t v = value;
+    while (v >= 256) {
+        v >>= 8;
+        bits += 8;
+    }
+    while (v != 0) {
+        v >>= 1;
+        ++bits;
+    }
+    return bits;
+}
+
+inline uint32_t load_u32(const uint8_t* p) {
+    uint32_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+inline void store_u32(uint8_t* p, uint32_t word) {
+    std::memcpy(p, &word, sizeof(word));
+}
+
+/// Bytes of packed words in a block of the given bit width
+inline size_t bitpack_payload_size(unsigned bit_width) {
+    return 16 * static_cast<size_t>(bit_width);
+}
+
+template <typename U>
+using PackFn = void(const U*, U, unsigned, uint8_t*);
+template <typename U>
+using UnpackFn = void(const uint8_t*, U, unsigned, U*);
+
+/**
+ * @brief Pack 128 values (minus reference) with bit_width bits each
+ */
+template <typename U>
+void pack_block_scalar(const U* in, U reference, unsigned bit_width, uint8_t* out) {
+    if (bit_width == 0) {
+        return;
+    }
+    for (size_t lane = 0; lane < 4; ++lane) {
+        uint64_t acc = 0;
+        unsigned filled = 0;
+        size_t word = 0;
+        auto push = [&](uint64_t bits, unsigned width) {
+            acc |= bits << filled;
+            filled += width;
+            if (filled >= 32) {
+                store_u32(out + (word++ * 4 + lane) * 4, static_cast<uint32_t>(acc));
+                acc >>= 32;
+                filled -= 32;
+            }
+        };
+        for (size_t k = 0; k < 32; ++k) {
+            uint64_t v = static_cast<U>(in[k * 4 + lane] - reference);
+            if (bit_width > 32) {
+                push(v & 0xFFFFFFFFu, 32);
+                push(v >> 32, bit_width - 32);
+            } else {
+                push(v, bit_width);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Unpack 128 values and add the reference back
+ */
+template <typename U>
+void unpack_block_scalar(const uint8_t* in, U reference, unsigned bit_width, U* out) {
+    if (bit_width == 0) {
+        for (size_t i = 0; i < BITPACK_BLOCK_SIZE; ++i) {
+            out[i] = reference;
+        }
+        return;
+    }
+    for (size_t lane = 0; lane < 4; ++lane) {
+        uint64_t acc = 0;
+        unsigned avail = 0;
+        size_t word = 0;
+        auto pull = [&](unsigned width) {
+            if (avail < width) {
+                acc |= static_cast<uint64_t>(load_u32(in + (word++ * 4 + lane) * 4)) << avail;
+                avail += 32;
+            }
+            uint64_t bits = acc & (~uint64_t{0} >> (64 - width));
+            acc >>= width;
+            avail -= width;
+            return bits;
+        };
+        for (size_t k = 0; k < 32; ++k) {
+            uint64_t v;
+            if (bit_width > 32) {
+                v = pull(32);
+                v |= pull(bit_width - 32) << 32;
+            } else {
+                v = pull(bit_width);
+            }
+            out[k * 4 + lane] = static_cast<U>(reference + static_cast<U>(v));
+        }
+    }
+}
+
+#if CHUNK_HAS_X86_DISPATCH
+
+CHUNK_TARGET_SSE2 inline void pack_block_sse2(const uint32_t* in, uint32_t reference,
+                                              unsigned bit_width, uint8_t* out) {
+    if (bit_width == 0) {
+        return;
+    }
+    const __m128i ref = _mm_set1_epi32(static_cast<int>(reference));
+    auto* dst = reinterpret_cast<__m128i*>(out);
+    __m128i word = _mm_setzero_si128();
+    unsigned shift = 0;
+    for (size_t k = 0; k < 32; ++k) {
+        __m128i v = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * k)),
+                                  ref);
+        word = _mm_or_si128(word, _mm_sll_epi32(v, _mm_cvtsi32_si128(static_cast<int>(shift))));
+        shift += bit_width;
+        if (shift >= 32) {
+            _mm_storeu_si128(dst++, word);
+            shift -= 32;
+            word = shift > 0 ? _mm_srl_epi32(v, _mm_cvtsi32_si128(static_cast<int>(bit_width -
+                                                                                  shift)))
+                             : _mm_setzero_si128();
+        }
+    }
+}
+
+CHUNK_TARGET_SSE2 inline void unpack_block_sse2(const uint8_t* in, uint32_t reference,
+                                                unsigned bit_width, uint32_t* out) {
+    const __m128i ref = _mm_set1_epi32(static_cast<int>(reference));
+    auto* dst = reinterpret_cast<__m128i*>(out);
+    if (bit_width == 0) {
+        for (size_t k = 0; k < 32; ++k) {
+            _mm_storeu_si128(dst + k, ref);
+        }
+        return;
+    }
+    const __m128i mask =
+        _mm_set1_epi32(static_cast<int>(bit_width == 32 ? 0xFFFFFFFFu : (1u << bit_width) - 1));
+    const auto* src = reinterpret_cast<const __m128i*>(in);
+    __m128i word = _mm_loadu_si128(src++);
+    unsigned shift = 0;
+    for (size_t k = 0; k < 32; ++k) {
+        __m128i v = _mm_srl_epi32(word, _mm_cvtsi32_si128(static_cast<int>(shift)));
+        shift += bit_width;
+        if (shift >= 32 && k < 31) {
+            shift -= 32;
+            word = _mm_loadu_si128(src++);
+            if (shift > 0) {
+                v = _mm_or_si128(
+                    v, _mm_sll_epi32(word, _mm_cvtsi32_si128(static_cast<int>(bit_width - shift))));
+            }
+        }
+        _mm_storeu_si128(dst + k, _mm_add_epi32(_mm_and_si128(v, mask), ref));
+    }
+}
+
+#endif // CHUNK_HAS_X86_DISPATCH
+
+/**
+ * @brief Block packing variants; SIMD variants exist for 32-bit words
+ */
+template <typename U>
+const chunk_backend::Kernel<PackFn<U>>& pack_block_kernel() {
+    static const chunk_backend::Kernel<PackFn<U>> kernel = []() {
+        chunk_backend::Kernel<PackFn<U>> k("compression.bitpack");
+        k.add(chunk_backend::Backend::Scalar, &pack_block_scalar<U>);
+#if CHUNK_HAS_X86_DISPATCH
+        if constexpr (std::is_same<U, uint32_t>::value) {
+            k.add(chunk_backend::Backend::SSE2, &pack_block_sse2);
+        }
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+/**
+ * @brief Block unpacking variants; SIMD variants exist for 32-bit words
+ */
+template <typename U>
+const chunk_backend::Kernel<UnpackFn<U>>& unpack_block_kernel() {
+    static const chunk_backend::Kernel<UnpackFn<U>> kernel = []() {
+        chunk_backend::Kernel<UnpackFn<U>> k("compression.bitunpack");
+        k.add(chunk_backend::Backend::Scalar, &unpack_block_scalar<U>);
+#if CHUNK_HAS_X86_DISPATCH
+        if constexpr (std::is_same<U, uint32_t>::value) {
+            k.add(chunk_backend::Backend::SSE2, &unpack_block_sse2);
+        }
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+/// Longest LEB128 encoding of a value with the given number of bits
+constexpr size_t varint_max_bytes(size_t bits) {
+    return (bits + 6) / 7;
+}
+
+/**
+ * @brief Append value as LEB128 (7 bits per byte, high bit = continuation)
+ * @return Number of bytes written
+ */
+inline size_t varint_put(uint64_t value, uint8_t* out) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+/**
+ * @brief Read one LEB128 value
+ * @return Pointer past the value
+ * @throws chunk_processing::SerializationError on truncated or overlong input
+ */
+inline const uint8_t* varint_get(const uint8_t* p, const uint8_t* end, uint64_t& value) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (p == end) {
+            throw chunk_processing::SerializationError("Truncated varint");
+        }
+        uint8_t byte = *p++;
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            value = result;
+            return p;
+        }
+    }
+    throw chunk_processing::SerializationError("Varint longer than 64 bits");
+}
+
+/// Bytes used by a value in group-varint coding (1..4)
+inline unsigned group_varint_length(uint32_t value) {
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+/**
+ * @brief Write four values behind one control byte holding their 2-bit lengths
+ * @return Number of bytes written (5..17)
+ */
+inline size_t group_varint_put4(const uint32_t* values, uint8_t* out) {
+    uint8_t control = 0;
+    size_t pos = 1;
+    for (unsigned i = 0; i < 4; ++i) {
+        unsigned len = group_varint_length(values[i]);
+        control |= static_cast<uint8_t>((len - 1) << (2 * i));
+        uint32_t v = values[i];
+        for (unsigned b = 0; b < len; ++b) {
+            out[pos++] = static_cast<uint8_t>(v >> (8 * b));
+        }
+    }
+    out[0] = control;
+    return pos;
+}
+
+/**
+ * @brief Read four group-varint values
+ * @return Pointer past the group
+ * @throws chunk_processing::SerializationError on truncated input
+ */
+inline const uint8_t* group_varint_get4(const uint8_t* p, const uint8_t* end, uint32_t* values) {
+    if (p == end) {
+        throw chunk_processing::SerializationError("Truncated group varint");
+    }
+    const uint8_t control = *p++;
+    if (end - p >= 16) {
+        // Fast path: unaligned 4-byte loads, masked to each value's length
+        for (unsigned i = 0; i < 4; ++i) {
+            unsigned len = ((control >> (2 * i)) & 3) + 1;
+            values[i] = load_u32(p) & (0xFFFFFFFFu >> (32 - 8 * len));
+            p += len;
+        }
+        return p;
+    }
+    for (unsigned i = 0; i < 4; ++i) {
+        unsigned len = ((control >> (2 * i)) & 3) + 1;
+        if (static_cast<size_t>(end - p) < len) {
+            throw chunk_processing::SerializationError("Truncated group varint");
+        }
+        uint32_t v = 0;
+        for (unsigned b = 0; b < len; ++b) {
+            v |= static_cast<uint32_t>(p[b]) << (8 * b);
+        }
+        values[i] = v;
+        p += len;
+    }
+    return p;
+}
+
+} // namespace detail
+} // namespace chunk_compression
@@ -0,0 +1,365 @@
+/**
+ * @file chunk_bitstream.hpp
+ * @brief MSB-first bit streams and the Gorilla XOR / delta-of-delta bit codecs
+ *
+ * The XOR codec follows the Gorilla time-series format: each value is
+ * XORed with its predecessor, and the meaningful bits of the result are
+ * written either inside the previous leading/trailing-zero window or with
+ * a new window. Slowly changing floating-point series then cost a few bits
+ * per value. Regularly spaced timestamps are delta-of-delta coded, so a
+ * fixed sampling interval costs one bit per value.
+ */
+
+#pragma once
+
+#include "chunk_errors.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace chunk_compression {
+
+/// Magic bytes at the start of an XOR-compressed stream
+constexpr char XOR_MAGIC[4] = {'C', 'X', 'O', 'R'};
+
+/// Current XOR stream version
+constexpr uint8_t XOR_VERSION = 1;
+
+/// Stream flag: a delta-of-delta timestamp section precedes the values
+constexpr uint8_t XOR_FLAG_TIMESTAMPS = 0x01;
+
+/**
+ * @brief Header of an XOR-compressed stream
+ *
+ * Followed by timestamp_bytes of delta-of-delta coded timestamps (when
+ * flagged) and then the XOR-coded values, each section byte aligned.
+ */
+struct XorHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t value_size; ///< 4 for float, 8 for double
+    uint8_t flags;
+    uint8_t reserved;
+    uint64_t value_count;
+    uint64_t timestamp_bytes;
+};
+
+static_assert(sizeof(XorHeader) == 24, "XorHeader layout must stay fixed");
+
+/**
+ * @brief Appends bit fields, most significant bit first, to a byte vector
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    /**
+     * @brief Write the low bits of value
+     * @param value Field value; bits above the field width are ignored
+     * @param bits Field width, 0..64
+     */
+    void write(uint64_t value, unsigned bits) {
+        if (bits > 32) {
+            write(value >> 32, bits - 32);
+            bits = 32;
+        }
+        acc_ = (acc_ << bits) | (value & low_mask(bits));
+        pending_ += bits;
+        if (pending_ >= 32) {
+            pending_ -= 32;
+            append(static_cast<uint32_t>(acc_ >> pending_), 4);
+        }
+    }
+
+    void write_bit(bool bit) {
+        write(bit ? 1 : 0, 1);
+    }
+
+    /**
+     * @brief Pad the last partial byte with zeros
+     */
+    void flush() {
+        if (pending_ > 0) {
+            const unsigned bytes = (pending_ + 7) / 8;
+            append(static_cast<uint32_t>(acc_ << (32 - pending_)), bytes);
+            pending_ = 0;
+        }
+    }
+
+    static uint64_t low_mask(unsigned bits) {
+        return bits == 0 ? 0 : ~uint64_t{0} >> (64 - bits);
+    }
+
+private:
+    // Append the leading bytes of a 32-bit word, most significant first
+    void append(uint32_t word, unsigned bytes) {
+        const size_t size = out_.size();
+        out_.resize(size + bytes);
+        for (unsigned i = 0; i < bytes; ++i) {
+            out_[size + i] = static_cast<uint8_t>(word >> (24 - 8 * i));
+        }
+    }
+
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    unsigned pending_ = 0;
+};
+
+/**
+ * @brief Reads bit fields written by BitWriter
+ */
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    /**
+     * @brief Read a field of up to 64 bits
+     * @throws chunk_processing::SerializationError past the end of the stream
+     */
+    uint64_t read(unsigned bits) {
+        if (bits > 32) {
+            uint64_t high = read(bits - 32);
+            return (high << 32) | read(32);
+        }
+        if (available_ < bits) {
+            refill(bits);
+        }
+        available_ -= bits;
+        return (acc_ >> available_) & BitWriter::low_mask(bits);
+    }
+
+    bool read_bit() {
+        return read(1) != 0;
+    }
+
+private:
+    void refill(unsigned bits) {
+        if (size_ - pos_ >= 4) {
+            uint32_t word;
+            std::memcpy(&word, data_ + pos_, sizeof(word));
+            acc_ = (acc_ << 32) | __builtin_bswap32(word);
+            available_ += 32;
+            pos_ += 4;
+            return;
+        }
+        while (available_ < bits) {
+            if (pos_ == size_) {
+                throw chunk_processing::SerializationError("Unexpected end of bit stream");
+            }
+            acc_ = (acc_ << 8) | data_[pos_++];
+            available_ += 8;
+        }
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint64_t acc_ = 0;
+    unsigned available_ = 0;
+};
+
+namespace detail {
+
+template <typename U>
+unsigned leading_zeros(U x) {
+    constexpr unsigned width = std::numeric_limits<U>::digits;
+    return x == 0 ? width : static_cast<unsigned>(__builtin_clzll(x)) - (64 - width);
+}
+
+template <typename U>
+unsigned trailing_zeros(U x) {
+    return x == 0 ? std::numeric_limits<U>::digits : static_cast<unsigned>(__builtin_ctzll(x));
+}
+
+/**
+ * @brief Gorilla XOR encoder for the bit patterns of float (U = uint32_t) or double
+ */
+template <typename U>
+class XorEncoder {
+public:
+    static constexpr unsigned width = std::numeric_limits<U>::digits;
+    static constexpr unsigned length_bits = width == 64 ? 6 : 5;
+
+    explicit XorEncoder(BitWriter& writer) : writer_(writer) {}
+
+    void put(U value) {
+        if (first_) {
+            writer_.write(value, width);
+            first_ = false;
+        } else {
+            const U x = static_cast<U>(value ^ previous_);
+            if (x == 0) {
+                writer_.write_bit(false);
+            } else {
+                // Leading zeros are capped to fit the 5-bit field
+                const unsigned lead = std::min(leading_zeros(x), 31u);
+                const unsigned trail = trailing_zeros(x);
+                writer_.write_bit(true);
+                if (window_ && lead >= lead_ && trail >= trail_) {
+                    writer_.write_bit(false);
+                    writer_.write(x >> trail_, width - lead_ - trail_);
+                } else {
+                    const unsigned length = width - lead - trail;
+                    writer_.write_bit(true);
+                    writer_.write(lead, 5);
+                    writer_.write(length == width ? 0 : length, length_bits);
+                    writer_.write(x >> trail, length);
+                    lead_ = lead;
+                    trail_ = trail;
+                    window_ = true;
+                }
+            }
+        }
+        previous_ = value;
+    }
+
+private:
+    BitWriter& writer_;
+    U previous_ = 0;
+    unsigned lead_ = 0;
+    unsigned trail_ = 0;
+    bool first_ = true;
+    bool window_ = false;
+};
+
+/**
+ * @brief Decoder matching XorEncoder
+ */
+template <typename U>
+class XorDecoder {
+public:
+    static constexpr unsigned width = XorEncoder<U>::width;
+    static constexpr unsigned length_bits = XorEncoder<U>::length_bits;
+
+    explicit XorDecoder(BitReader& reader) : reader_(reader) {}
+
+    U get() {
+        if (first_) {
+            previous_ = static_cast<U>(reader_.read(width));
+            first_ = false;
+        } else if (reader_.read_bit()) {
+            if (reader_.read_bit()) {
+                lead_ = static_cast<unsigned>(reader_.read(5));
+                unsigned length = static_cast<unsigned>(reader_.read(length_bits));
+                if (length == 0) {
+                    length = width;
+                }
+                if (lead_ + length > width) {
+                    throw chunk_processing::SerializationError("Invalid XOR window");
+                }
+                trail_ = width - lead_ - length;
+                window_ = true;
+            } else if (!window_) {
+                throw chunk_processing::SerializationError("XOR window used before being set");
+            }
+            const U x = static_cast<U>(reader_.read(width - lead_ - trail_) << trail_);
+            previous_ = static_cast<U>(previous_ ^ x);
+        }
+        return previous_;
+    }
+
+private:
+    BitReader& reader_;
+    U previous_ = 0;
+    unsigned lead_ = 0;
+    unsigned trail_ = 0;
+    bool first_ = true;
+    bool window_ = false;
+};
+
+/**
+ * @brief Delta-of-delta encoder for integer timestamps or counters
+ *
+ * Differences between consecutive deltas fall in one of four prefix-coded
+ * ranges ('0', '10' + 7 bits, '110' + 9 bits, '1110' + 12 bits); anything
+ * larger is written in full after '1111'. Arithmetic wraps in U.
+ */
+template <typename U>
+class DeltaOfDeltaEncoder {
+public:
+    static_assert(std::is_unsigned<U>::value, "DeltaOfDeltaEncoder expects an unsigned type");
+
+    explicit DeltaOfDeltaEncoder(BitWriter& writer) : writer_(writer) {}
+
+    void put(U value) {
+        if (first_) {
+            writer_.write(value, std::numeric_limits<U>::digits);
+            first_ = false;
+        } else {
+            const U delta = static_cast<U>(value - previous_);
+            put_dod(static_cast<U>(delta - delta_));
+            delta_ = delta;
+        }
+        previous_ = value;
+    }
+
+private:
+    void put_dod(U dod) {
+        // Offsetting by the lower bound maps each signed range onto [0, 2^bits)
+        if (dod == 0) {
+            writer_.write_bit(false);
+        } else if (static_cast<U>(dod + 63) < 128) {
+            writer_.write(0b10, 2);
+            writer_.write(static_cast<U>(dod + 63), 7);
+        } else if (static_cast<U>(dod + 255) < 512) {
+            writer_.write(0b110, 3);
+            writer_.write(static_cast<U>(dod + 255), 9);
+        } else if (static_cast<U>(dod + 2047) < 4096) {
+            writer_.write(0b1110, 4);
+            writer_.write(static_cast<U>(dod + 2047), 12);
+        } else {
+            writer_.write(0b1111, 4);
+            writer_.write(dod, std::numeric_limits<U>::digits);
+        }
+    }
+
+    BitWriter& writer_;
+    U previous_ = 0;
+    U delta_ = 0;
+    bool first_ = true;
+};
+
+/**
+ * @brief Decoder matching DeltaOfDeltaEncoder
+ */
+template <typename U>
+class DeltaOfDeltaDecoder {
+public:
+    explicit DeltaOfDeltaDecoder(BitReader& reader) : reader_(reader) {}
+
+    U get() {
+        if (first_) {
+            previous_ = static_cast<U>(reader_.read(std::numeric_limits<U>::digits));
+            first_ = false;
+            return previous_;
+        }
+        U dod;
+        if (!reader_.read_bit()) {
+            dod = 0;
+        } else if (!reader_.read_bit()) {
+            dod = static_cast<U>(reader_.read(7) - 63);
+        } else if (!reader_.read_bit()) {
+            dod = static_cast<U>(reader_.read(9) - 255);
+        } else if (!reader_.read_bit()) {
+            dod = static_cast<U>(reader_.read(12) - 2047);
+        } else {
+            dod = static_cast<U>(reader_.read(std::numeric_limits<U>::digits));
+        }
+        delta_ = static_cast<U>(delta_ + dod);
+        previous_ = static_cast<U>(previous_ + delta_);
+        return previous_;
+    }
+
+private:
+    BitReader& reader_;
+    U previous_ = 0;
+    U delta_ = 0;
+    bool first_ = true;
+};
+
+} // namespace detail
+} // namespace chunk_compression
@@ -0,0 +1,687 @@
+/**
+ * @file chunk_compressed_ops.hpp
+ * @brief Aggregates and filters evaluated directly on compressed chunks
+ *
+ * The views answer sum, min, max, equality and range queries over
+ * ChunkCompressor output without materializing the decoded chunk.
+ * Run-length queries cost one step per run. Delta streams are prefix-summed a
+ * block at a time into a stack buffer. Bit-packed blocks are first classified
+ * from their frame-of-reference bounds, so blocks that cannot match, or that
+ * match entirely, are never unpacked.
+ */
+
+#pragma once
+
+#include "chunk_compression.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chunk_compression {
+
+/// Half-open [first, second) range of positions in the decoded chunk
+using PositionRange = std::pair<size_t, size_t>;
+
+/**
+ * @brief Accumulator type of compressed-domain sums
+ *
+ * Floating-point values sum in double; integers sum modulo 2^64 in the
+ * 64-bit integer of matching signedness.
+ */
+template <typename T>
+using aggregate_sum_t =
+    typename std::conditional<std::is_floating_point<T>::value, double,
+                              typename std::conditional<std::is_signed<T>::value, int64_t,
+                                                        uint64_t>::type>::type;
+
+namespace detail {
+
+template <typename T>
+struct SumAccumulator {
+    using Sum = aggregate_sum_t<T>;
+    using Word = typename std::conditional<std::is_floating_point<T>::value, double,
+                                           uint64_t>::type;
+    Word acc = 0;
+
+    void add(T value, size_t count = 1) {
+        if constexpr (std::is_floating_point<T>::value) {
+            acc += static_cast<double>(value) * static_cast<double>(count);
+        } else {
+            acc += static_cast<uint64_t>(static_cast<Sum>(value)) * count;
+        }
+    }
+
+    void add(const T* values, size_t n) {
+        Word local = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if constexpr (std::is_floating_point<T>::value) {
+                local += static_cast<double>(values[i]);
+            } else {
+                local += static_cast<uint64_t>(static_cast<Sum>(values[i]));
+            }
+        }
+        acc += local;
+    }
+
+    Sum result() const {
+        return static_cast<Sum>(acc);
+    }
+};
+
+template <typename T>
+size_t count_in_range(const T* values, size_t n, T lo, T hi) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += static_cast<size_t>((values[i] >= lo) & (values[i] <= hi));
+    }
+    return count;
+}
+
+// Appends [first, last), merging with the previous range when they touch
+inline void append_range(std::vector<PositionRange>& out, size_t first, size_t last) {
+    if (first == last) {
+        return;
+    }
+    if (!out.empty() && out.back().second == first) {
+        out.back().second = last;
+    } else {
+        out.emplace_back(first, last);
+    }
+}
+
+template <typename T>
+void filter_in_range(const T* values, size_t n, T lo, T hi, size_t position,
+                     std::vector<PositionRange>& out) {
+    size_t i = 0;
+    while (i < n) {
+        while (i < n && !(values[i] >= lo && values[i] <= hi)) {
+            ++i;
+        }
+        const size_t first = i;
+        while (i < n && values[i] >= lo && values[i] <= hi) {
+            ++i;
+        }
+        append_range(out, position + first, position + i);
+    }
+}
+
+template <typename T>
+void update_min_max(const T* values, size_t n, T& lo, T& hi) {
+    for (size_t i = 0; i < n; ++i) {
+        lo = values[i] < lo ? values[i] : lo;
+        hi = values[i] > hi ? values[i] : hi;
+    }
+}
+
+inline void require_non_empty(size_t n) {
+    if (n == 0) {
+        throw std::invalid_argument("Cannot compute min/max of an empty chunk");
+    }
+}
+
+/// r = a + b; false if the sum overflows int64_t
+inline bool checked_add(int64_t a, int64_t b, int64_t& r) {
+    if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+        (b < 0 && a < std::numeric_limits<int64_t>::min() - b)) {
+        return false;
+    }
+    r = a + b;
+    return true;
+}
+
+/// r = a * b for a >= 0; false if the product overflows int64_t
+inline bool checked_mul(int64_t a, int64_t b, int64_t& r) {
+    if (a != 0 && (b > std::numeric_limits<int64_t>::max() / a ||
+                   b < std::numeric_limits<int64_t>::min() / a)) {
+        return false;
+    }
+    r = a * b;
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * @brief Queries over run-length pairs from ChunkCompressor::run_length_encode
+ *
+ * The view does not own the runs; they must outlive it.
+ * @tparam T Arithmetic value type
+ */
+template <typename T>
+class RunLengthView {
+public:
+    using sum_type = aggregate_sum_t<T>;
+
+    RunLengthView(const std::pair<T, size_t>* runs, size_t run_count)
+        : runs_(runs), run_count_(run_count) {
+        for (size_t r = 0; r < run_count_; ++r) {
+            size_ += runs_[r].second;
+        }
+    }
+
+    explicit RunLengthView(const std::vector<std::pair<T, size_t>>& runs)
+        : RunLengthView(runs.data(), runs.size()) {}
+
+    /// Views must not outlive their runs
+    explicit RunLengthView(std::vector<std::pair<T, size_t>>&&) = delete;
+
+    /// Number of values in the decoded chunk
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    size_t run_count() const {
+        return run_count_;
+    }
+
+    sum_type sum() const {
+        detail::SumAccumulator<T> acc;
+        for (size_t r = 0; r < run_count_; ++r) {
+            acc.add(runs_[r].first, runs_[r].second);
+        }
+        return acc.result();
+    }
+
+    /**
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    T min() const {
+        detail::require_non_empty(run_count_);
+        T lo = runs_[0].first;
+        for (size_t r = 1; r < run_count_; ++r) {
+            lo = runs_[r].first < lo ? runs_[r].first : lo;
+        }
+        return lo;
+    }
+
+    /**
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    T max() const {
+        detail::require_non_empty(run_count_);
+        T hi = runs_[0].first;
+        for (size_t r = 1; r < run_count_; ++r) {
+            hi = runs_[r].first > hi ? runs_[r].first : hi;
+        }
+        return hi;
+    }
+
+    size_t count_equal(T value) const {
+        return count_in_range(value, value);
+    }
+
+    /**
+     * @brief Number of values v with lo <= v <= hi
+     */
+    size_t count_in_range(T lo, T hi) const {
+        size_t count = 0;
+        for (size_t r = 0; r < run_count_; ++r) {
+            if (runs_[r].first >= lo && runs_[r].first <= hi) {
+                count += runs_[r].second;
+            }
+        }
+        return count;
+    }
+
+    std::vector<PositionRange> filter_equal(T value) const {
+        return filter_range(value, value);
+    }
+
+    /**
+     * @brief Positions of values v with lo <= v <= hi, as merged ranges
+     */
+    std::vector<PositionRange> filter_range(T lo, T hi) const {
+        std::vector<PositionRange> out;
+        size_t position = 0;
+        for (size_t r = 0; r < run_count_; ++r) {
+            const size_t next = position + runs_[r].second;
+            if (runs_[r].first >= lo && runs_[r].first <= hi) {
+                detail::append_range(out, position, next);
+            }
+            position = next;
+        }
+        return out;
+    }
+
+private:
+    const std::pair<T, size_t>* runs_;
+    size_t run_count_;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Queries over a stream from ChunkCompressor::delta_encode
+ *
+ * Deltas are prefix-summed with the SIMD decode kernels a block at a time,
+ * so no buffer proportional to the chunk is allocated. The view does not own
+ * the deltas; they must outlive it.
+ * @tparam T Arithmetic value type
+ */
+template <typename T>
+class DeltaView {
+public:
+    using sum_type = aggregate_sum_t<T>;
+
+    /// Values decoded per step
+    static constexpr size_t BLOCK_SIZE = 1024;
+
+    DeltaView(const T* deltas, size_t n) : deltas_(deltas), size_(n) {}
+
+    explicit DeltaView(const std::vector<T>& deltas) : DeltaView(deltas.data(), deltas.size()) {}
+
+    /// Views must not outlive their deltas
+    explicit DeltaView(std::vector<T>&&) = delete;
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    sum_type sum() const {
+        detail::SumAccumulator<T> acc;
+        for_each_block([&](const T* values, size_t n, size_t) { acc.add(values, n); });
+        return acc.result();
+    }
+
+    /**
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    T min() const {
+        return min_max().first;
+    }
+
+    /**
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    T max() const {
+        return min_max().second;
+    }
+
+    /**
+     * @brief Smallest and largest value in one pass
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    std::pair<T, T> min_max() const {
+        detail::require_non_empty(size_);
+        T lo = deltas_[0];
+        T hi = deltas_[0];
+        for_each_block([&](const T* values, size_t n, size_t) {
+            detail::update_min_max(values, n, lo, hi);
+        });
+        return {lo, hi};
+    }
+
+    size_t count_equal(T value) const {
+        return count_in_range(value, value);
+    }
+
+    /**
+     * @brief Number of values v with lo <= v <= hi
+     */
+    size_t count_in_range(T lo, T hi) const {
+        size_t count = 0;
+        for_each_block([&](const T* values, size_t n, size_t) {
+            count += detail::count_in_range(values, n, lo, hi);
+        });
+        return count;
+    }
+
+    std::vector<PositionRange> filter_equal(T value) const {
+        return filter_range(value, value);
+    }
+
+    /**
+     * @brief Positions of values v with lo <= v <= hi, as merged ranges
+     */
+    std::vector<PositionRange> filter_range(T lo, T hi) const {
+        std::vector<PositionRange> out;
+        for_each_block([&](const T* values, size_t n, size_t position) {
+            detail::filter_in_range(values, n, lo, hi, position, out);
+        });
+        return out;
+    }
+
+private:
+    using Word = typename std::conditional<std::is_integral<T>::value,
+                                           typename ChunkCompressor<T>::zigzag_type, T>::type;
+
+    // Calls body(values, n, position) for consecutive decoded blocks
+    template <typename Body>
+    void for_each_block(Body&& body) const {
+        T values[BLOCK_SIZE];
+        T previous = T(0);
+        for (size_t position = 0; position < size_; position += BLOCK_SIZE) {
+            const size_t n = std::min(BLOCK_SIZE, size_ - position);
+            std::memcpy(values, deltas_ + position, n * sizeof(T));
+            // Same wrap-around addition as the decoder, carried across blocks
+            values[0] =
+                static_cast<T>(static_cast<Word>(previous) + static_cast<Word>(values[0]));
+            ChunkCompressor<T>::delta_decode(values, n, values);
+            body(static_cast<const T*>(values), n, position);
+            previous = values[n - 1];
+        }
+    }
+
+    const T* deltas_;
+    size_t size_;
+};
+
+/**
+ * @brief Queries over a stream from ChunkCompressor::bitpack_encode
+ *
+ * Each block carries a reference and bit width that bound its values
+ * (for delta blocks, the base and the delta bounds do). Range queries skip
+ * blocks whose bounds miss the range, count blocks that fall inside it
+ * without unpacking, and unpack only the blocks that straddle a bound. Min
+ * reads block references alone; max unpacks blocks in order of their upper
+ * bound until no remaining block can exceed the best value seen.
+ * The view does not own the stream; it must outlive it.
+ * @tparam T Integral value type
+ */
+template <typename T>
+class BitPackView {
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                  "BitPackView requires an integral value type");
+
+public:
+    using sum_type = aggregate_sum_t<T>;
+    using Compressor = ChunkCompressor<T>;
+
+    /**
+     * @throws chunk_processing::SerializationError if the stream is malformed
+     */
+    BitPackView(const uint8_t* data, size_t size) : data_(data), size_(size) {
+        const size_t blocks = Compressor::bitpack_block_count(data, size);
+        size_t position = 0;
+        bounds_.reserve(blocks);
+        for (size_t b = 0; b < blocks; ++b) {
+            bounds_.push_back(block_bounds(b, position));
+            position += bounds_.back().count;
+        }
+        value_count_ = position;
+    }
+
+    explicit BitPackView(const std::vector<uint8_t>& encoded)
+        : BitPackView(encoded.data(), encoded.size()) {}
+
+    /// Views must not outlive their stream
+    explicit BitPackView(std::vector<uint8_t>&&) = delete;
+
+    size_t size() const {
+        return value_count_;
+    }
+
+    bool empty() const {
+        return value_count_ == 0;
+    }
+
+    size_t block_count() const {
+        return bounds_.size();
+    }
+
+    /**
+     * @brief Number of blocks a range query for [lo, hi] has to unpack
+     */
+    size_t blocks_to_unpack(T lo, T hi) const {
+        size_t count = 0;
+        for (const auto& block : bounds_) {
+            count += classify(block, lo, hi) == Overlap::Partial;
+        }
+        return count;
+    }
+
+    sum_type sum() const {
+        detail::SumAccumulator<T> acc;
+        T values[BITPACK_BLOCK_SIZE];
+        for (size_t b = 0; b < bounds_.size(); ++b) {
+            const BlockBounds& block = bounds_[b];
+            if (block.exact) {
+                acc.add(block.lo, block.count);
+            } else {
+                acc.add(values, decode(b, values));
+            }
+        }
+        return acc.result();
+    }
+
+    /**
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    T min() const {
+        detail::require_non_empty(value_count_);
+        T lo = std::numeric_limits<T>::max();
+        T values[BITPACK_BLOCK_SIZE];
+        for (size_t b = 0; b < bounds_.size(); ++b) {
+            const BlockBounds& block = bounds_[b];
+            if (block.tight_lo) {
+                lo = std::min(lo, block.lo);
+            } else if (block.lo < lo) {
+                const size_t n = decode(b, values);
+                lo = std::min(lo, *std::min_element(values, values + n));
+            }
+        }
+        return lo;
+    }
+
+    /**
+     * @throws std::invalid_argument if the chunk is empty
+     */
+    T max() const {
+        detail::require_non_empty(value_count_);
+        std::vector<size_t> order(bounds_.size());
+        for (size_t b = 0; b < order.size(); ++b) {
+            order[b] = b;
+        }
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return bounds_[a].hi > bounds_[b].hi; });
+
+        // Any value known to be present seeds the search
+        T hi = std::numeric_limits<T>::min();
+        for (const auto& block : bounds_) {
+            if (block.tight_lo) {
+                hi = std::max(hi, block.lo);
+            }
+        }
+        T values[BITPACK_BLOCK_SIZE];
+        for (size_t b : order) {
+            if (bounds_[b].hi <= hi) {
+                break;
+            }
+            const size_t n = decode(b, values);
+            hi = std::max(hi, *std::max_element(values, values + n));
+        }
+        return hi;
+    }
+
+    size_t count_equal(T value) const {
+        return count_in_range(value, value);
+    }
+
+    /**
+     * @brief Number of values v with lo <= v <= hi
+     */
+    size_t count_in_range(T lo, T hi) const {
+        size_t count = 0;
+        T values[BITPACK_BLOCK_SIZE];
+        for (size_t b = 0; b < bounds_.size(); ++b) {
+            switch (classify(bounds_[b], lo, hi)) {
+            case Overlap::None:
+                break;
+            case Overlap::Full:
+                count += bounds_[b].count;
+                break;
+            case Overlap::Partial:
+                count += detail::count_in_range(values, decode(b, values), lo, hi);
+                break;
+            }
+        }
+        return count;
+    }
+
+    std::vector<PositionRange> filter_equal(T value) const {
+        return filter_range(value, value);
+    }
+
+    /**
+     * @brief Positions of values v with lo <= v <= hi, as merged ranges
+     */
+    std::vector<PositionRange> filter_range(T lo, T hi) const {
+        std::vector<PositionRange> out;
+        T values[BITPACK_BLOCK_SIZE];
+        for (size_t b = 0; b < bounds_.size(); ++b) {
+            const BlockBounds& block = bounds_[b];
+            switch (classify(block, lo, hi)) {
+            case Overlap::None:
+                break;
+            case Overlap::Full:
+                detail::append_range(out, block.position, block.position + block.count);
+                break;
+            case Overlap::Partial:
+                detail::filter_in_range(values, decode(b, values), lo, hi, block.position, out);
+                break;
+            }
+        }
+        return out;
+    }
+
+private:
+#ifdef __SIZEOF_INT128__
+    using wide = __int128;
+#else
+    using wide = int64_t;
+#endif
+    /// Block bounds are computed exactly only if wide holds T's values plus span products
+    static constexpr bool exact_bounds = sizeof(T) < sizeof(wide);
+
+    // Conservative value bounds of a block; lo is attained when tight_lo is set
+    struct BlockBounds {
+        size_t position;
+        size_t count;
+        T lo;
+        T hi;
+        bool tight_lo;
+        bool exact; ///< every value equals lo
+    };
+
+    enum class Overlap { None, Partial, Full };
+
+    static Overlap classify(const BlockBounds& block, T lo, T hi) {
+        if (lo > hi || block.hi < lo || block.lo > hi) {
+            return Overlap::None;
+        }
+        if (block.lo >= lo && block.hi <= hi) {
+            return Overlap::Full;
+        }
+        return Overlap::Partial;
+    }
+
+    static T clamp(wide v) {
+        const wide lo = std::numeric_limits<T>::min();
+        const wide hi = std::numeric_limits<T>::max();
+        return static_cast<T>(v < lo ? lo : (v > hi ? hi : v));
+    }
+
+    BlockBounds block_bounds(size_t b, size_t position) const {
+        const auto info = Compressor::bitpack_block_info(data_, size_, b);
+        BlockBounds bounds{position, info.count, info.reference, info.reference, true, false};
+        if constexpr (!exact_bounds) {
+            return checked_block_bounds(info, bounds);
+        }
+        const wide span = info.bit_width == 0 ? 0 : (wide(1) << info.bit_width) - 1;
+        if (!info.delta) {
+            bounds.hi = clamp(wide(info.reference) + span);
+            bounds.exact = info.bit_width == 0;
+            return bounds;
+        }
+
+        // Value k of the block is base plus k deltas, each in [dlo, dlo + span]
+        using S = typename std::make_signed<T>::type;
+        const wide dlo = static_cast<S>(info.reference);
+        const wide steps = static_cast<wide>(info.count) - 1;
+        const wide lo = wide(info.base) + std::min<wide>(0, steps * dlo);
+        const wide hi = wide(info.base) + std::max<wide>(0, steps * (dlo + span));
+        bounds.lo = clamp(lo);
+        bounds.hi = clamp(hi);
+        // Bounds past the range of T mean the decoder wraps, so they prove nothing
+        if (bounds.lo != lo || bounds.hi != hi) {
+            bounds.lo = std::numeric_limits<T>::min();
+            bounds.hi = std::numeric_limits<T>::max();
+        }
+        bounds.exact = dlo == 0 && span == 0;
+        bounds.tight_lo = bounds.exact;
+        return bounds;
+    }
+
+    /**
+     * @brief block_bounds for 64-bit T without a 128-bit type
+     *
+     * The same bounds, computed in int64_t with overflow checks; a delta block
+     * whose bounds do not fit gets the full range of T, which is still safe.
+     */
+    template <typename Info>
+    static BlockBounds checked_block_bounds(const Info& info, BlockBounds bounds) {
+        using U = typename std::make_unsigned<T>::type;
+        using S = typename std::make_signed<T>::type;
+        const U span = info.bit_width == 0
+                           ? U(0)
+                           : static_cast<U>(~U(0) >> (std::numeric_limits<U>::digits -
+                                                      static_cast<int>(info.bit_width)));
+        if (!info.delta) {
+            const U room = static_cast<U>(std::numeric_limits<T>::max()) -
+                           static_cast<U>(info.reference);
+            bounds.hi = span <= room ? static_cast<T>(static_cast<U>(info.reference) + span)
+                                     : std::numeric_limits<T>::max();
+            bounds.exact = info.bit_width == 0;
+            return bounds;
+        }
+
+        bounds.lo = std::numeric_limits<T>::min();
+        bounds.hi = std::numeric_limits<T>::max();
+        bounds.tight_lo = false;
+        const int64_t dlo = static_cast<S>(info.reference);
+        const int64_t steps = static_cast<int64_t>(info.count) - 1;
+        if (span > static_cast<U>(std::numeric_limits<int64_t>::max()) ||
+            (std::is_unsigned<T>::value &&
+             static_cast<U>(info.base) > static_cast<U>(std::numeric_limits<int64_t>::max()))) {
+            return bounds;
+        }
+        const int64_t base = static_cast<int64_t>(info.base);
+        int64_t dhi, lo_step, hi_step, lo, hi;
+        if (!detail::checked_add(dlo, static_cast<int64_t>(span), dhi) ||
+            !detail::checked_mul(steps, dlo, lo_step) ||
+            !detail::checked_mul(steps, dhi, hi_step) ||
+            !detail::checked_add(base, std::min<int64_t>(0, lo_step), lo) ||
+            !detail::checked_add(base, std::max<int64_t>(0, hi_step), hi) ||
+            (std::is_unsigned<T>::value && lo < 0)) {
+            return bounds;
+        }
+        bounds.lo = static_cast<T>(lo);
+        bounds.hi = static_cast<T>(hi);
+        bounds.exact = dlo == 0 && span == 0;
+        bounds.tight_lo = bounds.exact;
+        return bounds;
+    }
+
+    size_t decode(size_t b, T* out) const {
+        return Compressor::bitpack_decode_block(data_, size_, b, out);
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t value_count_ = 0;
+    std::vector<BlockBounds> bounds_;
+};
+
+} // namespace chunk_compression
@@ -1,7 +1,17 @@
 #pragma once
 
+#include "chunk_bitpacking.hpp"
+#include "chunk_bitstream.hpp"
+#include "chunk_compression_kernels.hpp"
+#include "chunk_dictionary.hpp"
+#include "chunk_entropy.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 namespace chunk_compression {
@@ -39,45 +49,1075 @@ public:
         return result;
     }
 
+    /// Unsigned type holding zigzag codes for T
+    using zigzag_type = typename detail::zigzag_word<T>::type;
+
     /**
      * @brief Delta encode a chunk
      * @param chunk Input chunk
      * @return Delta-encoded chunk
      */
     static std::vector<T> delta_encode(const std::vector<T>& chunk) {
-        if (chunk.empty())
-            return {};
+        std::vector<T> result(chunk.size());
+        delta_encode(chunk.data(), chunk.size(), result.data());
+        return result;
+    }
 
-        std::vector<T> result;
-        result.reserve(chunk.size());
-        result.push_back(chunk[0]);
+    /**
+     * @brief Delta decode a chunk
+     * @param chunk Delta-encoded chunk
+     * @return Decoded chunk
+     */
+    static std::vector<T> delta_decode(const std::vector<T>& chunk) {
+        std::vector<T> result(chunk.size());
+        delta_decode(chunk.data(), chunk.size(), result.data());
+        return result;
+    }
 
-        for (size_t i = 1; i < chunk.size(); ++i) {
-            result.push_back(chunk[i] - chunk[i - 1]);
+    /**
+     * @brief Delta encode into a caller-provided buffer
+     *
+     * 32- and 64-bit integers use the SIMD kernels, with wrap-around
+     * arithmetic; other types fall back to a scalar loop.
+     * @param in Input values
+     * @param n Number of values
+     * @param out Output buffer of at least n values; may be the same as in
+     * @param backend Kernel variant to use for integer types
+     */
+    static void delta_encode(const T* in, size_t n, T* out,
+                             chunk_backend::Backend backend = chunk_backend::Backend::Auto) {
+        using U = typename detail::simd_word<T>::type;
+        if constexpr (!std::is_void<U>::value) {
+            detail::delta_encode_kernel<U>().resolve(backend)(reinterpret_cast<const U*>(in), n,
+                                                              reinterpret_cast<U*>(out));
+        } else {
+            for (size_t i = n; i-- > 1;) {
+                out[i] = static_cast<T>(in[i] - in[i - 1]);
+            }
+            if (n > 0) {
+                out[0] = in[0];
+            }
+        }
+    }
+
+    /**
+     * @brief Delta decode (prefix sum) into a caller-provided buffer
+     *
+     * Floating-point input is summed sequentially so results match the
+     * vector overload bit for bit.
+     * @param in Delta-encoded values
+     * @param n Number of values
+     * @param out Output buffer of at least n values; may be the same as in
+     * @param backend Kernel variant to use for integer types
+     */
+    static void delta_decode(const T* in, size_t n, T* out,
+                             chunk_backend::Backend backend = chunk_backend::Backend::Auto) {
+        using U = typename detail::simd_word<T>::type;
+        if constexpr (!std::is_void<U>::value) {
+            detail::delta_decode_kernel<U>().resolve(backend)(reinterpret_cast<const U*>(in), n,
+                                                              reinterpret_cast<U*>(out));
+        } else {
+            if (n > 0) {
+                out[0] = in[0];
+            }
+            for (size_t i = 1; i < n; ++i) {
+                out[i] = static_cast<T>(out[i - 1] + in[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Delta encode a chunk in place
+     * @param chunk Chunk to overwrite with its deltas
+     */
+    static void delta_encode_inplace(std::vector<T>& chunk) {
+        delta_encode(chunk.data(), chunk.size(), chunk.data());
+    }
+
+    /**
+     * @brief Delta decode a chunk in place
+     * @param chunk Delta-encoded chunk to overwrite with the original values
+     */
+    static void delta_decode_inplace(std::vector<T>& chunk) {
+        delta_decode(chunk.data(), chunk.size(), chunk.data());
+    }
+
+    /**
+     * @brief Map a signed value to an unsigned code with small magnitudes first
+     *
+     * 0, -1, 1, -2, ... become 0, 1, 2, 3, ..., so small deltas of either
+     * sign compress well with bit-packing and varints.
+     */
+    static zigzag_type zigzag_encode(T value) {
+        static_assert(std::is_integral<T>::value, "zigzag encoding requires an integral type");
+        return zigzag_word(static_cast<zigzag_type>(value));
+    }
+
+    /**
+     * @brief Inverse of zigzag_encode
+     */
+    static T zigzag_decode(zigzag_type code) {
+        static_assert(std::is_integral<T>::value, "zigzag encoding requires an integral type");
+        return static_cast<T>(unzigzag_word(code));
+    }
+
+    /**
+     * @brief Delta encode then zigzag the deltas into a caller-provided buffer
+     * @param in Input values
+     * @param n Number of values
+     * @param out Output buffer of at least n codes; may overlay in
+     */
+    static void zigzag_delta_encode(const T* in, size_t n, zigzag_type* out) {
+        static_assert(std::is_integral<T>::value, "zigzag encoding requires an integral type");
+        // Deltas are computed in the unsigned domain, so T and zigzag_type share the kernels
+        ChunkCompressor<zigzag_type>::delta_encode(reinterpret_cast<const zigzag_type*>(in), n,
+                                                   out);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = zigzag_word(out[i]);
         }
+    }
 
+    /**
+     * @brief Inverse of zigzag_delta_encode
+     * @param in Zigzag-coded deltas
+     * @param n Number of values
+     * @param out Output buffer of at least n values; may overlay in
+     */
+    static void zigzag_delta_decode(const zigzag_type* in, size_t n, T* out) {
+        static_assert(std::is_integral<T>::value, "zigzag encoding requires an integral type");
+        auto* words = reinterpret_cast<zigzag_type*>(out);
+        for (size_t i = 0; i < n; ++i) {
+            words[i] = unzigzag_word(in[i]);
+        }
+        ChunkCompressor<zigzag_type>::delta_decode(words, n, words);
+    }
+
+    /**
+     * @brief Zigzag delta encode a chunk
+     * @param chunk Input chunk
+     * @return Zigzag-coded deltas, small for slowly varying data
+     */
+    static std::vector<zigzag_type> zigzag_delta_encode(const std::vector<T>& chunk) {
+        std::vector<zigzag_type> result(chunk.size());
+        zigzag_delta_encode(chunk.data(), chunk.size(), result.data());
         return result;
     }
 
     /**
-     * @brief Delta decode a chunk
-     * @param chunk Delta-encoded chunk
+     * @brief Zigzag delta decode a chunk
+     * @param codes Output of zigzag_delta_encode
      * @return Decoded chunk
      */
-    static std::vector<T> delta_decode(const std::vector<T>& chunk) {
-        if (chunk.empty())
-            return {};
+    static std::vector<T> zigzag_delta_decode(const std::vector<zigzag_type>& codes) {
+        std::vector<T> result(codes.size());
+        zigzag_delta_decode(codes.data(), codes.size(), result.data());
+        return result;
+    }
 
-        std::vector<T> result;
-        result.reserve(chunk.size());
-        result.push_back(chunk[0]);
+    /**
+     * @brief Upper bound on the size of bitpack_encode output for n values
+     */
+    static size_t bitpack_max_encoded_size(size_t n) {
+        const size_t blocks = (n + BITPACK_BLOCK_SIZE - 1) / BITPACK_BLOCK_SIZE;
+        return sizeof(BitPackHeader) +
+               blocks * (sizeof(uint32_t) + bitpack_block_header_size(true) +
+                         detail::bitpack_payload_size(std::numeric_limits<zigzag_type>::digits));
+    }
 
-        for (size_t i = 1; i < chunk.size(); ++i) {
-            result.push_back(result.back() + chunk[i]);
+    /**
+     * @brief Frame-of-reference bit-pack a chunk into a caller-provided buffer
+     *
+     * Each block of 128 values stores its minimum as reference and packs
+     * value - reference with just enough bits for the block's range. With
+     * delta enabled the block stores its first value and packs the
+     * (frame-of-reference coded) deltas instead, which suits sorted or
+     * slowly varying data; blocks remain independently decodable.
+     * @param in Input values
+     * @param n Number of values
+     * @param out Buffer of at least bitpack_max_encoded_size(n) bytes
+     * @param delta Whether to pack deltas between consecutive values
+     * @return Number of bytes written
+     */
+    static size_t bitpack_encode(const T* in, size_t n, uint8_t* out, bool delta = false) {
+        static_assert(std::is_integral<T>::value, "bit-packing requires an integral type");
+        const size_t blocks = (n + BITPACK_BLOCK_SIZE - 1) / BITPACK_BLOCK_SIZE;
+        if (bitpack_max_encoded_size(n) > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Chunk too large for bit-packing");
+        }
+        const auto pack = detail::pack_block_kernel<zigzag_type>().resolve();
+
+        size_t pos = sizeof(BitPackHeader) + blocks * sizeof(uint32_t);
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t first = b * BITPACK_BLOCK_SIZE;
+            detail::store_u32(out + sizeof(BitPackHeader) + b * sizeof(uint32_t),
+                              static_cast<uint32_t>(pos));
+            pos += bitpack_encode_block(in + first, std::min(BITPACK_BLOCK_SIZE, n - first), delta,
+                                        pack, out + pos);
+        }
+
+        BitPackHeader header{};
+        std::memcpy(header.magic, BITPACK_MAGIC, sizeof(header.magic));
+        header.version = BITPACK_VERSION;
+        header.value_size = sizeof(T);
+        header.flags = delta ? BITPACK_FLAG_DELTA : 0;
+        header.value_count = n;
+        header.block_count = static_cast<uint32_t>(blocks);
+        std::memcpy(out, &header, sizeof(header));
+        return pos;
+    }
+
+    /**
+     * @brief Frame-of-reference bit-pack a chunk
+     * @param chunk Input chunk
+     * @param delta Whether to pack deltas between consecutive values
+     * @return Encoded bytes
+     */
+    static std::vector<uint8_t> bitpack_encode(const std::vector<T>& chunk, bool delta = false) {
+        std::vector<uint8_t> result(bitpack_max_encoded_size(chunk.size()));
+        result.resize(bitpack_encode(chunk.data(), chunk.size(), result.data(), delta));
+        return result;
+    }
+
+    /**
+     * @brief Number of values in a bit-packed stream
+     * @throws chunk_processing::SerializationError if the stream is malformed
+     */
+    static size_t bitpack_value_count(const uint8_t* data, size_t size) {
+        return static_cast<size_t>(bitpack_header(data, size).value_count);
+    }
+
+    /**
+     * @brief Number of independently decodable blocks in a bit-packed stream
+     */
+    static size_t bitpack_block_count(const uint8_t* data, size_t size) {
+        return bitpack_header(data, size).block_count;
+    }
+
+    /**
+     * @brief Decode a single block of a bit-packed stream
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param block Block index, less than bitpack_block_count
+     * @param out Buffer of at least BITPACK_BLOCK_SIZE values
+     * @return Number of values written
+     */
+    static size_t bitpack_decode_block(const uint8_t* data, size_t size, size_t block, T* out) {
+        const BitPackHeader header = bitpack_header(data, size);
+        if (block >= header.block_count) {
+            throw std::out_of_range("Bit-packed block index out of range");
+        }
+        return bitpack_decode_block(data, size, header, block, out,
+                                    detail::unpack_block_kernel<zigzag_type>().resolve());
+    }
+
+    /**
+     * @brief Entropy-code a chunk with interleaved rANS
+     *
+     * Values, or zigzag deltas between them, are split into byte planes and
+     * each plane is coded with its own model, so the constant high bytes of
+     * small deltas cost next to nothing.
+     * @param chunk Input chunk
+     * @param delta Code deltas between consecutive values (integral T only)
+     * @return Encoded bytes
+     * @throws std::invalid_argument if delta is requested for a floating-point T
+     */
+    static std::vector<uint8_t> rans_encode(const std::vector<T>& chunk, bool delta = false) {
+        static_assert(std::is_arithmetic<T>::value, "rANS coding requires arithmetic values");
+        const size_t n = chunk.size();
+        std::vector<zigzag_type> codes(n);
+        if constexpr (std::is_integral<T>::value) {
+            to_codes(chunk.data(), n, codes.data(), delta);
+        } else {
+            if (delta) {
+                throw std::invalid_argument("Delta rANS coding requires integral values");
+            }
+            if (n > 0) {
+                std::memcpy(codes.data(), chunk.data(), n * sizeof(T));
+            }
+        }
+
+        RansChunkHeader header{};
+        std::memcpy(header.magic, RANS_CHUNK_MAGIC, sizeof(header.magic));
+        header.version = RANS_VERSION;
+        header.value_size = sizeof(T);
+        header.flags = delta ? RANS_FLAG_DELTA : 0;
+        header.value_count = n;
+        std::vector<uint8_t> result(sizeof(header));
+        std::memcpy(result.data(), &header, sizeof(header));
+
+        const auto* bytes = reinterpret_cast<const uint8_t*>(codes.data());
+        std::vector<uint8_t> plane(n);
+        for (size_t j = 0; j < sizeof(T); ++j) {
+            bool constant = n > 0;
+            for (size_t i = 0; i < n; ++i) {
+                plane[i] = bytes[i * sizeof(T) + j];
+                constant &= plane[i] == plane[0];
+            }
+            const size_t pos = result.size();
+            if (constant) {
+                result.resize(pos + sizeof(uint32_t) + 1);
+                detail::store_u32(result.data() + pos, 1);
+                result[pos + sizeof(uint32_t)] = plane[0];
+                continue;
+            }
+            const std::vector<uint8_t> coded = RansCoder::encode(plane.data(), n);
+            result.resize(pos + sizeof(uint32_t) + coded.size());
+            detail::store_u32(result.data() + pos, static_cast<uint32_t>(coded.size()));
+            std::memcpy(result.data() + pos + sizeof(uint32_t), coded.data(), coded.size());
+        }
+        return result;
+    }
+
+    /**
+     * @brief Decode a chunk produced by rans_encode
+     * @param data Encoded chunk
+     * @param size Number of bytes
+     * @param max_values Largest chunk to accept; constant planes take five
+     *        bytes whatever the chunk length, so untrusted input needs a bound
+     * @throws chunk_processing::SerializationError if the stream is malformed or
+     *         holds more than max_values values
+     */
+    static std::vector<T> rans_decode(const uint8_t* data, size_t size,
+                                      uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        RansChunkHeader header;
+        if (size < sizeof(header)) {
+            throw chunk_processing::SerializationError("rANS chunk is truncated");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, RANS_CHUNK_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != RANS_VERSION) {
+            throw chunk_processing::SerializationError("Not an rANS chunk");
+        }
+        if (header.value_size != sizeof(T)) {
+            throw chunk_processing::SerializationError("rANS chunk has a different value type");
+        }
+        const bool delta = (header.flags & RANS_FLAG_DELTA) != 0;
+        if (delta && !std::is_integral<T>::value) {
+            throw chunk_processing::SerializationError("Invalid rANS chunk flags");
+        }
+
+        if (header.value_count > max_values) {
+            throw chunk_processing::SerializationError(
+                "rANS chunk exceeds the decoded value limit");
+        }
+
+        const size_t n = static_cast<size_t>(header.value_count);
+        std::vector<uint8_t> plane;
+        std::vector<zigzag_type> codes;
+        auto* bytes = static_cast<uint8_t*>(nullptr);
+        size_t pos = sizeof(header);
+        for (size_t j = 0; j < sizeof(T); ++j) {
+            if (size - pos < sizeof(uint32_t) ||
+                size - pos - sizeof(uint32_t) < detail::load_u32(data + pos)) {
+                throw chunk_processing::SerializationError("rANS chunk is truncated");
+            }
+            const size_t length = detail::load_u32(data + pos);
+            const uint8_t* stream = data + pos + sizeof(uint32_t);
+            if (j == 0) {
+                plane.resize(n);
+                codes.resize(n);
+                bytes = reinterpret_cast<uint8_t*>(codes.data());
+            }
+            if (length == 1) {
+                std::fill(plane.begin(), plane.end(), stream[0]);
+            } else {
+                if (RansCoder::decoded_size(stream, length, max_values) != n) {
+                    throw chunk_processing::SerializationError("rANS plane has the wrong length");
+                }
+                RansCoder::decode(stream, length, plane.data());
+            }
+            for (size_t i = 0; i < n; ++i) {
+                bytes[i * sizeof(T) + j] = plane[i];
+            }
+            pos += sizeof(uint32_t) + length;
+        }
+        if (pos != size) {
+            throw chunk_processing::SerializationError("Trailing bytes after rANS chunk");
+        }
+
+        std::vector<T> result(n);
+        if constexpr (std::is_integral<T>::value) {
+            from_codes(codes.data(), n, result.data(), delta);
+        } else if (n > 0) {
+            std::memcpy(result.data(), codes.data(), n * sizeof(T));
+        }
+        return result;
+    }
+
+    static std::vector<T> rans_decode(const std::vector<uint8_t>& encoded,
+                                      uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        return rans_decode(encoded.data(), encoded.size(), max_values);
+    }
+
+    /**
+     * @brief Frame-of-reference parameters of one bit-packed block
+     *
+     * Without the delta flag, every value v in the block satisfies
+     * reference <= v < reference + 2^bit_width. With it, reference is the
+     * smallest delta and base the first value of the block.
+     */
+    struct BitPackBlockInfo {
+        size_t count;
+        unsigned bit_width;
+        T reference;
+        T base;
+        bool delta;
+    };
+
+    /**
+     * @brief Read a block's parameters without unpacking its payload
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param block Block index, less than bitpack_block_count
+     * @throws chunk_processing::SerializationError if the stream is malformed
+     */
+    static BitPackBlockInfo bitpack_block_info(const uint8_t* data, size_t size, size_t block) {
+        const BitPackHeader header = bitpack_header(data, size);
+        if (block >= header.block_count) {
+            throw std::out_of_range("Bit-packed block index out of range");
+        }
+        const BitPackBlock parsed = bitpack_block(data, size, header, block);
+        return {parsed.count, parsed.bit_width, static_cast<T>(parsed.reference),
+                static_cast<T>(parsed.base), parsed.delta};
+    }
+
+    /**
+     * @brief Decode a bit-packed stream into a caller-provided buffer
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param out Buffer of at least bitpack_value_count values
+     * @return Number of values written
+     * @throws chunk_processing::SerializationError if the stream is malformed
+     */
+    static size_t bitpack_decode(const uint8_t* data, size_t size, T* out) {
+        const BitPackHeader header = bitpack_header(data, size);
+        const auto unpack = detail::unpack_block_kernel<zigzag_type>().resolve();
+        size_t written = 0;
+        for (size_t b = 0; b < header.block_count; ++b) {
+            written += bitpack_decode_block(data, size, header, b, out + written, unpack);
+        }
+        return written;
+    }
+
+    /**
+     * @brief Decode a bit-packed stream
+     * @param encoded Output of bitpack_encode
+     * @return Decoded chunk
+     */
+    static std::vector<T> bitpack_decode(const std::vector<uint8_t>& encoded) {
+        std::vector<T> result(bitpack_value_count(encoded.data(), encoded.size()));
+        bitpack_decode(encoded.data(), encoded.size(), result.data());
+        return result;
+    }
+
+    /**
+     * @brief Upper bound on the size of varint_encode output for n values
+     */
+    static size_t varint_max_encoded_size(size_t n) {
+        return n * detail::varint_max_bytes(std::numeric_limits<zigzag_type>::digits);
+    }
+
+    /**
+     * @brief LEB128-encode a chunk into a caller-provided buffer
+     *
+     * Signed values and deltas are zigzag coded first so that small
+     * magnitudes take a single byte.
+     * @param in Input values
+     * @param n Number of values
+     * @param out Buffer of at least varint_max_encoded_size(n) bytes
+     * @param delta Whether to encode deltas between consecutive values
+     * @return Number of bytes written
+     */
+    static size_t varint_encode(const T* in, size_t n, uint8_t* out, bool delta = false) {
+        static_assert(std::is_integral<T>::value, "varint coding requires an integral type");
+        std::vector<zigzag_type> codes(n);
+        to_codes(in, n, codes.data(), delta);
+        size_t pos = 0;
+        for (zigzag_type code : codes) {
+            pos += detail::varint_put(code, out + pos);
+        }
+        return pos;
+    }
+
+    /**
+     * @brief LEB128-encode a chunk
+     */
+    static std::vector<uint8_t> varint_encode(const std::vector<T>& chunk, bool delta = false) {
+        std::vector<uint8_t> result(varint_max_encoded_size(chunk.size()));
+        result.resize(varint_encode(chunk.data(), chunk.size(), result.data(), delta));
+        return result;
+    }
+
+    /**
+     * @brief Decode n LEB128 values into a caller-provided buffer
+     * @param data Encoded bytes
+     * @param size Number of encoded bytes available
+     * @param out Buffer of at least n values
+     * @param n Number of values to decode
+     * @param delta Whether the values were encoded as deltas
+     * @return Number of bytes consumed
+     * @throws chunk_processing::SerializationError on truncated or out-of-range input
+     */
+    static size_t varint_decode(const uint8_t* data, size_t size, T* out, size_t n,
+                                bool delta = false) {
+        static_assert(std::is_integral<T>::value, "varint coding requires an integral type");
+        std::vector<zigzag_type> codes(n);
+        const uint8_t* p = data;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t value;
+            p = detail::varint_get(p, data + size, value);
+            codes[i] = checked_code(value);
+        }
+        from_codes(codes.data(), n, out, delta);
+        return static_cast<size_t>(p - data);
+    }
+
+    /**
+     * @brief Decode a buffer of LEB128 values
+     */
+    static std::vector<T> varint_decode(const std::vector<uint8_t>& encoded, bool delta = false) {
+        std::vector<zigzag_type> codes;
+        const uint8_t* p = encoded.data();
+        const uint8_t* end = p + encoded.size();
+        while (p != end) {
+            uint64_t value;
+            p = detail::varint_get(p, end, value);
+            codes.push_back(checked_code(value));
+        }
+        std::vector<T> result(codes.size());
+        from_codes(codes.data(), codes.size(), result.data(), delta);
+        return result;
+    }
+
+    /**
+     * @brief Upper bound on the size of group_varint_encode output for n values
+     */
+    static size_t group_varint_max_encoded_size(size_t n) {
+        return detail::varint_max_bytes(64) + (n + 3) / 4 * 17;
+    }
+
+    /**
+     * @brief Group-varint encode a chunk of values up to 32 bits
+     *
+     * Four values share a control byte holding their byte lengths, so
+     * decoding needs no per-byte continuation branches. The stream starts
+     * with the value count as a LEB128 varint.
+     * @param in Input values
+     * @param n Number of values
+     * @param out Buffer of at least group_varint_max_encoded_size(n) bytes
+     * @param delta Whether to encode deltas between consecutive values
+     * @return Number of bytes written
+     */
+    static size_t group_varint_encode(const T* in, size_t n, uint8_t* out, bool delta = false) {
+        static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                      "group varint coding requires an integral type of at most 32 bits");
+        std::vector<zigzag_type> codes(n);
+        to_codes(in, n, codes.data(), delta);
+        size_t pos = detail::varint_put(n, out);
+        for (size_t i = 0; i < n; i += 4) {
+            uint32_t group[4] = {0, 0, 0, 0};
+            for (size_t j = 0; j < 4 && i + j < n; ++j) {
+                group[j] = codes[i + j];
+            }
+            pos += detail::group_varint_put4(group, out + pos);
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Group-varint encode a chunk of values up to 32 bits
+     */
+    static std::vector<uint8_t> group_varint_encode(const std::vector<T>& chunk,
+                                                    bool delta = false) {
+        std::vector<uint8_t> result(group_varint_max_encoded_size(chunk.size()));
+        result.resize(group_varint_encode(chunk.data(), chunk.size(), result.data(), delta));
+        return result;
+    }
+
+    /**
+     * @brief Number of values in a group-varint stream
+     */
+    static size_t group_varint_value_count(const uint8_t* data, size_t size) {
+        uint64_t count;
+        detail::varint_get(data, data + size, count);
+        return static_cast<size_t>(count);
+    }
+
+    /**
+     * @brief Decode a group-varint stream into a caller-provided buffer
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param out Buffer of at least group_varint_value_count values
+     * @param delta Whether the values were encoded as deltas
+     * @return Number of values written
+     * @throws chunk_processing::SerializationError on truncated or out-of-range input
+     */
+    static size_t group_varint_decode(const uint8_t* data, size_t size, T* out,
+                                      bool delta = false) {
+        static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                      "group varint coding requires an integral type of at most 32 bits");
+        const uint8_t* end = data + size;
+        uint64_t count;
+        const uint8_t* p = detail::varint_get(data, end, count);
+        if (count > size * 4) {
+            throw chunk_processing::SerializationError("Invalid group varint value count");
+        }
+        std::vector<zigzag_type> codes(static_cast<size_t>(count));
+        for (size_t i = 0; i < count; i += 4) {
+            uint32_t group[4];
+            p = detail::group_varint_get4(p, end, group);
+            for (size_t j = 0; j < 4 && i + j < count; ++j) {
+                codes[i + j] = checked_code(group[j]);
+            }
+        }
+        from_codes(codes.data(), codes.size(), out, delta);
+        return codes.size();
+    }
+
+    /**
+     * @brief Decode a group-varint stream
+     */
+    static std::vector<T> group_varint_decode(const std::vector<uint8_t>& encoded,
+                                              bool delta = false) {
+        std::vector<T> result(group_varint_value_count(encoded.data(), encoded.size()));
+        group_varint_decode(encoded.data(), encoded.size(), result.data(), delta);
+        return result;
+    }
+
+    /**
+     * @brief Gorilla-style XOR compression of a float or double chunk
+     *
+     * Repeated values cost one bit and slowly changing values only their
+     * differing mantissa bits; decoding is bit-exact, including NaN payloads.
+     * @param chunk Input chunk
+     * @return Encoded bytes
+     */
+    static std::vector<uint8_t> xor_encode(const std::vector<T>& chunk) {
+        std::vector<uint8_t> result;
+        xor_encode_impl(chunk.data(), chunk.size(), nullptr, result);
+        return result;
+    }
+
+    /**
+     * @brief Append the XOR compression of a chunk to a buffer
+     *
+     * Reusing one buffer for many chunks only allocates when it grows.
+     * @param in Input values
+     * @param n Number of values
+     * @param out Buffer the encoded bytes are appended to
+     * @return Number of bytes appended
+     */
+    static size_t xor_encode(const T* in, size_t n, std::vector<uint8_t>& out) {
+        const size_t start = out.size();
+        xor_encode_impl(in, n, nullptr, out);
+        return out.size() - start;
+    }
+
+    /**
+     * @brief Upper bound on the size of xor_encode output for n values
+     */
+    static size_t xor_max_encoded_size(size_t n) {
+        // Two control bits, the leading-zero and length fields, then every bit of the value
+        using Encoder = detail::XorEncoder<float_bits>;
+        return sizeof(XorHeader) + (n * (Encoder::width + 7 + Encoder::length_bits) + 7) / 8;
+    }
+
+    /**
+     * @brief XOR compression of a chunk with a paired timestamp column
+     * @param chunk Input chunk
+     * @param timestamps One timestamp per value, delta-of-delta coded
+     * @return Encoded bytes holding both columns
+     * @throws std::invalid_argument if the column lengths differ
+     */
+    static std::vector<uint8_t> xor_encode(const std::vector<T>& chunk,
+                                           const std::vector<int64_t>& timestamps) {
+        if (timestamps.size() != chunk.size()) {
+            throw std::invalid_argument("Timestamp column must match chunk size");
+        }
+        std::vector<uint8_t> result;
+        xor_encode_impl(chunk.data(), chunk.size(), timestamps.data(), result);
+        return result;
+    }
+
+    /**
+     * @brief Number of values in an XOR-compressed stream
+     * @throws chunk_processing::SerializationError if the stream is malformed or
+     *         holds more than max_values values
+     */
+    static size_t xor_value_count(const uint8_t* data, size_t size,
+                                  uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        return static_cast<size_t>(xor_header(data, size, max_values).value_count);
+    }
+
+    /**
+     * @brief Whether an XOR-compressed stream carries a timestamp column
+     */
+    static bool xor_has_timestamps(const uint8_t* data, size_t size) {
+        return (xor_header(data, size, std::numeric_limits<uint64_t>::max()).flags &
+                XOR_FLAG_TIMESTAMPS) != 0;
+    }
+
+    /**
+     * @brief Decode an XOR-compressed stream into caller-provided buffers
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param out Buffer of at least xor_value_count values
+     * @param timestamps Optional buffer for the timestamp column; ignored if null
+     * @param max_values Largest chunk to accept
+     * @return Number of values written
+     * @throws chunk_processing::SerializationError if the stream is malformed, holds
+     *         more than max_values values, or if timestamps are requested from a
+     *         stream without them
+     */
+    static size_t xor_decode(const uint8_t* data, size_t size, T* out,
+                             int64_t* timestamps = nullptr,
+                             uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        using Bits = float_bits;
+        const XorHeader header = xor_header(data, size, max_values);
+        const size_t n = static_cast<size_t>(header.value_count);
+        const uint8_t* values = data + sizeof(header) + header.timestamp_bytes;
+
+        if (timestamps) {
+            if (!(header.flags & XOR_FLAG_TIMESTAMPS)) {
+                throw chunk_processing::SerializationError("Stream has no timestamp column");
+            }
+            BitReader reader(data + sizeof(header), static_cast<size_t>(header.timestamp_bytes));
+            detail::DeltaOfDeltaDecoder<uint64_t> decoder(reader);
+            for (size_t i = 0; i < n; ++i) {
+                timestamps[i] = static_cast<int64_t>(decoder.get());
+            }
+        }
+
+        BitReader reader(values, size - static_cast<size_t>(values - data));
+        detail::XorDecoder<Bits> decoder(reader);
+        for (size_t i = 0; i < n; ++i) {
+            const Bits bits = decoder.get();
+            std::memcpy(out + i, &bits, sizeof(bits));
+        }
+        return n;
+    }
+
+    /**
+     * @brief Decode an XOR-compressed stream
+     */
+    static std::vector<T> xor_decode(const std::vector<uint8_t>& encoded,
+                                     uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        std::vector<T> result(xor_value_count(encoded.data(), encoded.size(), max_values));
+        xor_decode(encoded.data(), encoded.size(), result.data(), nullptr, max_values);
+        return result;
+    }
+
+    /**
+     * @brief Decode an XOR-compressed stream and its timestamp column
+     */
+    static std::vector<T> xor_decode(const std::vector<uint8_t>& encoded,
+                                     std::vector<int64_t>& timestamps,
+                                     uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        std::vector<T> result(xor_value_count(encoded.data(), encoded.size(), max_values));
+        timestamps.resize(result.size());
+        xor_decode(encoded.data(), encoded.size(), result.data(), timestamps.data(), max_values);
+        return result;
+    }
+
+    /**
+     * @brief Delta-of-delta encode an integer chunk, such as timestamps
+     *
+     * Values sampled at a fixed interval cost one bit each. The stream
+     * starts with the value count as a LEB128 varint.
+     */
+    static std::vector<uint8_t> delta_of_delta_encode(const std::vector<T>& chunk) {
+        static_assert(std::is_integral<T>::value,
+                      "delta-of-delta coding requires an integral type");
+        std::vector<uint8_t> result(detail::varint_max_bytes(64));
+        result.resize(detail::varint_put(chunk.size(), result.data()));
+        BitWriter writer(result);
+        detail::DeltaOfDeltaEncoder<zigzag_type> encoder(writer);
+        for (T value : chunk) {
+            encoder.put(static_cast<zigzag_type>(value));
         }
+        writer.flush();
+        return result;
+    }
 
+    /**
+     * @brief Decode the output of delta_of_delta_encode
+     */
+    static std::vector<T> delta_of_delta_decode(const std::vector<uint8_t>& encoded) {
+        static_assert(std::is_integral<T>::value,
+                      "delta-of-delta coding requires an integral type");
+        const uint8_t* end = encoded.data() + encoded.size();
+        uint64_t count;
+        const uint8_t* p = detail::varint_get(encoded.data(), end, count);
+        // Every value takes at least one bit
+        if (count > static_cast<uint64_t>(end - p) * 8 + 1) {
+            throw chunk_processing::SerializationError("Invalid delta-of-delta value count");
+        }
+        BitReader reader(p, static_cast<size_t>(end - p));
+        detail::DeltaOfDeltaDecoder<zigzag_type> decoder(reader);
+        std::vector<T> result(static_cast<size_t>(count));
+        for (auto& value : result) {
+            value = static_cast<T>(decoder.get());
+        }
         return result;
     }
+
+    /**
+     * @brief Dictionary-encode a chunk with few distinct values
+     *
+     * The result supports count_equal and filter_equal directly on its codes.
+     * @param chunk Input chunk
+     * @return Dictionary of distinct values plus bit-packed codes
+     */
+    static DictionaryChunk<T> dictionary_encode(const std::vector<T>& chunk) {
+        return DictionaryChunk<T>(chunk);
+    }
+
+    /**
+     * @brief Decode a dictionary-encoded chunk
+     */
+    static std::vector<T> dictionary_decode(const DictionaryChunk<T>& encoded) {
+        return encoded.decode();
+    }
+
+private:
+    using float_bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+    // Appends the header and streams to result
+    static void xor_encode_impl(const T* in, size_t n, const int64_t* timestamps,
+                                std::vector<uint8_t>& result) {
+        static_assert(std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "XOR compression requires float or double");
+        const size_t start = result.size();
+        result.reserve(start + sizeof(XorHeader) + n * (sizeof(T) + (timestamps ? 9 : 1)));
+        result.resize(start + sizeof(XorHeader));
+        XorHeader header{};
+        std::memcpy(header.magic, XOR_MAGIC, sizeof(header.magic));
+        header.version = XOR_VERSION;
+        header.value_size = sizeof(T);
+        header.value_count = n;
+
+        if (timestamps) {
+            BitWriter writer(result);
+            detail::DeltaOfDeltaEncoder<uint64_t> encoder(writer);
+            for (size_t i = 0; i < n; ++i) {
+                encoder.put(static_cast<uint64_t>(timestamps[i]));
+            }
+            writer.flush();
+            header.flags |= XOR_FLAG_TIMESTAMPS;
+            header.timestamp_bytes = result.size() - start - sizeof(header);
+        }
+
+        BitWriter writer(result);
+        detail::XorEncoder<float_bits> encoder(writer);
+        for (size_t i = 0; i < n; ++i) {
+            float_bits bits;
+            std::memcpy(&bits, in + i, sizeof(bits));
+            encoder.put(bits);
+        }
+        writer.flush();
+        std::memcpy(result.data() + start, &header, sizeof(header));
+    }
+
+    static XorHeader xor_header(const uint8_t* data, size_t size, uint64_t max_values) {
+        XorHeader header;
+        if (size < sizeof(header)) {
+            throw chunk_processing::SerializationError("XOR stream is truncated");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, XOR_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != XOR_VERSION) {
+            throw chunk_processing::SerializationError("Not an XOR-compressed stream");
+        }
+        if (header.value_size != sizeof(T)) {
+            throw chunk_processing::SerializationError("XOR stream has a different value type");
+        }
+        if (header.timestamp_bytes > size - sizeof(header)) {
+            throw chunk_processing::SerializationError("XOR stream is truncated");
+        }
+        // Every value, and every timestamp, takes at least one bit
+        const uint64_t value_bytes = size - sizeof(header) - header.timestamp_bytes;
+        if (header.value_count > value_bytes * 8 ||
+            ((header.flags & XOR_FLAG_TIMESTAMPS) &&
+             header.value_count > header.timestamp_bytes * 8)) {
+            throw chunk_processing::SerializationError("XOR stream is truncated");
+        }
+        if (header.value_count > max_values) {
+            throw chunk_processing::SerializationError(
+                "XOR stream exceeds the decoded value limit");
+        }
+        return header;
+    }
+
+    static constexpr size_t bitpack_block_header_size(bool delta) {
+        return (sizeof(BitPackBlockHeader) + sizeof(T) * (delta ? 2 : 1) + 3) & ~size_t{3};
+    }
+
+    static size_t bitpack_encode_block(const T* in, size_t count, bool delta,
+                                       detail::PackFn<zigzag_type>* pack, uint8_t* out) {
+        using U = zigzag_type;
+        U block[BITPACK_BLOCK_SIZE];
+        std::memcpy(block, in, count * sizeof(T));
+        const U base = block[0];
+        if (delta) {
+            ChunkCompressor<U>::delta_encode(block, count, block);
+        }
+
+        // Deltas and signed values are ranked as signed, so the reference is the true minimum
+        constexpr int bits = std::numeric_limits<U>::digits;
+        const U flip = delta || std::is_signed<T>::value ? static_cast<U>(U(1) << (bits - 1)) : 0;
+        const size_t first = delta ? 1 : 0;
+        U lo = std::numeric_limits<U>::max();
+        U hi = 0;
+        for (size_t i = first; i < count; ++i) {
+            const U key = static_cast<U>(block[i] ^ flip);
+            lo = std::min(lo, key);
+            hi = std::max(hi, key);
+        }
+        U reference = 0;
+        unsigned bit_width = 0;
+        if (first < count) {
+            reference = static_cast<U>(lo ^ flip);
+            bit_width = detail::bits_required(static_cast<U>(hi - lo));
+        }
+        if (delta) {
+            block[0] = reference;
+        }
+        std::fill(block + count, block + BITPACK_BLOCK_SIZE, reference);
+
+        const size_t header_size = bitpack_block_header_size(delta);
+        std::memset(out, 0, header_size);
+        BitPackBlockHeader header{static_cast<uint8_t>(bit_width), static_cast<uint8_t>(count), 0};
+        std::memcpy(out, &header, sizeof(header));
+        std::memcpy(out + sizeof(header), &reference, sizeof(U));
+        if (delta) {
+            std::memcpy(out + sizeof(header) + sizeof(U), &base, sizeof(U));
+        }
+        pack(block, reference, bit_width, out + header_size);
+        return header_size + detail::bitpack_payload_size(bit_width);
+    }
+
+    static BitPackHeader bitpack_header(const uint8_t* data, size_t size) {
+        BitPackHeader header;
+        if (size < sizeof(header)) {
+            throw chunk_processing::SerializationError("Bit-packed stream is truncated");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, BITPACK_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != BITPACK_VERSION) {
+            throw chunk_processing::SerializationError("Not a bit-packed stream");
+        }
+        if (header.value_size != sizeof(T)) {
+            throw chunk_processing::SerializationError(
+                "Bit-packed stream has a different value type");
+        }
+        // Written without value_count + 127, which wraps for counts near 2^64
+        if (header.block_count != header.value_count / BITPACK_BLOCK_SIZE +
+                                      (header.value_count % BITPACK_BLOCK_SIZE != 0) ||
+            size < sizeof(header) + header.block_count * sizeof(uint32_t)) {
+            throw chunk_processing::SerializationError("Bit-packed stream is truncated");
+        }
+        return header;
+    }
+
+    struct BitPackBlock {
+        size_t count;
+        unsigned bit_width;
+        zigzag_type reference;
+        zigzag_type base;
+        bool delta;
+        const uint8_t* payload;
+    };
+
+    static BitPackBlock bitpack_block(const uint8_t* data, size_t size,
+                                      const BitPackHeader& header, size_t block) {
+        using U = zigzag_type;
+        const bool delta = (header.flags & BITPACK_FLAG_DELTA) != 0;
+        const size_t header_size = bitpack_block_header_size(delta);
+        const size_t offset = detail::load_u32(data + sizeof(header) + block * sizeof(uint32_t));
+        if (offset > size || size - offset < header_size) {
+            throw chunk_processing::SerializationError("Bit-packed block is truncated");
+        }
+
+        BitPackBlockHeader block_header;
+        U reference;
+        U base = 0;
+        std::memcpy(&block_header, data + offset, sizeof(block_header));
+        std::memcpy(&reference, data + offset + sizeof(block_header), sizeof(U));
+        if (delta) {
+            std::memcpy(&base, data + offset + sizeof(block_header) + sizeof(U), sizeof(U));
+        }
+        const size_t count = block_header.count;
+        const size_t remaining =
+            static_cast<size_t>(header.value_count) - block * BITPACK_BLOCK_SIZE;
+        const size_t expected = std::min(BITPACK_BLOCK_SIZE, remaining);
+        if (count != expected || block_header.bit_width > std::numeric_limits<U>::digits ||
+            size - offset - header_size < detail::bitpack_payload_size(block_header.bit_width)) {
+            throw chunk_processing::SerializationError("Invalid bit-packed block");
+        }
+        return {count, block_header.bit_width, reference, base, delta,
+                data + offset + header_size};
+    }
+
+    static size_t bitpack_decode_block(const uint8_t* data, size_t size,
+                                       const BitPackHeader& header, size_t block, T* out,
+                                       detail::UnpackFn<zigzag_type>* unpack) {
+        using U = zigzag_type;
+        const BitPackBlock parsed = bitpack_block(data, size, header, block);
+        const size_t count = parsed.count;
+        U* words = reinterpret_cast<U*>(out);
+        if (count == BITPACK_BLOCK_SIZE) {
+            unpack(parsed.payload, parsed.reference, parsed.bit_width, words);
+        } else {
+            U tail[BITPACK_BLOCK_SIZE];
+            unpack(parsed.payload, parsed.reference, parsed.bit_width, tail);
+            std::memcpy(words, tail, count * sizeof(U));
+        }
+        if (parsed.delta) {
+            words[0] = parsed.base;
+            ChunkCompressor<U>::delta_decode(words, count, words);
+        }
+        return count;
+    }
+
+    // Varint codes: zigzag deltas, zigzag signed values, or unsigned values as they are
+    static void to_codes(const T* in, size_t n, zigzag_type* codes, bool delta) {
+        if (delta) {
+            zigzag_delta_encode(in, n, codes);
+            return;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const auto u = static_cast<zigzag_type>(in[i]);
+            codes[i] = std::is_signed<T>::value ? zigzag_word(u) : u;
+        }
+    }
+
+    static void from_codes(const zigzag_type* codes, size_t n, T* out, bool delta) {
+        if (delta) {
+            zigzag_delta_decode(codes, n, out);
+            return;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<T>(std::is_signed<T>::value ? unzigzag_word(codes[i]) : codes[i]);
+        }
+    }
+
+    static zigzag_type checked_code(uint64_t value) {
+        if (value > std::numeric_limits<zigzag_type>::max()) {
+            throw chunk_processing::SerializationError("Encoded value out of range for type");
+        }
+        return static_cast<zigzag_type>(value);
+    }
+
+    // Zigzag of a two's complement bit pattern, without signed shifts
+    static zigzag_type zigzag_word(zigzag_type u) {
+        constexpr int bits = std::numeric_limits<zigzag_type>::digits;
+        auto sign = static_cast<zigzag_type>(zigzag_type(0) - (u >> (bits - 1)));
+        return static_cast<zigzag_type>((u << 1) ^ sign);
+    }
+
+    static zigzag_type unzigzag_word(zigzag_type code) {
+        return static_cast<zigzag_type>((code >> 1) ^ (zigzag_type(0) - (code & 1)));
+    }
 };
 
 } // namespace chunk_compression
\ No newline at end of file
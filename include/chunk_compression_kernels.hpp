@@ -0,0 +1,259 @@
+/**
+ * @file chunk_compression_kernels.hpp
+ * @brief Vectorized delta and prefix-sum kernels used by ChunkCompressor
+ *
+ * Kernels operate on unsigned 32- and 64-bit words so that wrap-around is
+ * well defined; signed chunks are reinterpreted before dispatch. Delta
+ * decoding is a prefix sum, which compilers cannot vectorize on their own,
+ * so the SIMD variants scan each register with log2(lanes) shifted adds and
+ * carry the last lane into the next register.
+ */
+
+#pragma once
+
+#include "chunk_backend.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace chunk_compression {
+namespace detail {
+
+template <typename U>
+using DeltaKernelFn = void(const U*, size_t, U*);
+
+// Scalar reference kernels. Encoding walks backwards so that output may alias input.
+
+template <typename U>
+void delta_encode_scalar(const U* in, size_t n, U* out) {
+    for (size_t i = n; i-- > 1;) {
+        out[i] = static_cast<U>(in[i] - in[i - 1]);
+    }
+    if (n > 0) {
+        out[0] = in[0];
+    }
+}
+
+template <typename U>
+void delta_decode_scalar(const U* in, size_t n, U* out) {
+    U acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc = static_cast<U>(acc + in[i]);
+        out[i] = acc;
+    }
+}
+
+#if CHUNK_HAS_X86_DISPATCH
+
+// Per-width vector operations, so the loops below are written once per ISA.
+// Vectors only cross function boundaries through memory: the generic loops
+// have no target attribute, and a by-value __m256i would be passed under a
+// different calling convention whenever they are not inlined (e.g. at -O0).
+
+struct Sse2Ops32 {
+    using vec = __m128i;
+    static constexpr size_t lanes = 4;
+    __attribute__((target("sse2"))) static void zero(vec& v) {
+        v = _mm_setzero_si128();
+    }
+    // out = in - prev, lane-wise
+    __attribute__((target("sse2"))) static void diff(const void* in, const void* prev, void* out) {
+        const vec a = _mm_loadu_si128(static_cast<const vec*>(in));
+        const vec b = _mm_loadu_si128(static_cast<const vec*>(prev));
+        _mm_storeu_si128(static_cast<vec*>(out), _mm_sub_epi32(a, b));
+    }
+    // out = inclusive prefix sum of in plus the broadcast carry; updates carry
+    __attribute__((target("sse2"))) static void scan(const void* in, void* out, vec& carry) {
+        vec v = _mm_loadu_si128(static_cast<const vec*>(in));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        carry = _mm_shuffle_epi32(v, 0xFF);
+        _mm_storeu_si128(static_cast<vec*>(out), v);
+    }
+};
+
+struct Sse2Ops64 {
+    using vec = __m128i;
+    static constexpr size_t lanes = 2;
+    __attribute__((target("sse2"))) static void zero(vec& v) {
+        v = _mm_setzero_si128();
+    }
+    __attribute__((target("sse2"))) static void diff(const void* in, const void* prev, void* out) {
+        const vec a = _mm_loadu_si128(static_cast<const vec*>(in));
+        const vec b = _mm_loadu_si128(static_cast<const vec*>(prev));
+        _mm_storeu_si128(static_cast<vec*>(out), _mm_sub_epi64(a, b));
+    }
+    __attribute__((target("sse2"))) static void scan(const void* in, void* out, vec& carry) {
+        vec v = _mm_loadu_si128(static_cast<const vec*>(in));
+        v = _mm_add_epi64(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi64(v, carry);
+        carry = _mm_unpackhi_epi64(v, v);
+        _mm_storeu_si128(static_cast<vec*>(out), v);
+    }
+};
+
+struct Avx2Ops32 {
+    using vec = __m256i;
+    static constexpr size_t lanes = 8;
+    __attribute__((target("avx2"))) static void zero(vec& v) {
+        v = _mm256_setzero_si256();
+    }
+    __attribute__((target("avx2"))) static void diff(const void* in, const void* prev, void* out) {
+        const vec a = _mm256_loadu_si256(static_cast<const vec*>(in));
+        const vec b = _mm256_loadu_si256(static_cast<const vec*>(prev));
+        _mm256_storeu_si256(static_cast<vec*>(out), _mm256_sub_epi32(a, b));
+    }
+    __attribute__((target("avx2"))) static void scan(const void* in, void* out, vec& carry) {
+        // Scan each 128-bit half, then add the low half's total to the high half
+        vec v = _mm256_loadu_si256(static_cast<const vec*>(in));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        vec low_total = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(3));
+        v = _mm256_add_epi32(v, _mm256_blend_epi32(_mm256_setzero_si256(), low_total, 0xF0));
+        v = _mm256_add_epi32(v, carry);
+        carry = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(7));
+        _mm256_storeu_si256(static_cast<vec*>(out), v);
+    }
+};
+
+struct Avx2Ops64 {
+    using vec = __m256i;
+    static constexpr size_t lanes = 4;
+    __attribute__((target("avx2"))) static void zero(vec& v) {
+        v = _mm256_setzero_si256();
+    }
+    __attribute__((target("avx2"))) static void diff(const void* in, const void* prev, void* out) {
+        const vec a = _mm256_loadu_si256(static_cast<const vec*>(in));
+        const vec b = _mm256_loadu_si256(static_cast<const vec*>(prev));
+        _mm256_storeu_si256(static_cast<vec*>(out), _mm256_sub_epi64(a, b));
+    }
+    __attribute__((target("avx2"))) static void scan(const void* in, void* out, vec& carry) {
+        vec v = _mm256_loadu_si256(static_cast<const vec*>(in));
+        v = _mm256_add_epi64(v, _mm256_slli_si256(v, 8));
+        vec low_total = _mm256_permute4x64_epi64(v, 0x55);
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_setzero_si256(), low_total, 0xF0));
+        v = _mm256_add_epi64(v, carry);
+        carry = _mm256_permute4x64_epi64(v, 0xFF);
+        _mm256_storeu_si256(static_cast<vec*>(out), v);
+    }
+};
+
+template <typename Ops, typename U>
+inline void delta_encode_simd(const U* in, size_t n, U* out) {
+    // Blocks from the top down; each block only reads indices below the ones it writes
+    size_t i = n;
+    while (i >= Ops::lanes + 1) {
+        i -= Ops::lanes;
+        Ops::diff(in + i, in + i - 1, out + i);
+    }
+    delta_encode_scalar(in, i, out);
+}
+
+template <typename Ops, typename U>
+inline void delta_decode_simd(const U* in, size_t n, U* out) {
+    typename Ops::vec carry;
+    Ops::zero(carry);
+    size_t i = 0;
+    for (; i + Ops::lanes <= n; i += Ops::lanes) {
+        Ops::scan(in + i, out + i, carry);
+    }
+    U acc = i > 0 ? out[i - 1] : U{0};
+    for (; i < n; ++i) {
+        acc = static_cast<U>(acc + in[i]);
+        out[i] = acc;
+    }
+}
+
+template <typename U>
+using Sse2Ops = std::conditional_t<sizeof(U) == 4, Sse2Ops32, Sse2Ops64>;
+template <typename U>
+using Avx2Ops = std::conditional_t<sizeof(U) == 4, Avx2Ops32, Avx2Ops64>;
+
+template <typename U>
+CHUNK_TARGET_SSE2 void delta_encode_sse2(const U* in, size_t n, U* out) {
+    delta_encode_simd<Sse2Ops<U>>(in, n, out);
+}
+template <typename U>
+CHUNK_TARGET_SSE2 void delta_decode_sse2(const U* in, size_t n, U* out) {
+    delta_decode_simd<Sse2Ops<U>>(in, n, out);
+}
+template <typename U>
+CHUNK_TARGET_AVX2 void delta_encode_avx2(const U* in, size_t n, U* out) {
+    delta_encode_simd<Avx2Ops<U>>(in, n, out);
+}
+template <typename U>
+CHUNK_TARGET_AVX2 void delta_decode_avx2(const U* in, size_t n, U* out) {
+    delta_decode_simd<Avx2Ops<U>>(in, n, out);
+}
+
+#endif // CHUNK_HAS_X86_DISPATCH
+
+/**
+ * @brief Delta encoding variants for 32- or 64-bit words (output may alias input)
+ */
+template <typename U>
+const chunk_backend::Kernel<DeltaKernelFn<U>>& delta_encode_kernel() {
+    static_assert(std::is_unsigned<U>::value && (sizeof(U) == 4 || sizeof(U) == 8),
+                  "delta kernels operate on 32- or 64-bit unsigned words");
+    static const chunk_backend::Kernel<DeltaKernelFn<U>> kernel = []() {
+        chunk_backend::Kernel<DeltaKernelFn<U>> k("compression.delta_encode");
+        k.add(chunk_backend::Backend::Scalar, &delta_encode_scalar<U>);
+#if CHUNK_HAS_X86_DISPATCH
+        k.add(chunk_backend::Backend::SSE2, &delta_encode_sse2<U>);
+        k.add(chunk_backend::Backend::AVX2, &delta_encode_avx2<U>);
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+/**
+ * @brief Delta decoding (prefix sum) variants for 32- or 64-bit words
+ */
+template <typename U>
+const chunk_backend::Kernel<DeltaKernelFn<U>>& delta_decode_kernel() {
+    static_assert(std::is_unsigned<U>::value && (sizeof(U) == 4 || sizeof(U) == 8),
+                  "delta kernels operate on 32- or 64-bit unsigned words");
+    static const chunk_backend::Kernel<DeltaKernelFn<U>> kernel = []() {
+        chunk_backend::Kernel<DeltaKernelFn<U>> k("compression.delta_decode");
+        k.add(chunk_backend::Backend::Scalar, &delta_decode_scalar<U>);
+#if CHUNK_HAS_X86_DISPATCH
+        k.add(chunk_backend::Backend::SSE2, &delta_decode_sse2<U>);
+        k.add(chunk_backend::Backend::AVX2, &delta_decode_avx2<U>);
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+/**
+ * @brief Unsigned word type the SIMD kernels use for T, or void if T has none
+ */
+template <typename T, typename = void>
+struct simd_word {
+    using type = void;
+};
+
+template <typename T>
+struct simd_word<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                     (sizeof(T) == 4 || sizeof(T) == 8)>> {
+    using type = std::make_unsigned_t<T>;
+};
+
+/**
+ * @brief Unsigned counterpart used for zigzag codes (T itself for non-integral T)
+ */
+template <typename T, typename = void>
+struct zigzag_word {
+    using type = T;
+};
+
+template <typename T>
+struct zigzag_word<T,
+                   std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>> {
+    using type = std::make_unsigned_t<T>;
+};
+
+} // namespace detail
+} // namespace chunk_compression
@@ -0,0 +1,556 @@
+/**
+ * @file chunk_dictionary.hpp
+ * @brief Dictionary encoding for low-cardinality chunks
+ *
+ * A DictionaryChunk stores each distinct value once and replaces the values
+ * by bit-packed codes in the 128-value block layout of chunk_bitpacking.hpp.
+ * Equality filters and counts translate the probe value into codes once and
+ * then scan the codes, so they never materialize the decoded values.
+ */
+
+#pragma once
+
+#include "chunk_bitpacking.hpp"
+#include "chunk_errors.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace chunk_compression {
+
+/// Magic bytes at the start of a serialized dictionary chunk
+constexpr char DICTIONARY_MAGIC[4] = {'C', 'D', 'I', 'C'};
+
+/// Current serialized dictionary chunk version
+constexpr uint8_t DICTIONARY_VERSION = 1;
+
+/**
+ * @brief Header of a serialized dictionary chunk
+ *
+ * Followed by the dictionary entries (raw values, or varint length plus
+ * bytes for strings) and the packed code blocks.
+ */
+struct DictionaryHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t value_size; ///< sizeof(T), or 0 for strings
+    uint8_t bit_width;
+    uint8_t reserved;
+    uint32_t dictionary_size;
+    uint32_t reserved2;
+    uint64_t value_count;
+};
+
+static_assert(sizeof(DictionaryHeader) == 24, "DictionaryHeader layout must stay fixed");
+
+namespace detail {
+
+/// Types whose dictionary is built by hashing their bit pattern in a flat table
+template <typename T>
+constexpr bool dictionary_fast_path =
+    (std::is_arithmetic<T>::value || std::is_enum<T>::value) && sizeof(T) <= sizeof(uint64_t);
+
+/**
+ * @brief Assign codes in order of first appearance
+ * @param in Input values
+ * @param n Number of values
+ * @param codes Output buffer of n codes
+ * @param dictionary Receives the distinct values, indexed by code
+ * @param keys, slots Hash table of the fast path; their capacity is reused between calls
+ */
+template <typename T>
+void build_dictionary(const T* in, size_t n, uint32_t* codes, std::vector<T>& dictionary,
+                      [[maybe_unused]] std::vector<uint64_t>& keys,
+                      [[maybe_unused]] std::vector<uint32_t>& slots) {
+    dictionary.clear();
+    if constexpr (dictionary_fast_path<T>) {
+        // Open addressing on the value bits, kept at most half full
+        constexpr uint32_t empty = ~uint32_t{0};
+        size_t capacity = 64;
+        keys.assign(capacity, 0);
+        slots.assign(capacity, empty);
+        auto key_of = [](const T& value) {
+            uint64_t key = 0;
+            std::memcpy(&key, &value, sizeof(T));
+            return key;
+        };
+        auto slot_of = [](uint64_t key, size_t mask) {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        };
+        // Rehashes from the dictionary, which holds every key
+        auto grow = [&]() {
+            capacity *= 2;
+            keys.assign(capacity, 0);
+            slots.assign(capacity, empty);
+            for (uint32_t code = 0; code < dictionary.size(); ++code) {
+                const uint64_t key = key_of(dictionary[code]);
+                size_t s = slot_of(key, capacity - 1);
+                while (slots[s] != empty) {
+                    s = (s + 1) & (capacity - 1);
+                }
+                keys[s] = key;
+                slots[s] = code;
+            }
+        };
+
+        uint64_t last_key = 0;
+        uint32_t last_code = empty;
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t key = key_of(in[i]);
+            if (key == last_key && last_code != empty) {
+                codes[i] = last_code; // runs of equal values skip the probe
+                continue;
+            }
+            size_t s = slot_of(key, capacity - 1);
+            while (slots[s] != empty && keys[s] != key) {
+                s = (s + 1) & (capacity - 1);
+            }
+            if (slots[s] == empty) {
+                keys[s] = key;
+                slots[s] = static_cast<uint32_t>(dictionary.size());
+                dictionary.push_back(in[i]);
+                if (dictionary.size() * 2 > capacity) {
+                    const uint32_t code = static_cast<uint32_t>(dictionary.size() - 1);
+                    grow();
+                    codes[i] = last_code = code;
+                    last_key = key;
+                    continue;
+                }
+            }
+            codes[i] = last_code = slots[s];
+            last_key = key;
+        }
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        // Views point into the input, which outlives the map
+        std::unordered_map<std::string_view, uint32_t> index;
+        for (size_t i = 0; i < n; ++i) {
+            auto inserted = index.emplace(in[i], static_cast<uint32_t>(dictionary.size()));
+            if (inserted.second) {
+                dictionary.push_back(in[i]);
+            }
+            codes[i] = inserted.first->second;
+        }
+    } else {
+        std::unordered_map<T, uint32_t> index;
+        for (size_t i = 0; i < n; ++i) {
+            auto inserted = index.emplace(in[i], static_cast<uint32_t>(dictionary.size()));
+            if (inserted.second) {
+                dictionary.push_back(in[i]);
+            }
+            codes[i] = inserted.first->second;
+        }
+    }
+}
+
+/**
+ * @brief Assign codes in order of first appearance
+ * @return Distinct values, indexed by code
+ */
+template <typename T>
+std::vector<T> build_dictionary(const T* in, size_t n, uint32_t* codes) {
+    std::vector<T> dictionary;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> slots;
+    build_dictionary(in, n, codes, dictionary, keys, slots);
+    return dictionary;
+}
+
+} // namespace detail
+
+/**
+ * @brief Buffers DictionaryChunk::encode reuses between chunks
+ */
+template <typename T>
+struct DictionaryScratch {
+    std::vector<T> dictionary;
+    std::vector<uint32_t> codes;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> slots;
+};
+
+/**
+ * @brief A chunk stored as a dictionary of distinct values plus bit-packed codes
+ * @tparam T Value type; arithmetic types and std::string take fast paths
+ */
+template <typename T>
+class DictionaryChunk {
+    static_assert(!std::is_same<T, bool>::value, "Dictionary encoding of bool is not supported");
+
+public:
+    DictionaryChunk() = default;
+
+    /**
+     * @brief Dictionary-encode values
+     * @param in Input values
+     * @param n Number of values
+     */
+    DictionaryChunk(const T* in, size_t n) : size_(n) {
+        std::vector<uint32_t> codes(n);
+        dictionary_ = detail::build_dictionary(in, n, codes.data());
+        if (dictionary_.size() > 1) {
+            bit_width_ = detail::bits_required(static_cast<uint32_t>(dictionary_.size() - 1));
+        }
+        pack_codes(codes);
+    }
+
+    explicit DictionaryChunk(const std::vector<T>& chunk)
+        : DictionaryChunk(chunk.data(), chunk.size()) {}
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    /// Distinct values, indexed by code
+    const std::vector<T>& dictionary() const {
+        return dictionary_;
+    }
+
+    /// Bits per code
+    unsigned bit_width() const {
+        return bit_width_;
+    }
+
+    /**
+     * @brief Code of the value at a position, read straight from the packed words
+     */
+    uint32_t code_at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Dictionary chunk index out of range");
+        }
+        if (bit_width_ == 0) {
+            return 0;
+        }
+        // Locate the value's bits inside its lane of the SIMD-BP128 block
+        const size_t block = index / BITPACK_BLOCK_SIZE;
+        const size_t row = (index % BITPACK_BLOCK_SIZE) / 4;
+        const size_t lane = index % 4;
+        const size_t bit = row * bit_width_;
+        const uint8_t* base = packed_.data() + block * detail::bitpack_payload_size(bit_width_);
+        uint64_t bits = detail::load_u32(base + ((bit / 32) * 4 + lane) * 4);
+        if (bit % 32 + bit_width_ > 32) {
+            bits |= static_cast<uint64_t>(detail::load_u32(base + ((bit / 32 + 1) * 4 + lane) * 4))
+                    << 32;
+        }
+        return static_cast<uint32_t>((bits >> (bit % 32)) & ((uint64_t{1} << bit_width_) - 1));
+    }
+
+    const T& operator[](size_t index) const {
+        return dictionary_[code_at(index)];
+    }
+
+    /**
+     * @brief Decode all codes into a caller-provided buffer of size() codes
+     */
+    void decode_codes(uint32_t* out) const {
+        for_each_block([&](size_t first, const uint32_t* codes, size_t count) {
+            std::copy(codes, codes + count, out + first);
+        });
+    }
+
+    /**
+     * @brief Decode all values into a caller-provided buffer of size() values
+     */
+    void decode(T* out) const {
+        for_each_block([&](size_t first, const uint32_t* codes, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                out[first + i] = dictionary_[codes[i]];
+            }
+        });
+    }
+
+    std::vector<T> decode() const {
+        std::vector<T> result(size_);
+        decode(result.data());
+        return result;
+    }
+
+    /**
+     * @brief Number of values equal to value, computed on the codes
+     */
+    size_t count_equal(const T& value) const {
+        size_t total = 0;
+        scan_equal(value, [&](size_t, const uint32_t* codes, size_t count, auto&& matches) {
+            for (size_t i = 0; i < count; ++i) {
+                total += matches(codes[i]);
+            }
+        });
+        return total;
+    }
+
+    /**
+     * @brief Positions of the values equal to value, computed on the codes
+     */
+    std::vector<size_t> filter_equal(const T& value) const {
+        std::vector<size_t> positions;
+        scan_equal(value, [&](size_t first, const uint32_t* codes, size_t count, auto&& matches) {
+            for (size_t i = 0; i < count; ++i) {
+                if (matches(codes[i])) {
+                    positions.push_back(first + i);
+                }
+            }
+        });
+        return positions;
+    }
+
+    /**
+     * @brief Serialize to bytes (fixed-size arithmetic values and std::string)
+     */
+    std::vector<uint8_t> serialize() const {
+        size_t dictionary_bytes = dictionary_.size() * sizeof(T);
+        if constexpr (std::is_same<T, std::string>::value) {
+            dictionary_bytes = 0;
+            for (const auto& entry : dictionary_) {
+                dictionary_bytes += detail::varint_max_bytes(64) + entry.size();
+            }
+        }
+        std::vector<uint8_t> out(sizeof(DictionaryHeader) + dictionary_bytes + packed_.size());
+        write_header(out.data(), dictionary_.size(), bit_width_, size_);
+        size_t pos = sizeof(DictionaryHeader);
+        if constexpr (std::is_same<T, std::string>::value) {
+            for (const auto& entry : dictionary_) {
+                pos += detail::varint_put(entry.size(), out.data() + pos);
+                std::memcpy(out.data() + pos, entry.data(), entry.size());
+                pos += entry.size();
+            }
+        } else if (dictionary_bytes > 0) {
+            std::memcpy(out.data() + pos, dictionary_.data(), dictionary_bytes);
+            pos += dictionary_bytes;
+        }
+        if (!packed_.empty()) {
+            std::memcpy(out.data() + pos, packed_.data(), packed_.size());
+        }
+        out.resize(pos + packed_.size());
+        return out;
+    }
+
+    /**
+     * @brief Rebuild a chunk from serialize() output
+     * @param data Serialized chunk
+     * @param size Number of bytes
+     * @param max_values Largest value count to accept. A one-entry dictionary
+     *        needs no code bits, so its size is not bounded by the input.
+     * @throws chunk_processing::SerializationError if the bytes are malformed or
+     *         hold more than max_values values
+     */
+    static DictionaryChunk deserialize(const uint8_t* data, size_t size,
+                                       uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        DictionaryHeader header;
+        if (size < sizeof(header)) {
+            throw chunk_processing::SerializationError("Dictionary chunk is truncated");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, DICTIONARY_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != DICTIONARY_VERSION || header.value_size != value_size_tag()) {
+            throw chunk_processing::SerializationError("Not a dictionary chunk of this type");
+        }
+        if (header.bit_width > 32 || (header.dictionary_size == 0 && header.value_count != 0) ||
+            (header.dictionary_size > 1 && header.bit_width == 0)) {
+            throw chunk_processing::SerializationError("Invalid dictionary chunk header");
+        }
+        if (header.value_count > max_values) {
+            throw chunk_processing::SerializationError("Dictionary chunk exceeds the value limit");
+        }
+        // With codes present the input bounds the count; checked before size_ + 127 can wrap
+        const uint64_t payload = detail::bitpack_payload_size(header.bit_width);
+        if (payload > 0 && header.value_count / BITPACK_BLOCK_SIZE > size / payload) {
+            throw chunk_processing::SerializationError("Invalid dictionary chunk codes");
+        }
+
+        DictionaryChunk chunk;
+        chunk.size_ = static_cast<size_t>(header.value_count);
+        chunk.bit_width_ = header.bit_width;
+        const uint8_t* p = data + sizeof(header);
+        const uint8_t* end = data + size;
+        if constexpr (std::is_same<T, std::string>::value) {
+            for (uint32_t i = 0; i < header.dictionary_size; ++i) {
+                uint64_t length;
+                p = detail::varint_get(p, end, length);
+                if (length > static_cast<uint64_t>(end - p)) {
+                    throw chunk_processing::SerializationError("Dictionary chunk is truncated");
+                }
+                chunk.dictionary_.emplace_back(reinterpret_cast<const char*>(p),
+                                               static_cast<size_t>(length));
+                p += length;
+            }
+        } else {
+            if (static_cast<uint64_t>(end - p) < uint64_t{header.dictionary_size} * sizeof(T)) {
+                throw chunk_processing::SerializationError("Dictionary chunk is truncated");
+            }
+            chunk.dictionary_.resize(header.dictionary_size);
+            std::memcpy(chunk.dictionary_.data(), p, header.dictionary_size * sizeof(T));
+            p += header.dictionary_size * sizeof(T);
+        }
+
+        const size_t packed_size = chunk.packed_size();
+        if (static_cast<size_t>(end - p) != packed_size ||
+            (header.dictionary_size > 0 &&
+             detail::bits_required(header.dictionary_size - 1) > header.bit_width)) {
+            throw chunk_processing::SerializationError("Invalid dictionary chunk codes");
+        }
+        chunk.packed_.assign(p, end);
+        chunk.check_codes();
+        return chunk;
+    }
+
+    static DictionaryChunk deserialize(const std::vector<uint8_t>& bytes,
+                                       uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        return deserialize(bytes.data(), bytes.size(), max_values);
+    }
+
+    /**
+     * @brief Largest encode() output for n values
+     */
+    static size_t max_encoded_size(size_t n) {
+        // At most n distinct values, so codes need at most the bits of n - 1
+        const unsigned bit_width =
+            n > 1 ? std::min(32u, detail::bits_required(static_cast<uint64_t>(n - 1))) : 0;
+        const size_t blocks = (n + BITPACK_BLOCK_SIZE - 1) / BITPACK_BLOCK_SIZE;
+        return sizeof(DictionaryHeader) + n * sizeof(T) +
+               blocks * detail::bitpack_payload_size(bit_width);
+    }
+
+    /**
+     * @brief Dictionary-encode values straight to the serialize() format
+     *
+     * Builds no DictionaryChunk: the dictionary, codes and hash table live in
+     * scratch, so encoding many chunks only allocates while scratch grows.
+     * @param in Input values (fixed-size arithmetic types)
+     * @param n Number of values
+     * @param out Buffer of at least max_encoded_size(n) bytes
+     * @param scratch Buffers reused between calls
+     * @return Number of bytes written
+     */
+    static size_t encode(const T* in, size_t n, uint8_t* out, DictionaryScratch<T>& scratch) {
+        static_assert(detail::dictionary_fast_path<T>, "encode() requires fixed-size values");
+        const size_t padded =
+            (n + BITPACK_BLOCK_SIZE - 1) / BITPACK_BLOCK_SIZE * BITPACK_BLOCK_SIZE;
+        if (scratch.codes.size() < padded) {
+            scratch.codes.resize(padded);
+        }
+        std::fill(scratch.codes.begin() + n, scratch.codes.begin() + padded, 0);
+        detail::build_dictionary(in, n, scratch.codes.data(), scratch.dictionary, scratch.keys,
+                                 scratch.slots);
+        const auto& dictionary = scratch.dictionary;
+        const unsigned bit_width =
+            dictionary.size() > 1
+                ? detail::bits_required(static_cast<uint32_t>(dictionary.size() - 1))
+                : 0;
+
+        write_header(out, dictionary.size(), bit_width, n);
+        size_t pos = sizeof(DictionaryHeader);
+        if (!dictionary.empty()) {
+            std::memcpy(out + pos, dictionary.data(), dictionary.size() * sizeof(T));
+            pos += dictionary.size() * sizeof(T);
+        }
+        return pos + pack_into(scratch.codes.data(), n, bit_width, out + pos);
+    }
+
+private:
+    static void write_header(uint8_t* out, size_t dictionary_size, unsigned bit_width,
+                             size_t count) {
+        DictionaryHeader header{};
+        std::memcpy(header.magic, DICTIONARY_MAGIC, sizeof(header.magic));
+        header.version = DICTIONARY_VERSION;
+        header.value_size = value_size_tag();
+        header.bit_width = static_cast<uint8_t>(bit_width);
+        header.dictionary_size = static_cast<uint32_t>(dictionary_size);
+        header.value_count = count;
+        std::memcpy(out, &header, sizeof(header));
+    }
+
+    // Packs n codes (padded with zeros to whole blocks) and returns the bytes written
+    static size_t pack_into(const uint32_t* codes, size_t n, unsigned bit_width, uint8_t* out) {
+        const auto pack = detail::pack_block_kernel<uint32_t>().resolve();
+        const size_t payload = detail::bitpack_payload_size(bit_width);
+        size_t b = 0;
+        for (size_t first = 0; first < n; first += BITPACK_BLOCK_SIZE, ++b) {
+            pack(codes + first, 0, bit_width, out + b * payload);
+        }
+        return b * payload;
+    }
+
+    static uint8_t value_size_tag() {
+        static_assert(detail::dictionary_fast_path<T> || std::is_same<T, std::string>::value,
+                      "Serialization supports arithmetic types and std::string");
+        return std::is_same<T, std::string>::value ? 0 : static_cast<uint8_t>(sizeof(T));
+    }
+
+    size_t packed_size() const {
+        const size_t blocks = (size_ + BITPACK_BLOCK_SIZE - 1) / BITPACK_BLOCK_SIZE;
+        return blocks * detail::bitpack_payload_size(bit_width_);
+    }
+
+    void pack_codes(std::vector<uint32_t>& codes) {
+        packed_.resize(packed_size());
+        codes.resize((size_ + BITPACK_BLOCK_SIZE - 1) / BITPACK_BLOCK_SIZE * BITPACK_BLOCK_SIZE, 0);
+        pack_into(codes.data(), size_, bit_width_, packed_.data());
+    }
+
+    // Untrusted input may hold codes past the dictionary when its size is not a power of two
+    void check_codes() const {
+        for_each_block([&](size_t, const uint32_t* codes, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                if (codes[i] >= dictionary_.size()) {
+                    throw chunk_processing::SerializationError("Dictionary code out of range");
+                }
+            }
+        });
+    }
+
+    // Calls fn(first_index, codes, count) for each block of unpacked codes
+    template <typename Fn>
+    void for_each_block(Fn&& fn) const {
+        const auto unpack = detail::unpack_block_kernel<uint32_t>().resolve();
+        const size_t payload = detail::bitpack_payload_size(bit_width_);
+        uint32_t codes[BITPACK_BLOCK_SIZE];
+        for (size_t first = 0, b = 0; first < size_; first += BITPACK_BLOCK_SIZE, ++b) {
+            unpack(packed_.data() + b * payload, 0, bit_width_, codes);
+            fn(first, codes, std::min(BITPACK_BLOCK_SIZE, size_ - first));
+        }
+    }
+
+    // Translates value into the matching codes (several only for +0.0 / -0.0) and scans
+    template <typename Fn>
+    void scan_equal(const T& value, Fn&& fn) const {
+        std::vector<uint32_t> matching;
+        for (uint32_t code = 0; code < dictionary_.size(); ++code) {
+            if (dictionary_[code] == value) {
+                matching.push_back(code);
+            }
+        }
+        if (matching.empty()) {
+            return;
+        }
+        if (matching.size() == 1) {
+            const uint32_t target = matching[0];
+            for_each_block([&](size_t first, const uint32_t* codes, size_t count) {
+                fn(first, codes, count, [target](uint32_t code) { return code == target; });
+            });
+            return;
+        }
+        std::vector<uint8_t> hit(dictionary_.size(), 0);
+        for (uint32_t code : matching) {
+            hit[code] = 1;
+        }
+        for_each_block([&](size_t first, const uint32_t* codes, size_t count) {
+            fn(first, codes, count, [&hit](uint32_t code) { return hit[code] != 0; });
+        });
+    }
+
+    std::vector<T> dictionary_;
+    std::vector<uint8_t> packed_;
+    size_t size_ = 0;
+    unsigned bit_width_ = 0;
+};
+
+} // namespace chunk_compression
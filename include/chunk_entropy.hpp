@@ -0,0 +1,500 @@
+/**
+ * @file chunk_entropy.hpp
+ * @brief Interleaved rANS entropy coder for chunk payloads
+ *
+ * An order-0 byte model is quantized to 12-bit frequencies and coded with
+ * 32 rANS states that take turns symbol by symbol, so 32 independent
+ * decode chains are in flight at once. States are 32 bits and renormalize
+ * in 16-bit words, which bounds renormalization to one word per symbol.
+ * Decoding reads one packed 4096-entry table per symbol and has no division;
+ * the AVX2 decoder advances eight states per gather and keeps four
+ * registers in flight to hide the gather latency.
+ *
+ * The coder works on bytes, so it chains after any transform: bit-packed,
+ * varint, or run-length output, or the byte planes of delta-coded values.
+ */
+
+#pragma once
+
+#include "chunk_backend.hpp"
+#include "chunk_bitpacking.hpp"
+#include "chunk_errors.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace chunk_compression {
+
+/// Magic bytes at the start of an rANS stream
+constexpr char RANS_MAGIC[4] = {'C', 'A', 'N', 'S'};
+
+/// Current rANS stream version
+constexpr uint8_t RANS_VERSION = 1;
+
+/// Interleaved rANS states; four AVX2 registers of eight lanes
+constexpr size_t RANS_STREAMS = 32;
+
+/// Frequencies sum to 2^RANS_SCALE_BITS
+constexpr uint32_t RANS_SCALE_BITS = 12;
+
+/**
+ * @brief Header of an rANS stream
+ *
+ * Followed by the frequency table (a 32-byte bitmap of present symbols, then
+ * one LEB128 frequency per present symbol in symbol order), the final
+ * encoder states as RANS_STREAMS little-endian 32-bit words, and
+ * payload_size bytes of 16-bit renormalization words.
+ */
+struct RansHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t stream_count;
+    uint8_t scale_bits;
+    uint8_t reserved;
+    uint64_t value_count; ///< Decoded bytes
+    uint32_t payload_size;
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(RansHeader) == 24, "RansHeader layout must stay fixed");
+
+/// Magic bytes at the start of an rANS-coded chunk
+constexpr char RANS_CHUNK_MAGIC[4] = {'C', 'R', 'N', 'C'};
+
+/// Chunk flag: planes hold zigzag deltas rather than values
+constexpr uint8_t RANS_FLAG_DELTA = 0x01;
+
+/**
+ * @brief Header of an rANS-coded chunk
+ *
+ * Followed by value_size byte planes (least significant first), each a
+ * 32-bit length and an rANS stream of value_count bytes. A plane whose
+ * bytes are all equal is stored as length 1 and that byte.
+ */
+struct RansChunkHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t value_size; ///< sizeof(T) of the encoded values
+    uint8_t flags;
+    uint8_t reserved;
+    uint64_t value_count;
+    uint64_t reserved2;
+};
+
+static_assert(sizeof(RansChunkHeader) == 24, "RansChunkHeader layout must stay fixed");
+
+namespace detail {
+
+constexpr uint32_t RANS_TOTAL = 1u << RANS_SCALE_BITS;
+constexpr uint32_t RANS_LOWER = 1u << 16; ///< States stay in [RANS_LOWER, 2^32)
+
+/**
+ * @brief Quantize byte counts to frequencies summing to RANS_TOTAL
+ *
+ * Every byte that occurs keeps a frequency of at least 1. Rounding error is
+ * settled against the most frequent symbols, where it costs the fewest bits.
+ */
+inline void normalize_frequencies(const uint64_t* counts, uint32_t* freq) {
+    uint64_t total = 0;
+    for (int s = 0; s < 256; ++s) {
+        total += counts[s];
+    }
+    int64_t sum = 0;
+    for (int s = 0; s < 256; ++s) {
+        freq[s] = 0;
+        if (counts[s] != 0) {
+            freq[s] = std::max<uint32_t>(
+                1, static_cast<uint32_t>(counts[s] * RANS_TOTAL / std::max<uint64_t>(total, 1)));
+        }
+        sum += freq[s];
+    }
+    if (total == 0) {
+        return;
+    }
+    while (sum != RANS_TOTAL) {
+        int best = -1;
+        for (int s = 0; s < 256; ++s) {
+            if (freq[s] > (sum > RANS_TOTAL ? 1u : 0u) && (best < 0 || freq[s] > freq[best])) {
+                best = s;
+            }
+        }
+        const int64_t step = sum > RANS_TOTAL
+                                 ? -std::min<int64_t>(sum - RANS_TOTAL, freq[best] - 1)
+                                 : static_cast<int64_t>(RANS_TOTAL) - sum;
+        freq[best] = static_cast<uint32_t>(freq[best] + step);
+        sum += step;
+    }
+}
+
+inline void histogram(const uint8_t* data, size_t n, uint64_t* counts) {
+    // Four tables avoid store-to-load stalls on runs of one byte
+    uint32_t partial[4][256] = {};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ++partial[0][data[i]];
+        ++partial[1][data[i + 1]];
+        ++partial[2][data[i + 2]];
+        ++partial[3][data[i + 3]];
+    }
+    for (; i < n; ++i) {
+        ++partial[0][data[i]];
+    }
+    for (int s = 0; s < 256; ++s) {
+        counts[s] = uint64_t(partial[0][s]) + partial[1][s] + partial[2][s] + partial[3][s];
+    }
+}
+
+// Packed decode slot: symbol in bits 24..31, freq - 1 in 12..23, slot - start in 0..11
+inline uint32_t rans_slot(uint32_t symbol, uint32_t freq, uint32_t bias) {
+    return symbol << 24 | (freq - 1) << 12 | bias;
+}
+
+inline void rans_decode_step(uint32_t& x, const uint32_t* table, uint8_t& out) {
+    const uint32_t entry = table[x & (RANS_TOTAL - 1)];
+    out = static_cast<uint8_t>(entry >> 24);
+    x = (((entry >> 12) & (RANS_TOTAL - 1)) + 1) * (x >> RANS_SCALE_BITS) +
+        (entry & (RANS_TOTAL - 1));
+}
+
+// Branch-free: whether a state needs a word is data dependent and mispredicts often
+inline void rans_renormalize(uint32_t& x, const uint8_t*& words) {
+    uint16_t word;
+    std::memcpy(&word, words, sizeof(word));
+    const uint32_t refill = x < RANS_LOWER;
+    x = x << (refill * 16) | (word & (0u - refill));
+    words += refill * sizeof(word);
+}
+
+/**
+ * @brief Decodes whole groups of RANS_STREAMS symbols
+ *
+ * Each group decodes every state, then refills states in lane order. Stops
+ * before a group whose refills could run past end.
+ * @return Number of symbols decoded
+ */
+using RansDecodeFn = size_t(uint32_t* state, const uint32_t* table, const uint8_t** words,
+                            const uint8_t* end, uint8_t* out, size_t n);
+
+inline size_t rans_decode_groups_scalar(uint32_t* state, const uint32_t* table,
+                                        const uint8_t** words_io, const uint8_t* end,
+                                        uint8_t* out, size_t n) {
+    uint32_t x[RANS_STREAMS];
+    std::memcpy(x, state, sizeof(x));
+    const uint8_t* words = *words_io;
+    size_t i = 0;
+    for (; i + RANS_STREAMS <= n && static_cast<size_t>(end - words) >= 2 * RANS_STREAMS;
+         i += RANS_STREAMS) {
+        for (size_t k = 0; k < RANS_STREAMS; ++k) {
+            rans_decode_step(x[k], table, out[i + k]);
+        }
+        for (size_t k = 0; k < RANS_STREAMS; ++k) {
+            rans_renormalize(x[k], words);
+        }
+    }
+    std::memcpy(state, x, sizeof(x));
+    *words_io = words;
+    return i;
+}
+
+#if CHUNK_HAS_X86_DISPATCH
+
+/// Per refill mask, the word each lane takes from the next eight in the stream
+inline const std::array<std::array<uint32_t, 8>, 256>& rans_refill_permutations() {
+    static const auto table = []() {
+        std::array<std::array<uint32_t, 8>, 256> t{};
+        for (uint32_t mask = 0; mask < 256; ++mask) {
+            uint32_t next = 0;
+            for (uint32_t lane = 0; lane < 8; ++lane) {
+                if (mask >> lane & 1) {
+                    t[mask][lane] = next++;
+                }
+            }
+        }
+        return t;
+    }();
+    return table;
+}
+
+CHUNK_TARGET_AVX2 inline size_t rans_decode_groups_avx2(uint32_t* state, const uint32_t* table,
+                                                        const uint8_t** words_io,
+                                                        const uint8_t* end, uint8_t* out,
+                                                        size_t n) {
+    constexpr size_t REGISTERS = RANS_STREAMS / 8;
+    const auto& permutations = rans_refill_permutations();
+    const __m256i low_bits = _mm256_set1_epi32(static_cast<int>(RANS_TOTAL - 1));
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    static_assert(REGISTERS == 4, "symbol packing assumes four registers");
+    __m256i x[REGISTERS];
+    for (size_t r = 0; r < REGISTERS; ++r) {
+        x[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 8 * r));
+    }
+    const uint8_t* words = *words_io;
+    size_t i = 0;
+    for (; i + RANS_STREAMS <= n && static_cast<size_t>(end - words) >= 2 * RANS_STREAMS;
+         i += RANS_STREAMS) {
+        __m256i symbols[REGISTERS];
+        for (size_t r = 0; r < REGISTERS; ++r) {
+            const __m256i entry = _mm256_i32gather_epi32(
+                reinterpret_cast<const int*>(table), _mm256_and_si256(x[r], low_bits), 4);
+            const __m256i freq =
+                _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(entry, 12), low_bits), one);
+            x[r] = _mm256_add_epi32(
+                _mm256_mullo_epi32(freq, _mm256_srli_epi32(x[r], RANS_SCALE_BITS)),
+                _mm256_and_si256(entry, low_bits));
+            symbols[r] = _mm256_srli_epi32(entry, 24);
+        }
+        // Packing interleaves 128-bit halves; the permute restores symbol order
+        const __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(symbols[0], symbols[1]),
+                                                  _mm256_packus_epi32(symbols[2], symbols[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_permutevar8x32_epi32(bytes, order));
+
+        // Lanes below 2^16 take the next words in lane order
+        __m256i refill[REGISTERS];
+        int mask[REGISTERS];
+        for (size_t r = 0; r < REGISTERS; ++r) {
+            refill[r] = _mm256_cmpeq_epi32(_mm256_srli_epi32(x[r], 16), zero);
+            mask[r] = _mm256_movemask_ps(_mm256_castsi256_ps(refill[r]));
+        }
+        for (size_t r = 0; r < REGISTERS; ++r) {
+            const __m256i next = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(words)));
+            const __m256i lanes = _mm256_permutevar8x32_epi32(
+                next, _mm256_loadu_si256(
+                          reinterpret_cast<const __m256i*>(permutations[mask[r]].data())));
+            x[r] = _mm256_blendv_epi8(x[r], _mm256_or_si256(_mm256_slli_epi32(x[r], 16), lanes),
+                                      refill[r]);
+            words += 2 * static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask[r])));
+        }
+    }
+    for (size_t r = 0; r < REGISTERS; ++r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 8 * r), x[r]);
+    }
+    *words_io = words;
+    return i;
+}
+
+#endif // CHUNK_HAS_X86_DISPATCH
+
+/**
+ * @brief rANS group decoders
+ */
+inline const chunk_backend::Kernel<RansDecodeFn>& rans_decode_kernel() {
+    static const chunk_backend::Kernel<RansDecodeFn> kernel = []() {
+        chunk_backend::Kernel<RansDecodeFn> k("compression.rans_decode");
+        k.add(chunk_backend::Backend::Scalar, &rans_decode_groups_scalar);
+#if CHUNK_HAS_X86_DISPATCH
+        k.add(chunk_backend::Backend::AVX2, &rans_decode_groups_avx2);
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+} // namespace detail
+
+/**
+ * @brief Order-0 interleaved rANS coder over byte buffers
+ */
+class RansCoder {
+public:
+    /**
+     * @brief Upper bound on the encoded size of n bytes
+     */
+    static size_t max_encoded_size(size_t n) {
+        return sizeof(RansHeader) + 32 + 256 * 2 + RANS_STREAMS * sizeof(uint32_t) + 2 * n;
+    }
+
+    /**
+     * @brief Entropy-code a byte buffer
+     * @param data Input bytes
+     * @param n Number of bytes
+     * @return Encoded stream
+     * @throws std::invalid_argument if n is 2^31 bytes or more
+     */
+    static std::vector<uint8_t> encode(const uint8_t* data, size_t n) {
+        if (n >= (size_t{1} << 31)) {
+            throw std::invalid_argument("rANS input must be smaller than 2^31 bytes");
+        }
+        uint64_t counts[256];
+        uint32_t freq[256];
+        detail::histogram(data, n, counts);
+        detail::normalize_frequencies(counts, freq);
+        uint32_t start[256];
+        uint32_t cumulative = 0;
+        for (int s = 0; s < 256; ++s) {
+            start[s] = cumulative;
+            cumulative += freq[s];
+        }
+
+        std::vector<uint8_t> out(max_encoded_size(n));
+        size_t pos = sizeof(RansHeader);
+        uint8_t* bitmap = out.data() + pos;
+        std::memset(bitmap, 0, 32);
+        pos += 32;
+        for (int s = 0; s < 256; ++s) {
+            if (freq[s] != 0) {
+                bitmap[s >> 3] = static_cast<uint8_t>(bitmap[s >> 3] | 1u << (s & 7));
+                pos += detail::varint_put(freq[s], out.data() + pos);
+            }
+        }
+
+        // Symbols are coded last to first so the decoder reads words front to back
+        uint8_t* const words_end = out.data() + out.size();
+        uint8_t* words = words_end;
+        uint32_t state[RANS_STREAMS];
+        std::fill(state, state + RANS_STREAMS, detail::RANS_LOWER);
+        for (size_t i = n; i-- > 0;) {
+            uint32_t& x = state[i % RANS_STREAMS];
+            const uint8_t s = data[i];
+            const uint64_t x_max =
+                (uint64_t(detail::RANS_LOWER >> RANS_SCALE_BITS) << 16) * freq[s];
+            if (x >= x_max) {
+                words -= sizeof(uint16_t);
+                const uint16_t word = static_cast<uint16_t>(x);
+                std::memcpy(words, &word, sizeof(word));
+                x >>= 16;
+            }
+            x = ((x / freq[s]) << RANS_SCALE_BITS) + (x % freq[s]) + start[s];
+        }
+
+        for (size_t k = 0; k < RANS_STREAMS; ++k) {
+            detail::store_u32(out.data() + pos, state[k]);
+            pos += sizeof(uint32_t);
+        }
+        const size_t payload_size = static_cast<size_t>(words_end - words);
+        std::memmove(out.data() + pos, words, payload_size);
+        out.resize(pos + payload_size);
+
+        RansHeader header{};
+        std::memcpy(header.magic, RANS_MAGIC, sizeof(header.magic));
+        header.version = RANS_VERSION;
+        header.stream_count = static_cast<uint8_t>(RANS_STREAMS);
+        header.scale_bits = static_cast<uint8_t>(RANS_SCALE_BITS);
+        header.value_count = n;
+        header.payload_size = static_cast<uint32_t>(payload_size);
+        std::memcpy(out.data(), &header, sizeof(header));
+        return out;
+    }
+
+    static std::vector<uint8_t> encode(const std::vector<uint8_t>& data) {
+        return encode(data.data(), data.size());
+    }
+
+    /**
+     * @brief Number of bytes an encoded stream decodes to
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param max_values Largest size to accept. A single-symbol table decodes
+     *        any length without consuming input, so the stream size does not
+     *        bound the decoded size of untrusted input.
+     * @throws chunk_processing::SerializationError if the stream is malformed or
+     *         decodes to more than max_values bytes
+     */
+    static size_t decoded_size(const uint8_t* data, size_t size,
+                               uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        const uint64_t n = read_header(data, size).value_count;
+        if (n > max_values) {
+            throw chunk_processing::SerializationError(
+                "rANS stream exceeds the decoded size limit");
+        }
+        return static_cast<size_t>(n);
+    }
+
+    /**
+     * @brief Decode into a caller-provided buffer
+     * @param data Encoded stream
+     * @param size Stream size in bytes
+     * @param out Buffer of at least decoded_size bytes
+     * @param backend Group decoder to use (Auto picks the fastest available)
+     * @return Number of bytes written
+     * @throws chunk_processing::SerializationError if the stream is malformed
+     */
+    static size_t decode(const uint8_t* data, size_t size, uint8_t* out,
+                         chunk_backend::Backend backend = chunk_backend::Backend::Auto) {
+        const RansHeader header = read_header(data, size);
+        const uint8_t* end = data + size;
+        const uint8_t* p = data + sizeof(RansHeader);
+        const uint8_t* bitmap = p;
+        p += 32;
+
+        std::vector<uint32_t> table(detail::RANS_TOTAL);
+        uint32_t cumulative = 0;
+        for (uint32_t s = 0; s < 256; ++s) {
+            if ((bitmap[s >> 3] >> (s & 7) & 1) == 0) {
+                continue;
+            }
+            uint64_t freq;
+            p = detail::varint_get(p, end, freq);
+            if (freq == 0 || freq > detail::RANS_TOTAL - cumulative) {
+                throw chunk_processing::SerializationError("Invalid rANS frequency table");
+            }
+            for (uint32_t slot = 0; slot < freq; ++slot) {
+                table[cumulative + slot] =
+                    detail::rans_slot(s, static_cast<uint32_t>(freq), slot);
+            }
+            cumulative += static_cast<uint32_t>(freq);
+        }
+        const size_t n = static_cast<size_t>(header.value_count);
+        if ((n > 0 && cumulative != detail::RANS_TOTAL) ||
+            static_cast<size_t>(end - p) != RANS_STREAMS * sizeof(uint32_t) + header.payload_size) {
+            throw chunk_processing::SerializationError("Invalid rANS stream");
+        }
+
+        uint32_t state[RANS_STREAMS];
+        for (size_t k = 0; k < RANS_STREAMS; ++k) {
+            state[k] = detail::load_u32(p + k * sizeof(uint32_t));
+        }
+        const uint8_t* words = p + RANS_STREAMS * sizeof(uint32_t);
+        const uint32_t* t = table.data();
+        size_t i = detail::rans_decode_kernel().resolve(backend)(state, t, &words, end, out, n);
+        for (; i < n; ++i) {
+            uint32_t& x = state[i % RANS_STREAMS];
+            detail::rans_decode_step(x, t, out[i]);
+            if (x < detail::RANS_LOWER) {
+                if (end - words < 2) {
+                    throw chunk_processing::SerializationError("rANS stream is truncated");
+                }
+                detail::rans_renormalize(x, words);
+            }
+        }
+        for (uint32_t x : state) {
+            if (x != detail::RANS_LOWER) {
+                throw chunk_processing::SerializationError("rANS stream is corrupt");
+            }
+        }
+        if (words != end) {
+            throw chunk_processing::SerializationError("rANS stream is corrupt");
+        }
+        return n;
+    }
+
+    static std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded,
+                                       uint64_t max_values = DEFAULT_MAX_DECODED_VALUES) {
+        std::vector<uint8_t> out(decoded_size(encoded.data(), encoded.size(), max_values));
+        decode(encoded.data(), encoded.size(), out.data());
+        return out;
+    }
+
+private:
+    static RansHeader read_header(const uint8_t* data, size_t size) {
+        RansHeader header;
+        if (size < sizeof(header) + 32) {
+            throw chunk_processing::SerializationError("rANS stream is truncated");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, RANS_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != RANS_VERSION || header.stream_count != RANS_STREAMS ||
+            header.scale_bits != RANS_SCALE_BITS) {
+            throw chunk_processing::SerializationError("Not an rANS stream");
+        }
+        return header;
+    }
+};
+
+} // namespace chunk_compression
@@ -0,0 +1,567 @@
+/**
+ * @file chunk_file.hpp
+ * @brief Memory-mappable columnar file format for chunk sets
+ *
+ * File layout (all fields in host byte order, guarded by an endianness tag):
+ *
+ *   [ChunkFileHeader, 32 bytes]
+ *   [padding to 64 bytes]
+ *   [values: every chunk back to back, 64-byte aligned]
+ *   [offsets: chunk_count + 1 uint64 value indices, 64-byte aligned]
+ *   [statistics: ChunkFileStats<T> per chunk, 64-byte aligned]   (optional)
+ *   [codec tags: one byte per chunk, 64-byte aligned]             (optional)
+ *   [ChunkFileFooter, 64 bytes]
+ *
+ * The footer indexes the sections and holds the CRC-32 of every byte before
+ * it, so the writer can stream values without knowing the chunk count up
+ * front. MappedChunkFile maps the file and hands out ChunkView spans that
+ * point straight into the mapping: opening does not read the values, and
+ * several processes mapping one archive share it through the page cache.
+ */
+
+#pragma once
+
+#include "chunk_adaptive_compression.hpp"
+#include "chunk_common.hpp"
+#include "chunk_errors.hpp"
+#include "chunk_io.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace chunk_io {
+
+constexpr char CHUNK_FILE_MAGIC[8] = {'C', 'N', 'K', 'C', 'O', 'L', 'F', '1'};
+constexpr char CHUNK_FILE_END_MAGIC[8] = {'C', 'N', 'K', 'C', 'O', 'L', 'E', 'N'};
+constexpr uint32_t CHUNK_FILE_VERSION = 1;
+constexpr uint32_t CHUNK_FILE_ALIGNMENT = 64;
+constexpr uint32_t CHUNK_FILE_ENDIAN_TAG = 0x01020304u;
+
+/**
+ * @brief Value type identifiers stored in the chunk file header
+ */
+enum class ChunkValueType : uint32_t {
+    Int8 = 1,
+    Int16 = 2,
+    Int32 = 3,
+    Int64 = 4,
+    UInt8 = 5,
+    UInt16 = 6,
+    UInt32 = 7,
+    UInt64 = 8,
+    Float32 = 9,
+    Float64 = 10,
+};
+
+template <typename T>
+struct chunk_value_type_of;
+template <>
+struct chunk_value_type_of<int8_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::Int8> {};
+template <>
+struct chunk_value_type_of<int16_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::Int16> {};
+template <>
+struct chunk_value_type_of<int32_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::Int32> {};
+template <>
+struct chunk_value_type_of<int64_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::Int64> {};
+template <>
+struct chunk_value_type_of<uint8_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::UInt8> {};
+template <>
+struct chunk_value_type_of<uint16_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::UInt16> {};
+template <>
+struct chunk_value_type_of<uint32_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::UInt32> {};
+template <>
+struct chunk_value_type_of<uint64_t>
+    : std::integral_constant<ChunkValueType, ChunkValueType::UInt64> {};
+template <>
+struct chunk_value_type_of<float>
+    : std::integral_constant<ChunkValueType, ChunkValueType::Float32> {};
+template <>
+struct chunk_value_type_of<double>
+    : std::integral_constant<ChunkValueType, ChunkValueType::Float64> {};
+
+/// Header flag: the statistics section is present
+constexpr uint32_t CHUNK_FILE_FLAG_STATS = 1u << 0;
+/// Header flag: the codec tag section is present
+constexpr uint32_t CHUNK_FILE_FLAG_CODECS = 1u << 1;
+
+/**
+ * @brief Fixed 32-byte file header
+ */
+struct ChunkFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t value_type;
+    uint32_t endian_tag;
+    uint32_t flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(ChunkFileHeader) == 32, "ChunkFileHeader must be 32 bytes");
+
+/**
+ * @brief Fixed 64-byte footer indexing the sections
+ */
+struct ChunkFileFooter {
+    uint64_t chunk_count;
+    uint64_t value_count;
+    uint64_t values_offset;
+    uint64_t offsets_offset;
+    uint64_t stats_offset;  ///< 0 when the file has no statistics
+    uint64_t codecs_offset; ///< 0 when the file has no codec tags
+    uint32_t checksum;      ///< CRC-32 of bytes [0, footer offset)
+    uint32_t reserved;
+    char magic[8];
+};
+static_assert(sizeof(ChunkFileFooter) == 64, "ChunkFileFooter must be 64 bytes");
+
+/**
+ * @brief Per-chunk statistics stored next to the values
+ *
+ * Lets readers prune chunks by range or aggregate without touching values.
+ * min and max are zero for an empty chunk.
+ */
+template <typename T>
+struct ChunkFileStats {
+    T min;
+    T max;
+    double sum;
+};
+
+/**
+ * @brief What the writer stores besides the values
+ */
+struct ChunkFileOptions {
+    /// Store min, max and sum per chunk
+    bool statistics = true;
+    /// Store the codec AdaptiveCompressor picks for each chunk, for later tiering
+    bool codec_tags = false;
+};
+
+/**
+ * @brief Read-only span over a chunk's values
+ */
+template <typename T>
+class ChunkView {
+public:
+    ChunkView() = default;
+    ChunkView(const T* data, size_t size) : data_(data), size_(size) {}
+
+    const T* data() const {
+        return data_;
+    }
+    size_t size() const {
+        return size_;
+    }
+    bool empty() const {
+        return size_ == 0;
+    }
+    const T* begin() const {
+        return data_;
+    }
+    const T* end() const {
+        return data_ + size_;
+    }
+    const T& operator[](size_t i) const {
+        return data_[i];
+    }
+
+    std::vector<T> to_vector() const {
+        return std::vector<T>(begin(), end());
+    }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Streams chunks into a chunk file
+ *
+ * Values go straight to disk as chunks are appended; only the offsets,
+ * statistics and codec tags (a few bytes per chunk) are kept until finish().
+ * The file is written to a temporary sibling, synced and renamed into place
+ * by finish(), so readers never map a partial file. A writer destroyed
+ * without finish() removes its temporary file.
+ *
+ * @tparam T Value type (any ChunkValueType)
+ */
+template <typename T>
+class CHUNK_EXPORT ChunkFileWriter {
+public:
+    /**
+     * @param path Destination file
+     * @param options Optional sections to store
+     * @throws chunk_processing::SerializationError if the file cannot be created
+     */
+    explicit ChunkFileWriter(const std::string& path, ChunkFileOptions options = {})
+        : path_(path), tmp_path_(unique_temp_path(path)), options_(options),
+          out_(tmp_path_, std::ios::binary | std::ios::trunc) {
+        if (!out_) {
+            throw chunk_processing::SerializationError("Cannot create " + tmp_path_);
+        }
+        ChunkFileHeader header{};
+        std::memcpy(header.magic, CHUNK_FILE_MAGIC, sizeof(header.magic));
+        header.version = CHUNK_FILE_VERSION;
+        header.header_size = sizeof(ChunkFileHeader);
+        header.value_type = static_cast<uint32_t>(chunk_value_type_of<T>::value);
+        header.endian_tag = CHUNK_FILE_ENDIAN_TAG;
+        header.flags = (options.statistics ? CHUNK_FILE_FLAG_STATS : 0) |
+                       (options.codec_tags ? CHUNK_FILE_FLAG_CODECS : 0);
+        write(&header, sizeof(header));
+        pad();
+        footer_.values_offset = position_;
+    }
+
+    ChunkFileWriter(const ChunkFileWriter&) = delete;
+    ChunkFileWriter& operator=(const ChunkFileWriter&) = delete;
+
+    ~ChunkFileWriter() {
+        if (!finished_) {
+            out_.close();
+            std::remove(tmp_path_.c_str());
+        }
+    }
+
+    /**
+     * @brief Append one chunk
+     * @throws chunk_processing::SerializationError if writing fails
+     */
+    void append(const T* data, size_t n) {
+        if (finished_) {
+            throw std::logic_error("Chunk file already finished");
+        }
+        write(data, n * sizeof(T));
+        offsets_.push_back(offsets_.back() + n);
+        if (options_.statistics) {
+            stats_.push_back(compute_stats(data, n));
+        }
+        if (options_.codec_tags) {
+            codecs_.push_back(static_cast<uint8_t>(adaptive_.choose(data, n)));
+        }
+    }
+
+    void append(const std::vector<T>& chunk) {
+        append(chunk.data(), chunk.size());
+    }
+
+    /// Chunks appended so far
+    size_t chunk_count() const {
+        return offsets_.size() - 1;
+    }
+
+    /**
+     * @brief Write the index sections and footer, then move the file into place
+     * @throws chunk_processing::SerializationError if writing or renaming fails
+     */
+    void finish() {
+        if (finished_) {
+            return;
+        }
+        footer_.chunk_count = chunk_count();
+        footer_.value_count = offsets_.back();
+        pad();
+        footer_.offsets_offset = position_;
+        write(offsets_.data(), offsets_.size() * sizeof(uint64_t));
+        if (options_.statistics) {
+            pad();
+            footer_.stats_offset = position_;
+            write(stats_.data(), stats_.size() * sizeof(ChunkFileStats<T>));
+        }
+        if (options_.codec_tags) {
+            pad();
+            footer_.codecs_offset = position_;
+            write(codecs_.data(), codecs_.size());
+        }
+        pad();
+        footer_.checksum = crc_;
+        std::memcpy(footer_.magic, CHUNK_FILE_END_MAGIC, sizeof(footer_.magic));
+        write(&footer_, sizeof(footer_));
+        out_.close();
+        if (!out_) {
+            throw chunk_processing::SerializationError("Cannot write " + tmp_path_);
+        }
+        sync_file(tmp_path_);
+        if (std::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+            std::remove(tmp_path_.c_str());
+            throw chunk_processing::SerializationError("Cannot rename " + tmp_path_ + " to " +
+                                                       path_);
+        }
+        finished_ = true;
+    }
+
+private:
+    static ChunkFileStats<T> compute_stats(const T* data, size_t n) {
+        ChunkFileStats<T> stats;
+        std::memset(&stats, 0, sizeof(stats)); // padding is checksummed
+        if (n == 0) {
+            return stats;
+        }
+        T lo = data[0];
+        T hi = data[0];
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            lo = data[i] < lo ? data[i] : lo;
+            hi = data[i] > hi ? data[i] : hi;
+            sum += static_cast<double>(data[i]);
+        }
+        stats.min = lo;
+        stats.max = hi;
+        stats.sum = sum;
+        return stats;
+    }
+
+    void write(const void* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!out_) {
+            throw chunk_processing::SerializationError("Cannot write " + tmp_path_);
+        }
+        crc_ = crc32_update(crc_, data, size);
+        position_ += size;
+    }
+
+    void pad() {
+        static const char zeros[CHUNK_FILE_ALIGNMENT] = {};
+        write(zeros, align_up(position_, CHUNK_FILE_ALIGNMENT) - position_);
+    }
+
+    std::string path_;
+    std::string tmp_path_;
+    ChunkFileOptions options_;
+    std::ofstream out_;
+    chunk_compression::AdaptiveCompressor<T> adaptive_;
+    std::vector<uint64_t> offsets_{0};
+    std::vector<ChunkFileStats<T>> stats_;
+    std::vector<uint8_t> codecs_;
+    ChunkFileFooter footer_{};
+    uint64_t position_ = 0;
+    uint32_t crc_ = 0;
+    bool finished_ = false;
+};
+
+/**
+ * @brief Write a whole chunk set to a chunk file
+ * @throws chunk_processing::SerializationError if the file cannot be written
+ */
+template <typename T>
+void write_chunk_file(const std::string& path, const std::vector<std::vector<T>>& chunks,
+                      ChunkFileOptions options = {}) {
+    ChunkFileWriter<T> writer(path, options);
+    for (const auto& chunk : chunks) {
+        writer.append(chunk);
+    }
+    writer.finish();
+}
+
+/**
+ * @brief A chunk file mapped into memory and read in place
+ *
+ * Views stay valid for the lifetime of the MappedChunkFile (moving it keeps
+ * them valid because the mapping itself does not move).
+ *
+ * @tparam T Value type; must match the type the file was written with
+ */
+template <typename T>
+class CHUNK_EXPORT MappedChunkFile {
+public:
+    /**
+     * @brief Map and validate a chunk file
+     * @param path File written by ChunkFileWriter
+     * @param verify_checksum Verify the CRC-32 of the whole file. This touches
+     *        every page; disable it to open large archives without reading them.
+     * @throws chunk_processing::SerializationError if the file is malformed
+     */
+    explicit MappedChunkFile(const std::string& path, bool verify_checksum = true) : file_(path) {
+        const unsigned char* base = file_.data();
+        const size_t size = file_.size();
+
+        if (size < sizeof(ChunkFileHeader) + sizeof(ChunkFileFooter)) {
+            fail("file too small for header and footer");
+        }
+        std::memcpy(&header_, base, sizeof(header_));
+        if (std::memcmp(header_.magic, CHUNK_FILE_MAGIC, sizeof(header_.magic)) != 0) {
+            fail("bad magic");
+        }
+        if (header_.version != CHUNK_FILE_VERSION) {
+            fail("unsupported version " + std::to_string(header_.version));
+        }
+        if (header_.endian_tag != CHUNK_FILE_ENDIAN_TAG) {
+            fail("byte order does not match this host");
+        }
+        if (header_.header_size != sizeof(ChunkFileHeader)) {
+            fail("unexpected header size");
+        }
+        if (header_.value_type != static_cast<uint32_t>(chunk_value_type_of<T>::value)) {
+            fail("value type does not match the requested type");
+        }
+
+        const size_t footer_offset = size - sizeof(ChunkFileFooter);
+        std::memcpy(&footer_, base + footer_offset, sizeof(footer_));
+        if (std::memcmp(footer_.magic, CHUNK_FILE_END_MAGIC, sizeof(footer_.magic)) != 0) {
+            fail("bad footer magic (truncated?)");
+        }
+        if (verify_checksum && crc32(base, footer_offset) != footer_.checksum) {
+            fail("checksum mismatch");
+        }
+
+        if (footer_.chunk_count >= footer_offset / sizeof(uint64_t)) {
+            fail("chunk count exceeds file size");
+        }
+        validate_section(footer_.values_offset, footer_.value_count, sizeof(T), footer_offset);
+        validate_section(footer_.offsets_offset, footer_.chunk_count + 1, sizeof(uint64_t),
+                         footer_offset);
+        values_ = reinterpret_cast<const T*>(base + footer_.values_offset);
+        offsets_ = reinterpret_cast<const uint64_t*>(base + footer_.offsets_offset);
+        if (offsets_[0] != 0 || offsets_[footer_.chunk_count] != footer_.value_count) {
+            fail("offsets do not cover the values");
+        }
+        for (uint64_t i = 0; i < footer_.chunk_count; ++i) {
+            if (offsets_[i + 1] < offsets_[i]) {
+                fail("offsets are not monotonic");
+            }
+        }
+
+        if ((header_.flags & CHUNK_FILE_FLAG_STATS) != 0) {
+            validate_section(footer_.stats_offset, footer_.chunk_count, sizeof(ChunkFileStats<T>),
+                             footer_offset);
+            stats_ = reinterpret_cast<const ChunkFileStats<T>*>(base + footer_.stats_offset);
+        }
+        if ((header_.flags & CHUNK_FILE_FLAG_CODECS) != 0) {
+            validate_section(footer_.codecs_offset, footer_.chunk_count, 1, footer_offset);
+            codecs_ = base + footer_.codecs_offset;
+            for (uint64_t i = 0; i < footer_.chunk_count; ++i) {
+                if (codecs_[i] >= chunk_compression::CODEC_COUNT) {
+                    fail("unknown codec tag");
+                }
+            }
+        }
+    }
+
+    /// Number of chunks
+    size_t size() const {
+        return static_cast<size_t>(footer_.chunk_count);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /// Number of values across all chunks
+    size_t value_count() const {
+        return static_cast<size_t>(footer_.value_count);
+    }
+
+    /**
+     * @brief Values of chunk i, pointing into the mapping
+     * @throws std::out_of_range if i >= size()
+     */
+    ChunkView<T> chunk(size_t i) const {
+        check_index(i);
+        return ChunkView<T>(values_ + offsets_[i],
+                            static_cast<size_t>(offsets_[i + 1] - offsets_[i]));
+    }
+
+    ChunkView<T> operator[](size_t i) const {
+        return chunk(i);
+    }
+
+    /// Every value of every chunk, back to back
+    ChunkView<T> values() const {
+        return ChunkView<T>(values_, value_count());
+    }
+
+    bool has_statistics() const {
+        return stats_ != nullptr;
+    }
+
+    /**
+     * @throws std::out_of_range if i >= size()
+     * @throws std::logic_error if the file has no statistics
+     */
+    const ChunkFileStats<T>& statistics(size_t i) const {
+        check_index(i);
+        if (!stats_) {
+            throw std::logic_error("Chunk file has no statistics");
+        }
+        return stats_[i];
+    }
+
+    bool has_codec_tags() const {
+        return codecs_ != nullptr;
+    }
+
+    /**
+     * @throws std::out_of_range if i >= size()
+     * @throws std::logic_error if the file has no codec tags
+     */
+    chunk_compression::Codec codec(size_t i) const {
+        check_index(i);
+        if (!codecs_) {
+            throw std::logic_error("Chunk file has no codec tags");
+        }
+        return static_cast<chunk_compression::Codec>(codecs_[i]);
+    }
+
+    /**
+     * @brief Copy every chunk out of the mapping
+     */
+    std::vector<std::vector<T>> to_vectors() const {
+        std::vector<std::vector<T>> chunks(size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            chunks[i] = chunk(i).to_vector();
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief Ask the OS to start paging the file in
+     */
+    void prefetch() const {
+        file_.prefetch();
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw chunk_processing::SerializationError("Invalid chunk file: " + reason);
+    }
+
+    void check_index(size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("Chunk index out of range");
+        }
+    }
+
+    void validate_section(uint64_t offset, uint64_t count, size_t element_size,
+                          size_t limit) const {
+        if (offset % CHUNK_FILE_ALIGNMENT != 0 || offset < sizeof(ChunkFileHeader)) {
+            fail("misaligned section");
+        }
+        if (offset > limit || count > (limit - offset) / element_size) {
+            fail("section exceeds file size");
+        }
+    }
+
+    MappedFile file_;
+    ChunkFileHeader header_{};
+    ChunkFileFooter footer_{};
+    const T* values_ = nullptr;
+    const uint64_t* offsets_ = nullptr;
+    const ChunkFileStats<T>* stats_ = nullptr;
+    const unsigned char* codecs_ = nullptr;
+};
+
+} // namespace chunk_io
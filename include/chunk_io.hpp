@@ -0,0 +1,329 @@
+/**
+ * @file chunk_io.hpp
+ * @brief Low-level I/O helpers shared by the binary on-disk formats
+ *
+ * Provides a table-driven CRC-32, a read-only memory-mapped file and an
+ * atomic whole-file writer. The binary formats (neural model weights,
+ * chunk files, chunk logs) are all built on these primitives.
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include "chunk_errors.hpp"
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+
+#if defined(_WIN32)
+#define CHUNK_IO_NO_MMAP
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chunk_io {
+
+namespace detail {
+
+constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320u;
+
+/**
+ * @brief Slicing-by-8 lookup tables for the reflected CRC-32 polynomial
+ */
+struct Crc32Tables {
+    std::array<std::array<uint32_t, 256>, 8> table{};
+
+    Crc32Tables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1u) ? CRC32_POLYNOMIAL : 0u);
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (size_t slice = 1; slice < 8; ++slice) {
+                uint32_t prev = table[slice - 1][i];
+                table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFFu];
+            }
+        }
+    }
+};
+
+inline const Crc32Tables& crc32_tables() {
+    static const Crc32Tables tables;
+    return tables;
+}
+
+} // namespace detail
+
+/**
+ * @brief Update a running CRC-32 (IEEE 802.3) with more bytes
+ * @param crc Value returned by a previous call, or 0 to start
+ * @param data Bytes to checksum
+ * @param size Number of bytes
+ * @return Updated checksum
+ */
+inline uint32_t crc32_update(uint32_t crc, const void* data, size_t size) {
+    const auto& t = detail::crc32_tables().table;
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+
+    // Process eight bytes per step; the tables fold the byte order in
+    while (size >= 8) {
+        uint32_t lo = crc ^ (static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                             static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24);
+        crc = t[7][lo & 0xFFu] ^ t[6][(lo >> 8) & 0xFFu] ^ t[5][(lo >> 16) & 0xFFu] ^
+              t[4][lo >> 24] ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFFu];
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Compute the CRC-32 of a byte range
+ */
+inline uint32_t crc32(const void* data, size_t size) {
+    return crc32_update(0, data, size);
+}
+
+/**
+ * @brief Round a size or offset up to a multiple of a power-of-two alignment
+ */
+constexpr uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Read-only view of a whole file mapped into memory
+ *
+ * On POSIX systems the file is mapped with mmap so that pages are shared
+ * through the page cache and loaded lazily. Where mmap is unavailable the
+ * file is read into a 64-byte aligned buffer instead, which keeps the
+ * alignment guarantees callers rely on.
+ */
+class CHUNK_EXPORT MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Map a file for reading
+     * @param path File to map
+     * @throws chunk_processing::SerializationError if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path) {
+        open(path);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept {
+        swap(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    void open(const std::string& path) {
+        close();
+#ifndef CHUNK_IO_NO_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw chunk_processing::SerializationError("Cannot open " + path + ": " +
+                                                       std::strerror(errno));
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw chunk_processing::SerializationError("Cannot stat " + path + ": " +
+                                                       std::strerror(err));
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                size_ = 0;
+                throw chunk_processing::SerializationError("Cannot map " + path + ": " +
+                                                           std::strerror(err));
+            }
+            data_ = static_cast<const unsigned char*>(addr);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw chunk_processing::SerializationError("Cannot open " + path);
+        }
+        size_ = static_cast<size_t>(in.tellg());
+        in.seekg(0);
+        if (size_ > 0) {
+            auto* buffer = static_cast<char*>(::operator new(size_, std::align_val_t(64)));
+            if (!in.read(buffer, static_cast<std::streamsize>(size_))) {
+                ::operator delete(buffer, std::align_val_t(64));
+                size_ = 0;
+                throw chunk_processing::SerializationError("Cannot read " + path);
+            }
+            data_ = reinterpret_cast<const unsigned char*>(buffer);
+        }
+#endif
+    }
+
+    void close() {
+        if (data_) {
+#ifndef CHUNK_IO_NO_MMAP
+            ::munmap(const_cast<unsigned char*>(data_), size_);
+#else
+            ::operator delete(const_cast<unsigned char*>(data_), std::align_val_t(64));
+#endif
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Hint that the whole mapping will be read soon
+     */
+    void prefetch() const {
+#ifndef CHUNK_IO_NO_MMAP
+        if (data_) {
+            ::madvise(const_cast<unsigned char*>(data_), size_, MADV_WILLNEED);
+        }
+#endif
+    }
+
+    const unsigned char* data() const {
+        return data_;
+    }
+    size_t size() const {
+        return size_;
+    }
+    bool is_open() const {
+        return data_ != nullptr;
+    }
+
+private:
+    void swap(MappedFile& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Name for a temporary sibling of a file that no other writer will pick
+ *
+ * The name combines the process id with a per-process counter, so concurrent
+ * writers of the same destination, in this or another process, each get
+ * their own temporary file.
+ */
+inline std::string unique_temp_path(const std::string& path) {
+    static std::atomic<uint64_t> counter{0};
+#if defined(_WIN32)
+    const unsigned long long pid = static_cast<unsigned long long>(::_getpid());
+#else
+    const unsigned long long pid = static_cast<unsigned long long>(::getpid());
+#endif
+    return path + ".tmp." + std::to_string(pid) + "." +
+           std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+/**
+ * @brief Flush a written file's contents to stable storage
+ * @throws chunk_processing::SerializationError if the file cannot be opened or synced
+ */
+inline void sync_file(const std::string& path) {
+#if defined(_WIN32)
+    const int fd = ::_open(path.c_str(), _O_RDWR | _O_BINARY);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+#endif
+    if (fd < 0) {
+        throw chunk_processing::SerializationError("Cannot open " + path + ": " +
+                                                   std::strerror(errno));
+    }
+#if defined(_WIN32)
+    const bool ok = ::_commit(fd) == 0;
+    const int err = errno;
+    ::_close(fd);
+#else
+    const bool ok = ::fsync(fd) == 0;
+    const int err = errno;
+    ::close(fd);
+#endif
+    if (!ok) {
+        throw chunk_processing::SerializationError("Cannot sync " + path + ": " +
+                                                   std::strerror(err));
+    }
+}
+
+/**
+ * @brief Write a file atomically by writing a sibling temporary and renaming it
+ *
+ * Readers that map the destination never observe a partially written file.
+ * The temporary is synced before the rename, so after a crash the
+ * destination holds either the old or the complete new contents.
+ *
+ * @param path Destination file
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @throws chunk_processing::SerializationError if writing, syncing or renaming fails
+ */
+inline void write_file_atomic(const std::string& path, const void* data, size_t size) {
+    const std::string tmp_path = unique_temp_path(path);
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw chunk_processing::SerializationError("Cannot create " + tmp_path);
+        }
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        out.close();
+        if (!out) {
+            std::remove(tmp_path.c_str());
+            throw chunk_processing::SerializationError("Cannot write " + tmp_path);
+        }
+    }
+    try {
+        sync_file(tmp_path);
+    } catch (...) {
+        std::remove(tmp_path.c_str());
+        throw;
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw chunk_processing::SerializationError("Cannot rename " + tmp_path + " to " + path);
+    }
+}
+
+} // namespace chunk_io
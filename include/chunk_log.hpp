@@ -0,0 +1,553 @@
+/**
+ * @file chunk_log.hpp
+ * @brief Append-only, crash-safe chunk log with group commit
+ *
+ * A log is a directory of segment files named after the sequence number of
+ * their first record. Segment layout (host byte order):
+ *
+ *   [ChunkLogSegmentHeader, 24 bytes]
+ *   per record: [ChunkLogRecordHeader, 16 bytes][values][padding to 8 bytes]
+ *
+ * Each record's CRC-32 covers its values, length and sequence number.
+ * Concurrent appenders share fsyncs: the first appender to find no commit
+ * in flight becomes the leader, optionally waits up to commit_delay for
+ * more records, then writes and syncs the whole batch for everyone.
+ * Opening a log scans it up to the last valid record and cuts off a torn
+ * tail left by a crash.
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include "chunk_errors.hpp"
+#include "chunk_file.hpp"
+#include "chunk_io.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace chunk_io {
+
+constexpr char CHUNK_LOG_MAGIC[4] = {'C', 'L', 'O', 'G'};
+constexpr uint32_t CHUNK_LOG_VERSION = 1;
+constexpr size_t CHUNK_LOG_RECORD_ALIGNMENT = 8;
+
+/**
+ * @brief Fixed 24-byte segment header
+ */
+struct ChunkLogSegmentHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t value_type;
+    uint32_t reserved;
+    uint64_t first_sequence; ///< Sequence number of the segment's first record
+};
+static_assert(sizeof(ChunkLogSegmentHeader) == 24, "ChunkLogSegmentHeader layout must stay fixed");
+
+/**
+ * @brief Fixed 16-byte record header; the values follow
+ */
+struct ChunkLogRecordHeader {
+    uint32_t payload_bytes;
+    uint32_t checksum; ///< CRC-32 of the values, then payload_bytes, then sequence
+    uint64_t sequence;
+};
+static_assert(sizeof(ChunkLogRecordHeader) == 16, "ChunkLogRecordHeader layout must stay fixed");
+
+/**
+ * @brief Durability and batching settings of a ChunkLog
+ */
+struct ChunkLogOptions {
+    /// Start a new segment once the current one reaches this size
+    uint64_t segment_bytes = uint64_t{64} << 20;
+    /// Longest time a commit leader waits for more records before syncing.
+    /// Zero still batches every record appended while the previous sync ran.
+    std::chrono::microseconds commit_delay{0};
+    /// A leader stops waiting once this many bytes are pending
+    size_t commit_bytes = size_t{1} << 20;
+    /// fsync each commit; disable only where losing recent records on power loss is acceptable
+    bool sync = true;
+};
+
+namespace detail {
+
+inline uint32_t log_record_checksum(uint32_t payload_crc, uint32_t payload_bytes,
+                                    uint64_t sequence) {
+    uint32_t crc = crc32_update(payload_crc, &payload_bytes, sizeof(payload_bytes));
+    return crc32_update(crc, &sequence, sizeof(sequence));
+}
+
+inline std::string log_segment_name(uint64_t first_sequence) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020llu.clog",
+                  static_cast<unsigned long long>(first_sequence));
+    return name;
+}
+
+/**
+ * @brief Segment files of a log directory, in sequence order
+ */
+inline std::vector<std::filesystem::path> log_segments(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> segments;
+    if (!std::filesystem::is_directory(directory)) {
+        return segments;
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        const auto name = entry.path().filename().string();
+        if (entry.is_regular_file() && name.size() == 25 &&
+            name.compare(20, 5, ".clog") == 0) {
+            segments.push_back(entry.path());
+        }
+    }
+    // Zero-padded names sort in sequence order
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+/**
+ * @brief Valid prefix of one segment
+ */
+struct LogSegmentScan {
+    bool header_valid = false;
+    uint64_t valid_bytes = 0;   ///< Bytes up to the end of the last valid record
+    uint64_t next_sequence = 0; ///< Sequence expected after the last valid record
+    bool complete = false;      ///< Every byte of the segment belongs to a valid record
+};
+
+/**
+ * @brief Walk the valid records of a mapped segment
+ * @param fn Called as fn(sequence, values, count) for each valid record
+ */
+template <typename T, typename Fn>
+LogSegmentScan scan_log_segment(const MappedFile& file, uint64_t expected_sequence, Fn&& fn) {
+    LogSegmentScan scan;
+    const unsigned char* base = file.data();
+    const size_t size = file.size();
+    ChunkLogSegmentHeader header;
+    if (size < sizeof(header)) {
+        return scan;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, CHUNK_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHUNK_LOG_VERSION ||
+        header.value_type != static_cast<uint32_t>(chunk_value_type_of<T>::value) ||
+        header.first_sequence != expected_sequence) {
+        return scan;
+    }
+    scan.header_valid = true;
+    scan.next_sequence = expected_sequence;
+    size_t pos = sizeof(header);
+    while (size - pos >= sizeof(ChunkLogRecordHeader)) {
+        ChunkLogRecordHeader record;
+        std::memcpy(&record, base + pos, sizeof(record));
+        const size_t payload = pos + sizeof(record);
+        if (record.sequence != scan.next_sequence || record.payload_bytes % sizeof(T) != 0 ||
+            record.payload_bytes > size - payload) {
+            break;
+        }
+        // A record cut off in its padding is torn too: appends must resume aligned
+        const uint64_t record_end =
+            align_up(payload + record.payload_bytes, CHUNK_LOG_RECORD_ALIGNMENT);
+        if (record_end > size) {
+            break;
+        }
+        const uint32_t crc = crc32(base + payload, record.payload_bytes);
+        if (log_record_checksum(crc, record.payload_bytes, record.sequence) != record.checksum) {
+            break;
+        }
+        fn(record.sequence, reinterpret_cast<const T*>(base + payload),
+           record.payload_bytes / sizeof(T));
+        pos = static_cast<size_t>(record_end);
+        ++scan.next_sequence;
+    }
+    scan.valid_bytes = pos;
+    scan.complete = pos == size;
+    return scan;
+}
+
+/**
+ * @brief Minimal file-descriptor wrapper for appending and syncing segments
+ */
+class LogFile {
+public:
+    LogFile() = default;
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    ~LogFile() {
+        close();
+    }
+
+    void open_append(const std::string& path) {
+        close();
+#if defined(_WIN32)
+        fd_ = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+                      _S_IREAD | _S_IWRITE);
+#else
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+        if (fd_ < 0) {
+            throw chunk_processing::SerializationError("Cannot open " + path + ": " +
+                                                       std::strerror(errno));
+        }
+        path_ = path;
+    }
+
+    void write(const void* data, size_t size) {
+        const auto* p = static_cast<const char*>(data);
+        while (size > 0) {
+#if defined(_WIN32)
+            const int chunk = static_cast<int>(std::min<size_t>(size, 1u << 30));
+            const auto written = ::_write(fd_, p, static_cast<unsigned>(chunk));
+#else
+            const auto written = ::write(fd_, p, size);
+#endif
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw chunk_processing::SerializationError("Cannot write " + path_ + ": " +
+                                                           std::strerror(errno));
+            }
+            p += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    void sync() {
+#if defined(_WIN32)
+        const bool ok = ::_commit(fd_) == 0;
+#elif defined(__APPLE__)
+        const bool ok = ::fsync(fd_) == 0;
+#else
+        const bool ok = ::fdatasync(fd_) == 0;
+#endif
+        if (!ok) {
+            throw chunk_processing::SerializationError("Cannot sync " + path_ + ": " +
+                                                       std::strerror(errno));
+        }
+    }
+
+    void close() {
+        if (fd_ >= 0) {
+#if defined(_WIN32)
+            ::_close(fd_);
+#else
+            ::close(fd_);
+#endif
+        }
+        fd_ = -1;
+    }
+
+private:
+    int fd_ = -1;
+    std::string path_;
+};
+
+/**
+ * @brief Make a newly created segment's directory entry durable
+ */
+inline void sync_directory(const std::filesystem::path& directory) {
+#if !defined(_WIN32)
+    const int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Durable, append-only log of chunks
+ *
+ * append() returns once the record is on stable storage (with sync
+ * enabled). It is safe to call from many threads; their records are
+ * written and synced in batches. Sequence numbers are dense and start at 0.
+ *
+ * @tparam T Value type (any ChunkValueType)
+ */
+template <typename T>
+class CHUNK_EXPORT ChunkLog {
+public:
+    /**
+     * @brief Open or create the log in a directory and recover its valid prefix
+     *
+     * A torn or corrupt record ends the log: the segment holding it is
+     * truncated before it, and any later segments are deleted.
+     *
+     * @throws chunk_processing::SerializationError if the directory cannot be used or a
+     *         segment holds a different value type
+     */
+    explicit ChunkLog(const std::string& directory, ChunkLogOptions options = {})
+        : directory_(directory), options_(options) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory_, ec);
+        if (!std::filesystem::is_directory(directory_)) {
+            throw chunk_processing::SerializationError("Cannot create log directory " +
+                                                       directory);
+        }
+        recover();
+    }
+
+    ChunkLog(const ChunkLog&) = delete;
+    ChunkLog& operator=(const ChunkLog&) = delete;
+
+    ~ChunkLog() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return !committing_; });
+    }
+
+    /**
+     * @brief Append one chunk and wait until it is durable
+     * @return Sequence number of the record
+     * @throws std::invalid_argument if the chunk exceeds 4 GiB
+     * @throws chunk_processing::SerializationError if this or an earlier commit failed
+     */
+    uint64_t append(const T* data, size_t n) {
+        if (n > (std::numeric_limits<uint32_t>::max() - CHUNK_LOG_RECORD_ALIGNMENT) / sizeof(T)) {
+            throw std::invalid_argument("Chunk too large for a log record");
+        }
+        ChunkLogRecordHeader record{};
+        record.payload_bytes = static_cast<uint32_t>(n * sizeof(T));
+        const uint32_t payload_crc = crc32(data, record.payload_bytes);
+        const size_t padded = static_cast<size_t>(
+            align_up(sizeof(record) + record.payload_bytes, CHUNK_LOG_RECORD_ALIGNMENT));
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        check_failed();
+        record.sequence = next_sequence_++;
+        record.checksum =
+            detail::log_record_checksum(payload_crc, record.payload_bytes, record.sequence);
+        const size_t offset = pending_.size();
+        pending_.resize(offset + padded);
+        std::memcpy(pending_.data() + offset, &record, sizeof(record));
+        if (record.payload_bytes > 0) {
+            std::memcpy(pending_.data() + offset + sizeof(record), data, record.payload_bytes);
+        }
+        std::memset(pending_.data() + offset + sizeof(record) + record.payload_bytes, 0,
+                    padded - sizeof(record) - record.payload_bytes);
+        if (committing_ && pending_.size() >= options_.commit_bytes) {
+            cv_.notify_all(); // end the leader's commit_delay early
+        }
+
+        while (durable_sequence_ <= record.sequence) {
+            if (!committing_) {
+                commit(lock);
+            } else {
+                cv_.wait(lock);
+            }
+            check_failed();
+        }
+        return record.sequence;
+    }
+
+    uint64_t append(const std::vector<T>& chunk) {
+        return append(chunk.data(), chunk.size());
+    }
+
+    /// Sequence number the next append will get (the number of records in the log)
+    uint64_t next_sequence() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return next_sequence_;
+    }
+
+    /// Number of batched writes so far; at most one sync each
+    uint64_t commit_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return commit_count_;
+    }
+
+    const std::string& directory() const {
+        return directory_;
+    }
+
+private:
+    void recover() {
+        const auto segments = detail::log_segments(directory_);
+        uint64_t sequence = 0;
+        size_t kept = 0;
+        for (; kept < segments.size(); ++kept) {
+            MappedFile file(segments[kept].string());
+            check_value_type(file, segments[kept]);
+            auto scan = detail::scan_log_segment<T>(file, sequence,
+                                                    [](uint64_t, const T*, size_t) {});
+            if (!scan.header_valid) {
+                break;
+            }
+            sequence = scan.next_sequence;
+            segment_size_ = scan.valid_bytes;
+            if (!scan.complete) {
+                file.close();
+                std::filesystem::resize_file(segments[kept], scan.valid_bytes);
+                ++kept;
+                break;
+            }
+        }
+        for (size_t i = kept; i < segments.size(); ++i) {
+            std::filesystem::remove(segments[i]);
+        }
+        next_sequence_ = durable_sequence_ = sequence;
+        if (kept == 0) {
+            open_segment(sequence);
+        } else {
+            file_.open_append(segments[kept - 1].string());
+        }
+    }
+
+    void check_value_type(const MappedFile& file, const std::filesystem::path& path) const {
+        ChunkLogSegmentHeader header;
+        if (file.size() >= sizeof(header)) {
+            std::memcpy(&header, file.data(), sizeof(header));
+            if (std::memcmp(header.magic, CHUNK_LOG_MAGIC, sizeof(header.magic)) == 0 &&
+                header.value_type != static_cast<uint32_t>(chunk_value_type_of<T>::value)) {
+                throw chunk_processing::SerializationError(
+                    "Log segment " + path.string() + " holds a different value type");
+            }
+        }
+    }
+
+    /// Create a segment starting at first_sequence and make it durable
+    void open_segment(uint64_t first_sequence) {
+        const auto path =
+            std::filesystem::path(directory_) / detail::log_segment_name(first_sequence);
+        ChunkLogSegmentHeader header{};
+        std::memcpy(header.magic, CHUNK_LOG_MAGIC, sizeof(header.magic));
+        header.version = CHUNK_LOG_VERSION;
+        header.value_type = static_cast<uint32_t>(chunk_value_type_of<T>::value);
+        header.first_sequence = first_sequence;
+        file_.open_append(path.string());
+        file_.write(&header, sizeof(header));
+        if (options_.sync) {
+            file_.sync();
+            detail::sync_directory(directory_);
+        }
+        segment_size_ = sizeof(header);
+    }
+
+    /// Leader side of group commit; called and returns with the lock held
+    void commit(std::unique_lock<std::mutex>& lock) {
+        committing_ = true;
+        if (options_.commit_delay.count() > 0) {
+            cv_.wait_for(lock, options_.commit_delay,
+                         [&] { return pending_.size() >= options_.commit_bytes; });
+        }
+        std::vector<uint8_t> batch;
+        batch.swap(pending_);
+        pending_.swap(spare_);
+        const uint64_t first = durable_sequence_;
+        const uint64_t end = next_sequence_;
+        lock.unlock();
+
+        std::string error;
+        try {
+            if (segment_size_ >= options_.segment_bytes &&
+                segment_size_ > sizeof(ChunkLogSegmentHeader)) {
+                if (options_.sync) {
+                    file_.sync();
+                }
+                open_segment(first);
+            }
+            file_.write(batch.data(), batch.size());
+            if (options_.sync) {
+                file_.sync();
+            }
+            segment_size_ += batch.size();
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        lock.lock();
+        committing_ = false;
+        ++commit_count_;
+        if (error.empty()) {
+            durable_sequence_ = end;
+        } else {
+            failure_ = error;
+        }
+        batch.clear();
+        spare_.swap(batch);
+        cv_.notify_all();
+    }
+
+    void check_failed() const {
+        if (!failure_.empty()) {
+            throw chunk_processing::SerializationError("Chunk log commit failed: " + failure_);
+        }
+    }
+
+    std::string directory_;
+    ChunkLogOptions options_;
+    detail::LogFile file_;
+    uint64_t segment_size_ = 0; ///< Only touched by the commit leader
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<uint8_t> pending_; ///< Encoded records waiting for the next commit
+    std::vector<uint8_t> spare_;   ///< Reused as the next pending buffer
+    uint64_t next_sequence_ = 0;
+    uint64_t durable_sequence_ = 0; ///< Every record below this sequence is durable
+    uint64_t commit_count_ = 0;
+    bool committing_ = false;
+    std::string failure_;
+};
+
+/**
+ * @brief Visit every valid record of a log in sequence order
+ *
+ * Segments are mapped one at a time; the view passed to fn points into the
+ * mapping and is only valid during the call. Replay stops at the first
+ * invalid record, as recovery would.
+ *
+ * @param directory Log directory
+ * @param fn Called as fn(uint64_t sequence, ChunkView<T> values)
+ */
+template <typename T, typename Fn>
+void replay_chunk_log(const std::string& directory, Fn&& fn) {
+    uint64_t sequence = 0;
+    for (const auto& path : detail::log_segments(directory)) {
+        MappedFile file(path.string());
+        auto scan = detail::scan_log_segment<T>(
+            file, sequence,
+            [&](uint64_t seq, const T* values, size_t n) { fn(seq, ChunkView<T>(values, n)); });
+        if (!scan.header_valid || !scan.complete) {
+            return;
+        }
+        sequence = scan.next_sequence;
+    }
+}
+
+/**
+ * @brief Read every valid record of a log into memory
+ */
+template <typename T>
+std::vector<std::vector<T>> read_chunk_log(const std::string& directory) {
+    std::vector<std::vector<T>> chunks;
+    replay_chunk_log<T>(directory, [&](uint64_t, ChunkView<T> values) {
+        chunks.push_back(values.to_vector());
+    });
+    return chunks;
+}
+
+} // namespace chunk_io
@@ -7,13 +7,398 @@
 
 #pragma once
 #include "chunk_common.hpp"
+#include "chunk_thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 namespace chunk_metrics {
 
+/**
+ * @brief Summary statistics of one chunk, accumulated with Welford's method
+ *
+ * Statistics of disjoint parts combine exactly with merge(), so a table of
+ * these is enough to derive every mean- and variance-based metric.
+ */
+struct ChunkStatistics {
+    size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0; ///< Sum of squared deviations from the mean
+    double min = 0.0;
+    double max = 0.0;
+
+    void add(double value) {
+        if (count == 0) {
+            min = max = value;
+        } else {
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+        ++count;
+        const double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+
+    /// Combine with the statistics of a disjoint set of values
+    void merge(const ChunkStatistics& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        const double n_a = static_cast<double>(count);
+        const double n_b = static_cast<double>(other.count);
+        const double delta = other.mean - mean;
+        const double n = n_a + n_b;
+        mean += delta * n_b / n;
+        m2 += other.m2 + delta * delta * n_a * n_b / n;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        count += other.count;
+    }
+
+    /// Sample variance (0 for fewer than two values)
+    double variance() const {
+        return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+    }
+
+    template <typename T>
+    static ChunkStatistics of(const std::vector<T>& chunk) {
+        ChunkStatistics stats;
+        for (const T& value : chunk) {
+            stats.add(static_cast<double>(value));
+        }
+        return stats;
+    }
+};
+
+/**
+ * @brief Bounds for the per-chunk statistics cache of ChunkQualityAnalyzer
+ *
+ * Each entry takes roughly 128 bytes, so the default bound is about 8 MiB.
+ */
+struct MetricsCacheOptions {
+    size_t max_entries = size_t{1} << 16; ///< Least recently used entries are evicted beyond this
+    size_t min_chunk_size = 64; ///< Smaller chunks are cheaper to recompute than to look up
+};
+
+/**
+ * @brief Silhouette score estimated from a random sample of points
+ */
+struct SilhouetteEstimate {
+    double score = 0.0;      ///< Mean silhouette of the sampled points
+    double half_width = 0.0; ///< The exact score is within score +/- half_width...
+    double confidence = 0.0; ///< ...with at least this probability (Hoeffding bound)
+    size_t samples = 0;      ///< Number of points evaluated
+    bool exact = false;      ///< True when every point was evaluated and score is exact
+};
+
+namespace detail {
+
+/**
+ * @brief Sorted per-chunk values and prefix sums for exact 1-D silhouette queries
+ *
+ * The summed distance from x to a sorted set splits at x into
+ * x * below - sum(below) + sum(above) - x * above, so each query is one
+ * binary search. For the nearest other chunk, chunks are visited in order of
+ * |x - mean|, a lower bound on their mean distance to x, and the search stops
+ * once no remaining chunk can beat the best found. Sorted copies are built on
+ * first use, so a sampled estimate only sorts the chunks it touches.
+ */
+template <typename T>
+class SilhouetteIndex {
+public:
+    explicit SilhouetteIndex(const std::vector<std::vector<T>>& chunks)
+        : chunks_(chunks), sorted_(chunks.size()), built_(new std::once_flag[chunks.size()]) {
+        std::vector<double> means(chunks.size(), 0.0);
+        for (size_t j = 0; j < chunks.size(); ++j) {
+            if (chunks[j].empty()) {
+                continue; // Empty chunks never contribute a mean distance
+            }
+            double sum = 0.0;
+            for (const T& value : chunks[j]) {
+                sum += static_cast<double>(value);
+            }
+            means[j] = sum / static_cast<double>(chunks[j].size());
+            by_mean_.push_back(j);
+        }
+        std::sort(by_mean_.begin(), by_mean_.end(),
+                  [&](size_t a, size_t b) { return means[a] < means[b]; });
+        sorted_means_.reserve(by_mean_.size());
+        for (size_t j : by_mean_) {
+            sorted_means_.push_back(means[j]);
+        }
+    }
+
+    /// Sort every chunk up front, one chunk per task
+    void build_all(chunk_processing::ThreadPool& pool) {
+        pool.parallel_for(0, chunks_.size(), 1, [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                sorted(j);
+            }
+        });
+    }
+
+    /// Silhouette of value x belonging to chunk i
+    double point_score(size_t i, double x) {
+        const size_t own_size = chunks_[i].size();
+        const double a =
+            own_size > 1 ? distance_sum(i, x) / static_cast<double>(own_size - 1) : 0.0;
+
+        double b = std::numeric_limits<double>::max();
+        size_t hi = static_cast<size_t>(
+            std::lower_bound(sorted_means_.begin(), sorted_means_.end(), x) -
+            sorted_means_.begin());
+        size_t lo = hi;
+        while (lo > 0 || hi < sorted_means_.size()) {
+            const bool up = lo == 0 || (hi < sorted_means_.size() &&
+                                        sorted_means_[hi] - x <= x - sorted_means_[lo - 1]);
+            const size_t pos = up ? hi++ : --lo;
+            if (std::abs(x - sorted_means_[pos]) >= b) {
+                break; // The other direction is at least as far away
+            }
+            const size_t j = by_mean_[pos];
+            if (j != i) {
+                b = std::min(b, distance_sum(j, x) / static_cast<double>(chunks_[j].size()));
+            }
+        }
+
+        const double max_ab = std::max(a, b);
+        return max_ab > 0 ? (b - a) / max_ab : 0.0;
+    }
+
+private:
+    struct SortedChunk {
+        std::vector<double> values;
+        std::vector<double> prefix; ///< prefix[k] = sum of the k smallest values
+    };
+
+    const SortedChunk& sorted(size_t j) {
+        std::call_once(built_[j], [&]() {
+            SortedChunk& s = sorted_[j];
+            s.values.assign(chunks_[j].begin(), chunks_[j].end());
+            std::sort(s.values.begin(), s.values.end());
+            s.prefix.resize(s.values.size() + 1);
+            long double running = 0.0L;
+            s.prefix[0] = 0.0;
+            for (size_t k = 0; k < s.values.size(); ++k) {
+                running += s.values[k];
+                s.prefix[k + 1] = static_cast<double>(running);
+            }
+        });
+        return sorted_[j];
+    }
+
+    double distance_sum(size_t j, double x) {
+        const SortedChunk& s = sorted(j);
+        const size_t n = s.values.size();
+        const size_t below = static_cast<size_t>(
+            std::upper_bound(s.values.begin(), s.values.end(), x) - s.values.begin());
+        const double sum = x * static_cast<double>(below) - s.prefix[below] +
+                           (s.prefix[n] - s.prefix[below]) - x * static_cast<double>(n - below);
+        return std::max(sum, 0.0);
+    }
+
+    const std::vector<std::vector<T>>& chunks_;
+    std::vector<SortedChunk> sorted_;
+    std::unique_ptr<std::once_flag[]> built_;
+    std::vector<size_t> by_mean_;
+    std::vector<double> sorted_means_;
+};
+
+/**
+ * @brief Mean absolute difference over all pairs of values, in O(k log k)
+ *
+ * After sorting, value i exceeds each of the i values before it, so the
+ * pairwise sum is sum(i * v[i] - prefix[i]).
+ */
+inline double mean_pair_difference(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    double total = 0.0;
+    double prefix = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        total += values[i] * static_cast<double>(i) - prefix;
+        prefix += values[i];
+    }
+    const double pairs = static_cast<double>(values.size()) * (values.size() - 1) / 2.0;
+    return total / pairs;
+}
+
+/**
+ * @brief 64-bit content fingerprint in the style of xxHash64
+ *
+ * Four independent lanes keep the multiplier pipeline busy, so hashing a
+ * chunk costs a small fraction of computing its statistics.
+ */
+inline uint64_t fingerprint(const void* data, size_t size) {
+    constexpr uint64_t P1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t P3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ull;
+    auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+    auto load = [](const uint8_t* p) {
+        uint64_t w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+    };
+    auto round = [&](uint64_t acc, uint64_t w) { return rotl(acc + w * P2, 31) * P1; };
+
+    const auto* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t h;
+    if (size >= 32) {
+        uint64_t lanes[4] = {P1 + P2, P2, 0, 0 - P1};
+        for (; p + 32 <= end; p += 32) {
+            for (int lane = 0; lane < 4; ++lane) {
+                lanes[lane] = round(lanes[lane], load(p + 8 * lane));
+            }
+        }
+        h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        for (uint64_t lane : lanes) {
+            h = (h ^ round(0, lane)) * P1 + P4;
+        }
+    } else {
+        h = P3;
+    }
+    h += size;
+    for (; p + 8 <= end; p += 8) {
+        h = rotl(h ^ round(0, load(p)), 27) * P1 + P4;
+    }
+    for (; p < end; ++p) {
+        h = rotl(h ^ (*p * P3), 11) * P1;
+    }
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    return h ^ (h >> 32);
+}
+
+/**
+ * @brief Thread-safe LRU map from chunk fingerprints to ChunkStatistics
+ *
+ * Split into independently locked shards so a parallel statistics pass does
+ * not serialize on one mutex. Keys carry the chunk length alongside the
+ * 64-bit fingerprint.
+ */
+class StatisticsCache {
+public:
+    struct Key {
+        uint64_t hash;
+        uint64_t size;
+        bool operator==(const Key& other) const {
+            return hash == other.hash && size == other.size;
+        }
+    };
+
+    explicit StatisticsCache(const MetricsCacheOptions& options) : options_(options) {
+        const size_t per_shard = (options.max_entries + SHARDS - 1) / SHARDS;
+        for (auto& shard : shards_) {
+            shard.capacity = per_shard;
+        }
+    }
+
+    const MetricsCacheOptions& options() const {
+        return options_;
+    }
+
+    bool find(const Key& key, ChunkStatistics& stats) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        stats = it->second->second;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void insert(const Key& key, const ChunkStatistics& stats) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.capacity == 0 || shard.index.count(key)) {
+            return;
+        }
+        if (shard.entries.size() >= shard.capacity) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+        shard.entries.emplace_front(key, stats);
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.entries.clear();
+        }
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+    size_t hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    size_t misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>(key.hash ^ (key.size * 0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        size_t capacity = 0;
+        std::list<std::pair<Key, ChunkStatistics>> entries; ///< Most recently used first
+        std::unordered_map<Key, decltype(entries)::iterator, KeyHash> index;
+    };
+
+    Shard& shard_for(const Key& key) {
+        return shards_[key.hash >> 60];
+    }
+
+    MetricsCacheOptions options_;
+    Shard shards_[SHARDS];
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+};
+
+} // namespace detail
+
 /**
  * @brief Class for analyzing and evaluating chunk quality
  * @tparam T The data type of the chunks (must support arithmetic operations)
@@ -21,6 +406,36 @@ namespace chunk_metrics {
 template <typename T>
 class CHUNK_EXPORT ChunkQualityAnalyzer {
 public:
+    /**
+     * @brief Create an analyzer
+     *
+     * Per-chunk statistics are cached by content fingerprint, so evaluating
+     * the same or overlapping chunkings again reuses them. Copies of an
+     * analyzer share its cache.
+     *
+     * @param pool Pool for parallel metrics (nullptr uses ThreadPool::shared())
+     * @param cache Bounds for the statistics cache (max_entries 0 disables it)
+     */
+    explicit ChunkQualityAnalyzer(chunk_processing::ThreadPool* pool = nullptr,
+                                  const MetricsCacheOptions& cache = {})
+        : pool_(pool ? pool : &chunk_processing::ThreadPool::shared()),
+          cache_(std::make_shared<detail::StatisticsCache>(cache)) {}
+
+    /**
+     * @brief Compute count, mean, M2, min and max of every chunk in one parallel pass
+     * @param chunks Vector of chunk data
+     * @return One entry per chunk, in order
+     */
+    std::vector<ChunkStatistics> compute_statistics(const std::vector<std::vector<T>>& chunks) {
+        std::vector<ChunkStatistics> stats(chunks.size());
+        pool_->parallel_for(0, chunks.size(), 1, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                stats[i] = cached_statistics(chunks[i]);
+            }
+        });
+        return stats;
+    }
+
     /**
      * @brief Calculate cohesion (internal similarity) of chunks
      * @param chunks Vector of chunk data
@@ -31,20 +446,7 @@ public:
         if (chunks.empty()) {
             throw std::invalid_argument("Empty chunks vector");
         }
-
-        double total_cohesion = 0.0;
-        for (const auto& chunk : chunks) {
-            if (chunk.empty())
-                continue;
-
-            T mean = calculate_mean(chunk);
-            T variance = calculate_variance(chunk, mean);
-
-            // Normalize variance to [0,1] range
-            total_cohesion += 1.0 / (1.0 + std::sqrt(variance));
-        }
-
-        return total_cohesion / chunks.size();
+        return cohesion_from_statistics(compute_statistics(chunks));
     }
 
     /**
@@ -57,27 +459,56 @@ public:
         if (chunks.size() < 2) {
             throw std::invalid_argument("Need at least two chunks for separation");
         }
+        return separation_from_statistics(compute_statistics(chunks));
+    }
 
-        double total_separation = 0.0;
-        int comparisons = 0;
-
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            for (size_t j = i + 1; j < chunks.size(); ++j) {
-                T mean_i = calculate_mean(chunks[i]);
-                T mean_j = calculate_mean(chunks[j]);
-
-                // Calculate distance between means
-                double separation = std::abs(mean_i - mean_j);
-                total_separation += separation;
-                ++comparisons;
+    /**
+     * @brief Cohesion from precomputed chunk statistics
+     *
+     * Each non-empty chunk contributes 1 / (1 + stddev); the sum is averaged
+     * over all chunks, empty ones included.
+     *
+     * @throws std::invalid_argument if stats is empty
+     */
+    static double cohesion_from_statistics(const std::vector<ChunkStatistics>& stats) {
+        if (stats.empty()) {
+            throw std::invalid_argument("Empty chunks vector");
+        }
+        double total_cohesion = 0.0;
+        for (const auto& chunk : stats) {
+            if (chunk.count > 0) {
+                total_cohesion += 1.0 / (1.0 + std::sqrt(chunk.variance()));
             }
         }
+        return total_cohesion / stats.size();
+    }
 
-        return total_separation / comparisons;
+    /**
+     * @brief Mean absolute difference between the means of all chunk pairs
+     *
+     * Uses sorted means and a running prefix sum, O(k log k) instead of
+     * visiting all k(k-1)/2 pairs. Empty chunks count with mean 0.
+     *
+     * @throws std::invalid_argument if there are fewer than two entries
+     */
+    static double separation_from_statistics(const std::vector<ChunkStatistics>& stats) {
+        if (stats.size() < 2) {
+            throw std::invalid_argument("Need at least two chunks for separation");
+        }
+        std::vector<double> means(stats.size());
+        for (size_t i = 0; i < stats.size(); ++i) {
+            means[i] = stats[i].mean;
+        }
+        return detail::mean_pair_difference(std::move(means));
     }
 
     /**
      * @brief Calculate silhouette score for chunk validation
+     *
+     * For arithmetic T the score is exact in O(N log N): chunks are scored in
+     * parallel against sorted per-chunk prefix sums instead of comparing every
+     * pair of points.
+     *
      * @param chunks Vector of chunk data
      * @return Silhouette score between -1 and 1
      * @throws std::invalid_argument if chunks is empty or contains single chunk
@@ -86,44 +517,102 @@ public:
         if (chunks.size() < 2) {
             throw std::invalid_argument("Need at least two chunks for silhouette score");
         }
-
-        double total_score = 0.0;
-        size_t total_points = 0;
-
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            for (const auto& point : chunks[i]) {
-                // Calculate a (average distance to points in same chunk)
-                double a = 0.0;
-                for (const auto& other_point : chunks[i]) {
-                    if (&point != &other_point) {
-                        a += std::abs(point - other_point);
-                    }
-                }
-                a = chunks[i].size() > 1 ? a / (chunks[i].size() - 1) : 0;
-
-                // Calculate b (minimum average distance to points in other chunks)
-                double b = std::numeric_limits<double>::max();
-                for (size_t j = 0; j < chunks.size(); ++j) {
-                    if (i != j) {
-                        double avg_dist = 0.0;
-                        for (const auto& other_point : chunks[j]) {
-                            avg_dist += std::abs(point - other_point);
-                        }
-                        avg_dist /= chunks[j].size();
-                        b = std::min(b, avg_dist);
+        if constexpr (!std::is_arithmetic<T>::value) {
+            return compute_silhouette_pairwise(chunks);
+        } else {
+            detail::SilhouetteIndex<T> index(chunks);
+            index.build_all(*pool_);
+            std::vector<double> chunk_scores(chunks.size(), 0.0);
+            pool_->parallel_for(0, chunks.size(), 1, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    double sum = 0.0;
+                    for (const T& value : chunks[i]) {
+                        sum += index.point_score(i, static_cast<double>(value));
                     }
+                    chunk_scores[i] = sum;
                 }
+            });
 
-                // Calculate silhouette score for this point
-                double max_ab = std::max(a, b);
-                if (max_ab > 0) {
-                    total_score += (b - a) / max_ab;
-                }
-                ++total_points;
+            size_t total_points = 0;
+            for (const auto& chunk : chunks) {
+                total_points += chunk.size();
             }
+            return std::accumulate(chunk_scores.begin(), chunk_scores.end(), 0.0) /
+                   total_points;
         }
+    }
 
-        return total_score / total_points;
+    /**
+     * @brief Estimate the silhouette score from uniformly sampled points
+     *
+     * Each sampled point's silhouette is exact; only the chunks holding the
+     * sampled points and their nearest neighbours are sorted. Inputs with at
+     * most sample_size points are scored exactly.
+     *
+     * @param chunks Vector of chunk data
+     * @param sample_size Number of points to draw (with replacement)
+     * @param confidence Probability that the exact score lies within the returned bound
+     * @param seed Seed for the point sampler
+     * @return Estimate, its Hoeffding half-width and the number of points evaluated
+     * @throws std::invalid_argument if there are fewer than two chunks, no points,
+     *         sample_size is 0 or confidence is not in (0, 1)
+     */
+    SilhouetteEstimate estimate_silhouette_score(const std::vector<std::vector<T>>& chunks,
+                                                 size_t sample_size, double confidence = 0.95,
+                                                 uint64_t seed = 0x5EED) {
+        static_assert(std::is_arithmetic<T>::value,
+                      "Sampled silhouette requires arithmetic chunk values");
+        if (chunks.size() < 2) {
+            throw std::invalid_argument("Need at least two chunks for silhouette score");
+        }
+        if (sample_size == 0) {
+            throw std::invalid_argument("Sample size must be positive");
+        }
+        if (!(confidence > 0.0 && confidence < 1.0)) {
+            throw std::invalid_argument("Confidence must be in (0, 1)");
+        }
+        std::vector<size_t> ends(chunks.size());
+        size_t total_points = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            total_points += chunks[i].size();
+            ends[i] = total_points;
+        }
+        if (total_points == 0) {
+            throw std::invalid_argument("Chunks contain no points");
+        }
+
+        SilhouetteEstimate estimate;
+        estimate.confidence = confidence;
+        if (sample_size >= total_points) {
+            estimate.score = compute_silhouette_score(chunks);
+            estimate.samples = total_points;
+            estimate.exact = true;
+            return estimate;
+        }
+
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<size_t> pick(0, total_points - 1);
+        std::vector<size_t> points(sample_size);
+        for (auto& point : points) {
+            point = pick(rng);
+        }
+        detail::SilhouetteIndex<T> index(chunks);
+        std::vector<double> scores(sample_size);
+        pool_->parallel_for(0, sample_size, 64, [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) {
+                const size_t i = static_cast<size_t>(
+                    std::upper_bound(ends.begin(), ends.end(), points[k]) - ends.begin());
+                const size_t offset = points[k] - (i == 0 ? 0 : ends[i - 1]);
+                scores[k] = index.point_score(i, static_cast<double>(chunks[i][offset]));
+            }
+        });
+
+        // Per-point scores lie in [-1, 1]: P(|mean - score| >= t) <= 2 exp(-m t^2 / 2)
+        const double m = static_cast<double>(sample_size);
+        estimate.score = std::accumulate(scores.begin(), scores.end(), 0.0) / m;
+        estimate.half_width = std::sqrt(2.0 * std::log(2.0 / (1.0 - confidence)) / m);
+        estimate.samples = sample_size;
+        return estimate;
     }
 
     /**
@@ -137,8 +626,9 @@ public:
             throw std::invalid_argument("Empty chunks vector");
         }
 
-        double cohesion = compute_cohesion(chunks);
-        double separation = chunks.size() > 1 ? compute_separation(chunks) : 1.0;
+        const auto stats = compute_statistics(chunks);
+        double cohesion = cohesion_from_statistics(stats);
+        double separation = chunks.size() > 1 ? separation_from_statistics(stats) : 1.0;
 
         return (cohesion + separation) / 2.0;
     }
@@ -190,49 +680,230 @@ public:
      * @brief Clear internal caches to free memory
      */
     void clear_cache() {
-        // Clear any cached computations
-        cached_cohesion.clear();
-        cached_separation.clear();
+        cache_->clear();
+    }
+
+    /// Number of chunk statistics currently cached
+    size_t cache_size() const {
+        return cache_->size();
+    }
+
+    /// Statistics lookups served from the cache since construction
+    size_t cache_hits() const {
+        return cache_->hits();
+    }
+
+    /// Statistics lookups that had to be computed since construction
+    size_t cache_misses() const {
+        return cache_->misses();
     }
 
 private:
     /**
-     * @brief Calculate mean value of a chunk
-     * @param chunk Single chunk data
-     * @return Mean value of the chunk
+     * @brief Reference O(N^2) silhouette for non-arithmetic element types
      */
-    T calculate_mean(const std::vector<T>& chunk) {
-        if (chunk.empty()) {
-            return T{};
+    double compute_silhouette_pairwise(const std::vector<std::vector<T>>& chunks) {
+        double total_score = 0.0;
+        size_t total_points = 0;
+
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            for (const auto& point : chunks[i]) {
+                // Calculate a (average distance to points in same chunk)
+                double a = 0.0;
+                for (const auto& other_point : chunks[i]) {
+                    if (&point != &other_point) {
+                        a += std::abs(point - other_point);
+                    }
+                }
+                a = chunks[i].size() > 1 ? a / (chunks[i].size() - 1) : 0;
+
+                // Calculate b (minimum average distance to points in other chunks)
+                double b = std::numeric_limits<double>::max();
+                for (size_t j = 0; j < chunks.size(); ++j) {
+                    if (i != j) {
+                        double avg_dist = 0.0;
+                        for (const auto& other_point : chunks[j]) {
+                            avg_dist += std::abs(point - other_point);
+                        }
+                        avg_dist /= chunks[j].size();
+                        b = std::min(b, avg_dist);
+                    }
+                }
+
+                // Calculate silhouette score for this point
+                double max_ab = std::max(a, b);
+                if (max_ab > 0) {
+                    total_score += (b - a) / max_ab;
+                }
+                ++total_points;
+            }
         }
-        T sum = T{};
-        for (const auto& val : chunk) {
-            sum += val;
+
+        return total_score / total_points;
+    }
+
+    ChunkStatistics cached_statistics(const std::vector<T>& chunk) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (chunk.size() >= cache_->options().min_chunk_size &&
+                cache_->options().max_entries > 0) {
+                const detail::StatisticsCache::Key key{
+                    detail::fingerprint(chunk.data(), chunk.size() * sizeof(T)), chunk.size()};
+                ChunkStatistics stats;
+                if (!cache_->find(key, stats)) {
+                    stats = ChunkStatistics::of(chunk);
+                    cache_->insert(key, stats);
+                }
+                return stats;
+            }
+        }
+        return ChunkStatistics::of(chunk);
+    }
+
+    chunk_processing::ThreadPool* pool_;
+    std::shared_ptr<detail::StatisticsCache> cache_;
+};
+
+/**
+ * @brief Online chunk quality metrics, fed one finished chunk at a time
+ *
+ * Keeps what ChunkQualityAnalyzer would report for the whole chunking
+ * without buffering it: cohesion and size metrics are exact running sums,
+ * and separation is computed from a uniform reservoir sample of chunk means.
+ * The sample's mean pairwise difference is an unbiased estimate of the full
+ * one, and exact while at most separation_sample chunks have been seen.
+ * Memory is bounded by the sample size. Not thread-safe; use one
+ * accumulator per producer.
+ *
+ * Usable directly as a chunk sink: accumulator(chunk).
+ *
+ * @tparam T The data type of the chunks
+ */
+template <typename T>
+class CHUNK_EXPORT ChunkMetricsAccumulator {
+public:
+    /**
+     * @param separation_sample Number of chunk means kept for separation
+     * @param seed Seed for the reservoir sampler
+     * @throws std::invalid_argument if separation_sample < 2
+     */
+    explicit ChunkMetricsAccumulator(size_t separation_sample = 4096, uint64_t seed = 0x5EED)
+        : sample_capacity_(separation_sample), rng_(seed) {
+        if (separation_sample < 2) {
+            throw std::invalid_argument("Separation sample must hold at least two chunks");
         }
-        return sum / static_cast<T>(chunk.size());
     }
 
     /**
-     * @brief Calculate variance of a chunk
-     * @param chunk Single chunk data
-     * @param mean Pre-calculated mean value
-     * @return Variance of the chunk
+     * @brief Record one finished chunk
      */
-    T calculate_variance(const std::vector<T>& chunk, T mean) {
-        if (chunk.size() < 2) {
-            return T{};
+    void add(const T* data, size_t size) {
+        ChunkStatistics chunk;
+        for (size_t i = 0; i < size; ++i) {
+            chunk.add(static_cast<double>(data[i]));
         }
-        T sum_sq_diff = T{};
-        for (const auto& val : chunk) {
-            T diff = val - mean;
-            sum_sq_diff += diff * diff;
+        if (chunk.count > 0) {
+            cohesion_sum_ += 1.0 / (1.0 + std::sqrt(chunk.variance()));
+        }
+        sizes_.add(static_cast<double>(size));
+        values_.merge(chunk);
+
+        // Reservoir sampling (Algorithm R) of the chunk means
+        const size_t seen = chunk_count() - 1;
+        if (means_.size() < sample_capacity_) {
+            means_.push_back(chunk.mean);
+        } else {
+            const size_t slot = std::uniform_int_distribution<size_t>(0, seen)(rng_);
+            if (slot < sample_capacity_) {
+                means_[slot] = chunk.mean;
+            }
+        }
+    }
+
+    void add(const std::vector<T>& chunk) {
+        add(chunk.data(), chunk.size());
+    }
+
+    void operator()(const std::vector<T>& chunk) {
+        add(chunk);
+    }
+
+    /// Number of chunks recorded
+    size_t chunk_count() const {
+        return sizes_.count;
+    }
+
+    /// Statistics of all values across all chunks
+    const ChunkStatistics& value_statistics() const {
+        return values_;
+    }
+
+    /**
+     * @brief Same as ChunkQualityAnalyzer::compute_cohesion over the recorded chunks
+     * @throws std::invalid_argument if no chunks were recorded
+     */
+    double cohesion() const {
+        require_chunks(1, "Empty chunks vector");
+        return cohesion_sum_ / static_cast<double>(chunk_count());
+    }
+
+    /**
+     * @brief Mean absolute difference between chunk means, estimated from the sample
+     * @throws std::invalid_argument if fewer than two chunks were recorded
+     */
+    double separation() const {
+        require_chunks(2, "Need at least two chunks for separation");
+        return detail::mean_pair_difference(means_);
+    }
+
+    /// True while separation() covers every chunk rather than a sample
+    bool separation_is_exact() const {
+        return chunk_count() <= sample_capacity_;
+    }
+
+    /**
+     * @brief Same combination as ChunkQualityAnalyzer::compute_quality_score
+     * @throws std::invalid_argument if no chunks were recorded
+     */
+    double quality_score() const {
+        const double separation_score = chunk_count() > 1 ? separation() : 1.0;
+        return (cohesion() + separation_score) / 2.0;
+    }
+
+    /**
+     * @brief Same keys and values as ChunkQualityAnalyzer::compute_size_metrics
+     * @throws std::invalid_argument if no chunks were recorded
+     */
+    std::unordered_map<std::string, double> size_metrics() const {
+        require_chunks(1, "Empty chunks vector");
+        const double variance = sizes_.m2 / static_cast<double>(sizes_.count);
+        return {{"average_size", sizes_.mean},
+                {"max_size", sizes_.max},
+                {"min_size", sizes_.min},
+                {"size_variance", variance},
+                {"size_stddev", std::sqrt(variance)}};
+    }
+
+    /// Forget all recorded chunks
+    void reset() {
+        sizes_ = ChunkStatistics{};
+        values_ = ChunkStatistics{};
+        cohesion_sum_ = 0.0;
+        means_.clear();
+    }
+
+private:
+    void require_chunks(size_t minimum, const char* message) const {
+        if (chunk_count() < minimum) {
+            throw std::invalid_argument(message);
         }
-        return sum_sq_diff / static_cast<T>(chunk.size() - 1);
     }
 
-    // Add cache containers
-    std::unordered_map<size_t, double> cached_cohesion;
-    std::unordered_map<size_t, double> cached_separation;
+    size_t sample_capacity_;
+    std::mt19937_64 rng_;
+    ChunkStatistics sizes_;
+    ChunkStatistics values_;
+    double cohesion_sum_ = 0.0;
+    std::vector<double> means_;
 };
 
 } // namespace chunk_metrics
\ No newline at end of file
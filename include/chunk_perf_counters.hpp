@@ -0,0 +1,206 @@
+/**
+ * @file chunk_perf_counters.hpp
+ * @brief Hardware performance counters for benchmarks via Linux perf_event_open
+ *
+ * Counts user-space cycles, instructions, branch misses, cache misses and
+ * last-level-cache loads of the calling thread. Events the CPU, kernel or
+ * container does not allow (perf_event_paranoid, seccomp, virtual machines
+ * without a PMU) are skipped individually; on other platforms no counter is
+ * available and every reading is NaN.
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace chunk_benchmark {
+
+/**
+ * @brief Counters collected by PerfCounters, in reporting order
+ */
+enum class PerfEvent { Cycles, Instructions, BranchMisses, CacheMisses, LLCLoads };
+
+constexpr size_t PERF_EVENT_COUNT = 5;
+
+inline const char* perf_event_name(PerfEvent event) {
+    static const char* const names[PERF_EVENT_COUNT] = {"cycles", "instructions",
+                                                        "branch_misses", "cache_misses",
+                                                        "llc_loads"};
+    return names[static_cast<size_t>(event)];
+}
+
+/**
+ * @brief One reading per event; NaN where the event is unavailable
+ */
+struct PerfCounterValues {
+    std::array<double, PERF_EVENT_COUNT> values;
+
+    PerfCounterValues() {
+        values.fill(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    double operator[](PerfEvent event) const {
+        return values[static_cast<size_t>(event)];
+    }
+    double& operator[](PerfEvent event) {
+        return values[static_cast<size_t>(event)];
+    }
+};
+
+/**
+ * @brief A group of hardware counters on the calling thread
+ *
+ * Counting starts disabled. start() resets and enables the group, stop()
+ * pauses it and resume() continues, so several intervals accumulate until
+ * the next start(). Readings are scaled by time enabled over time running when
+ * the kernel multiplexes the PMU. Threads other than the creating one are
+ * not counted.
+ */
+class CHUNK_EXPORT PerfCounters {
+public:
+    PerfCounters() {
+        fds_.fill(-1);
+#if defined(__linux__)
+        const std::array<std::pair<uint32_t, uint64_t>, PERF_EVENT_COUNT> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16)},
+        }};
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = leader_ < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format =
+                PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+            if (fd < 0) {
+                if (error_.empty()) {
+                    error_ = std::string(perf_event_name(static_cast<PerfEvent>(i))) + ": " +
+                             std::strerror(errno);
+                }
+                continue;
+            }
+            fds_[i] = static_cast<int>(fd);
+            group_order_[group_size_++] = i;
+            if (leader_ < 0) {
+                leader_ = static_cast<int>(fd);
+            }
+        }
+#else
+        error_ = "perf_event_open is only available on Linux";
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    /// True if at least one event could be opened
+    bool available() const {
+        return leader_ >= 0;
+    }
+
+    bool available(PerfEvent event) const {
+        return fds_[static_cast<size_t>(event)] >= 0;
+    }
+
+    /// Why the first unavailable event could not be opened (empty if all opened)
+    const std::string& error() const {
+        return error_;
+    }
+
+    /// Reset the counts and start counting
+    void start() {
+#if defined(__linux__)
+        if (available()) {
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    /// Pause counting; resume() continues without resetting
+    void stop() {
+#if defined(__linux__)
+        if (available()) {
+            ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    void resume() {
+#if defined(__linux__)
+        if (available()) {
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    /**
+     * @brief Counts since the last start(), NaN for unavailable events
+     *
+     * Every reading is NaN if the group was never scheduled on the PMU
+     * (time running is zero), since no count can be extrapolated then.
+     */
+    PerfCounterValues read() const {
+        PerfCounterValues result;
+#if defined(__linux__)
+        if (!available()) {
+            return result;
+        }
+        // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, value[nr]
+        uint64_t buffer[3 + PERF_EVENT_COUNT] = {};
+        const ssize_t bytes = ::read(leader_, buffer, sizeof(buffer));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != group_size_ ||
+            buffer[2] == 0) {
+            return result;
+        }
+        const double scale = static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+        for (size_t k = 0; k < group_size_; ++k) {
+            result.values[group_order_[k]] = static_cast<double>(buffer[3 + k]) * scale;
+        }
+#endif
+        return result;
+    }
+
+private:
+    std::array<int, PERF_EVENT_COUNT> fds_;
+    std::array<size_t, PERF_EVENT_COUNT> group_order_{};
+    size_t group_size_ = 0;
+    int leader_ = -1;
+    std::string error_;
+};
+
+} // namespace chunk_benchmark
@@ -7,12 +7,829 @@
 
 #pragma once
 #include "chunk_common.hpp"
+#include "chunk_errors.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace chunk_serialization {
 
+/**
+ * @brief Layout of JSON output
+ */
+struct JsonOptions {
+    /// One chunk per line with ", " between values, instead of no whitespace at all
+    bool pretty = false;
+    /// Spaces before each chunk in pretty mode
+    unsigned indent = 2;
+};
+
+namespace detail {
+
+// MessagePack type tags (https://github.com/msgpack/msgpack/blob/master/spec.md)
+constexpr uint8_t MSGPACK_FIXARRAY = 0x90;
+constexpr uint8_t MSGPACK_ARRAY16 = 0xdc;
+constexpr uint8_t MSGPACK_ARRAY32 = 0xdd;
+constexpr uint8_t MSGPACK_FLOAT32 = 0xca;
+constexpr uint8_t MSGPACK_FLOAT64 = 0xcb;
+constexpr uint8_t MSGPACK_UINT8 = 0xcc;
+constexpr uint8_t MSGPACK_UINT16 = 0xcd;
+constexpr uint8_t MSGPACK_UINT32 = 0xce;
+constexpr uint8_t MSGPACK_UINT64 = 0xcf;
+constexpr uint8_t MSGPACK_INT8 = 0xd0;
+constexpr uint8_t MSGPACK_INT16 = 0xd1;
+constexpr uint8_t MSGPACK_INT32 = 0xd2;
+constexpr uint8_t MSGPACK_INT64 = 0xd3;
+
+inline uint8_t byte_swap(uint8_t v) {
+    return v;
+}
+
+inline uint16_t byte_swap(uint16_t v) {
+    return __builtin_bswap16(v);
+}
+
+inline uint32_t byte_swap(uint32_t v) {
+    return __builtin_bswap32(v);
+}
+
+inline uint64_t byte_swap(uint64_t v) {
+    return __builtin_bswap64(v);
+}
+
+template <size_t Bytes>
+struct UnsignedOfSize;
+template <>
+struct UnsignedOfSize<1> {
+    using type = uint8_t;
+};
+template <>
+struct UnsignedOfSize<2> {
+    using type = uint16_t;
+};
+template <>
+struct UnsignedOfSize<4> {
+    using type = uint32_t;
+};
+template <>
+struct UnsignedOfSize<8> {
+    using type = uint64_t;
+};
+
+/// Decoded integer to T, rejecting values T cannot hold
+template <typename T>
+T checked_from_unsigned(uint64_t v) {
+    if (!std::is_floating_point<T>::value &&
+        v > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+        throw chunk_processing::SerializationError("Serialized integer out of range for T");
+    }
+    return static_cast<T>(v);
+}
+
+template <typename T>
+T checked_from_signed(int64_t v) {
+    if (v >= 0) {
+        return checked_from_unsigned<T>(static_cast<uint64_t>(v));
+    }
+    if (!std::is_floating_point<T>::value &&
+        (std::is_unsigned<T>::value ||
+         v < static_cast<int64_t>(std::numeric_limits<T>::lowest()))) {
+        throw chunk_processing::SerializationError("Serialized integer out of range for T");
+    }
+    return static_cast<T>(v);
+}
+
+template <typename T, typename F>
+T checked_from_float(F v) {
+    if (!std::is_floating_point<T>::value) {
+        throw chunk_processing::SerializationError(
+            "Serialized float cannot be decoded into an integer chunk");
+    }
+    return static_cast<T>(v);
+}
+
+/**
+ * @brief Fixed-width MessagePack tag for T, so every value has the same encoded size
+ */
+template <typename T>
+constexpr uint8_t msgpack_tag() {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "MessagePack chunks hold numeric values");
+    static_assert(std::is_integral<T>::value ? sizeof(T) <= 8 : sizeof(T) == 4 || sizeof(T) == 8,
+                  "No MessagePack encoding for this value type");
+    if (std::is_floating_point<T>::value) {
+        return sizeof(T) == 4 ? MSGPACK_FLOAT32 : MSGPACK_FLOAT64;
+    }
+    const uint8_t width = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+    return static_cast<uint8_t>((std::is_signed<T>::value ? MSGPACK_INT8 : MSGPACK_UINT8) + width);
+}
+
+inline size_t msgpack_array_header_size(size_t n) {
+    return n < 16 ? 1 : n <= 0xffff ? 3 : 5;
+}
+
+/// Big-endian store of a value's object representation
+template <typename V>
+inline uint8_t* store_big_endian(uint8_t* out, V value) {
+    typename UnsignedOfSize<sizeof(V)>::type bits;
+    std::memcpy(&bits, &value, sizeof(V));
+    bits = byte_swap(bits);
+    std::memcpy(out, &bits, sizeof(V));
+    return out + sizeof(V);
+}
+
+template <typename V>
+inline V load_big_endian(const uint8_t* in) {
+    typename UnsignedOfSize<sizeof(V)>::type bits;
+    std::memcpy(&bits, in, sizeof(V));
+    bits = byte_swap(bits);
+    V value;
+    std::memcpy(&value, &bits, sizeof(V));
+    return value;
+}
+
+/**
+ * @throws std::invalid_argument if n does not fit the 32-bit array length
+ */
+inline uint8_t* write_msgpack_array_header(uint8_t* out, size_t n) {
+    if (n < 16) {
+        *out = static_cast<uint8_t>(MSGPACK_FIXARRAY | n);
+        return out + 1;
+    }
+    if (n <= 0xffff) {
+        *out = MSGPACK_ARRAY16;
+        return store_big_endian(out + 1, static_cast<uint16_t>(n));
+    }
+    if (n <= 0xffffffffu) {
+        *out = MSGPACK_ARRAY32;
+        return store_big_endian(out + 1, static_cast<uint32_t>(n));
+    }
+    throw std::invalid_argument("MessagePack arrays hold at most 2^32 - 1 elements");
+}
+
+template <typename T>
+inline uint8_t* write_msgpack_values(uint8_t* out, const T* values, size_t n) {
+    constexpr uint8_t tag = msgpack_tag<T>();
+    for (size_t i = 0; i < n; ++i) {
+        out[0] = tag;
+        out = store_big_endian(out + 1, values[i]);
+    }
+    return out;
+}
+
+/**
+ * @brief Bounds-checked cursor over a MessagePack buffer
+ */
+class MsgpackReader {
+public:
+    MsgpackReader(const uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+
+    size_t remaining() const {
+        return static_cast<size_t>(end_ - pos_);
+    }
+
+    /**
+     * @brief Read an array header and check that n elements can fit in the rest of the input
+     */
+    size_t read_array_header() {
+        const uint8_t tag = next_byte();
+        size_t n;
+        if ((tag & 0xf0) == MSGPACK_FIXARRAY) {
+            n = tag & 0x0f;
+        } else if (tag == MSGPACK_ARRAY16) {
+            n = load<uint16_t>();
+        } else if (tag == MSGPACK_ARRAY32) {
+            n = load<uint32_t>();
+        } else {
+            throw chunk_processing::SerializationError("Expected a MessagePack array");
+        }
+        if (n > remaining()) {
+            throw chunk_processing::SerializationError("Truncated MessagePack array");
+        }
+        return n;
+    }
+
+    /**
+     * @brief Read n numbers of any MessagePack integer or float encoding into out
+     */
+    template <typename T>
+    void read_values(T* out, size_t n) {
+        constexpr uint8_t native = msgpack_tag<T>();
+        constexpr size_t stride = 1 + sizeof(T);
+        size_t i = 0;
+        while (i < n) {
+            // Fast path: a run of values in the encoding to_msgpack writes for T
+            while (i < n && remaining() >= stride && *pos_ == native) {
+                out[i++] = load_big_endian<T>(pos_ + 1);
+                pos_ += stride;
+            }
+            if (i < n) {
+                out[i++] = read_value<T>();
+            }
+        }
+    }
+
+private:
+    uint8_t next_byte() {
+        require(1);
+        return *pos_++;
+    }
+
+    void require(size_t bytes) const {
+        if (remaining() < bytes) {
+            throw chunk_processing::SerializationError("Truncated MessagePack data");
+        }
+    }
+
+    template <typename V>
+    V load() {
+        require(sizeof(V));
+        V value = load_big_endian<V>(pos_);
+        pos_ += sizeof(V);
+        return value;
+    }
+
+    template <typename T>
+    T read_value() {
+        const uint8_t tag = next_byte();
+        if (tag <= 0x7f) {
+            return checked_from_unsigned<T>(tag);
+        }
+        if (tag >= 0xe0) {
+            return checked_from_signed<T>(static_cast<int8_t>(tag));
+        }
+        switch (tag) {
+        case MSGPACK_UINT8:
+            return checked_from_unsigned<T>(load<uint8_t>());
+        case MSGPACK_UINT16:
+            return checked_from_unsigned<T>(load<uint16_t>());
+        case MSGPACK_UINT32:
+            return checked_from_unsigned<T>(load<uint32_t>());
+        case MSGPACK_UINT64:
+            return checked_from_unsigned<T>(load<uint64_t>());
+        case MSGPACK_INT8:
+            return checked_from_signed<T>(load<int8_t>());
+        case MSGPACK_INT16:
+            return checked_from_signed<T>(load<int16_t>());
+        case MSGPACK_INT32:
+            return checked_from_signed<T>(load<int32_t>());
+        case MSGPACK_INT64:
+            return checked_from_signed<T>(load<int64_t>());
+        case MSGPACK_FLOAT32:
+            return checked_from_float<T>(load<float>());
+        case MSGPACK_FLOAT64:
+            return checked_from_float<T>(load<double>());
+        default:
+            throw chunk_processing::SerializationError("Unsupported MessagePack type in chunk");
+        }
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+// Protocol Buffers wire format for proto/chunk_set.proto
+constexpr uint32_t PROTOBUF_WIRE_VARINT = 0;
+constexpr uint32_t PROTOBUF_WIRE_FIXED64 = 1;
+constexpr uint32_t PROTOBUF_WIRE_LEN = 2;
+constexpr uint32_t PROTOBUF_WIRE_FIXED32 = 5;
+constexpr uint32_t PROTOBUF_CHUNKSET_CHUNKS = 1;
+constexpr uint32_t PROTOBUF_CHUNK_DOUBLE = 1;
+constexpr uint32_t PROTOBUF_CHUNK_FLOAT = 2;
+constexpr uint32_t PROTOBUF_CHUNK_SINT64 = 3;
+constexpr uint32_t PROTOBUF_CHUNK_UINT64 = 4;
+
+constexpr uint8_t protobuf_key(uint32_t field, uint32_t wire_type) {
+    return static_cast<uint8_t>(field << 3 | wire_type);
+}
+
+/**
+ * @brief Chunk message field that holds values of type T
+ */
+template <typename T>
+constexpr uint32_t protobuf_field() {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "Protobuf chunks hold numeric values");
+    static_assert(std::is_integral<T>::value ? sizeof(T) <= 8 : sizeof(T) == 4 || sizeof(T) == 8,
+                  "No protobuf encoding for this value type");
+    return std::is_floating_point<T>::value
+               ? (sizeof(T) == 4 ? PROTOBUF_CHUNK_FLOAT : PROTOBUF_CHUNK_DOUBLE)
+               : (std::is_signed<T>::value ? PROTOBUF_CHUNK_SINT64 : PROTOBUF_CHUNK_UINT64);
+}
+
+inline size_t varint_size(uint64_t v) {
+    return 1 + static_cast<size_t>(63 - __builtin_clzll(v | 1)) / 7;
+}
+
+inline uint8_t* write_varint(uint8_t* out, uint64_t v) {
+    while (v >= 0x80) {
+        *out++ = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(v);
+    return out;
+}
+
+/// Wire value of an integer: zigzag for signed types (sint64), as is for unsigned (uint64)
+template <typename T>
+inline uint64_t protobuf_varint(T v) {
+    if (std::is_signed<T>::value) {
+        const int64_t s = static_cast<int64_t>(v);
+        return (static_cast<uint64_t>(s) << 1) ^ static_cast<uint64_t>(s >> 63);
+    }
+    return static_cast<uint64_t>(v);
+}
+
+/// Bytes of the packed field payload for n values
+template <typename T>
+size_t protobuf_packed_size(const T* values, size_t n) {
+    if (std::is_floating_point<T>::value) {
+        return n * sizeof(T);
+    }
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        bytes += varint_size(protobuf_varint(values[i]));
+    }
+    return bytes;
+}
+
+/// Bytes of a Chunk message whose packed payload is payload_bytes long
+inline size_t protobuf_chunk_size(size_t payload_bytes) {
+    // proto3 omits an empty repeated field
+    return payload_bytes == 0 ? 0 : 1 + varint_size(payload_bytes) + payload_bytes;
+}
+
+template <typename T>
+uint8_t* write_protobuf_chunk(uint8_t* out, const T* values, size_t n, size_t payload_bytes) {
+    *out++ = protobuf_key(PROTOBUF_CHUNKSET_CHUNKS, PROTOBUF_WIRE_LEN);
+    out = write_varint(out, protobuf_chunk_size(payload_bytes));
+    if (payload_bytes == 0) {
+        return out;
+    }
+    *out++ = protobuf_key(protobuf_field<T>(), PROTOBUF_WIRE_LEN);
+    out = write_varint(out, payload_bytes);
+    if (std::is_floating_point<T>::value) {
+        // Protobuf fixed-width values are little-endian, like the host
+        std::memcpy(out, values, payload_bytes);
+        return out + payload_bytes;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        out = write_varint(out, protobuf_varint(values[i]));
+    }
+    return out;
+}
+
+/**
+ * @brief Bounds-checked cursor over a protobuf message
+ */
+class ProtobufReader {
+public:
+    ProtobufReader(const uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+
+    bool done() const {
+        return pos_ == end_;
+    }
+
+    uint64_t read_varint() {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos_ == end_) {
+                throw chunk_processing::SerializationError("Truncated protobuf varint");
+            }
+            const uint8_t byte = *pos_++;
+            v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return v;
+            }
+        }
+        throw chunk_processing::SerializationError("Protobuf varint longer than 10 bytes");
+    }
+
+    /// Read a length prefix and return a reader over that many bytes
+    ProtobufReader read_length_delimited() {
+        const uint64_t len = read_varint();
+        if (len > static_cast<uint64_t>(end_ - pos_)) {
+            throw chunk_processing::SerializationError("Truncated protobuf field");
+        }
+        ProtobufReader sub(pos_, static_cast<size_t>(len));
+        pos_ += len;
+        return sub;
+    }
+
+    template <typename V>
+    V read_fixed() {
+        if (static_cast<size_t>(end_ - pos_) < sizeof(V)) {
+            throw chunk_processing::SerializationError("Truncated protobuf field");
+        }
+        V value;
+        std::memcpy(&value, pos_, sizeof(V));
+        pos_ += sizeof(V);
+        return value;
+    }
+
+    void skip(uint32_t wire_type) {
+        switch (wire_type) {
+        case PROTOBUF_WIRE_VARINT:
+            read_varint();
+            break;
+        case PROTOBUF_WIRE_FIXED64:
+            read_fixed<uint64_t>();
+            break;
+        case PROTOBUF_WIRE_LEN:
+            read_length_delimited();
+            break;
+        case PROTOBUF_WIRE_FIXED32:
+            read_fixed<uint32_t>();
+            break;
+        default:
+            throw chunk_processing::SerializationError("Unsupported protobuf wire type");
+        }
+    }
+
+    /**
+     * @brief Append the values of one Chunk message to out
+     *
+     * Accepts every value field in packed or unpacked form and skips
+     * unknown fields, as protobuf parsers must.
+     */
+    template <typename T>
+    void read_chunk(std::vector<T>& out) {
+        while (!done()) {
+            const uint64_t key = read_varint();
+            const uint32_t wire_type = static_cast<uint32_t>(key & 7);
+            switch (key >> 3) {
+            case PROTOBUF_CHUNK_DOUBLE:
+                read_floats<double>(wire_type, PROTOBUF_WIRE_FIXED64, out);
+                break;
+            case PROTOBUF_CHUNK_FLOAT:
+                read_floats<float>(wire_type, PROTOBUF_WIRE_FIXED32, out);
+                break;
+            case PROTOBUF_CHUNK_SINT64:
+                read_varints(wire_type, out, [](uint64_t v) {
+                    return checked_from_signed<T>(static_cast<int64_t>(v >> 1) ^
+                                                  -static_cast<int64_t>(v & 1));
+                });
+                break;
+            case PROTOBUF_CHUNK_UINT64:
+                read_varints(wire_type, out,
+                             [](uint64_t v) { return checked_from_unsigned<T>(v); });
+                break;
+            default:
+                skip(wire_type);
+            }
+        }
+    }
+
+private:
+    template <typename F, typename T>
+    void read_floats(uint32_t wire_type, uint32_t fixed_wire_type, std::vector<T>& out) {
+        if (wire_type == fixed_wire_type) {
+            out.push_back(checked_from_float<T>(read_fixed<F>()));
+            return;
+        }
+        if (wire_type != PROTOBUF_WIRE_LEN) {
+            throw chunk_processing::SerializationError("Unexpected protobuf wire type");
+        }
+        ProtobufReader packed = read_length_delimited();
+        const size_t bytes = static_cast<size_t>(packed.end_ - packed.pos_);
+        if (bytes % sizeof(F) != 0) {
+            throw chunk_processing::SerializationError("Malformed packed protobuf field");
+        }
+        const size_t offset = out.size();
+        out.resize(offset + bytes / sizeof(F));
+        if (std::is_same<F, T>::value) {
+            std::memcpy(out.data() + offset, packed.pos_, bytes);
+            return;
+        }
+        for (size_t i = offset; i < out.size(); ++i) {
+            out[i] = checked_from_float<T>(packed.read_fixed<F>());
+        }
+    }
+
+    template <typename T, typename Convert>
+    void read_varints(uint32_t wire_type, std::vector<T>& out, Convert convert) {
+        if (wire_type == PROTOBUF_WIRE_VARINT) {
+            out.push_back(convert(read_varint()));
+            return;
+        }
+        if (wire_type != PROTOBUF_WIRE_LEN) {
+            throw chunk_processing::SerializationError("Unexpected protobuf wire type");
+        }
+        ProtobufReader packed = read_length_delimited();
+        // Each varint ends in exactly one byte below 0x80
+        const auto ends =
+            std::count_if(packed.pos_, packed.end_, [](uint8_t b) { return b < 0x80; });
+        out.reserve(out.size() + static_cast<size_t>(ends));
+        while (!packed.done()) {
+            out.push_back(convert(packed.read_varint()));
+        }
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+// JSON numbers, shortest round-trip via <charconv> where the library supports floats
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define CHUNK_HAS_FLOAT_CHARCONV 1
+#else
+#define CHUNK_HAS_FLOAT_CHARCONV 0
+#endif
+
+/// Longest number the writer emits, and the longest the reader accepts
+constexpr size_t JSON_MAX_WRITTEN_NUMBER = 32;
+constexpr size_t JSON_MAX_NUMBER = 128;
+
+template <typename F>
+char* format_json_float(char* out, F v) {
+    if (!std::isfinite(v)) {
+        const char* special = std::isnan(v) ? "NaN" : v > 0 ? "Infinity" : "-Infinity";
+        const size_t len = std::strlen(special);
+        std::memcpy(out, special, len);
+        return out + len;
+    }
+#if CHUNK_HAS_FLOAT_CHARCONV
+    char* end = std::to_chars(out, out + JSON_MAX_WRITTEN_NUMBER, v).ptr;
+#else
+    char* end = out + std::snprintf(out, JSON_MAX_WRITTEN_NUMBER, "%.*g",
+                                    std::numeric_limits<F>::max_digits10,
+                                    static_cast<double>(v));
+#endif
+    if (std::find_if(out, end, [](char c) { return c == '.' || c == 'e'; }) == end) {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    return end;
+}
+
+/**
+ * @brief Format v as a JSON number into out (at least JSON_MAX_WRITTEN_NUMBER bytes)
+ *
+ * Floats use the shortest form that parses back to the same value and keep
+ * a ".0" on integral values. Non-finite values are written as NaN,
+ * Infinity and -Infinity, as JavaScript and Python do.
+ */
+template <typename T>
+char* format_json_number(char* out, T v) {
+    if constexpr (!std::is_floating_point<T>::value) {
+        return std::to_chars(out, out + JSON_MAX_WRITTEN_NUMBER, v).ptr;
+    } else {
+        return format_json_float(out, v);
+    }
+}
+
+template <typename F>
+bool parse_float(const char* first, const char* last, F& value) {
+    if (last - first == 3 && std::memcmp(first, "NaN", 3) == 0) {
+        value = std::numeric_limits<F>::quiet_NaN();
+        return true;
+    }
+    const bool negative = first != last && *first == '-';
+    if (last - first - negative == 8 && std::memcmp(first + negative, "Infinity", 8) == 0) {
+        value = negative ? -std::numeric_limits<F>::infinity() : std::numeric_limits<F>::infinity();
+        return true;
+    }
+#if CHUNK_HAS_FLOAT_CHARCONV
+    const auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+#else
+    char token[JSON_MAX_NUMBER + 1];
+    std::memcpy(token, first, static_cast<size_t>(last - first));
+    token[last - first] = '\0';
+    char* end = nullptr;
+    value = static_cast<F>(std::strtod(token, &end));
+    return end == token + (last - first) && last != first;
+#endif
+}
+
+/**
+ * @brief Parse one JSON number token into T
+ *
+ * Integral chunks also accept integral values written with a fraction or
+ * exponent (e.g. 3.0 or 1e3) by other producers.
+ *
+ * @throws chunk_processing::SerializationError if the token is not a number T can hold
+ */
+template <typename T>
+T parse_json_number(const char* first, const char* last) {
+    if constexpr (std::is_floating_point<T>::value) {
+        T value;
+        if (parse_float(first, last, value)) {
+            return value;
+        }
+    } else {
+        T value;
+        const auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc() && result.ptr == last) {
+            return value;
+        }
+        // max() + 1.0 is the exact power of two above the range
+        const double lowest = static_cast<double>(std::numeric_limits<T>::lowest());
+        const double limit = static_cast<double>(std::numeric_limits<T>::max()) + 1.0;
+        double real;
+        if (result.ec != std::errc::result_out_of_range && parse_float(first, last, real) &&
+            std::trunc(real) == real && real >= lowest && real < limit) {
+            return static_cast<T>(real);
+        }
+    }
+    throw chunk_processing::SerializationError("Invalid JSON number for chunk type: " +
+                                               std::string(first, last));
+}
+
+/**
+ * @brief Writes a chunk set as JSON through a fixed buffer handed to a sink in pieces
+ * @tparam Sink Callable as sink(const char* data, size_t size)
+ */
+template <typename Sink>
+class JsonWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    JsonWriter(const JsonOptions& options, Sink& sink)
+        : options_(options), sink_(sink), buffer_(BUFFER_SIZE), pos_(buffer_.data()) {}
+
+    template <typename T>
+    void write(const std::vector<std::vector<T>>& chunks) {
+        put('[');
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (i > 0) {
+                put(',');
+            }
+            if (options_.pretty) {
+                put('\n');
+                for (unsigned k = 0; k < options_.indent; ++k) {
+                    put(' ');
+                }
+            }
+            write_chunk(chunks[i]);
+        }
+        if (options_.pretty && !chunks.empty()) {
+            put('\n');
+        }
+        put(']');
+        flush();
+    }
+
+private:
+    template <typename T>
+    void write_chunk(const std::vector<T>& chunk) {
+        put('[');
+        for (size_t j = 0; j < chunk.size(); ++j) {
+            reserve(JSON_MAX_WRITTEN_NUMBER + 2);
+            if (j > 0) {
+                *pos_++ = ',';
+                if (options_.pretty) {
+                    *pos_++ = ' ';
+                }
+            }
+            pos_ = format_json_number(pos_, chunk[j]);
+        }
+        put(']');
+    }
+
+    void put(char c) {
+        reserve(1);
+        *pos_++ = c;
+    }
+
+    void reserve(size_t bytes) {
+        if (static_cast<size_t>(buffer_.data() + buffer_.size() - pos_) < bytes) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (pos_ != buffer_.data()) {
+            sink_(buffer_.data(), static_cast<size_t>(pos_ - buffer_.data()));
+            pos_ = buffer_.data();
+        }
+    }
+
+    const JsonOptions& options_;
+    Sink& sink_;
+    std::vector<char> buffer_;
+    char* pos_;
+};
+
+/**
+ * @brief Parses a JSON array of number arrays from memory or an input stream
+ *
+ * A stream is read through a fixed window, so input size does not bound memory.
+ */
+class JsonReader {
+public:
+    JsonReader(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+    explicit JsonReader(std::istream& in) : in_(&in), window_(1 << 16) {
+        pos_ = end_ = window_.data();
+    }
+
+    template <typename T>
+    std::vector<std::vector<T>> read_chunks() {
+        std::vector<std::vector<T>> chunks;
+        expect('[');
+        if (!consume(']')) {
+            do {
+                chunks.emplace_back();
+                read_chunk(chunks.back());
+            } while (consume(','));
+            expect(']');
+        }
+        if (next_token() != EOF) {
+            throw chunk_processing::SerializationError("Trailing characters after JSON data");
+        }
+        return chunks;
+    }
+
+private:
+    template <typename T>
+    void read_chunk(std::vector<T>& out) {
+        expect('[');
+        if (consume(']')) {
+            return;
+        }
+        do {
+            next_token();
+            while (static_cast<size_t>(end_ - pos_) < JSON_MAX_NUMBER && refill()) {
+            }
+            const char* token_end = std::find_if(pos_, end_, [](char c) {
+                return c == ',' || c == ']' || c == '[' || c == ' ' || c == '\n' || c == '\r' ||
+                       c == '\t';
+            });
+            if (token_end == pos_ || token_end - pos_ > static_cast<ptrdiff_t>(JSON_MAX_NUMBER)) {
+                throw chunk_processing::SerializationError("Expected a JSON number");
+            }
+            out.push_back(parse_json_number<T>(pos_, token_end));
+            pos_ = token_end;
+        } while (consume(','));
+        expect(']');
+    }
+
+    /// Skip whitespace; the next character, or EOF at the end of input
+    int next_token() {
+        for (;;) {
+            if (pos_ == end_ && !refill()) {
+                return EOF;
+            }
+            const char c = *pos_;
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                return static_cast<unsigned char>(c);
+            }
+            ++pos_;
+        }
+    }
+
+    bool consume(char c) {
+        if (next_token() == static_cast<unsigned char>(c)) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            throw chunk_processing::SerializationError(std::string("Expected '") + c +
+                                                       "' in JSON chunk data");
+        }
+    }
+
+    /// Move the unread tail to the front of the window and read more; false at end of input
+    bool refill() {
+        if (!in_ || in_->eof()) {
+            return false;
+        }
+        const size_t keep = static_cast<size_t>(end_ - pos_);
+        std::memmove(window_.data(), pos_, keep);
+        in_->read(window_.data() + keep, static_cast<std::streamsize>(window_.size() - keep));
+        if (in_->bad()) {
+            throw chunk_processing::SerializationError("Failed to read JSON stream");
+        }
+        const size_t got = static_cast<size_t>(in_->gcount());
+        pos_ = window_.data();
+        end_ = pos_ + keep + got;
+        return got > 0;
+    }
+
+    const char* pos_;
+    const char* end_;
+    std::istream* in_ = nullptr;
+    std::vector<char> window_;
+};
+
+} // namespace detail
+
 /**
  * @brief Class for serializing chunks to various formats
  * @tparam T The data type of the chunks
@@ -22,72 +839,267 @@ class CHUNK_EXPORT ChunkSerializer {
 public:
     /**
      * @brief Serialize chunks to JSON format
+     *
+     * Numbers use the shortest form that reads back to the same value
+     * (locale-independent); see write_json() for the layout.
+     *
      * @param chunks Vector of chunk data
+     * @param options Compact or pretty layout
      * @return JSON string representation
-     * @throws std::runtime_error if serialization fails
+     * @throws std::invalid_argument if validation fails
      */
-    std::string to_json(const std::vector<std::vector<T>>& chunks) {
-        validate_chunks(chunks);
+    std::string to_json(const std::vector<std::vector<T>>& chunks,
+                        const JsonOptions& options = {}) {
+        std::string result;
+        size_t values = 0;
+        for (const auto& chunk : chunks) {
+            values += chunk.size();
+        }
+        result.reserve(values * (std::is_floating_point<T>::value ? 12 : 6) + chunks.size() * 4);
+        auto sink = [&](const char* data, size_t size) { result.append(data, size); };
+        write_json_impl(chunks, options, sink);
+        return result;
+    }
 
-        // Basic JSON array serialization
-        std::string result = "[";
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            result += "[";
-            for (size_t j = 0; j < chunks[i].size(); ++j) {
-                result += std::to_string(chunks[i][j]);
-                if (j < chunks[i].size() - 1) {
-                    result += ",";
-                }
+    /**
+     * @brief Stream chunks to an output stream in JSON format
+     *
+     * The set is written as an array of arrays of numbers through a fixed
+     * 64 KiB buffer, so memory use does not grow with the output. Pretty
+     * output puts each chunk on its own indented line.
+     *
+     * @param os Destination stream
+     * @param chunks Vector of chunk data
+     * @param options Compact or pretty layout
+     * @throws std::invalid_argument if validation fails
+     * @throws chunk_processing::SerializationError if the stream fails
+     */
+    void write_json(std::ostream& os, const std::vector<std::vector<T>>& chunks,
+                    const JsonOptions& options = {}) {
+        auto sink = [&](const char* data, size_t size) {
+            os.write(data, static_cast<std::streamsize>(size));
+            if (!os) {
+                throw chunk_processing::SerializationError("Failed to write JSON stream");
             }
-            result += "]";
-            if (i < chunks.size() - 1) {
-                result += ",";
+        };
+        write_json_impl(chunks, options, sink);
+    }
+
+    /**
+     * @brief Write chunks in JSON format into a caller buffer
+     * @param buffer Destination (not NUL-terminated)
+     * @param capacity Size of buffer in bytes
+     * @param chunks Vector of chunk data
+     * @param options Compact or pretty layout
+     * @return Number of bytes written
+     * @throws std::invalid_argument if validation fails or the output exceeds capacity
+     */
+    size_t write_json(char* buffer, size_t capacity, const std::vector<std::vector<T>>& chunks,
+                      const JsonOptions& options = {}) {
+        size_t written = 0;
+        auto sink = [&](const char* data, size_t size) {
+            if (size > capacity - written) {
+                throw std::invalid_argument("JSON output exceeds buffer capacity");
             }
-        }
-        result += "]";
-        return result;
+            std::memcpy(buffer + written, data, size);
+            written += size;
+        };
+        write_json_impl(chunks, options, sink);
+        return written;
+    }
+
+    /**
+     * @brief Deserialize chunks from JSON format
+     *
+     * Reads an array of arrays of numbers with any whitespace, including
+     * the NaN/Infinity tokens the writer emits for non-finite floats.
+     *
+     * @param data JSON text
+     * @param size Number of bytes
+     * @return Decoded chunks
+     * @throws chunk_processing::SerializationError if the text is malformed or holds a
+     *         value that T cannot represent
+     */
+    static std::vector<std::vector<T>> from_json(const char* data, size_t size) {
+        return detail::JsonReader(data, size).read_chunks<T>();
+    }
+
+    static std::vector<std::vector<T>> from_json(const std::string& data) {
+        return from_json(data.data(), data.size());
+    }
+
+    /**
+     * @brief Deserialize chunks from a JSON stream, reading it through a fixed window
+     */
+    static std::vector<std::vector<T>> from_json(std::istream& is) {
+        return detail::JsonReader(is).read_chunks<T>();
     }
 
     /**
      * @brief Serialize chunks to Protocol Buffers format
+     *
+     * Writes a chunk_serialization.ChunkSet message (proto/chunk_set.proto)
+     * without a protobuf library. Each chunk is a length-delimited Chunk
+     * whose values are one packed field: double/float for floating-point T,
+     * zigzag sint64 for signed and uint64 for unsigned integers. The output
+     * is sized exactly before it is written.
+     *
      * @param chunks Vector of chunk data
      * @return Protobuf binary string
-     * @throws std::runtime_error if Protobuf support not available
+     * @throws std::invalid_argument if validation fails
      */
     std::string to_protobuf(const std::vector<std::vector<T>>& chunks) {
         validate_chunks(chunks);
-        throw std::runtime_error("Protocol Buffers serialization not implemented");
+
+        std::vector<size_t> payload_bytes(chunks.size());
+        size_t bytes = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            payload_bytes[i] = detail::protobuf_packed_size(chunks[i].data(), chunks[i].size());
+            const size_t chunk_bytes = detail::protobuf_chunk_size(payload_bytes[i]);
+            bytes += 1 + detail::varint_size(chunk_bytes) + chunk_bytes;
+        }
+        std::string result(bytes, '\0');
+        uint8_t* out = reinterpret_cast<uint8_t*>(&result[0]);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            out = detail::write_protobuf_chunk(out, chunks[i].data(), chunks[i].size(),
+                                               payload_bytes[i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Deserialize chunks from Protocol Buffers format
+     *
+     * Reads any ChunkSet encoding a protobuf library may produce: values in
+     * any of the Chunk fields, packed or not, with unknown fields skipped.
+     *
+     * @param data Serialized ChunkSet message
+     * @param size Number of bytes
+     * @return Decoded chunks
+     * @throws chunk_processing::SerializationError if the data is malformed or holds a
+     *         value that T cannot represent
+     */
+    static std::vector<std::vector<T>> from_protobuf(const uint8_t* data, size_t size) {
+        detail::ProtobufReader reader(data, size);
+        std::vector<std::vector<T>> chunks;
+        while (!reader.done()) {
+            const uint64_t key = reader.read_varint();
+            if (key == detail::protobuf_key(detail::PROTOBUF_CHUNKSET_CHUNKS,
+                                            detail::PROTOBUF_WIRE_LEN)) {
+                chunks.emplace_back();
+                detail::ProtobufReader chunk = reader.read_length_delimited();
+                chunk.read_chunk(chunks.back());
+            } else {
+                reader.skip(static_cast<uint32_t>(key & 7));
+            }
+        }
+        return chunks;
+    }
+
+    static std::vector<std::vector<T>> from_protobuf(const std::string& data) {
+        return from_protobuf(reinterpret_cast<const uint8_t*>(data.data()), data.size());
     }
 
     /**
      * @brief Serialize chunks to MessagePack format
+     *
+     * The chunk set is an array of arrays. Every value uses the fixed-width
+     * encoding of T (float 32/64, int/uint 8-64), so the output is sized
+     * exactly up front and each chunk is written in one pass.
+     *
      * @param chunks Vector of chunk data
      * @return MessagePack binary string
-     * @throws std::runtime_error if MessagePack support not available
+     * @throws std::invalid_argument if validation fails
      */
     std::string to_msgpack(const std::vector<std::vector<T>>& chunks) {
         validate_chunks(chunks);
 
-        // Basic implementation without MessagePack dependency
-        std::string result = "[";
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            result += "[";
-            for (size_t j = 0; j < chunks[i].size(); ++j) {
-                result += std::to_string(chunks[i][j]);
-                if (j < chunks[i].size() - 1) {
-                    result += ",";
-                }
+        size_t bytes = detail::msgpack_array_header_size(chunks.size());
+        for (const auto& chunk : chunks) {
+            bytes += detail::msgpack_array_header_size(chunk.size()) +
+                     chunk.size() * (1 + sizeof(T));
+        }
+        std::string result(bytes, '\0');
+        uint8_t* out = reinterpret_cast<uint8_t*>(&result[0]);
+        out = detail::write_msgpack_array_header(out, chunks.size());
+        for (const auto& chunk : chunks) {
+            out = detail::write_msgpack_array_header(out, chunk.size());
+            out = detail::write_msgpack_values(out, chunk.data(), chunk.size());
+        }
+        return result;
+    }
+
+    /**
+     * @brief Stream chunks to an output stream in MessagePack format
+     *
+     * Produces the same bytes as to_msgpack() through a fixed-size buffer,
+     * so memory use does not grow with the chunk set.
+     *
+     * @param os Destination stream
+     * @param chunks Vector of chunk data
+     * @throws std::invalid_argument if validation fails
+     * @throws chunk_processing::SerializationError if the stream fails
+     */
+    void write_msgpack(std::ostream& os, const std::vector<std::vector<T>>& chunks) {
+        validate_chunks(chunks);
+
+        constexpr size_t values_per_write = 4096;
+        std::vector<uint8_t> buffer(5 + values_per_write * (1 + sizeof(T)));
+        auto flush = [&](const uint8_t* end) {
+            os.write(reinterpret_cast<const char*>(buffer.data()),
+                     static_cast<std::streamsize>(end - buffer.data()));
+            if (!os) {
+                throw chunk_processing::SerializationError("Failed to write MessagePack stream");
             }
-            result += "]";
-            if (i < chunks.size() - 1) {
-                result += ",";
+        };
+        flush(detail::write_msgpack_array_header(buffer.data(), chunks.size()));
+        for (const auto& chunk : chunks) {
+            uint8_t* out = detail::write_msgpack_array_header(buffer.data(), chunk.size());
+            for (size_t i = 0; i < chunk.size(); i += values_per_write) {
+                const size_t n = std::min(values_per_write, chunk.size() - i);
+                flush(detail::write_msgpack_values(out, chunk.data() + i, n));
+                out = buffer.data();
             }
         }
-        result += "]";
-        return result;
+    }
+
+    /**
+     * @brief Deserialize chunks from MessagePack format
+     *
+     * Accepts an array of arrays of numbers in any MessagePack integer or
+     * float encoding, not only the fixed-width one to_msgpack() writes.
+     *
+     * @param data MessagePack bytes
+     * @param size Number of bytes
+     * @return Decoded chunks
+     * @throws chunk_processing::SerializationError if the data is malformed, holds a
+     *         non-numeric value, or holds a value that T cannot represent
+     */
+    static std::vector<std::vector<T>> from_msgpack(const uint8_t* data, size_t size) {
+        detail::MsgpackReader reader(data, size);
+        std::vector<std::vector<T>> chunks(reader.read_array_header());
+        for (auto& chunk : chunks) {
+            chunk.resize(reader.read_array_header());
+            reader.read_values(chunk.data(), chunk.size());
+        }
+        if (reader.remaining() != 0) {
+            throw chunk_processing::SerializationError("Trailing bytes after MessagePack data");
+        }
+        return chunks;
+    }
+
+    static std::vector<std::vector<T>> from_msgpack(const std::string& data) {
+        return from_msgpack(reinterpret_cast<const uint8_t*>(data.data()), data.size());
     }
 
 private:
+    template <typename Sink>
+    void write_json_impl(const std::vector<std::vector<T>>& chunks, const JsonOptions& options,
+                         Sink& sink) {
+        validate_chunks(chunks);
+        detail::JsonWriter<Sink>(options, sink).write(chunks);
+    }
+
     /**
      * @brief Validate chunk data before serialization
      * @param chunks Vector of chunk data to validate
@@ -0,0 +1,193 @@
+/**
+ * @file chunk_thread_pool.hpp
+ * @brief Shared worker pool for data-parallel chunk operations
+ */
+
+#pragma once
+
+#include "chunk_common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chunk_processing {
+
+/**
+ * @brief Fixed-size pool of worker threads with a blocking parallel_for
+ *
+ * The calling thread always takes part in parallel_for, so the pool can be
+ * used from inside its own tasks without deadlocking and a pool with zero
+ * workers simply runs everything inline.
+ */
+class CHUNK_EXPORT ThreadPool {
+public:
+    /**
+     * @brief Create a pool
+     * @param num_workers Number of background workers (0 runs everything on the caller)
+     */
+    explicit ThreadPool(size_t num_workers) {
+        workers_.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Process-wide pool sized to the hardware concurrency
+     */
+    static ThreadPool& shared() {
+        static ThreadPool pool(default_worker_count());
+        return pool;
+    }
+
+    /**
+     * @brief Number of threads that execute a parallel_for, including the caller
+     */
+    size_t concurrency() const {
+        return workers_.size() + 1;
+    }
+
+    /**
+     * @brief Queue a task for a worker (runs inline when there are no workers)
+     */
+    void submit(std::function<void()> task) {
+        if (workers_.empty()) {
+            task();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Run body(block_begin, block_end) over [begin, end) split into blocks
+     *
+     * Blocks are at least @p grain elements long. Returns once every block has
+     * finished; the first exception thrown by a block is rethrown here.
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Minimum block length (0 is treated as 1)
+     * @param body Callable invoked as body(size_t, size_t)
+     */
+    template <typename Body>
+    void parallel_for(size_t begin, size_t end, size_t grain, Body&& body) {
+        if (end <= begin) {
+            return;
+        }
+        const size_t length = end - begin;
+        grain = std::max<size_t>(grain, 1);
+        // A few blocks per thread keeps load balanced without tiny blocks
+        size_t blocks = std::min((length + grain - 1) / grain, concurrency() * 4);
+        if (blocks <= 1 || workers_.empty()) {
+            body(begin, end);
+            return;
+        }
+
+        struct State {
+            std::function<void(size_t, size_t)> body;
+            size_t begin = 0;
+            size_t length = 0;
+            size_t blocks = 0;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+
+            // Claim and run blocks until none are left
+            void drain() {
+                size_t block;
+                while ((block = next.fetch_add(1)) < blocks) {
+                    size_t lo = begin + length * block / blocks;
+                    size_t hi = begin + length * (block + 1) / blocks;
+                    try {
+                        body(lo, hi);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    if (done.fetch_add(1) + 1 == blocks) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        finished.notify_all();
+                    }
+                }
+            }
+        };
+
+        auto state = std::make_shared<State>();
+        state->body = std::forward<Body>(body);
+        state->begin = begin;
+        state->length = length;
+        state->blocks = blocks;
+
+        size_t helpers = std::min(workers_.size(), blocks - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            submit([state]() { state->drain(); });
+        }
+        state->drain();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&]() { return state->done.load() == state->blocks; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+private:
+    static size_t default_worker_count() {
+        size_t hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 0;
+    }
+
+    void worker_loop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (stopping_ && tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+} // namespace chunk_processing
@@ -0,0 +1,643 @@
+/**
+ * @file cpu_chunking.hpp
+ * @brief CPU implementation of the GPUChunking windowed-variance boundary rule
+ *
+ * A position idx in [1, n - window) is a boundary when
+ *
+ *     |data[idx] - data[idx - 1]| > threshold * (max - min)  and
+ *     variance > threshold * mean
+ *
+ * where max, min, mean and (population) variance are taken over the window
+ * data[idx, idx + window). This is the rule evaluated by chunk_kernel in
+ * gpu_chunking.hpp. Min/max come from monotonic deques and the window sum
+ * and sum of squares slide in O(1) per position, so the cost is O(n)
+ * regardless of the window size.
+ *
+ * For integral data of up to 32 bits the sums are exact integers and the
+ * results match compute_boundaries_reference bit for bit. Floating-point and
+ * 64-bit data slide double sums with error compensation, and every
+ * REANCHOR_INTERVAL positions (at least once per window) the sums are
+ * recomputed from the window, for amortized O(1) per position. Their
+ * variance and mean can then differ from the reference's by rounding,
+ * so a flag can differ only where variance and threshold * mean are equal to
+ * within that rounding. Anchors sit at fixed indices, so a backend gives the
+ * same flags however the positions are split across threads.
+ *
+ * The rule is registered as a chunk_backend::Kernel with scalar, AVX2,
+ * AVX-512, multithreaded and (with HAVE_CUDA) CUDA variants; callers get the
+ * best one for the host unless they ask for a specific backend.
+ */
+
+#pragma once
+
+#include "chunk_backend.hpp"
+#include "chunk_common.hpp"
+#include "chunk_thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace gpu_chunking {
+
+namespace detail {
+
+#ifdef __SIZEOF_INT128__
+using wide_int = __int128;
+constexpr bool HAS_WIDE_INT = true;
+#else
+using wide_int = long double;
+constexpr bool HAS_WIDE_INT = false;
+#endif
+
+/// Positions between exact recomputations of inexact sliding sums (or the window, if longer)
+constexpr size_t REANCHOR_INTERVAL = 1024;
+
+/**
+ * @brief Accumulator types for a window sum and sum of squares
+ *
+ * exact is true where the accumulators are integers that cannot overflow:
+ * the sum of up to 2^31 values of 32 bits (any int window) fits int64_t and
+ * the variance numerator window * sum_sq fits a 128-bit integer.
+ */
+template <typename T,
+          bool = std::is_integral<T>::value && sizeof(T) <= 4 && HAS_WIDE_INT>
+struct window_sums {
+    using sum_type = int64_t;
+    using square_type = wide_int;
+    static constexpr bool exact = true;
+};
+
+template <typename T>
+struct window_sums<T, false> {
+    using sum_type = double;
+    using square_type = double;
+    static constexpr bool exact = false;
+};
+
+/**
+ * @brief Population variance of a window from its sum and sum of squares
+ *
+ * For integral data w*Q - S*S is computed exactly before the single
+ * floating-point division, so every caller gets bit-identical results.
+ */
+template <typename S, typename Q>
+inline double window_variance(S sum, Q sum_sq, size_t window) {
+    if constexpr (std::is_integral<S>::value) {
+        wide_int w = static_cast<wide_int>(window);
+        wide_int numerator = w * sum_sq - static_cast<wide_int>(sum) * sum;
+        return static_cast<double>(numerator) / (static_cast<double>(window) * window);
+    } else {
+        double mean = sum / static_cast<double>(window);
+        return std::max(0.0, sum_sq / static_cast<double>(window) - mean * mean);
+    }
+}
+
+template <typename T>
+inline typename window_sums<T>::square_type square(T value) {
+    using Q = typename window_sums<T>::square_type;
+    return static_cast<Q>(value) * static_cast<Q>(value);
+}
+
+/**
+ * @brief Double sum that keeps the rounding error of each addition (Knuth's two-sum)
+ *
+ * A large value that enters and later leaves the window takes its rounding
+ * with it, instead of leaving it in the sum for the following windows.
+ */
+class CompensatedSum {
+public:
+    void add(double x) {
+        const double t = sum_ + x;
+        const double z = t - sum_;
+        error_ += (sum_ - (t - z)) + (x - z);
+        sum_ = t;
+    }
+
+    double value() const {
+        return sum_ + error_;
+    }
+
+private:
+    double sum_ = 0.0;
+    double error_ = 0.0;
+};
+
+/**
+ * @brief Window sum and sum of squares that slide as values enter and leave
+ *
+ * Exact accumulators never need anchoring; see the specialization below.
+ */
+template <typename T, bool = window_sums<T>::exact>
+class SlidingSums {
+public:
+    using sum_type = typename window_sums<T>::sum_type;
+    using square_type = typename window_sums<T>::square_type;
+
+    void add(T v) {
+        sum_ += static_cast<sum_type>(v);
+        sum_sq_ += square(v);
+    }
+    void remove(T v) {
+        sum_ -= static_cast<sum_type>(v);
+        sum_sq_ -= square(v);
+    }
+    sum_type sum() const {
+        return sum_;
+    }
+    square_type sum_sq() const {
+        return sum_sq_;
+    }
+
+private:
+    sum_type sum_ = 0;
+    square_type sum_sq_ = 0;
+};
+
+template <typename T>
+class SlidingSums<T, false> {
+public:
+    void add(T v) {
+        sum_.add(static_cast<double>(v));
+        sum_sq_.add(rounded_square(v));
+    }
+    void remove(T v) {
+        sum_.add(-static_cast<double>(v));
+        sum_sq_.add(-rounded_square(v));
+    }
+
+    /// Replace the sums by those of first[0, window), dropping the error of earlier slides
+    void anchor(const T* first, size_t window) {
+        sum_ = CompensatedSum();
+        sum_sq_ = CompensatedSum();
+        for (size_t j = 0; j < window; ++j) {
+            add(first[j]);
+        }
+    }
+
+    double sum() const {
+        return sum_.value();
+    }
+    double sum_sq() const {
+        return sum_sq_.value();
+    }
+
+private:
+    /**
+     * @brief The square rounded to double before it reaches a compensated sum
+     *
+     * Compilers that contract floating-point expressions (GCC by default)
+     * would otherwise fuse the multiply into the addition as an FMA, whose
+     * rounding the compensation cannot see. Adding zero cannot be folded
+     * while signed zeros are honoured, and fused with the multiply it still
+     * yields the rounded square.
+     */
+    static double rounded_square(T v) {
+        return square(v) + 0.0;
+    }
+
+    CompensatedSum sum_;
+    CompensatedSum sum_sq_;
+};
+
+/**
+ * @brief Fixed-capacity ring of indices used as a monotonic deque
+ */
+class IndexRing {
+public:
+    explicit IndexRing(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity + 1) {
+            cap <<= 1;
+        }
+        slots_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    bool empty() const {
+        return head_ == tail_;
+    }
+    size_t front() const {
+        return slots_[head_ & mask_];
+    }
+    size_t back() const {
+        return slots_[(tail_ - 1) & mask_];
+    }
+    void pop_front() {
+        ++head_;
+    }
+    void pop_back() {
+        --tail_;
+    }
+    void push_back(size_t index) {
+        slots_[tail_++ & mask_] = index;
+    }
+
+private:
+    std::vector<size_t> slots_;
+    size_t mask_ = 0;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+};
+
+/**
+ * @brief Evaluate the boundary rule for positions [lo, hi)
+ *
+ * Window statistics are gathered for a tile of positions by the sliding
+ * pass, then the comparisons run as a separate branch-free loop over the
+ * tile so the compiler can vectorize them.
+ */
+template <typename T>
+void boundaries_for_range(const T* data, size_t window, double threshold, size_t lo, size_t hi,
+                          uint8_t* out) {
+    constexpr bool exact = window_sums<T>::exact;
+    constexpr size_t TILE = 1024;
+    const size_t reanchor = std::max(window, REANCHOR_INTERVAL);
+
+    SlidingSums<T> sums;
+    IndexRing max_q(window);
+    IndexRing min_q(window);
+
+    auto push = [&](size_t j) {
+        const T v = data[j];
+        while (!max_q.empty() && data[max_q.back()] <= v) {
+            max_q.pop_back();
+        }
+        max_q.push_back(j);
+        while (!min_q.empty() && data[min_q.back()] >= v) {
+            min_q.pop_back();
+        }
+        min_q.push_back(j);
+    };
+
+    for (size_t j = lo; j < lo + window; ++j) {
+        push(j);
+    }
+    if constexpr (exact) {
+        for (size_t j = lo; j < lo + window; ++j) {
+            sums.add(data[j]);
+        }
+    } else {
+        // Slide from the anchor a sequential pass would have used, so splits agree bit for bit
+        const size_t first = lo - lo % reanchor;
+        sums.anchor(data + first, window);
+        for (size_t j = first; j < lo; ++j) {
+            sums.remove(data[j]);
+            sums.add(data[j + window]);
+        }
+    }
+
+    double range[TILE];
+    double variance[TILE];
+    double mean[TILE];
+    double step[TILE];
+
+    for (size_t tile = lo; tile < hi; tile += TILE) {
+        const size_t count = std::min(TILE, hi - tile);
+
+        // Sliding pass: window [i, i + window) is current when i is visited
+        for (size_t k = 0; k < count; ++k) {
+            const size_t i = tile + k;
+            if constexpr (!exact) {
+                if (i % reanchor == 0) {
+                    sums.anchor(data + i, window);
+                }
+            }
+            range[k] = static_cast<double>(data[max_q.front()]) -
+                       static_cast<double>(data[min_q.front()]);
+            variance[k] = window_variance(sums.sum(), sums.sum_sq(), window);
+            mean[k] = static_cast<double>(sums.sum()) / static_cast<double>(window);
+            step[k] = static_cast<double>(data[i]) - static_cast<double>(data[i - 1]);
+
+            if (i + 1 < hi) {
+                sums.remove(data[i]);
+                sums.add(data[i + window]);
+                if (max_q.front() == i) {
+                    max_q.pop_front();
+                }
+                if (min_q.front() == i) {
+                    min_q.pop_front();
+                }
+                push(i + window);
+            }
+        }
+
+        // Decision pass: independent per position
+        uint8_t* flags = out + tile;
+        for (size_t k = 0; k < count; ++k) {
+            const bool jump = std::fabs(step[k]) > threshold * range[k];
+            const bool spread = variance[k] > threshold * mean[k];
+            flags[k] = static_cast<uint8_t>(jump & spread);
+        }
+    }
+}
+
+/// Evaluate positions [lo, hi) of the boundary rule on one thread
+template <typename T>
+using RangeKernelFn = void(const T*, size_t, double, size_t, size_t, uint8_t*);
+
+/// Evaluate every position of the boundary rule for n elements
+template <typename T>
+using BoundaryKernelFn = void(const T*, size_t, size_t, double, uint8_t*);
+
+template <typename T>
+void range_scalar(const T* data, size_t window, double threshold, size_t lo, size_t hi,
+                  uint8_t* out) {
+    boundaries_for_range(data, window, threshold, lo, hi, out);
+}
+
+#if CHUNK_HAS_X86_DISPATCH
+template <typename T>
+CHUNK_TARGET_AVX2 void range_avx2(const T* data, size_t window, double threshold, size_t lo,
+                                  size_t hi, uint8_t* out) {
+    boundaries_for_range(data, window, threshold, lo, hi, out);
+}
+
+template <typename T>
+CHUNK_TARGET_AVX512 void range_avx512(const T* data, size_t window, double threshold, size_t lo,
+                                      size_t hi, uint8_t* out) {
+    boundaries_for_range(data, window, threshold, lo, hi, out);
+}
+#endif
+
+/**
+ * @brief Single-threaded variants, one per instruction set
+ */
+template <typename T>
+const chunk_backend::Kernel<RangeKernelFn<T>>& range_kernel() {
+    static const chunk_backend::Kernel<RangeKernelFn<T>> kernel = []() {
+        chunk_backend::Kernel<RangeKernelFn<T>> k("gpu_chunking.boundary_range");
+        k.add(chunk_backend::Backend::Scalar, &range_scalar<T>);
+#if CHUNK_HAS_X86_DISPATCH
+        k.add(chunk_backend::Backend::AVX2, &range_avx2<T>);
+        k.add(chunk_backend::Backend::AVX512, &range_avx512<T>);
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+/// Run a single-threaded range variant over all positions
+template <typename T, RangeKernelFn<T>* Range>
+void boundaries_single(const T* data, size_t n, size_t window, double threshold, uint8_t* out) {
+    if (n > window + 1) {
+        Range(data, window, threshold, 1, n - window, out);
+    }
+}
+
+/// Split positions across a pool, each block using the best ISA variant
+template <typename T>
+void boundaries_on_pool(chunk_processing::ThreadPool& pool, const T* data, size_t n,
+                        size_t window, double threshold, uint8_t* out) {
+    if (n <= window + 1) {
+        return;
+    }
+    auto range = range_kernel<T>().resolve();
+    // Each block re-primes its window and slides from the last anchor, so keep blocks long
+    const size_t grain = std::max<size_t>(16384, window * 8);
+    pool.parallel_for(1, n - window, grain, [&](size_t lo, size_t hi) {
+        range(data, window, threshold, lo, hi, out);
+    });
+}
+
+template <typename T>
+void boundaries_threaded(const T* data, size_t n, size_t window, double threshold, uint8_t* out) {
+    boundaries_on_pool(chunk_processing::ThreadPool::shared(), data, n, window, threshold, out);
+}
+
+#ifdef HAVE_CUDA
+// Defined in gpu_chunking.hpp, which is included at the end of this header
+template <typename T>
+void boundaries_cuda(const T* data, size_t n, size_t window, double threshold, uint8_t* out);
+template <typename T>
+bool cuda_device_available();
+#endif
+
+} // namespace detail
+
+/**
+ * @brief All registered variants of the boundary rule
+ */
+template <typename T>
+const chunk_backend::Kernel<detail::BoundaryKernelFn<T>>& boundary_kernel() {
+    using chunk_backend::Backend;
+    static const chunk_backend::Kernel<detail::BoundaryKernelFn<T>> kernel = []() {
+        chunk_backend::Kernel<detail::BoundaryKernelFn<T>> k("gpu_chunking.boundaries");
+        k.add(Backend::Scalar, &detail::boundaries_single<T, &detail::range_scalar<T>>);
+#if CHUNK_HAS_X86_DISPATCH
+        k.add(Backend::AVX2, &detail::boundaries_single<T, &detail::range_avx2<T>>);
+        k.add(Backend::AVX512, &detail::boundaries_single<T, &detail::range_avx512<T>>);
+#endif
+        k.add(Backend::Threaded, &detail::boundaries_threaded<T>);
+#ifdef HAVE_CUDA
+        k.add(Backend::CUDA, &detail::boundaries_cuda<T>, &detail::cuda_device_available<T>);
+#endif
+        return k;
+    }();
+    return kernel;
+}
+
+/**
+ * @brief Straightforward O(n * window) evaluation of the boundary rule
+ *
+ * Mirrors the per-thread loop of chunk_kernel and is kept as the reference
+ * the optimized implementation is tested against.
+ *
+ * @param data Input values
+ * @param window_size Window length (must be positive)
+ * @param threshold Boundary threshold
+ * @return One flag per element, 1 where a chunk ends after that element
+ */
+template <typename T>
+std::vector<uint8_t> compute_boundaries_reference(const std::vector<T>& data, int window_size,
+                                                  float threshold) {
+    if (window_size <= 0) {
+        throw std::invalid_argument("Window size must be positive");
+    }
+    using S = typename detail::window_sums<T>::sum_type;
+    using Q = typename detail::window_sums<T>::square_type;
+    const size_t n = data.size();
+    const size_t window = static_cast<size_t>(window_size);
+    std::vector<uint8_t> boundaries(n, 0);
+
+    for (size_t idx = 1; idx + window < n; ++idx) {
+        S sum = S{};
+        Q sum_sq = Q{};
+        T window_max = data[idx];
+        T window_min = data[idx];
+        for (size_t i = 0; i < window; ++i) {
+            const T current = data[idx + i];
+            sum += static_cast<S>(current);
+            sum_sq += detail::square(current);
+            window_max = std::max(window_max, current);
+            window_min = std::min(window_min, current);
+        }
+
+        double mean = static_cast<double>(sum) / static_cast<double>(window);
+        double variance = detail::window_variance(sum, sum_sq, window);
+        double value_diff =
+            std::fabs(static_cast<double>(data[idx]) - static_cast<double>(data[idx - 1]));
+        double range = static_cast<double>(window_max) - static_cast<double>(window_min);
+
+        boundaries[idx] =
+            (value_diff > threshold * range) && (variance > threshold * mean) ? 1 : 0;
+    }
+    return boundaries;
+}
+
+/**
+ * @brief O(n) evaluation of the boundary rule on a chosen backend
+ * @param data Input values
+ * @param window_size Window length (must be positive)
+ * @param threshold Boundary threshold
+ * @param backend Backend to run on; Auto picks the best available
+ * @return One flag per element, as from compute_boundaries_reference (see the file
+ *         comment for floating-point and 64-bit data)
+ * @throws std::runtime_error if the requested backend is unavailable
+ */
+template <typename T>
+std::vector<uint8_t>
+compute_boundaries(const std::vector<T>& data, int window_size, float threshold,
+                   chunk_backend::Backend backend = chunk_backend::Backend::Auto) {
+    if (window_size <= 0) {
+        throw std::invalid_argument("Window size must be positive");
+    }
+    std::vector<uint8_t> boundaries(data.size(), 0);
+    boundary_kernel<T>().resolve(backend)(data.data(), data.size(),
+                                          static_cast<size_t>(window_size),
+                                          static_cast<double>(threshold), boundaries.data());
+    return boundaries;
+}
+
+/**
+ * @brief O(n) evaluation of the boundary rule, split across a specific thread pool
+ * @param data Input values
+ * @param window_size Window length (must be positive)
+ * @param threshold Boundary threshold
+ * @param pool Pool to run on
+ * @return One flag per element, as from compute_boundaries_reference (see the file
+ *         comment for floating-point and 64-bit data)
+ */
+template <typename T>
+std::vector<uint8_t> compute_boundaries(const std::vector<T>& data, int window_size,
+                                        float threshold, chunk_processing::ThreadPool* pool) {
+    if (!pool) {
+        return compute_boundaries(data, window_size, threshold);
+    }
+    if (window_size <= 0) {
+        throw std::invalid_argument("Window size must be positive");
+    }
+    std::vector<uint8_t> boundaries(data.size(), 0);
+    detail::boundaries_on_pool(*pool, data.data(), data.size(), static_cast<size_t>(window_size),
+                               static_cast<double>(threshold), boundaries.data());
+    return boundaries;
+}
+
+/**
+ * @brief Split data after every flagged position
+ * @param data Input values
+ * @param boundaries Flags as produced by compute_boundaries
+ * @return Chunks covering data in order
+ */
+template <typename T>
+std::vector<std::vector<T>> split_at_boundaries(const std::vector<T>& data,
+                                                const std::vector<uint8_t>& boundaries) {
+    std::vector<std::vector<T>> chunks;
+    if (data.empty()) {
+        return chunks;
+    }
+    chunks.reserve(std::count(boundaries.begin(), boundaries.end(), uint8_t{1}) + 1);
+    size_t start = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (boundaries[i] || i == data.size() - 1) {
+            chunks.emplace_back(data.begin() + start, data.begin() + i + 1);
+            start = i + 1;
+        }
+    }
+    return chunks;
+}
+
+/**
+ * @brief CPU backend with the same interface as GPUChunking
+ * @tparam T Element type (arithmetic)
+ */
+template <typename T>
+class CPUChunking {
+private:
+    int window_size;
+    float threshold;
+    chunk_processing::ThreadPool* pool;
+    chunk_backend::Backend backend = chunk_backend::Backend::Auto;
+
+public:
+    CPUChunking(int window_sz = 32, float thresh = 0.1f,
+                chunk_processing::ThreadPool* thread_pool = nullptr)
+        : window_size(window_sz), threshold(thresh), pool(thread_pool) {}
+
+    std::vector<std::vector<T>> chunk(const std::vector<T>& data) const {
+        if (data.empty())
+            return {};
+        return split_at_boundaries(data, boundaries(data));
+    }
+
+    /**
+     * @brief Boundary flags for data without materializing chunks
+     */
+    std::vector<uint8_t> boundaries(const std::vector<T>& data) const {
+        if (pool && backend == chunk_backend::Backend::Auto) {
+            return compute_boundaries(data, window_size, threshold, pool);
+        }
+        return compute_boundaries(data, window_size, threshold, backend);
+    }
+
+    /**
+     * @brief Pin a backend by name ("auto", "scalar", "sse2", "avx2", ..., "cuda")
+     * @throws std::invalid_argument for unknown names
+     */
+    void set_backend(const std::string& name) {
+        backend = chunk_backend::parse_backend(name);
+    }
+
+    std::string get_backend() const {
+        return chunk_backend::backend_name(backend);
+    }
+
+    // Getters and setters
+    void set_window_size(int size) {
+        if (size <= 0) {
+            throw std::invalid_argument("Window size must be positive");
+        }
+        window_size = size;
+    }
+
+    void set_threshold(float thresh) {
+        if (thresh <= 0.0f || thresh >= 1.0f) {
+            throw std::invalid_argument("Threshold must be between 0 and 1");
+        }
+        threshold = thresh;
+    }
+
+    int get_window_size() const {
+        return window_size;
+    }
+    float get_threshold() const {
+        return threshold;
+    }
+
+    static bool is_gpu_available() {
+        return false;
+    }
+
+    static std::string get_gpu_info() {
+        return "No CUDA-capable GPU found (using CPU backend)";
+    }
+};
+
+} // namespace gpu_chunking
+
+#ifdef HAVE_CUDA
+#include "gpu_chunking.hpp"
+#endif
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "cpu_chunking.hpp"
+
+#ifdef HAVE_CUDA
+
 #include <cuda_runtime.h>
 #include <device_launch_parameters.h>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace gpu_chunking {
@@ -65,7 +70,9 @@ class GPUChunking {
 private:
     int window_size;
     float threshold;
-    cudaStream_t stream;
+    cudaStream_t stream = nullptr;
+    bool use_gpu;
+    CPUChunking<T> cpu_fallback;
 
     // Helper to allocate GPU memory
     template <typename U>
@@ -89,39 +96,57 @@ private:
 
 public:
     GPUChunking(int window_sz = 32, float thresh = 0.1f)
-        : window_size(window_sz), threshold(thresh) {
-        CUDA_CHECK(cudaStreamCreate(&stream));
+        : window_size(window_sz), threshold(thresh), use_gpu(is_gpu_available()),
+          cpu_fallback(window_sz, thresh) {
+        if (use_gpu) {
+            CUDA_CHECK(cudaStreamCreate(&stream));
+        }
     }
 
     ~GPUChunking() {
-        cudaStreamDestroy(stream);
+        if (use_gpu) {
+            cudaStreamDestroy(stream);
+        }
     }
 
     std::vector<std::vector<T>> chunk(const std::vector<T>& data) {
         if (data.empty())
             return {};
 
+        // Same boundary rule on the CPU when no device is present
+        if (!use_gpu) {
+            return cpu_fallback.chunk(data);
+        }
+
+        return split_at_boundaries(data, device_boundaries(data.data(), data.size()));
+    }
+
+    /**
+     * @brief Run chunk_kernel on the device and return one flag per element
+     */
+    std::vector<uint8_t> device_boundaries(const T* data, size_t size) {
         // Allocate device memory
-        int* d_data = allocate_device_memory<int>(data.size());
-        int* d_boundaries = allocate_device_memory<int>(data.size());
+        int* d_data = allocate_device_memory<int>(size);
+        int* d_boundaries = allocate_device_memory<int>(size);
 
-        // Copy input data to GPU
-        copy_to_device(d_data, data.data(), data.size());
+        // Copy input data to GPU; positions the kernel skips are not boundaries
+        copy_to_device(d_data, data, size);
+        CUDA_CHECK(cudaMemsetAsync(d_boundaries, 0, size * sizeof(int), stream));
 
         // Configure kernel launch parameters
         const int BLOCK_SIZE = 256;
-        int num_blocks = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        int num_blocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
 
         // Launch kernel
-        chunk_kernel<<<num_blocks, BLOCK_SIZE, 0, stream>>>(d_data, d_boundaries, data.size(),
+        chunk_kernel<<<num_blocks, BLOCK_SIZE, 0, stream>>>(d_data, d_boundaries, size,
                                                             window_size, threshold);
 
         // Check for kernel errors
         CUDA_CHECK(cudaGetLastError());
 
         // Copy boundaries back to host
-        std::vector<int> boundaries(data.size());
-        copy_from_device(boundaries.data(), d_boundaries, data.size());
+        std::vector<int> boundaries(size);
+        copy_from_device(boundaries.data(), d_boundaries, size);
 
         // Synchronize stream
         CUDA_CHECK(cudaStreamSynchronize(stream));
@@ -130,21 +155,7 @@ public:
         CUDA_CHECK(cudaFree(d_data));
         CUDA_CHECK(cudaFree(d_boundaries));
 
-        // Create chunks based on boundaries
-        std::vector<std::vector<T>> chunks;
-        std::vector<T> current_chunk;
-
-        for (size_t i = 0; i < data.size(); ++i) {
-            current_chunk.push_back(data[i]);
-            if (boundaries[i] || i == data.size() - 1) {
-                if (!current_chunk.empty()) {
-                    chunks.push_back(std::move(current_chunk));
-                    current_chunk = std::vector<T>();
-                }
-            }
-        }
-
-        return chunks;
+        return std::vector<uint8_t>(boundaries.begin(), boundaries.end());
     }
 
     // Getters and setters
@@ -153,6 +164,7 @@ public:
             throw std::invalid_argument("Window size must be positive");
         }
         window_size = size;
+        cpu_fallback.set_window_size(size);
     }
 
     void set_threshold(float thresh) {
@@ -160,6 +172,7 @@ public:
             throw std::invalid_argument("Threshold must be between 0 and 1");
         }
         threshold = thresh;
+        cpu_fallback.set_threshold(thresh);
     }
 
     int get_window_size() const {
@@ -191,4 +204,34 @@ public:
     }
 };
 
-} // namespace gpu_chunking
\ No newline at end of file
+namespace detail {
+
+template <typename T>
+void boundaries_cuda(const T* data, size_t n, size_t window, double threshold, uint8_t* out) {
+    GPUChunking<T> gpu(static_cast<int>(window), static_cast<float>(threshold));
+    auto flags = gpu.device_boundaries(data, n);
+    std::copy(flags.begin(), flags.end(), out);
+}
+
+template <typename T>
+bool cuda_device_available() {
+    return GPUChunking<T>::is_gpu_available();
+}
+
+} // namespace detail
+
+} // namespace gpu_chunking
+
+#else // HAVE_CUDA
+
+namespace gpu_chunking {
+
+/**
+ * @brief Without CUDA, GPUChunking is the CPU implementation of the same rule
+ */
+template <typename T>
+using GPUChunking = CPUChunking<T>;
+
+} // namespace gpu_chunking
+
+#endif // HAVE_CUDA
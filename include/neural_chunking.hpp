@@ -29,19 +29,75 @@ public:
         initialize_weights();
     }
 
+    /**
+     * @brief Construct a layer that borrows externally owned parameters
+     *
+     * No copy is made; the caller (typically a MappedNeuralModel) must keep
+     * the storage alive for as long as the layer is used.
+     *
+     * @param input_size Number of inputs
+     * @param output_size Number of outputs
+     * @param weights Row-major output_size x input_size weight matrix
+     * @param biases output_size bias values
+     */
+    Layer(size_t input_size, size_t output_size, const T* weights, const T* biases)
+        : input_size_(input_size), output_size_(output_size), external_weights_(weights),
+          external_biases_(biases) {
+        if (!weights || !biases) {
+            throw std::invalid_argument("Borrowed layer parameters must not be null");
+        }
+    }
+
     std::vector<T> forward(const std::vector<T>& input) {
         if (input.size() != input_size_) {
             throw std::invalid_argument("Invalid input size");
         }
         std::vector<T> output(output_size_);
+        forward(input.data(), output.data());
+        return output;
+    }
+
+    /**
+     * @brief Forward pass into a caller-provided buffer
+     * @param input input_size() values
+     * @param output Receives output_size() values
+     */
+    void forward(const T* input, T* output) const {
+        const T* weights = weight_data();
+        const T* biases = bias_data();
         // Simple forward pass implementation
         for (size_t i = 0; i < output_size_; ++i) {
-            output[i] = biases_[i];
+            T sum = biases[i];
+            const T* row = weights + i * input_size_;
             for (size_t j = 0; j < input_size_; ++j) {
-                output[i] += input[j] * weights_[i * input_size_ + j];
+                sum += input[j] * row[j];
             }
+            output[i] = sum;
         }
-        return output;
+    }
+
+    size_t input_size() const {
+        return input_size_;
+    }
+    size_t output_size() const {
+        return output_size_;
+    }
+
+    /**
+     * @brief Row-major weight matrix (output_size x input_size)
+     */
+    const T* weight_data() const {
+        return external_weights_ ? external_weights_ : weights_.data();
+    }
+    const T* bias_data() const {
+        return external_biases_ ? external_biases_ : biases_.data();
+    }
+
+    /**
+     * @brief Whether the parameters are borrowed rather than owned
+     */
+    bool is_borrowed() const {
+        return external_weights_ != nullptr;
     }
 
 private:
@@ -49,6 +105,8 @@ private:
     size_t output_size_;
     std::vector<T> weights_;
     std::vector<T> biases_;
+    const T* external_weights_ = nullptr;
+    const T* external_biases_ = nullptr;
 
     void initialize_weights() {
         // Simple Xavier initialization
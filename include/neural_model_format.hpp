@@ -0,0 +1,316 @@
+/**
+ * @file neural_model_format.hpp
+ * @brief Versioned, memory-mappable binary weight format for neural chunking
+ *
+ * File layout (all fields in host byte order, guarded by an endianness tag):
+ *
+ *   [WeightFileHeader, 64 bytes]
+ *   [WeightLayerRecord x layer_count]
+ *   [padding to 64 bytes]
+ *   per layer: [weights, 64-byte aligned][biases, 64-byte aligned]
+ *
+ * The CRC-32 in the header covers the whole file, header included (with the
+ * checksum field read as zero), so the stored shapes, threshold and window
+ * size are protected as well as the parameters. Loading maps
+ * the file and hands out Layer objects that point straight into the mapping,
+ * so no parsing or copying of parameters happens at startup.
+ */
+
+#pragma once
+
+#include "chunk_io.hpp"
+#include "neural_chunking.hpp"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace neural_chunking {
+
+constexpr char WEIGHT_FILE_MAGIC[8] = {'C', 'N', 'K', 'N', 'N', 'W', 'G', 'T'};
+constexpr uint32_t WEIGHT_FILE_VERSION = 2;
+constexpr uint32_t WEIGHT_FILE_ALIGNMENT = 64;
+constexpr uint32_t WEIGHT_FILE_ENDIAN_TAG = 0x01020304u;
+
+/**
+ * @brief Element type identifiers stored in the weight file header
+ */
+enum class WeightType : uint32_t { Float32 = 1, Float64 = 2, Int32 = 3, Int64 = 4 };
+
+template <typename T>
+struct weight_type_of;
+template <>
+struct weight_type_of<float> : std::integral_constant<WeightType, WeightType::Float32> {};
+template <>
+struct weight_type_of<double> : std::integral_constant<WeightType, WeightType::Float64> {};
+template <>
+struct weight_type_of<int32_t> : std::integral_constant<WeightType, WeightType::Int32> {};
+template <>
+struct weight_type_of<int64_t> : std::integral_constant<WeightType, WeightType::Int64> {};
+
+/**
+ * @brief Fixed 64-byte file header
+ */
+struct WeightFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t weight_type;
+    uint32_t endian_tag;
+    uint64_t layer_count;
+    uint64_t window_size;
+    double threshold;
+    uint64_t file_size;
+    uint32_t checksum;  ///< CRC-32 of the whole file with this field zeroed
+    uint32_t alignment; ///< Alignment of every parameter block
+};
+static_assert(sizeof(WeightFileHeader) == 64, "WeightFileHeader must be 64 bytes");
+
+/**
+ * @brief Per-layer shape and parameter location
+ */
+struct WeightLayerRecord {
+    uint64_t input_size;
+    uint64_t output_size;
+    uint64_t weights_offset; ///< Byte offset of the output_size x input_size matrix
+    uint64_t biases_offset;  ///< Byte offset of the output_size bias vector
+};
+static_assert(sizeof(WeightLayerRecord) == 32, "WeightLayerRecord must be 32 bytes");
+
+/**
+ * @brief CRC-32 of a weight file image, reading the header's checksum field as zero
+ * @param image Whole file, at least sizeof(WeightFileHeader) bytes
+ * @param size Number of bytes in the file
+ */
+inline uint32_t weight_file_checksum(const unsigned char* image, size_t size) {
+    WeightFileHeader header;
+    std::memcpy(&header, image, sizeof(header));
+    header.checksum = 0;
+    const uint32_t crc = chunk_io::crc32(&header, sizeof(header));
+    return chunk_io::crc32_update(crc, image + sizeof(header), size - sizeof(header));
+}
+
+/**
+ * @brief Encode a chunker configuration and its layers into the weight format
+ * @param chunker Chunker whose window size and threshold are stored
+ * @param layers Layer stack, each layer's output feeding the next layer's input
+ * @return File image ready to be written to disk
+ * @throws std::invalid_argument if consecutive layer shapes do not match
+ */
+template <typename T>
+std::vector<unsigned char> serialize_model(const NeuralChunking<T>& chunker,
+                                           const std::vector<Layer<T>>& layers) {
+    for (size_t i = 1; i < layers.size(); ++i) {
+        if (layers[i].input_size() != layers[i - 1].output_size()) {
+            throw std::invalid_argument("Layer " + std::to_string(i) +
+                                        " input size does not match previous output size");
+        }
+    }
+
+    // Lay out every parameter block on an aligned boundary
+    std::vector<WeightLayerRecord> records(layers.size());
+    uint64_t offset = chunk_io::align_up(sizeof(WeightFileHeader) +
+                                             layers.size() * sizeof(WeightLayerRecord),
+                                         WEIGHT_FILE_ALIGNMENT);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        records[i].input_size = layers[i].input_size();
+        records[i].output_size = layers[i].output_size();
+        records[i].weights_offset = offset;
+        offset = chunk_io::align_up(offset + records[i].input_size * records[i].output_size *
+                                                 sizeof(T),
+                                    WEIGHT_FILE_ALIGNMENT);
+        records[i].biases_offset = offset;
+        offset =
+            chunk_io::align_up(offset + records[i].output_size * sizeof(T), WEIGHT_FILE_ALIGNMENT);
+    }
+
+    std::vector<unsigned char> image(offset, 0);
+    std::memcpy(image.data() + sizeof(WeightFileHeader), records.data(),
+                records.size() * sizeof(WeightLayerRecord));
+    for (size_t i = 0; i < layers.size(); ++i) {
+        std::memcpy(image.data() + records[i].weights_offset, layers[i].weight_data(),
+                    records[i].input_size * records[i].output_size * sizeof(T));
+        std::memcpy(image.data() + records[i].biases_offset, layers[i].bias_data(),
+                    records[i].output_size * sizeof(T));
+    }
+
+    WeightFileHeader header{};
+    std::memcpy(header.magic, WEIGHT_FILE_MAGIC, sizeof(header.magic));
+    header.version = WEIGHT_FILE_VERSION;
+    header.header_size = sizeof(WeightFileHeader);
+    header.weight_type = static_cast<uint32_t>(weight_type_of<T>::value);
+    header.endian_tag = WEIGHT_FILE_ENDIAN_TAG;
+    header.layer_count = layers.size();
+    header.window_size = chunker.get_window_size();
+    header.threshold = chunker.get_threshold();
+    header.file_size = image.size();
+    header.alignment = WEIGHT_FILE_ALIGNMENT;
+    std::memcpy(image.data(), &header, sizeof(header));
+    header.checksum = weight_file_checksum(image.data(), image.size());
+    std::memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+/**
+ * @brief Write a chunker configuration and its layers to a weight file
+ *
+ * The file is written to a temporary sibling and renamed into place, so a
+ * service mapping the path never sees a partially written model.
+ *
+ * @param path Destination file
+ * @param chunker Chunker whose window size and threshold are stored
+ * @param layers Layer stack to store
+ * @throws chunk_processing::SerializationError if the file cannot be written
+ */
+template <typename T>
+void save_model(const std::string& path, const NeuralChunking<T>& chunker,
+                const std::vector<Layer<T>>& layers) {
+    auto image = serialize_model(chunker, layers);
+    chunk_io::write_file_atomic(path, image.data(), image.size());
+}
+
+/**
+ * @brief A weight file mapped into memory and used in place
+ *
+ * The returned layers borrow their parameters from the mapping; they stay
+ * valid for the lifetime of the MappedNeuralModel (moving the model keeps
+ * them valid because the mapping itself does not move).
+ *
+ * @tparam T Parameter type; must match the type the file was written with
+ */
+template <typename T>
+class CHUNK_EXPORT MappedNeuralModel {
+public:
+    /**
+     * @brief Map and validate a weight file
+     * @param path File written by save_model
+     * @param verify_checksum Verify the CRC-32 of the header and parameters.
+     *        This touches every page; disable it to defer page faults until the
+     *        parameters are first used.
+     * @throws chunk_processing::SerializationError if the file is malformed
+     */
+    explicit MappedNeuralModel(const std::string& path, bool verify_checksum = true)
+        : file_(path) {
+        const unsigned char* base = file_.data();
+        const size_t size = file_.size();
+
+        if (size < sizeof(WeightFileHeader)) {
+            fail("file too small for header");
+        }
+        std::memcpy(&header_, base, sizeof(header_));
+        if (std::memcmp(header_.magic, WEIGHT_FILE_MAGIC, sizeof(header_.magic)) != 0) {
+            fail("bad magic");
+        }
+        if (header_.version != WEIGHT_FILE_VERSION) {
+            fail("unsupported version " + std::to_string(header_.version));
+        }
+        if (header_.endian_tag != WEIGHT_FILE_ENDIAN_TAG) {
+            fail("byte order does not match this host");
+        }
+        if (header_.header_size != sizeof(WeightFileHeader) ||
+            header_.alignment != WEIGHT_FILE_ALIGNMENT) {
+            fail("unexpected header size or alignment");
+        }
+        if (header_.weight_type != static_cast<uint32_t>(weight_type_of<T>::value)) {
+            fail("parameter type does not match the requested type");
+        }
+        if (header_.file_size != size) {
+            fail("file size mismatch (truncated?)");
+        }
+        if (header_.layer_count > (size - sizeof(WeightFileHeader)) / sizeof(WeightLayerRecord)) {
+            fail("layer table exceeds file size");
+        }
+        if (verify_checksum && weight_file_checksum(base, size) != header_.checksum) {
+            fail("checksum mismatch");
+        }
+
+        const auto* table = base + sizeof(WeightFileHeader);
+        layers_.reserve(header_.layer_count);
+        for (uint64_t i = 0; i < header_.layer_count; ++i) {
+            WeightLayerRecord record;
+            std::memcpy(&record, table + i * sizeof(WeightLayerRecord), sizeof(record));
+            if (record.input_size != 0 &&
+                record.output_size > std::numeric_limits<uint64_t>::max() / record.input_size) {
+                fail("layer shape overflows");
+            }
+            validate_block(record.weights_offset, record.input_size * record.output_size, size);
+            validate_block(record.biases_offset, record.output_size, size);
+            if (i > 0 && record.input_size != layers_.back().output_size()) {
+                fail("layer shapes do not chain");
+            }
+            layers_.emplace_back(record.input_size, record.output_size,
+                                 reinterpret_cast<const T*>(base + record.weights_offset),
+                                 reinterpret_cast<const T*>(base + record.biases_offset));
+        }
+    }
+
+    const std::vector<Layer<T>>& layers() const {
+        return layers_;
+    }
+
+    size_t window_size() const {
+        return static_cast<size_t>(header_.window_size);
+    }
+
+    double threshold() const {
+        return header_.threshold;
+    }
+
+    /**
+     * @brief Create a chunker configured from the stored parameters
+     */
+    NeuralChunking<T> make_chunker() const {
+        return NeuralChunking<T>(window_size(), threshold());
+    }
+
+    /**
+     * @brief Run the input through every layer in order
+     * @param input Values for the first layer
+     * @return Output of the last layer (the input itself if there are no layers)
+     */
+    std::vector<T> forward(const std::vector<T>& input) const {
+        if (layers_.empty()) {
+            return input;
+        }
+        if (input.size() != layers_.front().input_size()) {
+            throw std::invalid_argument("Invalid input size");
+        }
+        std::vector<T> current = input;
+        std::vector<T> next;
+        for (const auto& layer : layers_) {
+            next.resize(layer.output_size());
+            layer.forward(current.data(), next.data());
+            current.swap(next);
+        }
+        return current;
+    }
+
+    /**
+     * @brief Ask the OS to start paging the parameters in
+     */
+    void prefetch() const {
+        file_.prefetch();
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw chunk_processing::SerializationError("Invalid neural weight file: " + reason);
+    }
+
+    void validate_block(uint64_t offset, uint64_t count, size_t file_size) const {
+        if (offset % WEIGHT_FILE_ALIGNMENT != 0) {
+            fail("misaligned parameter block");
+        }
+        if (count > 0 && (offset > file_size || count > (file_size - offset) / sizeof(T))) {
+            fail("parameter block exceeds file size");
+        }
+    }
+
+    chunk_io::MappedFile file_;
+    WeightFileHeader header_{};
+    std::vector<Layer<T>> layers_;
+};
+
+} // namespace neural_chunking
@@ -0,0 +1,135 @@
+/**
+ * @file allocation_hooks.cpp
+ * @brief Replaceable global operator new/delete that feed AllocationTracker
+ *
+ * Compile this file into an executable (not a library) to count its heap
+ * allocations. Each block carries a 16-byte header holding the requested
+ * size and the pointer returned by malloc, so unsized and over-aligned
+ * deletes can be accounted for as well.
+ */
+
+#include "chunk_allocation.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+using chunk_benchmark::AllocationTracker;
+
+struct BlockHeader {
+    size_t size;
+    void* base;
+};
+
+constexpr size_t HEADER_BYTES = 16;
+static_assert(sizeof(BlockHeader) <= HEADER_BYTES, "Block header must fit its slot");
+
+void* allocate(size_t size, size_t alignment) noexcept {
+    if (alignment < HEADER_BYTES) {
+        alignment = HEADER_BYTES;
+    }
+    if (size > SIZE_MAX - alignment) {
+        return nullptr;
+    }
+    // malloc returns 16-byte aligned memory, so alignment - 16 bytes of slack always suffice
+    void* base = std::malloc(size + alignment);
+    if (!base) {
+        return nullptr;
+    }
+    const uintptr_t first = reinterpret_cast<uintptr_t>(base) + HEADER_BYTES;
+    auto* user = reinterpret_cast<char*>((first + alignment - 1) & ~(uintptr_t{alignment} - 1));
+    auto* header = reinterpret_cast<BlockHeader*>(user - HEADER_BYTES);
+    header->size = size;
+    header->base = base;
+    AllocationTracker::record_allocation(size);
+    return user;
+}
+
+void* allocate_or_throw(size_t size, size_t alignment) {
+    for (;;) {
+        if (void* p = allocate(size, alignment)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocate(void* p) noexcept {
+    if (!p) {
+        return;
+    }
+    auto* header = reinterpret_cast<BlockHeader*>(static_cast<char*>(p) - HEADER_BYTES);
+    AllocationTracker::record_deallocation(header->size);
+    std::free(header->base);
+}
+
+const bool installed = (AllocationTracker::mark_installed(), true);
+
+} // namespace
+
+void* operator new(size_t size) {
+    return allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size) {
+    return allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, std::align_val_t) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
@@ -1,46 +1,911 @@
 /**
  * @file benchmark.cpp
- * @brief Implementation of benchmarking utilities
+ * @brief Benchmark suite covering the library's strategies, structures and codecs
  * @author Jonathan Reich
  * @date 2024-12-07
+ *
+ * Every benchmark is named group/case/distribution/size, e.g.
+ * "strategies/variance/random_walk/1000000", and runs on a deterministic
+ * input so results are comparable between releases.
+ *
+ * Usage: benchmark_exe [options]
+ *   --filter REGEX         Run only benchmarks whose name matches REGEX
+ *   --sizes LIST           Comma-separated input sizes (default 1e3,1e4,1e5,1e6; up to 1e9)
+ *   --distributions LIST   Any of uniform,random_walk,steps,bursty,text (default all)
+ *   --iterations N         Timed runs per benchmark (default 10, fewer above 10^6 elements)
+ *   --warmup N             Untimed runs per benchmark (default 1, none above 10^7 elements)
+ *   --format FORMAT        text, csv or json (default text)
+ *   --output FILE          Write results to FILE instead of standard output
+ *   --perf                 Collect hardware performance counters
+ *   --list                 Print the names of the selected benchmarks and exit
+ *
+ * Cases that are quadratic (mutual information), need far more memory than
+ * their input (graph-based chunking, the node-based structures), start a
+ * thread per chunk (ParallelChunkProcessor) or degrade on some distributions
+ * (exact silhouette) are capped at a smaller size and skipped above it.
  */
 
+#include "advanced_structures.hpp"
 #include "chunk.hpp"
+#include "chunk_adaptive_compression.hpp"
+#include "chunk_arrow.hpp"
+#include "chunk_batch_compression.hpp"
 #include "chunk_benchmark.hpp"
+#include "chunk_compression.hpp"
+#include "chunk_dictionary.hpp"
+#include "chunk_entropy.hpp"
+#include "chunk_metrics.hpp"
+#include "chunk_serialization.hpp"
 #include "chunk_strategies.hpp"
 #include "chunk_strategy_implementations.hpp"
-#include <chrono>
+#include "cpu_chunking.hpp"
+#include "neural_chunking.hpp"
+#include "parallel_chunk.hpp"
+#include "sophisticated_chunking.hpp"
+#include "sub_chunk_strategies.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
-template <typename T>
-void run_benchmark(const std::vector<T>& data) {
-    chunk_benchmark::ChunkBenchmark<T> benchmark(data);
+namespace {
 
-    // Add different chunking strategies
-    benchmark.add_strategy(std::make_shared<chunk_processing::NeuralChunkingStrategy<T>>());
-    benchmark.add_strategy(std::make_shared<chunk_processing::SimilarityChunkingStrategy<T>>(0.5));
+using chunk_benchmark::BenchmarkOptions;
+using chunk_benchmark::BenchmarkResult;
 
-    // Run benchmark and print results
-    auto results = benchmark.benchmark_chunking();
-    for (const auto& result : results) {
-        std::cout << "Strategy: " << result.strategy_name << "\n"
-                  << "  Execution time: " << result.execution_time_ms << " ms\n"
-                  << "  Memory usage: " << result.memory_usage_bytes << " bytes\n"
-                  << "  Average chunks: " << result.num_chunks << "\n\n";
+constexpr size_t CHUNK_LENGTH = 256; ///< Values per chunk for the chunk-level benchmarks
+constexpr uint64_t SEED = 42;
+
+const std::vector<std::string> DISTRIBUTIONS = {"uniform", "random_walk", "steps", "bursty",
+                                                "text"};
+
+std::vector<double> generate(const std::string& distribution, size_t n) {
+    std::mt19937_64 rng(SEED);
+    std::uniform_real_distribution<double> uniform(0.0, 100.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> values(n);
+
+    if (distribution == "uniform") {
+        for (auto& v : values) {
+            v = uniform(rng);
+        }
+    } else if (distribution == "random_walk") {
+        double x = 0.0;
+        for (auto& v : values) {
+            x += normal(rng);
+            v = x;
+        }
+    } else if (distribution == "steps") {
+        // Plateaus with a mean length of 1000 and a little noise
+        std::geometric_distribution<size_t> run_length(1.0 / 1000.0);
+        size_t i = 0;
+        while (i < n) {
+            const double level = uniform(rng);
+            const size_t end = std::min(n, i + 1 + run_length(rng));
+            for (; i < end; ++i) {
+                values[i] = level + 0.1 * normal(rng);
+            }
+        }
+    } else if (distribution == "bursty") {
+        // Quiet baseline with rare bursts of 10 to 100 large values
+        std::bernoulli_distribution burst_starts(0.001);
+        std::uniform_int_distribution<size_t> burst_length(10, 100);
+        size_t remaining = 0;
+        for (auto& v : values) {
+            if (remaining == 0 && burst_starts(rng)) {
+                remaining = burst_length(rng);
+            }
+            if (remaining > 0) {
+                --remaining;
+                v = 25.0 * normal(rng);
+            } else {
+                v = 0.1 * normal(rng);
+            }
+        }
+    } else if (distribution == "text") {
+        // Lower-case words separated by spaces and sentence punctuation
+        static const char* const words[] = {
+            "the",   "chunk",  "of",    "data",   "is",    "split", "into",    "parts",
+            "and",   "each",   "part",  "holds",  "a",     "range", "values",  "stream",
+            "where", "bursts", "mark",  "change", "with",  "small", "windows", "over",
+            "large", "inputs", "for",   "every",  "codec", "that",  "runs",    "fast"};
+        std::uniform_int_distribution<size_t> word(0, sizeof(words) / sizeof(words[0]) - 1);
+        std::uniform_int_distribution<int> sentence_end(0, 11);
+        size_t i = 0;
+        while (i < n) {
+            for (const char* c = words[word(rng)]; *c && i < n; ++c) {
+                values[i++] = static_cast<unsigned char>(*c);
+            }
+            if (i < n && sentence_end(rng) == 0) {
+                values[i++] = '.';
+            }
+            if (i < n) {
+                values[i++] = ' ';
+            }
+        }
+    } else {
+        throw std::invalid_argument("Unknown distribution: " + distribution);
     }
+    return values;
 }
 
-int main() {
-    // Example data for benchmarking
-    std::vector<int> data(1000);
-    for (size_t i = 0; i < data.size(); ++i) {
-        data[i] = static_cast<int>(i % 10);
+/**
+ * @brief One benchmark input and the representations derived from it on demand
+ */
+class Dataset {
+public:
+    Dataset(std::string distribution, size_t size)
+        : distribution_(std::move(distribution)), values_(generate(distribution_, size)) {}
+
+    const std::string& distribution() const {
+        return distribution_;
+    }
+
+    size_t size() const {
+        return values_.size();
+    }
+
+    const std::vector<double>& values() const {
+        return values_;
+    }
+
+    /// Values in fixed point with three decimals (text: the bytes themselves)
+    const std::vector<int64_t>& integers() {
+        if (integers_.size() != values_.size()) {
+            integers_.resize(values_.size());
+            const double scale = is_text() ? 1.0 : 1000.0;
+            for (size_t i = 0; i < values_.size(); ++i) {
+                integers_[i] = std::llround(values_[i] * scale);
+            }
+        }
+        return integers_;
+    }
+
+    /// Text bytes, or the low byte of successive integer deltas for numeric data
+    const std::vector<uint8_t>& bytes() {
+        if (bytes_.size() != values_.size()) {
+            const auto& ints = integers();
+            bytes_.resize(ints.size());
+            for (size_t i = 0; i < ints.size(); ++i) {
+                const int64_t v = is_text() || i == 0 ? ints[i] : ints[i] - ints[i - 1];
+                bytes_[i] = static_cast<uint8_t>(v);
+            }
+        }
+        return bytes_;
+    }
+
+    const std::string& text() {
+        if (text_.size() != values_.size()) {
+            const auto& b = bytes();
+            text_.assign(b.begin(), b.end());
+        }
+        return text_;
+    }
+
+    /// Values split into consecutive chunks of CHUNK_LENGTH
+    const std::vector<std::vector<double>>& chunks() {
+        if (chunks_.empty()) {
+            chunks_ = split(values_);
+        }
+        return chunks_;
+    }
+
+    const std::vector<std::vector<int64_t>>& integer_chunks() {
+        if (integer_chunks_.empty()) {
+            integer_chunks_ = split(integers());
+        }
+        return integer_chunks_;
+    }
+
+private:
+    bool is_text() const {
+        return distribution_ == "text";
+    }
+
+    template <typename T>
+    static std::vector<std::vector<T>> split(const std::vector<T>& data) {
+        std::vector<std::vector<T>> result;
+        result.reserve((data.size() + CHUNK_LENGTH - 1) / CHUNK_LENGTH);
+        for (size_t i = 0; i < data.size(); i += CHUNK_LENGTH) {
+            const size_t end = std::min(data.size(), i + CHUNK_LENGTH);
+            result.emplace_back(data.begin() + i, data.begin() + end);
+        }
+        return result;
     }
 
-    std::cout << "Running benchmark with integer data...\n";
-    run_benchmark(data);
+    std::string distribution_;
+    std::vector<double> values_;
+    std::vector<int64_t> integers_;
+    std::vector<uint8_t> bytes_;
+    std::string text_;
+    std::vector<std::vector<double>> chunks_;
+    std::vector<std::vector<int64_t>> integer_chunks_;
+};
+
+/// A timed body; returns the number of chunks (or items) it produced
+using Body = std::function<size_t()>;
+
+/**
+ * @brief A benchmark before it is bound to an input
+ *
+ * prepare() does all setup (building strategies, encoding the input of a
+ * decoder) outside the timed region and returns the body to time.
+ */
+struct BenchmarkCase {
+    std::string name;                  ///< group/case
+    size_t max_size;                   ///< Largest input size the case runs on
+    size_t element_bytes;              ///< Input bytes per element, for throughput
+    std::function<Body(Dataset&)> prepare;
+    bool text_only = false;            ///< Only meaningful on the text distribution
+};
+
+constexpr size_t UNLIMITED = static_cast<size_t>(-1);
+
+using StrategyFactory = std::function<std::shared_ptr<chunk_processing::ChunkStrategy<double>>()>;
+
+BenchmarkCase strategy_case(const std::string& name, size_t max_size, StrategyFactory make) {
+    return {name, max_size, sizeof(double), [make](Dataset& d) -> Body {
+                std::shared_ptr<const chunk_processing::ChunkStrategy<double>> strategy = make();
+                const auto* data = &d.values();
+                return [strategy, data] { return strategy->apply(*data).size(); };
+            }};
+}
+
+/// Any object with chunk(const std::vector<double>&)
+template <typename Chunker>
+BenchmarkCase chunker_case(const std::string& name, size_t max_size, Chunker chunker) {
+    return {name, max_size, sizeof(double), [chunker](Dataset& d) -> Body {
+                auto instance = std::make_shared<Chunker>(chunker);
+                const auto* data = &d.values();
+                return [instance, data] { return instance->chunk(*data).size(); };
+            }};
+}
+
+/// Insert every value into a fresh structure
+template <typename Structure>
+BenchmarkCase insert_case(const std::string& name, size_t max_size) {
+    return {name, max_size, sizeof(double), [](Dataset& d) -> Body {
+                const auto* data = &d.values();
+                return [data] {
+                    Structure structure;
+                    for (double v : *data) {
+                        structure.insert(v);
+                    }
+                    return data->size();
+                };
+            }};
+}
+
+void add_strategy_cases(std::vector<BenchmarkCase>& cases) {
+    using namespace chunk_processing;
+    using Strategy = std::shared_ptr<ChunkStrategy<double>>;
+
+    cases.push_back(strategy_case("strategies/pattern_based", UNLIMITED, [] {
+        return std::make_shared<PatternBasedStrategy<double>>(size_t{64});
+    }));
+    cases.push_back(strategy_case("strategies/pattern_predicate", UNLIMITED, [] {
+        return std::make_shared<PatternBasedStrategy<double>>([](double v) { return v > 50.0; });
+    }));
+    cases.push_back(strategy_case("strategies/variance", UNLIMITED, [] {
+        return std::make_shared<VarianceStrategy<double>>(5.0);
+    }));
+    cases.push_back(strategy_case("strategies/entropy", UNLIMITED, [] {
+        return std::make_shared<EntropyStrategy<double>>(2.0);
+    }));
+    cases.push_back(strategy_case("strategies/neural", UNLIMITED, [] {
+        return std::make_shared<NeuralChunkingStrategy<double>>();
+    }));
+    cases.push_back(strategy_case("strategies/similarity", UNLIMITED, [] {
+        return std::make_shared<SimilarityChunkingStrategy<double>>(0.5);
+    }));
+
+    cases.push_back({"chunk/by_size", UNLIMITED, sizeof(double), [](Dataset& d) -> Body {
+                         auto chunk = std::make_shared<Chunk<double>>(CHUNK_LENGTH);
+                         chunk->add(d.values());
+                         return [chunk] { return chunk->chunk_by_size(CHUNK_LENGTH).size(); };
+                     }});
+    cases.push_back({"chunk/by_threshold", UNLIMITED, sizeof(double), [](Dataset& d) -> Body {
+                         auto chunk = std::make_shared<Chunk<double>>(1);
+                         chunk->add(d.values());
+                         return [chunk] { return chunk->chunk_by_threshold(50.0).size(); };
+                     }});
+
+    cases.push_back(strategy_case("sub_chunk/recursive", UNLIMITED, [] {
+        return std::make_shared<RecursiveSubChunkStrategy<double>>(
+            std::make_shared<VarianceStrategy<double>>(5.0), 2, 16);
+    }));
+    cases.push_back(strategy_case("sub_chunk/hierarchical", UNLIMITED, [] {
+        std::vector<Strategy> levels = {std::make_shared<VarianceStrategy<double>>(5.0),
+                                        std::make_shared<SimilarityChunkingStrategy<double>>(0.5)};
+        return std::make_shared<HierarchicalSubChunkStrategy<double>>(levels, 16);
+    }));
+    cases.push_back(strategy_case("sub_chunk/conditional", UNLIMITED, [] {
+        return std::make_shared<ConditionalSubChunkStrategy<double>>(
+            std::make_shared<VarianceStrategy<double>>(5.0),
+            [](const std::vector<double>& chunk) { return chunk.size() > 1000; }, 16);
+    }));
+}
+
+void add_sophisticated_cases(std::vector<BenchmarkCase>& cases) {
+    using namespace sophisticated_chunking;
+    cases.push_back(chunker_case("sophisticated/wavelet", UNLIMITED,
+                                 WaveletChunking<double>(64, 0.5)));
+    cases.push_back(chunker_case("sophisticated/mutual_information", 1000,
+                                 MutualInformationChunking<double>(8, 0.3)));
+    cases.push_back(chunker_case("sophisticated/dtw", UNLIMITED, DTWChunking<double>(16, 2.0)));
+    cases.push_back(chunker_case("neural/network", UNLIMITED,
+                                 neural_chunking::NeuralChunking<double>(8, 0.5)));
+}
+
+void add_structure_cases(std::vector<BenchmarkCase>& cases) {
+    using namespace advanced_structures;
+    constexpr size_t width = sizeof(double);
+
+    cases.push_back(chunker_case("structures/semantic_boundaries", UNLIMITED,
+                                 SemanticBoundariesChunk<double>(0.5)));
+    cases.push_back(chunker_case("structures/fractal_patterns", UNLIMITED,
+                                 FractalPatternsChunk<double>(3, 0.8)));
+    cases.push_back(chunker_case("structures/bloom_filter", UNLIMITED,
+                                 BloomFilterChunk<double>(1024, 3)));
+    cases.push_back(
+        chunker_case("structures/graph_based", 1000000, GraphBasedChunk<double>(0.5)));
+    cases.push_back(insert_case<ChunkSkipList<double>>("structures/skip_list_insert", 1000000));
+    cases.push_back(insert_case<ChunkBPlusTree<double>>("structures/bplus_tree_insert", 1000000));
+    cases.push_back(insert_case<ChunkTreap<double>>("structures/treap_insert", 1000000));
+    cases.push_back(insert_case<ChunkLSMTree<double>>("structures/lsm_tree_insert", 1000000));
+    cases.push_back({"structures/deque_push_pop", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* data = &d.values();
+                         return [data] {
+                             ChunkDeque<double> deque;
+                             for (double v : *data) {
+                                 deque.push_back(v);
+                             }
+                             while (!deque.empty()) {
+                                 deque.pop_front();
+                             }
+                             return data->size();
+                         };
+                     }});
+    cases.push_back({"structures/stack_push_pop", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* data = &d.values();
+                         return [data] {
+                             ChunkStack<double> stack;
+                             for (double v : *data) {
+                                 stack.push(v);
+                             }
+                             while (!stack.empty()) {
+                                 stack.pop();
+                             }
+                             return data->size();
+                         };
+                     }});
+
+    BenchmarkCase semantic{"structures/semantic_text", UNLIMITED, 1, [](Dataset& d) -> Body {
+                               auto chunker = std::make_shared<SemanticChunker<std::string>>(0.7);
+                               const auto* text = &d.text();
+                               return [chunker, text] { return chunker->chunk(*text).size(); };
+                           }};
+    semantic.text_only = true;
+    cases.push_back(semantic);
+}
+
+void add_parallel_cases(std::vector<BenchmarkCase>& cases) {
+    using Processor = parallel_chunk::ParallelChunkProcessor<double>;
+    constexpr size_t width = sizeof(double);
 
-    return 0;
-}
\ No newline at end of file
+    for (auto backend : gpu_chunking::boundary_kernel<double>().available()) {
+        const std::string suffix = chunk_backend::backend_name(backend);
+        cases.push_back({"parallel/cpu_chunking_" + suffix, UNLIMITED, width,
+                         [suffix](Dataset& d) -> Body {
+                             auto chunker = std::make_shared<gpu_chunking::CPUChunking<double>>(
+                                 32, 0.1f);
+                             chunker->set_backend(suffix);
+                             const auto* data = &d.values();
+                             return [chunker, data] { return chunker->chunk(*data).size(); };
+                         }});
+    }
+    // One thread (or async task) per chunk of CHUNK_LENGTH values
+    cases.push_back({"parallel/process_chunks", 100000, width, [](Dataset& d) -> Body {
+                         auto chunks = std::make_shared<std::vector<std::vector<double>>>(
+                             d.chunks());
+                         return [chunks] {
+                             Processor::process_chunks(*chunks, [](std::vector<double>& chunk) {
+                                 for (auto& v : chunk) {
+                                     v = -v;
+                                 }
+                             });
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"parallel/map", 100000, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             return Processor::map<double>(
+                                        *chunks, [](const double& v) { return v * 2.0; })
+                                 .size();
+                         };
+                     }});
+    cases.push_back({"parallel/reduce", 100000, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             Processor::reduce(
+                                 *chunks, [](const double& a, const double& b) { return a + b; },
+                                 0.0);
+                             return chunks->size();
+                         };
+                     }});
+}
+
+void add_compression_cases(std::vector<BenchmarkCase>& cases) {
+    using namespace chunk_compression;
+    using Compressor = ChunkCompressor<int64_t>;
+    constexpr size_t width = sizeof(int64_t);
+
+    for (auto backend : detail::delta_decode_kernel<uint64_t>().available()) {
+        const std::string suffix = chunk_backend::backend_name(backend);
+        cases.push_back({"compression/delta_encode_" + suffix, UNLIMITED, width,
+                         [backend](Dataset& d) -> Body {
+                             const auto* in = &d.integers();
+                             auto out = std::make_shared<std::vector<int64_t>>(in->size());
+                             return [in, out, backend] {
+                                 Compressor::delta_encode(in->data(), in->size(), out->data(),
+                                                          backend);
+                                 return size_t{0};
+                             };
+                         }});
+        cases.push_back({"compression/delta_decode_" + suffix, UNLIMITED, width,
+                         [backend](Dataset& d) -> Body {
+                             auto in = std::make_shared<std::vector<int64_t>>(
+                                 Compressor::delta_encode(d.integers()));
+                             auto out = std::make_shared<std::vector<int64_t>>(in->size());
+                             return [in, out, backend] {
+                                 Compressor::delta_decode(in->data(), in->size(), out->data(),
+                                                          backend);
+                                 return size_t{0};
+                             };
+                         }});
+    }
+    cases.push_back({"compression/zigzag_delta_encode", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* in = &d.integers();
+                         auto out = std::make_shared<std::vector<Compressor::zigzag_type>>(
+                             in->size());
+                         return [in, out] {
+                             Compressor::zigzag_delta_encode(in->data(), in->size(), out->data());
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/bitpack_delta_encode", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* in = &d.integers();
+                         auto out = std::make_shared<std::vector<uint8_t>>(
+                             Compressor::bitpack_max_encoded_size(in->size()));
+                         return [in, out] {
+                             Compressor::bitpack_encode(in->data(), in->size(), out->data(), true);
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/bitpack_delta_decode", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto& in = d.integers();
+                         auto packed = std::make_shared<std::vector<uint8_t>>(
+                             Compressor::bitpack_max_encoded_size(in.size()));
+                         packed->resize(Compressor::bitpack_encode(in.data(), in.size(),
+                                                                   packed->data(), true));
+                         auto out = std::make_shared<std::vector<int64_t>>(in.size());
+                         return [packed, out] {
+                             Compressor::bitpack_decode(packed->data(), packed->size(),
+                                                        out->data());
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/varint_delta_encode", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* in = &d.integers();
+                         auto out = std::make_shared<std::vector<uint8_t>>(
+                             Compressor::varint_max_encoded_size(in->size()));
+                         return [in, out] {
+                             Compressor::varint_encode(in->data(), in->size(), out->data(), true);
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/xor_encode", UNLIMITED, sizeof(double), [](Dataset& d) -> Body {
+                         const auto* in = &d.values();
+                         return [in] {
+                             ChunkCompressor<double>::xor_encode(*in);
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/rans_encode", UNLIMITED, 1, [](Dataset& d) -> Body {
+                         const auto* in = &d.bytes();
+                         return [in] {
+                             RansCoder::encode(in->data(), in->size());
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/rans_decode", UNLIMITED, 1, [](Dataset& d) -> Body {
+                         auto encoded =
+                             std::make_shared<std::vector<uint8_t>>(RansCoder::encode(d.bytes()));
+                         auto out = std::make_shared<std::vector<uint8_t>>(d.size());
+                         return [encoded, out] {
+                             RansCoder::decode(encoded->data(), encoded->size(), out->data());
+                             return size_t{0};
+                         };
+                     }});
+    cases.push_back({"compression/dictionary_encode", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* in = &d.integers();
+                         return [in] {
+                             DictionaryChunk<int64_t> dictionary(in->data(), in->size());
+                             return size_t{1};
+                         };
+                     }});
+    cases.push_back({"compression/adaptive", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.integer_chunks();
+                         return [chunks] {
+                             AdaptiveCompressor<int64_t> compressor;
+                             for (const auto& chunk : *chunks) {
+                                 compressor.compress(chunk);
+                             }
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"compression/batch_compress", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.integer_chunks();
+                         return [chunks] {
+                             return BatchCompressor<int64_t>().compress(*chunks).size();
+                         };
+                     }});
+    cases.push_back({"compression/batch_decompress", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto batch = std::make_shared<CompressedBatch>(
+                             BatchCompressor<int64_t>().compress(d.integer_chunks()));
+                         return [batch] {
+                             return BatchCompressor<int64_t>().decompress(*batch).size();
+                         };
+                     }});
+}
+
+void add_serialization_cases(std::vector<BenchmarkCase>& cases) {
+    using Serializer = chunk_serialization::ChunkSerializer<double>;
+    constexpr size_t width = sizeof(double);
+
+    cases.push_back({"serialization/json_write", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             Serializer().to_json(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"serialization/json_read", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto json =
+                             std::make_shared<std::string>(Serializer().to_json(d.chunks()));
+                         return [json] { return Serializer::from_json(*json).size(); };
+                     }});
+    cases.push_back({"serialization/msgpack_write", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             Serializer().to_msgpack(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"serialization/msgpack_read", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto packed =
+                             std::make_shared<std::string>(Serializer().to_msgpack(d.chunks()));
+                         return [packed] { return Serializer::from_msgpack(*packed).size(); };
+                     }});
+    cases.push_back({"serialization/protobuf_write", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             Serializer().to_protobuf(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"serialization/protobuf_read", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto message =
+                             std::make_shared<std::string>(Serializer().to_protobuf(d.chunks()));
+                         return [message] { return Serializer::from_protobuf(*message).size(); };
+                     }});
+    cases.push_back({"serialization/arrow_write", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             chunk_serialization::ArrowChunkArray<double>(*chunks).to_ipc_stream();
+                             return chunks->size();
+                         };
+                     }});
+}
+
+void add_metrics_cases(std::vector<BenchmarkCase>& cases) {
+    using Analyzer = chunk_metrics::ChunkQualityAnalyzer<double>;
+    constexpr size_t width = sizeof(double);
+
+    cases.push_back({"metrics/quality_score", UNLIMITED, width, [](Dataset& d) -> Body {
+                         chunk_metrics::MetricsCacheOptions no_cache;
+                         no_cache.max_entries = 0;
+                         auto analyzer = std::make_shared<Analyzer>(nullptr, no_cache);
+                         const auto* chunks = &d.chunks();
+                         return [analyzer, chunks] {
+                             analyzer->compute_quality_score(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"metrics/quality_score_cached", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto analyzer = std::make_shared<Analyzer>();
+                         const auto* chunks = &d.chunks();
+                         return [analyzer, chunks] {
+                             analyzer->compute_quality_score(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    // Exact silhouette degrades towards chunks x points when chunk means coincide (bursty)
+    cases.push_back({"metrics/silhouette", 100000, width, [](Dataset& d) -> Body {
+                         auto analyzer = std::make_shared<Analyzer>();
+                         const auto* chunks = &d.chunks();
+                         return [analyzer, chunks] {
+                             analyzer->compute_silhouette_score(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"metrics/silhouette_estimate", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto analyzer = std::make_shared<Analyzer>();
+                         const auto* chunks = &d.chunks();
+                         return [analyzer, chunks] {
+                             analyzer->estimate_silhouette_score(*chunks, 1000);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"metrics/size_metrics", UNLIMITED, width, [](Dataset& d) -> Body {
+                         auto analyzer = std::make_shared<Analyzer>();
+                         const auto* chunks = &d.chunks();
+                         return [analyzer, chunks] {
+                             analyzer->compute_size_metrics(*chunks);
+                             return chunks->size();
+                         };
+                     }});
+    cases.push_back({"metrics/accumulator", UNLIMITED, width, [](Dataset& d) -> Body {
+                         const auto* chunks = &d.chunks();
+                         return [chunks] {
+                             chunk_metrics::ChunkMetricsAccumulator<double> accumulator;
+                             for (const auto& chunk : *chunks) {
+                                 accumulator.add(chunk);
+                             }
+                             accumulator.quality_score();
+                             return accumulator.chunk_count();
+                         };
+                     }});
+}
+
+std::vector<BenchmarkCase> all_cases() {
+    std::vector<BenchmarkCase> cases;
+    add_strategy_cases(cases);
+    add_sophisticated_cases(cases);
+    add_structure_cases(cases);
+    add_parallel_cases(cases);
+    add_compression_cases(cases);
+    add_serialization_cases(cases);
+    add_metrics_cases(cases);
+    return cases;
+}
+
+struct SuiteOptions {
+    std::regex filter{".*"};
+    std::vector<size_t> sizes{1000, 10000, 100000, 1000000};
+    std::vector<std::string> distributions = DISTRIBUTIONS;
+    long iterations = -1; ///< -1: scale with input size
+    long warmup = -1;
+    std::string format = "text";
+    std::string output;
+    bool perf = false;
+    bool list = false;
+};
+
+std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(std::ostream& os) {
+    os << "Usage: benchmark_exe [--filter REGEX] [--sizes 1e3,1e6,...] "
+          "[--distributions uniform,random_walk,steps,bursty,text]\n"
+          "                     [--iterations N] [--warmup N] [--format text|csv|json] "
+          "[--output FILE] [--perf] [--list]\n";
+}
+
+SuiteOptions parse_arguments(int argc, char** argv) {
+    SuiteOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument(arg + " needs a value");
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") {
+            options.filter = std::regex(value());
+        } else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& item : split_list(value())) {
+                const double size = std::stod(item);
+                if (!(size >= 1.0 && size <= 1e12)) {
+                    throw std::invalid_argument("Invalid size: " + item);
+                }
+                options.sizes.push_back(static_cast<size_t>(std::llround(size)));
+            }
+        } else if (arg == "--distributions") {
+            options.distributions = split_list(value());
+            for (const auto& distribution : options.distributions) {
+                if (std::find(DISTRIBUTIONS.begin(), DISTRIBUTIONS.end(), distribution) ==
+                    DISTRIBUTIONS.end()) {
+                    throw std::invalid_argument("Unknown distribution: " + distribution);
+                }
+            }
+        } else if (arg == "--iterations") {
+            options.iterations = std::stol(value());
+        } else if (arg == "--warmup") {
+            options.warmup = std::stol(value());
+        } else if (arg == "--format") {
+            options.format = value();
+            if (options.format != "text" && options.format != "csv" && options.format != "json") {
+                throw std::invalid_argument("Unknown format: " + options.format);
+            }
+        } else if (arg == "--output") {
+            options.output = value();
+        } else if (arg == "--perf") {
+            options.perf = true;
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    if (options.iterations == 0 || options.iterations < -1 || options.warmup < -1) {
+        throw std::invalid_argument("Iteration counts must be positive");
+    }
+    return options;
+}
+
+BenchmarkOptions options_for(const SuiteOptions& suite, size_t size) {
+    BenchmarkOptions options;
+    options.iterations = suite.iterations > 0 ? static_cast<size_t>(suite.iterations)
+                         : size <= 1000000    ? 10
+                         : size <= 10000000   ? 3
+                                              : 1;
+    options.warmup_iterations = suite.warmup >= 0 ? static_cast<size_t>(suite.warmup)
+                                : size <= 10000000 ? 1
+                                                   : 0;
+    options.perf_counters = suite.perf;
+    return options;
+}
+
+std::string format_duration(double ns) {
+    char buffer[32];
+    if (ns < 1e3) {
+        std::snprintf(buffer, sizeof(buffer), "%.0f ns", ns);
+    } else if (ns < 1e6) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+    } else if (ns < 1e9) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2f s", ns / 1e9);
+    }
+    return buffer;
+}
+
+void print_result(std::ostream& os, const BenchmarkResult& result) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-60s %11s  p99 %11s  %10.2f Melem/s  %10.2f MB/s",
+                  result.strategy_name.c_str(), format_duration(result.median_ns).c_str(),
+                  format_duration(result.p99_ns).c_str(), result.elements_per_second / 1e6,
+                  result.bytes_per_second / 1e6);
+    os << line;
+    if (result.memory_tracked) {
+        std::snprintf(line, sizeof(line), "  %.0f allocs/run  %.1f KiB/run  peak %.1f KiB",
+                      result.allocations_per_run, result.allocated_bytes_per_run / 1024.0,
+                      static_cast<double>(result.memory_usage_bytes) / 1024.0);
+        os << line;
+    }
+    for (size_t e = 0; e < chunk_benchmark::PERF_EVENT_COUNT; ++e) {
+        const auto event = static_cast<chunk_benchmark::PerfEvent>(e);
+        if (!std::isnan(result.counters_per_element[event])) {
+            os << "  " << chunk_benchmark::perf_event_name(event) << "/elem "
+               << result.counters_per_element[event];
+        }
+    }
+    os << "\n";
+}
+
+int run_suite(const SuiteOptions& options) {
+    const auto cases = all_cases();
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            throw chunk_processing::ChunkingError("Failed to open " + options.output);
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    std::vector<BenchmarkResult> results;
+    int failures = 0;
+    for (size_t size : options.sizes) {
+        for (const auto& distribution : options.distributions) {
+            std::vector<const BenchmarkCase*> selected;
+            for (const auto& c : cases) {
+                const std::string name =
+                    c.name + "/" + distribution + "/" + std::to_string(size);
+                if (size <= c.max_size && (!c.text_only || distribution == "text") &&
+                    std::regex_search(name, options.filter)) {
+                    selected.push_back(&c);
+                }
+            }
+            if (selected.empty()) {
+                continue;
+            }
+            if (options.list) {
+                for (const auto* c : selected) {
+                    out << c->name << "/" << distribution << "/" << size << "\n";
+                }
+                continue;
+            }
+
+            Dataset dataset(distribution, size);
+            const BenchmarkOptions run_options = options_for(options, size);
+            for (const auto* c : selected) {
+                const std::string name =
+                    c->name + "/" + distribution + "/" + std::to_string(size);
+                try {
+                    const Body body = c->prepare(dataset);
+                    results.push_back(chunk_benchmark::run_benchmark(
+                        name, size, size * c->element_bytes, body, run_options));
+                    if (options.format == "text") {
+                        print_result(out, results.back());
+                        out.flush();
+                    }
+                } catch (const std::exception& e) {
+                    // Some strategies reject some inputs; report and keep going
+                    std::cerr << name << ": failed: " << e.what() << "\n";
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    if (options.format == "csv") {
+        chunk_benchmark::write_csv(out, results);
+    } else if (options.format == "json") {
+        chunk_benchmark::write_json(out, results);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SuiteOptions options;
+    try {
+        options = parse_arguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        print_usage(std::cerr);
+        return 2;
+    }
+    try {
+        return run_suite(options);
+    } catch (const std::exception& e) {
+        std::cerr << "benchmark_exe: " << e.what() << "\n";
+        return 1;
+    }
+}
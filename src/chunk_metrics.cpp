@@ -7,4 +7,7 @@ namespace chunk_metrics {
 template class ChunkQualityAnalyzer<double>;
 template class ChunkQualityAnalyzer<float>;
 template class ChunkQualityAnalyzer<int>;
+template class ChunkMetricsAccumulator<double>;
+template class ChunkMetricsAccumulator<float>;
+template class ChunkMetricsAccumulator<int>;
 } // namespace chunk_metrics
\ No newline at end of file
@@ -1,10 +1,10 @@
 #include "gpu_chunking.hpp"
+#include <iostream>
 
 int main() {
-    // Check GPU availability
+    // Without a GPU the same boundary rule runs on the CPU backend
     if (!gpu_chunking::GPUChunking<int>::is_gpu_available()) {
-        std::cerr << "No GPU available\n";
-        return 1;
+        std::cerr << "No GPU available, using CPU backend\n";
     }
 
     // Print GPU info
@@ -17,4 +17,6 @@ int main() {
 
     // Perform chunking
     auto chunks = chunker.chunk(data);
+    std::cout << "Chunks: " << chunks.size() << std::endl;
+    return 0;
 }
\ No newline at end of file
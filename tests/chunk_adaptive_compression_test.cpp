@@ -0,0 +1,148 @@
+#include "chunk_adaptive_compression.hpp"
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_processing::SerializationError;
+
+namespace {
+
+std::vector<int64_t> timestamps(size_t n) {
+    std::vector<int64_t> data(n);
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = 1700000000000 + static_cast<int64_t>(i) * 1000 + static_cast<int64_t>(i % 3);
+    }
+    return data;
+}
+
+std::vector<int32_t> status_codes(size_t n) {
+    const int32_t codes[] = {200, 404, 500, 503, 301};
+    std::mt19937 gen(1);
+    std::vector<int32_t> data(n);
+    for (auto& v : data) {
+        v = codes[gen() % 5];
+    }
+    return data;
+}
+
+std::vector<double> telemetry(size_t n) {
+    std::mt19937 gen(2);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    std::vector<double> data(n);
+    double level = 20.0;
+    for (auto& v : data) {
+        level += noise(gen);
+        v = std::round(level * 16.0) / 16.0;
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(AdaptiveCompressionTest, PicksExpectedCodecPerShape) {
+    AdaptiveCompressor<int64_t> wide;
+    auto ts = timestamps(10000);
+    EXPECT_EQ(wide.choose(ts.data(), ts.size()), Codec::DeltaBitPack);
+
+    AdaptiveCompressor<int32_t> narrow;
+    auto codes = status_codes(10000);
+    EXPECT_EQ(narrow.choose(codes.data(), codes.size()), Codec::Dictionary);
+
+    std::vector<int32_t> runs;
+    for (int32_t v = 0; v < 20; ++v) {
+        runs.insert(runs.end(), 500, v * 1000003);
+    }
+    EXPECT_EQ(narrow.choose(runs.data(), runs.size()), Codec::RunLength);
+
+    std::mt19937 gen(3);
+    std::vector<int32_t> noise(5000);
+    for (auto& v : noise) {
+        v = static_cast<int32_t>(gen());
+    }
+    EXPECT_EQ(narrow.choose(noise.data(), noise.size()), Codec::Raw);
+
+    AdaptiveCompressor<double> floats;
+    auto series = telemetry(10000);
+    EXPECT_EQ(floats.choose(series.data(), series.size()), Codec::Xor);
+}
+
+TEST(AdaptiveCompressionTest, EveryCodecRoundTrips) {
+    auto ints = status_codes(1000);
+    for (Codec codec : AdaptiveCompressor<int32_t>::candidates()) {
+        auto encoded = AdaptiveCompressor<int32_t>::compress_with(codec, ints.data(), ints.size());
+        EXPECT_EQ(AdaptiveCompressor<int32_t>::codec_of(encoded.data(), encoded.size()), codec);
+        EXPECT_EQ(AdaptiveCompressor<int32_t>::decompress(encoded), ints) << codec_name(codec);
+    }
+    auto doubles = telemetry(1000);
+    for (Codec codec : AdaptiveCompressor<double>::candidates()) {
+        auto encoded =
+            AdaptiveCompressor<double>::compress_with(codec, doubles.data(), doubles.size());
+        EXPECT_EQ(AdaptiveCompressor<double>::decompress(encoded), doubles) << codec_name(codec);
+    }
+    EXPECT_THROW(AdaptiveCompressor<double>::compress_with(Codec::BitPack, doubles.data(), 10),
+                 std::invalid_argument);
+}
+
+TEST(AdaptiveCompressionTest, CompressedChunksAreSelfDescribing) {
+    AdaptiveCompressor<int64_t> compressor;
+    std::vector<std::vector<int64_t>> chunks{timestamps(3000), {}, {42},
+                                             std::vector<int64_t>(900, 7)};
+    for (const auto& chunk : chunks) {
+        auto encoded = compressor.compress(chunk);
+        EXPECT_EQ(AdaptiveCompressor<int64_t>::decompress(encoded), chunk);
+    }
+    auto encoded = compressor.compress(timestamps(3000));
+    EXPECT_LT(encoded.size() * 4, 3000 * sizeof(int64_t));
+}
+
+TEST(AdaptiveCompressionTest, SampledEstimatesTrackActualSize) {
+    AdaptiveCompressor<int32_t> compressor;
+    auto codes = status_codes(50000);
+    for (const auto& e : compressor.estimate(codes.data(), codes.size())) {
+        const double actual = static_cast<double>(
+            AdaptiveCompressor<int32_t>::compress_with(e.codec, codes.data(), codes.size()).size());
+        EXPECT_NEAR(e.estimated_bytes / actual, 1.0, 0.2) << codec_name(e.codec);
+    }
+}
+
+TEST(AdaptiveCompressionTest, SpeedWeightFavoursFastDecoders) {
+    auto series = telemetry(5000);
+    AdaptiveOptions options;
+    options.speed_weight = 100.0;
+    AdaptiveCompressor<double> fast(options);
+    EXPECT_EQ(fast.choose(series.data(), series.size()), Codec::Raw);
+}
+
+TEST(AdaptiveCompressionTest, RejectsInvalidHeaders) {
+    AdaptiveCompressor<int32_t> compressor;
+    auto encoded = compressor.compress(status_codes(100));
+    EXPECT_THROW(AdaptiveCompressor<int64_t>::decompress(encoded), SerializationError);
+    encoded[0] = 99;
+    EXPECT_THROW(AdaptiveCompressor<int32_t>::decompress(encoded), SerializationError);
+    EXPECT_THROW(AdaptiveCompressor<int32_t>::decompress(encoded.data(), 1), SerializationError);
+}
+
+TEST(AdaptiveCompressionTest, DecodedSizeIsBounded) {
+    // 1000 runs of UINT32_MAX values in about 7 bytes each
+    std::vector<uint8_t> bomb{static_cast<uint8_t>(Codec::RunLength), sizeof(int32_t), 0xE8, 0x07};
+    for (int r = 0; r < 1000; ++r) {
+        bomb.insert(bomb.end(), {1, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F});
+    }
+    EXPECT_THROW(AdaptiveCompressor<int32_t>::decompress(bomb), SerializationError);
+
+    auto constant = AdaptiveCompressor<int32_t>::compress_with(
+        Codec::RunLength, std::vector<int32_t>(5000, 3).data(), 5000);
+    EXPECT_EQ(AdaptiveCompressor<int32_t>::decompress(constant, 5000).size(), 5000);
+    EXPECT_THROW(AdaptiveCompressor<int32_t>::decompress(constant, 4999), SerializationError);
+
+    for (Codec codec : AdaptiveCompressor<int32_t>::candidates()) {
+        auto data = status_codes(300);
+        auto encoded = AdaptiveCompressor<int32_t>::compress_with(codec, data.data(), data.size());
+        EXPECT_EQ(AdaptiveCompressor<int32_t>::decompress(encoded, 300), data) << codec_name(codec);
+        EXPECT_THROW(AdaptiveCompressor<int32_t>::decompress(encoded, 299), SerializationError)
+            << codec_name(codec);
+    }
+}
@@ -0,0 +1,215 @@
+#include "chunk_arrow.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace chunk_serialization;
+
+namespace {
+
+uint32_t read_u32(const std::string& s, size_t pos) {
+    uint32_t v;
+    std::memcpy(&v, s.data() + pos, sizeof(v));
+    return v;
+}
+
+template <typename V>
+V read_at(const std::string& s, size_t pos) {
+    V v;
+    std::memcpy(&v, s.data() + pos, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Read-only view of a FlatBuffers table inside an IPC stream
+ *
+ * Follows the generic FlatBuffers rules (vtable at table - soffset, field
+ * slots from the vtable, uoffsets relative to where they are stored), so it
+ * checks the encoding rather than the writer's particular layout.
+ */
+class FlatTable {
+public:
+    FlatTable(const std::string& s, size_t pos) : s_(&s), pos_(pos) {}
+
+    /// Root table of the metadata that starts at pos
+    static FlatTable root(const std::string& s, size_t pos) {
+        return FlatTable(s, pos + read_u32(s, pos));
+    }
+
+    bool has(uint16_t id) const {
+        return slot(id) != 0;
+    }
+
+    template <typename V>
+    V scalar(uint16_t id, V fallback = 0) const {
+        return has(id) ? read_at<V>(*s_, pos_ + slot(id)) : fallback;
+    }
+
+    FlatTable table(uint16_t id) const {
+        return FlatTable(*s_, target(id));
+    }
+
+    std::string string(uint16_t id) const {
+        const size_t pos = target(id);
+        return s_->substr(pos + 4, read_u32(*s_, pos));
+    }
+
+    /// Length and element start of a vector field
+    std::pair<size_t, size_t> vector(uint16_t id) const {
+        const size_t pos = target(id);
+        return {read_u32(*s_, pos), pos + 4};
+    }
+
+    FlatTable table_at(uint16_t id, size_t i) const {
+        const size_t element = vector(id).second + 4 * i;
+        return FlatTable(*s_, element + read_u32(*s_, element));
+    }
+
+private:
+    uint16_t slot(uint16_t id) const {
+        const size_t vtable = pos_ - read_at<int32_t>(*s_, pos_);
+        if (4u + 2u * id >= read_at<uint16_t>(*s_, vtable)) {
+            return 0;
+        }
+        return read_at<uint16_t>(*s_, vtable + 4 + 2 * id);
+    }
+
+    size_t target(uint16_t id) const {
+        const size_t pos = pos_ + slot(id);
+        return pos + read_u32(*s_, pos);
+    }
+
+    const std::string* s_;
+    size_t pos_;
+};
+
+} // namespace
+
+TEST(ArrowChunkArrayTest, BuildsAlignedListLayout) {
+    std::vector<std::vector<double>> chunks{{1.5, -2.0, 3.25}, {}, {4.0}};
+    ArrowChunkArray<double> array(chunks);
+
+    ASSERT_EQ(array.size(), 3);
+    EXPECT_EQ(array.value_count(), 4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(array.offsets()) % ARROW_ALIGNMENT, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(array.values()) % ARROW_ALIGNMENT, 0);
+    EXPECT_EQ(std::vector<int32_t>(array.offsets(), array.offsets() + 4),
+              (std::vector<int32_t>{0, 3, 3, 4}));
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        EXPECT_EQ(array.chunk(i).to_vector(), chunks[i]);
+    }
+    EXPECT_THROW(array.chunk(3), std::out_of_range);
+
+    ArrowChunkArray<int16_t, int64_t> large(std::vector<std::vector<int16_t>>{{1, 2}, {3}});
+    EXPECT_EQ(large.offsets()[2], 3);
+    EXPECT_EQ(large.chunk(1)[0], 3);
+}
+
+TEST(ArrowChunkArrayTest, WritesFramedIpcStream) {
+    std::vector<std::vector<float>> chunks{{1.0f, 2.0f}, {3.0f}, std::vector<float>(100, 0.5f)};
+    ArrowChunkArray<float> array(chunks);
+    const std::string stream = array.to_ipc_stream();
+
+    // Schema message
+    ASSERT_GE(stream.size(), 16u);
+    EXPECT_EQ(read_u32(stream, 0), 0xFFFFFFFFu);
+    const size_t schema_end = 8 + read_u32(stream, 4);
+    EXPECT_EQ(schema_end % ARROW_ALIGNMENT, 0);
+
+    // Record batch message; its body is the arena, starting 64-byte aligned
+    EXPECT_EQ(read_u32(stream, schema_end), 0xFFFFFFFFu);
+    const size_t body = schema_end + 8 + read_u32(stream, schema_end + 4);
+    EXPECT_EQ(body % ARROW_ALIGNMENT, 0);
+    int32_t offsets[4];
+    std::memcpy(offsets, stream.data() + body, sizeof(offsets));
+    EXPECT_EQ(offsets[3], 103);
+    float value;
+    std::memcpy(&value, stream.data() + body + ARROW_ALIGNMENT + 2 * sizeof(float), sizeof(value));
+    EXPECT_EQ(value, 3.0f);
+
+    // End-of-stream marker
+    EXPECT_EQ(read_u32(stream, stream.size() - 8), 0xFFFFFFFFu);
+    EXPECT_EQ(read_u32(stream, stream.size() - 4), 0u);
+    EXPECT_EQ((stream.size() - 8 - body) % ARROW_ALIGNMENT, 0);
+}
+
+TEST(ArrowChunkArrayTest, EncodesMessageMetadata) {
+    std::vector<std::vector<float>> chunks{{1.0f, 2.0f}, {3.0f}, std::vector<float>(100, 0.5f)};
+    ArrowChunkArray<float> array(chunks);
+    const std::string stream = array.to_ipc_stream("values");
+    const size_t schema_end = 8 + read_u32(stream, 4);
+    const size_t body = schema_end + 8 + read_u32(stream, schema_end + 4);
+
+    // Message { version, header_type, header, bodyLength } carrying a Schema
+    FlatTable schema_message = FlatTable::root(stream, 8);
+    EXPECT_EQ(schema_message.scalar<int16_t>(0), 4); // MetadataVersion V5
+    EXPECT_EQ(schema_message.scalar<uint8_t>(1), 1); // MessageHeader Schema
+    EXPECT_EQ(schema_message.scalar<int64_t>(3), 0);
+    FlatTable schema = schema_message.table(2);
+    EXPECT_EQ(schema.scalar<int16_t>(0), 0); // Little endian
+    ASSERT_EQ(schema.vector(1).first, 1u);
+
+    // Field { name, nullable, type_type, type, children }: List<item: Float32>
+    FlatTable list = schema.table_at(1, 0);
+    EXPECT_EQ(list.string(0), "values");
+    EXPECT_EQ(list.scalar<uint8_t>(1), 0);
+    EXPECT_EQ(list.scalar<uint8_t>(2), 12); // Type List
+    ASSERT_TRUE(list.has(3));
+    ASSERT_EQ(list.vector(5).first, 1u);
+    FlatTable item = list.table_at(5, 0);
+    EXPECT_EQ(item.string(0), "item");
+    EXPECT_EQ(item.scalar<uint8_t>(2), 3);          // Type FloatingPoint
+    EXPECT_EQ(item.table(3).scalar<int16_t>(0), 1); // Precision SINGLE
+    EXPECT_EQ(item.vector(5).first, 0u);
+
+    // Message carrying a RecordBatch whose body is the arena
+    FlatTable batch_message = FlatTable::root(stream, schema_end + 8);
+    EXPECT_EQ(batch_message.scalar<int16_t>(0), 4);
+    EXPECT_EQ(batch_message.scalar<uint8_t>(1), 3); // MessageHeader RecordBatch
+    const int64_t body_length = batch_message.scalar<int64_t>(3);
+    EXPECT_EQ(body_length, 512);
+    EXPECT_EQ(static_cast<size_t>(body_length), stream.size() - 8 - body);
+
+    // RecordBatch { length, nodes, buffers }
+    FlatTable batch = batch_message.table(2);
+    EXPECT_EQ(batch.scalar<int64_t>(0), 3);
+    const auto nodes = batch.vector(1);
+    ASSERT_EQ(nodes.first, 2u);
+    EXPECT_EQ(nodes.second % 8, 0u);
+    const int64_t expected_nodes[4] = {3, 0, 103, 0}; // (length, null_count) per array
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(read_at<int64_t>(stream, nodes.second + 8 * i), expected_nodes[i]) << i;
+    }
+    const auto buffers = batch.vector(2);
+    ASSERT_EQ(buffers.first, 4u);
+    EXPECT_EQ(buffers.second % 8, 0u);
+    // (offset, length): list validity, list offsets, item validity, item values
+    const int64_t expected_buffers[8] = {0, 0, 0, 16, 0, 0, 64, 412};
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(read_at<int64_t>(stream, buffers.second + 8 * i), expected_buffers[i]) << i;
+    }
+
+    // LargeList of signed 16-bit integers
+    ArrowChunkArray<int16_t, int64_t> large(std::vector<std::vector<int16_t>>{{1, 2}, {3}});
+    const std::string large_stream = large.to_ipc_stream();
+    FlatTable large_list = FlatTable::root(large_stream, 8).table(2).table_at(1, 0);
+    EXPECT_EQ(large_list.string(0), "chunks");
+    EXPECT_EQ(large_list.scalar<uint8_t>(2), 21); // Type LargeList
+    FlatTable large_item = large_list.table_at(5, 0);
+    EXPECT_EQ(large_item.scalar<uint8_t>(2), 2); // Type Int
+    EXPECT_EQ(large_item.table(3).scalar<int32_t>(0), 16);
+    EXPECT_EQ(large_item.table(3).scalar<uint8_t>(1), 1);
+    const size_t large_schema_end = 8 + read_u32(large_stream, 4);
+    FlatTable large_batch = FlatTable::root(large_stream, large_schema_end + 8).table(2);
+    EXPECT_EQ(read_at<int64_t>(large_stream, large_batch.vector(2).second + 8 * 3), 24);
+}
+
+TEST(ArrowChunkArrayTest, HandlesEmptySets) {
+    ArrowChunkArray<uint64_t> array(std::vector<std::vector<uint64_t>>{});
+    EXPECT_EQ(array.size(), 0);
+    EXPECT_EQ(array.offsets()[0], 0);
+    const std::string stream = array.to_ipc_stream();
+    EXPECT_EQ(read_u32(stream, stream.size() - 4), 0u);
+}
@@ -0,0 +1,101 @@
+#include "chunk_backend.hpp"
+#include "cpu_chunking.hpp"
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace chunk_backend;
+
+namespace {
+
+int add_one(int x) {
+    return x + 1;
+}
+int add_two(int x) {
+    return x + 2;
+}
+bool never_available() {
+    return false;
+}
+
+} // namespace
+
+TEST(ChunkBackendTest, NamesRoundTrip) {
+    for (Backend b : {Backend::Auto, Backend::Scalar, Backend::SSE2, Backend::AVX2,
+                      Backend::AVX512, Backend::Threaded, Backend::CUDA}) {
+        EXPECT_EQ(parse_backend(backend_name(b)), b);
+    }
+    EXPECT_THROW(parse_backend("quantum"), std::invalid_argument);
+}
+
+TEST(ChunkBackendTest, AutoPicksBestUsableVariant) {
+    Kernel<int(int)> kernel("test.add");
+    kernel.add(Backend::Scalar, &add_one);
+    EXPECT_EQ(kernel(1), 2);
+    EXPECT_EQ(kernel.auto_backend(), Backend::Scalar);
+
+    // A more preferred but unusable variant must be skipped
+    kernel.add(Backend::CUDA, &add_two, &never_available);
+    EXPECT_EQ(kernel(1), 2);
+    EXPECT_THROW(kernel.resolve(Backend::CUDA), std::runtime_error);
+    EXPECT_THROW(kernel.resolve(Backend::AVX512), std::runtime_error);
+    EXPECT_EQ(kernel.available(), std::vector<Backend>{Backend::Scalar});
+}
+
+TEST(ChunkBackendTest, UnusableEnvironmentOverrideFallsBackToAuto) {
+    for (const char* forced : {"cuda", "avx512", "quantum"}) {
+        ::setenv("CHUNK_BACKEND", forced, 1);
+        Kernel<int(int)> kernel("test.env");
+        kernel.add(Backend::Scalar, &add_one);
+        kernel.add(Backend::CUDA, &add_two, &never_available);
+        EXPECT_EQ(kernel(1), 2) << forced;
+        EXPECT_EQ(kernel.auto_backend(), Backend::Scalar) << forced;
+    }
+
+    ::setenv("CHUNK_BACKEND", "scalar", 1);
+    Kernel<int(int)> kernel("test.env");
+    kernel.add(Backend::Scalar, &add_one);
+    kernel.add(Backend::AVX2, &add_two);
+    EXPECT_EQ(kernel(1), 2);
+    ::unsetenv("CHUNK_BACKEND");
+}
+
+TEST(ChunkBackendTest, CpuFeaturesGateSimdVariants) {
+    Kernel<int(int)> kernel("test.simd");
+    kernel.add(Backend::Scalar, &add_one);
+    kernel.add(Backend::AVX2, &add_two);
+    auto available = kernel.available();
+    bool has_avx2 = std::find(available.begin(), available.end(), Backend::AVX2) != available.end();
+    EXPECT_EQ(has_avx2, CpuFeatures::host().avx2);
+    EXPECT_EQ(kernel(0), CpuFeatures::host().avx2 ? 2 : 1);
+}
+
+TEST(ChunkBackendTest, EveryBoundaryVariantMatchesReference) {
+    std::mt19937 gen(99);
+    std::uniform_int_distribution<int> dist(-500, 500);
+    std::vector<int> data(60000);
+    for (auto& v : data) {
+        v = dist(gen);
+    }
+    auto expected = gpu_chunking::compute_boundaries_reference(data, 12, 0.2f);
+
+    auto backends = gpu_chunking::boundary_kernel<int>().available();
+    ASSERT_FALSE(backends.empty());
+    for (Backend b : backends) {
+        EXPECT_EQ(gpu_chunking::compute_boundaries(data, 12, 0.2f, b), expected)
+            << "backend " << backend_name(b);
+    }
+}
+
+TEST(ChunkBackendTest, ChunkerBackendSelection) {
+    gpu_chunking::CPUChunking<int> chunker(4, 0.1f);
+    EXPECT_EQ(chunker.get_backend(), "auto");
+    chunker.set_backend("scalar");
+    EXPECT_EQ(chunker.get_backend(), "scalar");
+    EXPECT_THROW(chunker.set_backend("tpu"), std::invalid_argument);
+
+    std::vector<int> data{1, 1, 1, 1, 50, 50, 50, 50, 1, 1, 1, 1, 1};
+    gpu_chunking::CPUChunking<int> automatic(4, 0.1f);
+    EXPECT_EQ(chunker.chunk(data), automatic.chunk(data));
+}
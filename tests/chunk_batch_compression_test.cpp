@@ -0,0 +1,142 @@
+#include "chunk_allocation.hpp"
+#include "chunk_batch_compression.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_processing::SerializationError;
+using chunk_processing::ThreadPool;
+
+namespace {
+
+// Mixed shapes so adaptive selection picks different codecs across the batch
+std::vector<std::vector<int32_t>> chunk_set(size_t count) {
+    std::mt19937 gen(11);
+    std::vector<std::vector<int32_t>> chunks(count);
+    for (size_t c = 0; c < count; ++c) {
+        auto& chunk = chunks[c];
+        const size_t n = gen() % 300;
+        switch (c % 3) {
+        case 0:
+            for (size_t i = 0; i < n; ++i) {
+                chunk.push_back(static_cast<int32_t>(c * 1000 + i * 3));
+            }
+            break;
+        case 1:
+            chunk.assign(n, static_cast<int32_t>(c));
+            break;
+        default:
+            for (size_t i = 0; i < n; ++i) {
+                chunk.push_back(static_cast<int32_t>(gen()));
+            }
+        }
+    }
+    return chunks;
+}
+
+// The same shapes at one length, so per-range buffers stop growing after a few chunks
+std::vector<std::vector<int32_t>> fixed_length_chunk_set(size_t count) {
+    std::mt19937 gen(13);
+    std::vector<std::vector<int32_t>> chunks(count, std::vector<int32_t>(256));
+    for (size_t c = 0; c < count; ++c) {
+        for (size_t i = 0; i < chunks[c].size(); ++i) {
+            switch (c % 3) {
+            case 0:
+                chunks[c][i] = static_cast<int32_t>(c * 1000 + i * 3);
+                break;
+            case 1:
+                chunks[c][i] = static_cast<int32_t>(c);
+                break;
+            default:
+                chunks[c][i] = static_cast<int32_t>(gen());
+            }
+        }
+    }
+    return chunks;
+}
+
+template <typename Fn>
+uint64_t allocations_during(Fn&& fn) {
+    chunk_benchmark::ScopedAllocationCounter counter;
+    fn();
+    return counter.stats().allocations;
+}
+
+} // namespace
+
+TEST(BatchCompressionTest, AdaptiveBatchRoundTrips) {
+    ThreadPool pool(3);
+    BatchCompressor<int32_t> compressor({}, &pool);
+    auto chunks = chunk_set(1000);
+    CompressedBatch batch = compressor.compress(chunks);
+
+    ASSERT_EQ(batch.size(), chunks.size());
+    EXPECT_EQ(batch.offsets.front(), 0);
+    EXPECT_EQ(batch.offsets.back(), batch.arena.size());
+    EXPECT_EQ(compressor.decompress(batch), chunks);
+    for (size_t i : {0, 1, 2, 500, 999}) {
+        EXPECT_EQ(BatchCompressor<int32_t>::decompress(batch, i), chunks[i]);
+    }
+    EXPECT_THROW(batch.chunk_size(1000), std::out_of_range);
+
+    // Each chunk matches what the single-chunk API produces for the same codec
+    const Codec codec = AdaptiveCompressor<int32_t>::codec_of(batch.chunk_data(7),
+                                                              batch.chunk_size(7));
+    auto single = AdaptiveCompressor<int32_t>::compress_with(codec, chunks[7].data(),
+                                                             chunks[7].size());
+    EXPECT_EQ(std::vector<uint8_t>(batch.chunk_data(7), batch.chunk_data(7) + batch.chunk_size(7)),
+              single);
+}
+
+TEST(BatchCompressionTest, FixedCodecAndSerialPoolAgree) {
+    auto chunks = chunk_set(257);
+    ThreadPool inline_pool(0);
+    ThreadPool pool(4);
+    auto serial = BatchCompressor<int32_t>({}, &inline_pool).compress(chunks, Codec::DeltaBitPack);
+    auto parallel = BatchCompressor<int32_t>({}, &pool).compress(chunks, Codec::DeltaBitPack);
+    EXPECT_EQ(serial.arena, parallel.arena);
+    EXPECT_EQ(serial.offsets, parallel.offsets);
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        EXPECT_EQ(AdaptiveCompressor<int32_t>::codec_of(parallel.chunk_data(i),
+                                                        parallel.chunk_size(i)),
+                  Codec::DeltaBitPack);
+    }
+    EXPECT_EQ(BatchCompressor<int32_t>({}, &pool).decompress(parallel), chunks);
+
+    BatchCompressor<double> floats;
+    EXPECT_THROW(floats.compress({{1.0}}, Codec::BitPack), std::invalid_argument);
+}
+
+TEST(BatchCompressionTest, EmptyAndCorruptBatches) {
+    BatchCompressor<int64_t> compressor;
+    CompressedBatch empty = compressor.compress({});
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(compressor.decompress(empty).empty());
+
+    auto batch = compressor.compress({{1, 2, 3}, {}, {4}});
+    EXPECT_EQ(compressor.decompress(batch),
+              (std::vector<std::vector<int64_t>>{{1, 2, 3}, {}, {4}}));
+    batch.offsets[1] = batch.arena.size() + 1;
+    EXPECT_THROW(compressor.decompress(batch), SerializationError);
+}
+
+TEST(BatchCompressionTest, AllocationsDoNotGrowWithTheChunkCount) {
+    // The test runner links the allocation hooks
+    ASSERT_TRUE(chunk_benchmark::AllocationTracker::installed());
+    ThreadPool pool(2);
+    BatchCompressor<int32_t> compressor({}, &pool);
+    const auto few = fixed_length_chunk_set(100);
+    const auto many = fixed_length_chunk_set(10000);
+
+    const uint64_t adaptive = allocations_during([&] { compressor.compress(many); });
+    EXPECT_LE(adaptive, allocations_during([&] { compressor.compress(few); }) + 8);
+    EXPECT_LT(adaptive, many.size() / 10);
+    for (Codec codec : AdaptiveCompressor<int32_t>::candidates()) {
+        const uint64_t fixed = allocations_during([&] { compressor.compress(many, codec); });
+        EXPECT_LE(fixed, allocations_during([&] { compressor.compress(few, codec); }) + 8)
+            << codec_name(codec);
+        EXPECT_LT(fixed, many.size() / 10) << codec_name(codec);
+    }
+}
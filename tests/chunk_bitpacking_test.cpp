@@ -0,0 +1,217 @@
+#include "chunk_compression.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_processing::SerializationError;
+
+namespace {
+
+template <typename T>
+std::vector<T> random_walk(size_t n, int step, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(-step, step);
+    std::vector<T> data(n);
+    T value = 1000;
+    for (auto& v : data) {
+        value = static_cast<T>(value + dist(gen));
+        v = value;
+    }
+    return data;
+}
+
+template <typename T>
+std::vector<T> random_values(size_t n, unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> data(n);
+    for (auto& v : data) {
+        v = static_cast<T>(gen());
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(BitPackKernelTest, BackendsMatchScalarForEveryWidth) {
+    std::mt19937 gen(1);
+    for (unsigned width = 0; width <= 32; ++width) {
+        std::vector<uint32_t> values(BITPACK_BLOCK_SIZE);
+        for (auto& v : values) {
+            v = 77u + (width == 0 ? 0u : static_cast<uint32_t>(gen() >> (32 - width)));
+        }
+        std::vector<uint8_t> expected(detail::bitpack_payload_size(width) + 1, 0xAB);
+        detail::pack_block_scalar<uint32_t>(values.data(), 77u, width, expected.data());
+
+        for (auto backend : detail::pack_block_kernel<uint32_t>().available()) {
+            std::vector<uint8_t> packed(expected.size(), 0xAB);
+            detail::pack_block_kernel<uint32_t>().resolve(backend)(values.data(), 77u, width,
+                                                                   packed.data());
+            EXPECT_EQ(packed, expected) << backend_name(backend) << " width=" << width;
+        }
+        for (auto backend : detail::unpack_block_kernel<uint32_t>().available()) {
+            std::vector<uint32_t> unpacked(BITPACK_BLOCK_SIZE);
+            detail::unpack_block_kernel<uint32_t>().resolve(backend)(expected.data(), 77u, width,
+                                                                     unpacked.data());
+            EXPECT_EQ(unpacked, values) << backend_name(backend) << " width=" << width;
+        }
+    }
+}
+
+TEST(BitPackCodecTest, RoundTripsAllLengthsAndTypes) {
+    for (size_t n : {0, 1, 2, 127, 128, 129, 1000}) {
+        auto ints = random_walk<int32_t>(n, 50, static_cast<unsigned>(n));
+        auto wide = random_values<int64_t>(n, static_cast<unsigned>(n));
+        auto bytes = random_values<uint8_t>(n, static_cast<unsigned>(n));
+        for (bool delta : {false, true}) {
+            EXPECT_EQ(ChunkCompressor<int32_t>::bitpack_decode(
+                          ChunkCompressor<int32_t>::bitpack_encode(ints, delta)),
+                      ints);
+            EXPECT_EQ(ChunkCompressor<int64_t>::bitpack_decode(
+                          ChunkCompressor<int64_t>::bitpack_encode(wide, delta)),
+                      wide);
+            EXPECT_EQ(ChunkCompressor<uint8_t>::bitpack_decode(
+                          ChunkCompressor<uint8_t>::bitpack_encode(bytes, delta)),
+                      bytes);
+        }
+    }
+}
+
+TEST(BitPackCodecTest, ExtremeValuesRoundTrip) {
+    using L = std::numeric_limits<int64_t>;
+    std::vector<int64_t> data{L::min(), L::max(), 0, -1, L::max(), L::min()};
+    for (bool delta : {false, true}) {
+        EXPECT_EQ(ChunkCompressor<int64_t>::bitpack_decode(
+                      ChunkCompressor<int64_t>::bitpack_encode(data, delta)),
+                  data);
+    }
+    std::vector<uint32_t> high(300, 0xFFFFFFF0u);
+    high[5] = 0xFFFFFFFFu;
+    using U32 = ChunkCompressor<uint32_t>;
+    EXPECT_EQ(U32::bitpack_decode(U32::bitpack_encode(high)), high);
+}
+
+TEST(BitPackCodecTest, NarrowRangesCompress) {
+    // Values in [1000000, 1000015] need 4 bits each after frame-of-reference
+    std::vector<int32_t> data(4096);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = 1000000 + static_cast<int32_t>(i % 16);
+    }
+    auto encoded = ChunkCompressor<int32_t>::bitpack_encode(data);
+    EXPECT_LT(encoded.size(), data.size() * sizeof(int32_t) / 6);
+
+    // Sorted data compresses better with deltas
+    std::vector<int32_t> sorted(4096);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        sorted[i] = static_cast<int32_t>(i * 1000 + i % 3);
+    }
+    EXPECT_LT(ChunkCompressor<int32_t>::bitpack_encode(sorted, true).size(),
+              ChunkCompressor<int32_t>::bitpack_encode(sorted, false).size());
+}
+
+TEST(BitPackCodecTest, BlocksDecodeIndependently) {
+    auto data = random_walk<int32_t>(1000, 20, 3);
+    auto encoded = ChunkCompressor<int32_t>::bitpack_encode(data, true);
+    const size_t blocks =
+        ChunkCompressor<int32_t>::bitpack_block_count(encoded.data(), encoded.size());
+    ASSERT_EQ(blocks, 8);
+
+    // Decode the last block first, then block 3, without touching the others
+    for (size_t b : {size_t{7}, size_t{3}}) {
+        std::vector<int32_t> out(BITPACK_BLOCK_SIZE);
+        size_t count =
+            ChunkCompressor<int32_t>::bitpack_decode_block(encoded.data(), encoded.size(), b,
+                                                           out.data());
+        ASSERT_EQ(count, std::min(BITPACK_BLOCK_SIZE, data.size() - b * BITPACK_BLOCK_SIZE));
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(out[i], data[b * BITPACK_BLOCK_SIZE + i]);
+        }
+    }
+    EXPECT_THROW(
+        ChunkCompressor<int32_t>::bitpack_decode_block(encoded.data(), encoded.size(), 8, nullptr),
+        std::out_of_range);
+}
+
+TEST(BitPackCodecTest, RejectsMalformedStreams) {
+    auto encoded = ChunkCompressor<int32_t>::bitpack_encode(random_walk<int32_t>(300, 5, 4));
+    EXPECT_THROW(ChunkCompressor<int64_t>::bitpack_decode(encoded), SerializationError);
+
+    auto truncated = encoded;
+    truncated.resize(truncated.size() - 10);
+    EXPECT_THROW(ChunkCompressor<int32_t>::bitpack_decode(truncated), SerializationError);
+
+    auto corrupt = encoded;
+    corrupt[0] = 'X';
+    EXPECT_THROW(ChunkCompressor<int32_t>::bitpack_decode(corrupt), SerializationError);
+
+    // A count whose block count wraps to zero must not pass as an empty stream
+    auto empty = ChunkCompressor<int32_t>::bitpack_encode(std::vector<int32_t>{});
+    BitPackHeader header;
+    std::memcpy(&header, empty.data(), sizeof(header));
+    header.value_count = std::numeric_limits<uint64_t>::max();
+    std::memcpy(empty.data(), &header, sizeof(header));
+    EXPECT_THROW(ChunkCompressor<int32_t>::bitpack_value_count(empty.data(), empty.size()),
+                 SerializationError);
+}
+
+TEST(VarintCodecTest, RoundTripsWithAndWithoutDelta) {
+    auto signed_data = random_walk<int64_t>(500, 1000, 5);
+    auto unsigned_data = random_values<uint32_t>(500, 6);
+    for (bool delta : {false, true}) {
+        EXPECT_EQ(ChunkCompressor<int64_t>::varint_decode(
+                      ChunkCompressor<int64_t>::varint_encode(signed_data, delta), delta),
+                  signed_data);
+        EXPECT_EQ(ChunkCompressor<uint32_t>::varint_decode(
+                      ChunkCompressor<uint32_t>::varint_encode(unsigned_data, delta), delta),
+                  unsigned_data);
+    }
+}
+
+TEST(VarintCodecTest, SmallValuesTakeOneByte) {
+    std::vector<int32_t> data{0, -1, 1, 63, -64};
+    auto encoded = ChunkCompressor<int32_t>::varint_encode(data);
+    EXPECT_EQ(encoded.size(), data.size());
+    EXPECT_EQ(encoded[1], 1); // zigzag(-1)
+
+    std::vector<int32_t> out(data.size());
+    EXPECT_EQ(ChunkCompressor<int32_t>::varint_decode(encoded.data(), encoded.size(), out.data(),
+                                                      out.size()),
+              encoded.size());
+    EXPECT_EQ(out, data);
+}
+
+TEST(VarintCodecTest, RejectsTruncatedAndOutOfRangeInput) {
+    std::vector<uint8_t> truncated{0x80, 0x80};
+    EXPECT_THROW(ChunkCompressor<int32_t>::varint_decode(truncated), SerializationError);
+
+    auto wide = ChunkCompressor<uint64_t>::varint_encode(std::vector<uint64_t>{1ull << 40});
+    EXPECT_THROW(ChunkCompressor<uint32_t>::varint_decode(wide), SerializationError);
+}
+
+TEST(GroupVarintCodecTest, RoundTripsAllGroupRemainders) {
+    for (size_t n : {0, 1, 2, 3, 4, 5, 17, 1000}) {
+        auto data = random_walk<int32_t>(n, 100000, static_cast<unsigned>(n));
+        for (bool delta : {false, true}) {
+            auto encoded = ChunkCompressor<int32_t>::group_varint_encode(data, delta);
+            EXPECT_EQ(ChunkCompressor<int32_t>::group_varint_decode(encoded, delta), data);
+        }
+    }
+    auto shorts = random_values<uint16_t>(99, 7);
+    EXPECT_EQ(ChunkCompressor<uint16_t>::group_varint_decode(
+                  ChunkCompressor<uint16_t>::group_varint_encode(shorts)),
+              shorts);
+}
+
+TEST(GroupVarintCodecTest, UsesMinimalByteLengths) {
+    std::vector<uint32_t> data{1, 300, 70000, 20000000};
+    auto encoded = ChunkCompressor<uint32_t>::group_varint_encode(data);
+    // count varint + control byte + 1 + 2 + 3 + 4 value bytes
+    EXPECT_EQ(encoded.size(), 1 + 1 + 10);
+    EXPECT_EQ(encoded[1], 0b11100100);
+
+    encoded.pop_back();
+    EXPECT_THROW(ChunkCompressor<uint32_t>::group_varint_decode(encoded), SerializationError);
+}
@@ -0,0 +1,183 @@
+#include "chunk_compression.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_processing::SerializationError;
+
+namespace {
+
+std::vector<double> telemetry(size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    std::vector<double> data(n);
+    double level = 20.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 7 != 0) {
+            level += noise(gen);
+        }
+        // Readings quantized to 1/16 of a unit, like a fixed-point sensor
+        data[i] = std::round(level * 16.0) / 16.0;
+    }
+    return data;
+}
+
+template <typename T>
+bool bitwise_equal(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+} // namespace
+
+TEST(BitStreamTest, FieldsRoundTrip) {
+    std::vector<uint8_t> bytes;
+    BitWriter writer(bytes);
+    writer.write_bit(true);
+    writer.write(0x5, 3);
+    writer.write(0xDEADBEEFCAFEF00Dull, 64);
+    writer.write(0, 0);
+    writer.write(0x1FFFF, 17);
+    writer.flush();
+    EXPECT_EQ(bytes.size(), (1 + 3 + 64 + 17 + 7) / 8);
+
+    BitReader reader(bytes.data(), bytes.size());
+    EXPECT_TRUE(reader.read_bit());
+    EXPECT_EQ(reader.read(3), 0x5u);
+    EXPECT_EQ(reader.read(64), 0xDEADBEEFCAFEF00Dull);
+    EXPECT_EQ(reader.read(0), 0u);
+    EXPECT_EQ(reader.read(17), 0x1FFFFu);
+    EXPECT_EQ(reader.read(3), 0u); // padding
+    EXPECT_THROW(reader.read(8), SerializationError);
+}
+
+TEST(XorCompressionTest, DoubleRoundTripIsBitExact) {
+    auto data = telemetry(5000, 1);
+    data.push_back(std::numeric_limits<double>::quiet_NaN());
+    data.push_back(-0.0);
+    data.push_back(std::numeric_limits<double>::infinity());
+    data.push_back(std::numeric_limits<double>::denorm_min());
+    data.push_back(-0.0);
+
+    auto encoded = ChunkCompressor<double>::xor_encode(data);
+    EXPECT_TRUE(bitwise_equal(ChunkCompressor<double>::xor_decode(encoded), data));
+}
+
+TEST(XorCompressionTest, FloatRoundTripIsBitExact) {
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<float> dist(-1e6f, 1e6f);
+    std::vector<float> data(777);
+    for (auto& v : data) {
+        v = dist(gen);
+    }
+    data[10] = data[11] = data[12];
+    auto encoded = ChunkCompressor<float>::xor_encode(data);
+    EXPECT_TRUE(bitwise_equal(ChunkCompressor<float>::xor_decode(encoded), data));
+}
+
+TEST(XorCompressionTest, SlowlyChangingSeriesCompress) {
+    auto data = telemetry(10000, 3);
+    auto encoded = ChunkCompressor<double>::xor_encode(data);
+    EXPECT_LT(encoded.size() * 2, data.size() * sizeof(double));
+
+    std::vector<double> constant(1000, 42.5);
+    // One full value, then a single bit per repeat
+    EXPECT_LE(ChunkCompressor<double>::xor_encode(constant).size(), sizeof(XorHeader) + 8 + 125);
+}
+
+TEST(XorCompressionTest, EdgeCases) {
+    for (size_t n : {0, 1, 2}) {
+        std::vector<double> data(n, 3.25);
+        EXPECT_EQ(ChunkCompressor<double>::xor_decode(ChunkCompressor<double>::xor_encode(data)),
+                  data);
+    }
+    auto encoded = ChunkCompressor<double>::xor_encode(telemetry(100, 4));
+    EXPECT_THROW(ChunkCompressor<float>::xor_decode(encoded), SerializationError);
+    encoded.resize(encoded.size() / 2);
+    EXPECT_THROW(ChunkCompressor<double>::xor_decode(encoded), SerializationError);
+}
+
+TEST(XorCompressionTest, RejectsValueCountsTheInputCannotHold) {
+    auto encoded = ChunkCompressor<double>::xor_encode(std::vector<double>(100, 1.5));
+    XorHeader header;
+    std::memcpy(&header, encoded.data(), sizeof(header));
+    const uint64_t payload_bits = (encoded.size() - sizeof(header)) * 8;
+
+    // A count the payload cannot hold fails before anything is allocated
+    for (uint64_t count : {payload_bits + 1, uint64_t{1} << 31, ~uint64_t{0}}) {
+        header.value_count = count;
+        std::memcpy(encoded.data(), &header, sizeof(header));
+        EXPECT_THROW(ChunkCompressor<double>::xor_decode(encoded), SerializationError) << count;
+    }
+
+    // A header alone cannot claim any values
+    header.value_count = uint64_t{1} << 31;
+    std::vector<uint8_t> bare(sizeof(header) + 8);
+    std::memcpy(bare.data(), &header, sizeof(header));
+    EXPECT_THROW(ChunkCompressor<double>::xor_decode(bare), SerializationError);
+    std::vector<int64_t> timestamps;
+    EXPECT_THROW(ChunkCompressor<double>::xor_decode(bare, timestamps), SerializationError);
+
+    // Plausible counts are still bounded by max_values
+    header.value_count = 100;
+    std::memcpy(encoded.data(), &header, sizeof(header));
+    EXPECT_EQ(ChunkCompressor<double>::xor_decode(encoded).size(), 100u);
+    EXPECT_THROW(ChunkCompressor<double>::xor_decode(encoded, 99), SerializationError);
+}
+
+TEST(XorCompressionTest, PairedTimestampColumn) {
+    auto values = telemetry(2000, 5);
+    std::vector<int64_t> timestamps(values.size());
+    int64_t t = 1700000000000;
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        t += (i % 100 == 99) ? 1003 : 1000; // occasional jitter
+        timestamps[i] = t;
+    }
+
+    auto encoded = ChunkCompressor<double>::xor_encode(values, timestamps);
+    EXPECT_TRUE(ChunkCompressor<double>::xor_has_timestamps(encoded.data(), encoded.size()));
+
+    std::vector<int64_t> decoded_ts;
+    auto decoded = ChunkCompressor<double>::xor_decode(encoded, decoded_ts);
+    EXPECT_EQ(decoded, values);
+    EXPECT_EQ(decoded_ts, timestamps);
+
+    // Values alone can be decoded without touching the timestamp column
+    EXPECT_EQ(ChunkCompressor<double>::xor_decode(encoded), values);
+
+    auto plain = ChunkCompressor<double>::xor_encode(values);
+    EXPECT_THROW(ChunkCompressor<double>::xor_decode(plain, decoded_ts), SerializationError);
+    EXPECT_THROW(ChunkCompressor<double>::xor_encode(values, std::vector<int64_t>(3)),
+                 std::invalid_argument);
+}
+
+TEST(DeltaOfDeltaTest, RegularIntervalsCostOneBit) {
+    std::vector<int64_t> timestamps(8001);
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        timestamps[i] = 1000000 + static_cast<int64_t>(i) * 60;
+    }
+    auto encoded = ChunkCompressor<int64_t>::delta_of_delta_encode(timestamps);
+    // count + first value + first delta + one bit for each remaining value
+    EXPECT_LE(encoded.size(), 2 + 8 + 4 + 1000);
+    EXPECT_EQ(ChunkCompressor<int64_t>::delta_of_delta_decode(encoded), timestamps);
+}
+
+TEST(DeltaOfDeltaTest, AllBucketsAndWrapAround) {
+    using L = std::numeric_limits<int64_t>;
+    std::vector<int64_t> data{0, 10, 20, 90, 100, -400, 3000, 2999, L::max(), L::min(), 0, 1};
+    EXPECT_EQ(ChunkCompressor<int64_t>::delta_of_delta_decode(
+                  ChunkCompressor<int64_t>::delta_of_delta_encode(data)),
+              data);
+
+    std::vector<int16_t> shorts{5, -32768, 32767, 0, 12, 13, 14};
+    EXPECT_EQ(ChunkCompressor<int16_t>::delta_of_delta_decode(
+                  ChunkCompressor<int16_t>::delta_of_delta_encode(shorts)),
+              shorts);
+    EXPECT_TRUE(ChunkCompressor<int32_t>::delta_of_delta_decode(
+                    ChunkCompressor<int32_t>::delta_of_delta_encode({}))
+                    .empty());
+}
@@ -0,0 +1,177 @@
+#include "chunk_compressed_ops.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+
+namespace {
+
+template <typename T>
+std::vector<PositionRange> expected_ranges(const std::vector<T>& data, T lo, T hi) {
+    std::vector<PositionRange> out;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i] >= lo && data[i] <= hi) {
+            if (!out.empty() && out.back().second == i) {
+                ++out.back().second;
+            } else {
+                out.emplace_back(i, i + 1);
+            }
+        }
+    }
+    return out;
+}
+
+template <typename T>
+size_t expected_count(const std::vector<T>& data, T lo, T hi) {
+    return static_cast<size_t>(
+        std::count_if(data.begin(), data.end(), [&](T v) { return v >= lo && v <= hi; }));
+}
+
+template <typename T>
+int64_t expected_sum(const std::vector<T>& data) {
+    int64_t sum = 0;
+    for (T v : data) {
+        sum += v;
+    }
+    return sum;
+}
+
+template <typename View, typename T>
+void expect_matches(const View& view, const std::vector<T>& data, T lo, T hi) {
+    ASSERT_EQ(view.size(), data.size());
+    EXPECT_EQ(view.sum(), expected_sum(data));
+    EXPECT_EQ(view.min(), *std::min_element(data.begin(), data.end()));
+    EXPECT_EQ(view.max(), *std::max_element(data.begin(), data.end()));
+    EXPECT_EQ(view.count_in_range(lo, hi), expected_count(data, lo, hi));
+    EXPECT_EQ(view.count_equal(data[data.size() / 2]),
+              expected_count(data, data[data.size() / 2], data[data.size() / 2]));
+    EXPECT_EQ(view.filter_range(lo, hi), expected_ranges(data, lo, hi));
+    EXPECT_EQ(view.count_in_range(hi, lo), 0);
+}
+
+// Sorted readings with a few plateaus, like a sensor sampled in order
+std::vector<int64_t> sorted_series(size_t n) {
+    std::mt19937 gen(7);
+    std::vector<int64_t> data(n);
+    int64_t level = -50000;
+    for (size_t i = 0; i < n; ++i) {
+        level += (i / 500) % 3 == 0 ? 0 : static_cast<int64_t>(gen() % 40);
+        data[i] = level;
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(CompressedOpsTest, RunLengthAggregatesWithoutExpanding) {
+    std::vector<int32_t> data;
+    for (int32_t v : {5, 3, 9, 3, -2, 5}) {
+        data.insert(data.end(), static_cast<size_t>(100 + v * 10), v);
+    }
+    auto runs = ChunkCompressor<int32_t>::run_length_encode(data);
+    RunLengthView<int32_t> view(runs);
+    EXPECT_EQ(view.run_count(), 6);
+    expect_matches(view, data, 3, 5);
+    EXPECT_EQ(view.filter_equal(3), expected_ranges(data, 3, 3));
+
+    RunLengthView<int32_t> empty(nullptr, 0);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.sum(), 0);
+    EXPECT_THROW(empty.min(), std::invalid_argument);
+}
+
+TEST(CompressedOpsTest, RunLengthFloatSumsInDouble) {
+    std::vector<float> data(1000, 0.5f);
+    data.insert(data.end(), 500, 2.25f);
+    auto runs = ChunkCompressor<float>::run_length_encode(data);
+    RunLengthView<float> view(runs);
+    EXPECT_DOUBLE_EQ(view.sum(), 500.0 + 1125.0);
+    EXPECT_EQ(view.count_in_range(1.0f, 3.0f), 500);
+    EXPECT_EQ(view.filter_equal(0.5f), (std::vector<PositionRange>{{0, 1000}}));
+}
+
+TEST(CompressedOpsTest, DeltaStreamsMatchDecodedChunk) {
+    auto data = sorted_series(5000);
+    auto deltas = ChunkCompressor<int64_t>::delta_encode(data);
+    DeltaView<int64_t> view(deltas);
+    expect_matches(view, data, data[1200], data[3100]);
+    EXPECT_EQ(view.min_max(), std::make_pair(data.front(), data.back()));
+
+    std::vector<int32_t> wrapping{std::numeric_limits<int32_t>::max(), -5,
+                                  std::numeric_limits<int32_t>::min(), 7};
+    auto wrapping_deltas = ChunkCompressor<int32_t>::delta_encode(wrapping);
+    DeltaView<int32_t> wrapped(wrapping_deltas);
+    EXPECT_EQ(wrapped.min(), std::numeric_limits<int32_t>::min());
+    EXPECT_EQ(wrapped.max(), std::numeric_limits<int32_t>::max());
+}
+
+TEST(CompressedOpsTest, DeltaFloatBlocksDecodeLikeFullDecode) {
+    std::vector<double> data(3000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = 0.1 * static_cast<double>(i % 1700);
+    }
+    auto deltas = ChunkCompressor<double>::delta_encode(data);
+    auto decoded = ChunkCompressor<double>::delta_decode(deltas);
+    DeltaView<double> view(deltas);
+    EXPECT_EQ(view.filter_range(10.0, 20.0), expected_ranges(decoded, 10.0, 20.0));
+    EXPECT_EQ(view.max(), *std::max_element(decoded.begin(), decoded.end()));
+}
+
+TEST(CompressedOpsTest, BitPackedRangeQueriesSkipBlocks) {
+    auto data = sorted_series(20000);
+    const int64_t lo = data[7000];
+    const int64_t hi = data[9000];
+    for (bool delta : {false, true}) {
+        auto encoded = ChunkCompressor<int64_t>::bitpack_encode(data, delta);
+        BitPackView<int64_t> view(encoded);
+        EXPECT_EQ(view.block_count(), (data.size() + 127) / 128);
+        expect_matches(view, data, lo, hi);
+        // Sorted data: only blocks near a bound are unpacked; bit widths round bounds up
+        EXPECT_LE(view.blocks_to_unpack(lo, hi), 8) << "delta=" << delta;
+        EXPECT_EQ(view.blocks_to_unpack(data.back() + 10000, data.back() + 20000), 0);
+    }
+}
+
+TEST(CompressedOpsTest, BitPackedUnsortedAndSignedData) {
+    std::mt19937 gen(3);
+    std::vector<int32_t> data(1000);
+    for (auto& v : data) {
+        v = static_cast<int32_t>(gen() % 2001) - 1000;
+    }
+    data[437] = std::numeric_limits<int32_t>::min();
+    data[901] = std::numeric_limits<int32_t>::max();
+    for (bool delta : {false, true}) {
+        auto encoded = ChunkCompressor<int32_t>::bitpack_encode(data, delta);
+        BitPackView<int32_t> view(encoded);
+        expect_matches(view, data, -100, 250);
+    }
+
+    std::vector<uint16_t> shorts(300, 40000);
+    shorts[299] = 7;
+    auto packed = ChunkCompressor<uint16_t>::bitpack_encode(shorts);
+    BitPackView<uint16_t> small(packed);
+    EXPECT_EQ(small.sum(), 299u * 40000u + 7u);
+    EXPECT_EQ(small.min(), 7);
+    EXPECT_EQ(small.max(), 40000);
+    EXPECT_EQ(small.count_equal(40000), 299);
+    // The two constant blocks are counted from their headers alone
+    EXPECT_EQ(small.blocks_to_unpack(40000, 40000), 1);
+}
+
+TEST(CompressedOpsTest, BitPackedEmptyAndMalformedStreams) {
+    auto nothing = ChunkCompressor<int32_t>::bitpack_encode({});
+    BitPackView<int32_t> empty(nothing);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.sum(), 0);
+    EXPECT_TRUE(empty.filter_range(0, 10).empty());
+    EXPECT_THROW(empty.max(), std::invalid_argument);
+
+    auto encoded = ChunkCompressor<int32_t>::bitpack_encode(std::vector<int32_t>(500, 1));
+    EXPECT_THROW(BitPackView<int64_t>{encoded}, chunk_processing::SerializationError);
+    encoded.resize(encoded.size() - 10);
+    EXPECT_THROW(BitPackView<int32_t>{encoded}, chunk_processing::SerializationError);
+}
@@ -0,0 +1,136 @@
+#include "chunk_compression.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_backend::Backend;
+
+namespace {
+
+template <typename T>
+std::vector<T> random_values(size_t n, unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> data(n);
+    for (auto& v : data) {
+        v = static_cast<T>(gen());
+    }
+    return data;
+}
+
+template <typename U>
+void check_all_backends(size_t n) {
+    auto input = random_values<U>(n, static_cast<unsigned>(n));
+    std::vector<U> expected_enc(n), expected_dec(n);
+    detail::delta_encode_scalar(input.data(), n, expected_enc.data());
+    detail::delta_decode_scalar(input.data(), n, expected_dec.data());
+
+    for (Backend b : detail::delta_encode_kernel<U>().available()) {
+        std::vector<U> out(n);
+        detail::delta_encode_kernel<U>().resolve(b)(input.data(), n, out.data());
+        EXPECT_EQ(out, expected_enc) << backend_name(b) << " encode n=" << n;
+
+        std::vector<U> inplace = input;
+        detail::delta_encode_kernel<U>().resolve(b)(inplace.data(), n, inplace.data());
+        EXPECT_EQ(inplace, expected_enc) << backend_name(b) << " in-place encode n=" << n;
+    }
+    for (Backend b : detail::delta_decode_kernel<U>().available()) {
+        std::vector<U> out(n);
+        detail::delta_decode_kernel<U>().resolve(b)(input.data(), n, out.data());
+        EXPECT_EQ(out, expected_dec) << backend_name(b) << " decode n=" << n;
+
+        std::vector<U> inplace = input;
+        detail::delta_decode_kernel<U>().resolve(b)(inplace.data(), n, inplace.data());
+        EXPECT_EQ(inplace, expected_dec) << backend_name(b) << " in-place decode n=" << n;
+    }
+}
+
+} // namespace
+
+TEST(DeltaKernelTest, BackendsMatchScalarForAllTailLengths) {
+    for (size_t n = 0; n < 40; ++n) {
+        check_all_backends<uint32_t>(n);
+        check_all_backends<uint64_t>(n);
+    }
+    check_all_backends<uint32_t>(10007);
+    check_all_backends<uint64_t>(10007);
+}
+
+TEST(DeltaKernelTest, RoundTripWrapsAroundSignedRange) {
+    const int32_t lo = std::numeric_limits<int32_t>::min();
+    const int32_t hi = std::numeric_limits<int32_t>::max();
+    std::vector<int32_t> data{hi, lo, 0, -1, 1, hi};
+    auto encoded = ChunkCompressor<int32_t>::delta_encode(data);
+    EXPECT_EQ(ChunkCompressor<int32_t>::delta_decode(encoded), data);
+
+    auto wide = random_values<int64_t>(1001, 9);
+    EXPECT_EQ(ChunkCompressor<int64_t>::delta_decode(ChunkCompressor<int64_t>::delta_encode(wide)),
+              wide);
+}
+
+TEST(DeltaKernelTest, InPlaceMatchesCopyingApi) {
+    auto data = random_values<int32_t>(517, 3);
+    auto encoded = ChunkCompressor<int32_t>::delta_encode(data);
+
+    auto inplace = data;
+    ChunkCompressor<int32_t>::delta_encode_inplace(inplace);
+    EXPECT_EQ(inplace, encoded);
+    ChunkCompressor<int32_t>::delta_decode_inplace(inplace);
+    EXPECT_EQ(inplace, data);
+}
+
+TEST(DeltaKernelTest, FloatingPointMatchesSequentialSum) {
+    std::vector<double> data{1.5, 2.25, -3.0, 1e10, 1e-10, 7.0};
+    auto encoded = ChunkCompressor<double>::delta_encode(data);
+    std::vector<double> expected{data[0]};
+    for (size_t i = 1; i < encoded.size(); ++i) {
+        expected.push_back(expected.back() + encoded[i]);
+    }
+    EXPECT_EQ(ChunkCompressor<double>::delta_decode(encoded), expected);
+
+    std::vector<float> floats{1.0f, 2.0f, 4.0f, 8.0f};
+    std::vector<float> out(floats.size());
+    ChunkCompressor<float>::delta_encode(floats.data(), floats.size(), out.data());
+    EXPECT_EQ(out, (std::vector<float>{1.0f, 1.0f, 2.0f, 4.0f}));
+}
+
+TEST(DeltaKernelTest, ZigzagMapsSmallMagnitudesToSmallCodes) {
+    using C = ChunkCompressor<int32_t>;
+    EXPECT_EQ(C::zigzag_encode(0), 0u);
+    EXPECT_EQ(C::zigzag_encode(-1), 1u);
+    EXPECT_EQ(C::zigzag_encode(1), 2u);
+    EXPECT_EQ(C::zigzag_encode(-2), 3u);
+    EXPECT_EQ(C::zigzag_encode(std::numeric_limits<int32_t>::min()), 0xFFFFFFFFu);
+    for (int32_t v : {0, 1, -1, 12345, -12345, std::numeric_limits<int32_t>::max(),
+                      std::numeric_limits<int32_t>::min()}) {
+        EXPECT_EQ(C::zigzag_decode(C::zigzag_encode(v)), v);
+    }
+    EXPECT_EQ(ChunkCompressor<int16_t>::zigzag_encode(-3), uint16_t{5});
+}
+
+TEST(DeltaKernelTest, ZigzagDeltaRoundTrip) {
+    std::vector<int64_t> data{100, 99, 101, 101, -50, std::numeric_limits<int64_t>::min()};
+    auto codes = ChunkCompressor<int64_t>::zigzag_delta_encode(data);
+    EXPECT_EQ(codes[1], 1u);
+    EXPECT_EQ(codes[2], 4u);
+    EXPECT_EQ(codes[3], 0u);
+    EXPECT_EQ(ChunkCompressor<int64_t>::zigzag_delta_decode(codes), data);
+
+    auto shorts = random_values<int16_t>(300, 4);
+    EXPECT_EQ(ChunkCompressor<int16_t>::zigzag_delta_decode(
+                  ChunkCompressor<int16_t>::zigzag_delta_encode(shorts)),
+              shorts);
+}
+
+TEST(DeltaKernelTest, ZigzagDeltaIntoCallerBuffer) {
+    auto data = random_values<int32_t>(1000, 5);
+    std::vector<uint32_t> codes(data.size());
+    ChunkCompressor<int32_t>::zigzag_delta_encode(data.data(), data.size(), codes.data());
+    EXPECT_EQ(codes, ChunkCompressor<int32_t>::zigzag_delta_encode(data));
+
+    std::vector<int32_t> decoded(data.size());
+    ChunkCompressor<int32_t>::zigzag_delta_decode(codes.data(), codes.size(), decoded.data());
+    EXPECT_EQ(decoded, data);
+}
@@ -3,7 +3,7 @@
 
 using namespace chunk_compression;
 
-class ChunkCompressorTest : public ::testing::Test {
+class ChunkCompressionTest : public ::testing::Test {
 protected:
     void SetUp() override {
         test_data = {1, 1, 1, 2, 2, 3, 4, 4, 4, 4};
@@ -18,7 +18,7 @@ protected:
     std::vector<int> same_data;
 };
 
-TEST_F(ChunkCompressorTest, RunLengthEncoding) {
+TEST_F(ChunkCompressionTest, RunLengthEncoding) {
     auto encoded = ChunkCompressor<int>::run_length_encode(test_data);
 
     EXPECT_EQ(encoded.size(), 4);
@@ -28,7 +28,7 @@ TEST_F(ChunkCompressorTest, RunLengthEncoding) {
     EXPECT_EQ(encoded[3], (std::pair<int, size_t>{4, 4}));
 }
 
-TEST_F(ChunkCompressorTest, DeltaEncoding) {
+TEST_F(ChunkCompressionTest, DeltaEncoding) {
     std::vector<int> data = {10, 12, 15, 19, 24};
     auto encoded = ChunkCompressor<int>::delta_encode(data);
     auto decoded = ChunkCompressor<int>::delta_decode(encoded);
@@ -37,12 +37,12 @@ TEST_F(ChunkCompressorTest, DeltaEncoding) {
     EXPECT_EQ(decoded, data);
 }
 
-TEST_F(ChunkCompressorTest, EmptyCompression) {
+TEST_F(ChunkCompressionTest, EmptyCompression) {
     EXPECT_TRUE(ChunkCompressor<int>::run_length_encode(empty_data).empty());
     EXPECT_TRUE(ChunkCompressor<int>::delta_encode(empty_data).empty());
 }
 
-TEST_F(ChunkCompressorTest, SingleElementCompression) {
+TEST_F(ChunkCompressionTest, SingleElementCompression) {
     auto rle = ChunkCompressor<int>::run_length_encode(single_data);
     EXPECT_EQ(rle.size(), 1);
 
@@ -50,12 +50,12 @@ TEST_F(ChunkCompressorTest, SingleElementCompression) {
     EXPECT_EQ(delta.size(), 1);
 }
 
-TEST_F(ChunkCompressorTest, AllSameElements) {
+TEST_F(ChunkCompressionTest, AllSameElements) {
     auto rle = ChunkCompressor<int>::run_length_encode(same_data);
     EXPECT_EQ(rle.size(), 1);
 }
 
-TEST_F(ChunkCompressorTest, RunLengthEdgeCases) {
+TEST_F(ChunkCompressionTest, RunLengthEdgeCases) {
     // Test alternating values
     std::vector<int> alternating = {1, 2, 1, 2, 1, 2};
     auto encoded = ChunkCompressor<int>::run_length_encode(alternating);
@@ -72,7 +72,7 @@ TEST_F(ChunkCompressorTest, RunLengthEdgeCases) {
     EXPECT_EQ(encoded_repeated[0], (std::pair<int, size_t>{42, 5}));
 }
 
-TEST_F(ChunkCompressorTest, DeltaEdgeCases) {
+TEST_F(ChunkCompressionTest, DeltaEdgeCases) {
     // Test constant sequence
     std::vector<int> constant(5, 7);
     auto encoded_constant = ChunkCompressor<int>::delta_encode(constant);
@@ -90,7 +90,7 @@ TEST_F(ChunkCompressorTest, DeltaEdgeCases) {
     }
 }
 
-TEST_F(ChunkCompressorTest, DeltaRoundTrip) {
+TEST_F(ChunkCompressionTest, DeltaRoundTrip) {
     // Test various sequences
     std::vector<std::vector<int>> test_sequences = {
         {1, 1, 1, 1},      // Constant
@@ -107,7 +107,7 @@ TEST_F(ChunkCompressorTest, DeltaRoundTrip) {
     }
 }
 
-TEST_F(ChunkCompressorTest, LargeNumbers) {
+TEST_F(ChunkCompressionTest, LargeNumbers) {
     std::vector<int> large_nums = {1000000, 1000001, 1000002, 1000003};
 
     // Test RLE with large numbers
@@ -126,7 +126,7 @@ TEST_F(ChunkCompressorTest, LargeNumbers) {
     }
 }
 
-TEST_F(ChunkCompressorTest, MixedPatterns) {
+TEST_F(ChunkCompressionTest, MixedPatterns) {
     std::vector<int> mixed = {1, 1, 1, 2, 3, 3, 4, 4, 4, 4};
 
     // Test RLE with mixed patterns
@@ -143,7 +143,7 @@ TEST_F(ChunkCompressorTest, MixedPatterns) {
     EXPECT_EQ(decoded, mixed);
 }
 
-TEST_F(ChunkCompressorTest, CompressionRatio) {
+TEST_F(ChunkCompressionTest, CompressionRatio) {
     // Create a highly compressible sequence
     std::vector<int> compressible(100, 42);
     auto rle = ChunkCompressor<int>::run_length_encode(compressible);
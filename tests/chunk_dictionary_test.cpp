@@ -0,0 +1,158 @@
+#include "chunk_compression.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_processing::SerializationError;
+
+namespace {
+
+std::vector<int32_t> status_codes(size_t n, unsigned seed) {
+    const int32_t codes[] = {200, 201, 204, 301, 404, 500, 503};
+    std::mt19937 gen(seed);
+    std::discrete_distribution<int> pick({70, 5, 5, 5, 10, 3, 2});
+    std::vector<int32_t> data(n);
+    for (auto& v : data) {
+        v = codes[pick(gen)];
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(DictionaryCodecTest, RoundTripAndDictionaryOrder) {
+    auto data = status_codes(1000, 1);
+    auto encoded = ChunkCompressor<int32_t>::dictionary_encode(data);
+    EXPECT_EQ(encoded.size(), data.size());
+    EXPECT_EQ(encoded.dictionary().size(), 7);
+    EXPECT_EQ(encoded.bit_width(), 3);
+    EXPECT_EQ(encoded.dictionary()[0], data[0]);
+    EXPECT_EQ(ChunkCompressor<int32_t>::dictionary_decode(encoded), data);
+}
+
+TEST(DictionaryCodecTest, RandomAccessMatchesInput) {
+    for (size_t n : {1, 5, 127, 128, 129, 1000}) {
+        auto data = status_codes(n, static_cast<unsigned>(n));
+        DictionaryChunk<int32_t> encoded(data);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(encoded[i], data[i]) << "n=" << n << " i=" << i;
+        }
+        EXPECT_THROW(encoded.code_at(n), std::out_of_range);
+    }
+}
+
+TEST(DictionaryCodecTest, ManyDistinctValuesUseWiderCodes) {
+    std::vector<int64_t> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int64_t>((i * 7919) % 3001) * 1000003;
+    }
+    DictionaryChunk<int64_t> encoded(data);
+    EXPECT_EQ(encoded.dictionary().size(), 3001);
+    EXPECT_EQ(encoded.bit_width(), 12);
+    EXPECT_EQ(encoded.decode(), data);
+}
+
+TEST(DictionaryCodecTest, CountAndFilterRunOnCodes) {
+    auto data = status_codes(3000, 2);
+    DictionaryChunk<int32_t> encoded(data);
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i] == 404) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(encoded.count_equal(404), expected.size());
+    EXPECT_EQ(encoded.filter_equal(404), expected);
+    EXPECT_EQ(encoded.count_equal(418), 0);
+    EXPECT_TRUE(encoded.filter_equal(418).empty());
+}
+
+TEST(DictionaryCodecTest, FloatingPointKeepsSignedZeroAndMatchesByValue) {
+    std::vector<double> data{0.0, -0.0, 1.5, 0.0, 1.5, -0.0};
+    DictionaryChunk<double> encoded(data);
+    EXPECT_EQ(encoded.dictionary().size(), 3);
+    auto decoded = encoded.decode();
+    EXPECT_TRUE(std::signbit(decoded[1]));
+    EXPECT_FALSE(std::signbit(decoded[3]));
+    // Both zeros compare equal to 0.0, as they would when decoded
+    EXPECT_EQ(encoded.count_equal(0.0), 4);
+    EXPECT_EQ(encoded.filter_equal(1.5), (std::vector<size_t>{2, 4}));
+}
+
+TEST(DictionaryCodecTest, StringChunks) {
+    std::vector<std::string> data;
+    const char* states[] = {"ok", "degraded", "offline", "a much longer status string"};
+    for (size_t i = 0; i < 500; ++i) {
+        data.push_back(states[(i * i) % 4]);
+    }
+    auto encoded = ChunkCompressor<std::string>::dictionary_encode(data);
+    EXPECT_EQ(encoded.dictionary().size(), 2); // squares mod 4 are 0 or 1
+    EXPECT_EQ(encoded.decode(), data);
+    EXPECT_EQ(encoded.count_equal("degraded"), 250);
+
+    auto restored = DictionaryChunk<std::string>::deserialize(encoded.serialize());
+    EXPECT_EQ(restored.decode(), data);
+    EXPECT_EQ(restored.filter_equal("ok"), encoded.filter_equal("ok"));
+}
+
+TEST(DictionaryCodecTest, SerializationRoundTripAndValidation) {
+    auto data = status_codes(777, 3);
+    DictionaryChunk<int32_t> encoded(data);
+    auto bytes = encoded.serialize();
+    EXPECT_LT(bytes.size(), data.size() * sizeof(int32_t) / 5);
+    EXPECT_EQ(DictionaryChunk<int32_t>::deserialize(bytes).decode(), data);
+
+    EXPECT_THROW(DictionaryChunk<int64_t>::deserialize(bytes), SerializationError);
+    auto truncated = bytes;
+    truncated.pop_back();
+    EXPECT_THROW(DictionaryChunk<int32_t>::deserialize(truncated), SerializationError);
+
+    // Code 7 with only 7 dictionary entries (0..6) must be rejected
+    auto corrupt = bytes;
+    const size_t codes_offset = sizeof(DictionaryHeader) + 7 * sizeof(int32_t);
+    std::fill(corrupt.begin() + codes_offset, corrupt.begin() + codes_offset + 16, 0xFF);
+    EXPECT_THROW(DictionaryChunk<int32_t>::deserialize(corrupt), SerializationError);
+}
+
+TEST(DictionaryCodecTest, EmptyAndConstantChunks) {
+    DictionaryChunk<int32_t> empty(std::vector<int32_t>{});
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.decode().empty());
+    EXPECT_TRUE(DictionaryChunk<int32_t>::deserialize(empty.serialize()).empty());
+
+    DictionaryChunk<uint8_t> constant(std::vector<uint8_t>(300, 9));
+    EXPECT_EQ(constant.bit_width(), 0);
+    EXPECT_EQ(constant.count_equal(9), 300);
+    EXPECT_EQ(constant.decode(), std::vector<uint8_t>(300, 9));
+}
+
+TEST(DictionaryCodecTest, RejectsValueCountsTheInputCannotHold) {
+    auto bytes = DictionaryChunk<int32_t>(std::vector<int32_t>(300, 7)).serialize();
+    DictionaryHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    // A one-entry dictionary needs no code bits: only the limit bounds its size
+    EXPECT_EQ(DictionaryChunk<int32_t>::deserialize(bytes, 300).size(), 300);
+    EXPECT_THROW(DictionaryChunk<int32_t>::deserialize(bytes, 299), SerializationError);
+    header.value_count = uint64_t{1} << 60;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    EXPECT_THROW(DictionaryChunk<int32_t>::deserialize(bytes), SerializationError);
+
+    // Several entries without code bits, and counts that would wrap the block count
+    auto multi = DictionaryChunk<int32_t>(status_codes(100, 1)).serialize();
+    std::memcpy(&header, multi.data(), sizeof(header));
+    header.bit_width = 0;
+    auto zero_width = multi;
+    std::memcpy(zero_width.data(), &header, sizeof(header));
+    EXPECT_THROW(DictionaryChunk<int32_t>::deserialize(zero_width), SerializationError);
+
+    std::memcpy(&header, multi.data(), sizeof(header));
+    header.value_count = ~uint64_t{0};
+    std::memcpy(multi.data(), &header, sizeof(header));
+    EXPECT_THROW(DictionaryChunk<int32_t>::deserialize(multi, ~uint64_t{0}), SerializationError);
+}
@@ -0,0 +1,174 @@
+#include "chunk_compression.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace chunk_compression;
+using chunk_processing::SerializationError;
+
+namespace {
+
+// Geometric-ish bytes: the skew left behind by delta and run-length transforms
+std::vector<uint8_t> skewed_bytes(size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::geometric_distribution<int> dist(0.3);
+    std::vector<uint8_t> data(n);
+    for (auto& b : data) {
+        b = static_cast<uint8_t>(std::min(dist(gen), 255));
+    }
+    return data;
+}
+
+double entropy_bits(const std::vector<uint8_t>& data) {
+    double counts[256] = {};
+    for (uint8_t b : data) {
+        counts[b] += 1;
+    }
+    double bits = 0;
+    for (double c : counts) {
+        if (c > 0) {
+            bits -= c * std::log2(c / data.size());
+        }
+    }
+    return bits;
+}
+
+} // namespace
+
+TEST(RansCoderTest, RoundTripsAllLengths) {
+    for (size_t n : {0, 1, 2, 3, 4, 5, 7, 8, 9, 100, 4097}) {
+        auto data = skewed_bytes(n, static_cast<unsigned>(n));
+        auto encoded = RansCoder::encode(data);
+        EXPECT_EQ(RansCoder::decoded_size(encoded.data(), encoded.size()), n);
+        EXPECT_EQ(RansCoder::decode(encoded), data) << "n=" << n;
+    }
+}
+
+TEST(RansCoderTest, CompressesCloseToEntropy) {
+    auto data = skewed_bytes(1 << 18, 1);
+    auto encoded = RansCoder::encode(data);
+    const double ideal = entropy_bits(data) / 8;
+    EXPECT_LT(static_cast<double>(encoded.size()), ideal * 1.02 + 600);
+    EXPECT_EQ(RansCoder::decode(encoded), data);
+}
+
+TEST(RansCoderTest, DegenerateDistributions) {
+    std::vector<uint8_t> constant(10000, 0xAB);
+    auto encoded = RansCoder::encode(constant);
+    // A single symbol with the full probability emits no payload words, only final states
+    EXPECT_LT(encoded.size(), sizeof(RansHeader) + 40 + RANS_STREAMS * sizeof(uint32_t));
+    EXPECT_EQ(RansCoder::decode(encoded), constant);
+
+    std::vector<uint8_t> uniform(256 * 40);
+    for (size_t i = 0; i < uniform.size(); ++i) {
+        uniform[i] = static_cast<uint8_t>(i * 7);
+    }
+    EXPECT_EQ(RansCoder::decode(RansCoder::encode(uniform)), uniform);
+
+    // One dominant byte and every other byte once forces heavy renormalization
+    std::vector<uint8_t> spiky(100000, 0);
+    for (int s = 1; s < 256; ++s) {
+        spiky[static_cast<size_t>(s) * 300] = static_cast<uint8_t>(s);
+    }
+    EXPECT_EQ(RansCoder::decode(RansCoder::encode(spiky)), spiky);
+}
+
+TEST(RansCoderTest, EveryBackendDecodesTheSameStream) {
+    auto data = skewed_bytes(100000, 4);
+    auto encoded = RansCoder::encode(data);
+    for (auto backend : detail::rans_decode_kernel().available()) {
+        std::vector<uint8_t> decoded(data.size());
+        RansCoder::decode(encoded.data(), encoded.size(), decoded.data(), backend);
+        EXPECT_EQ(decoded, data) << chunk_backend::backend_name(backend);
+    }
+}
+
+TEST(RansCoderTest, RejectsMalformedStreams) {
+    auto encoded = RansCoder::encode(skewed_bytes(5000, 2));
+    auto truncated = encoded;
+    truncated.resize(truncated.size() - 3);
+    EXPECT_THROW(RansCoder::decode(truncated), SerializationError);
+
+    auto corrupt = encoded;
+    corrupt[corrupt.size() - 100] ^= 0x5A;
+    EXPECT_THROW(RansCoder::decode(corrupt), SerializationError);
+
+    auto bad_magic = encoded;
+    bad_magic[0] = 'X';
+    EXPECT_THROW(RansCoder::decode(bad_magic), SerializationError);
+}
+
+TEST(RansCoderTest, DecodedSizeIsBounded) {
+    // A single-symbol table decodes any length without reading input
+    auto encoded = RansCoder::encode(std::vector<uint8_t>(1000, 0x11));
+    RansHeader header;
+    std::memcpy(&header, encoded.data(), sizeof(header));
+    EXPECT_EQ(RansCoder::decoded_size(encoded.data(), encoded.size(), 1000), 1000);
+    EXPECT_THROW(RansCoder::decoded_size(encoded.data(), encoded.size(), 999), SerializationError);
+    EXPECT_THROW(RansCoder::decode(encoded, 999), SerializationError);
+
+    header.value_count = uint64_t{1} << 40;
+    std::memcpy(encoded.data(), &header, sizeof(header));
+    EXPECT_THROW(RansCoder::decoded_size(encoded.data(), encoded.size()), SerializationError);
+    EXPECT_THROW(RansCoder::decode(encoded), SerializationError);
+
+    // Constant planes are stored in five bytes whatever the chunk length
+    auto chunk = ChunkCompressor<int32_t>::rans_encode(std::vector<int32_t>(500, 42));
+    EXPECT_EQ(ChunkCompressor<int32_t>::rans_decode(chunk, 500).size(), 500);
+    EXPECT_THROW(ChunkCompressor<int32_t>::rans_decode(chunk, 499), SerializationError);
+    RansChunkHeader chunk_header;
+    std::memcpy(&chunk_header, chunk.data(), sizeof(chunk_header));
+    chunk_header.value_count = uint64_t{1} << 40;
+    std::memcpy(chunk.data(), &chunk_header, sizeof(chunk_header));
+    EXPECT_THROW(ChunkCompressor<int32_t>::rans_decode(chunk), SerializationError);
+}
+
+TEST(RansChunkTest, DeltaPlanesBeatPlainBitPacking) {
+    std::mt19937 gen(3);
+    std::geometric_distribution<int> gap(0.05);
+    std::vector<int64_t> timestamps(50000);
+    int64_t t = 1700000000000;
+    for (auto& v : timestamps) {
+        t += 1000 + gap(gen);
+        v = t;
+    }
+    auto encoded = ChunkCompressor<int64_t>::rans_encode(timestamps, true);
+    EXPECT_EQ(ChunkCompressor<int64_t>::rans_decode(encoded), timestamps);
+    EXPECT_LT(encoded.size(), ChunkCompressor<int64_t>::bitpack_encode(timestamps, true).size());
+    EXPECT_LT(encoded.size() * 8, timestamps.size() * sizeof(int64_t));
+}
+
+TEST(RansChunkTest, ChainsAfterOtherTransforms) {
+    std::vector<int32_t> values(20000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int32_t>((i * i) % 97) - 40;
+    }
+    EXPECT_EQ(ChunkCompressor<int32_t>::rans_decode(ChunkCompressor<int32_t>::rans_encode(values)),
+              values);
+
+    // Raw bytes of another codec's output go straight through the byte coder
+    auto varints = ChunkCompressor<int32_t>::varint_encode(values);
+    auto coded = RansCoder::encode(varints);
+    EXPECT_LT(coded.size(), varints.size());
+    EXPECT_EQ(ChunkCompressor<int32_t>::varint_decode(RansCoder::decode(coded)), values);
+
+    std::vector<double> readings(3000);
+    for (size_t i = 0; i < readings.size(); ++i) {
+        readings[i] = 20.0 + static_cast<double>(i % 50) / 4;
+    }
+    auto encoded = ChunkCompressor<double>::rans_encode(readings);
+    EXPECT_EQ(ChunkCompressor<double>::rans_decode(encoded), readings);
+    EXPECT_THROW(ChunkCompressor<double>::rans_encode(readings, true), std::invalid_argument);
+    EXPECT_THROW(ChunkCompressor<float>::rans_decode(encoded), SerializationError);
+    EXPECT_TRUE(ChunkCompressor<int16_t>::rans_decode(ChunkCompressor<int16_t>::rans_encode({}))
+                    .empty());
+
+    // Constant byte planes are stored as a single byte
+    std::vector<int64_t> constant(1000, 0x0102030405060708);
+    auto planes = ChunkCompressor<int64_t>::rans_encode(constant);
+    EXPECT_EQ(planes.size(), sizeof(RansChunkHeader) + 8 * (sizeof(uint32_t) + 1));
+    EXPECT_EQ(ChunkCompressor<int64_t>::rans_decode(planes), constant);
+}
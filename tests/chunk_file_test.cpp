@@ -0,0 +1,142 @@
+#include "chunk_file.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+using namespace chunk_io;
+using chunk_processing::SerializationError;
+
+class ChunkFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("chunk_file_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                 "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin"))
+                   .string();
+        chunks = {{1.5, -2.0, 3.25}, {}, {4.0}, std::vector<double>(1000, 0.5)};
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    bool temporary_left_behind() const {
+        const auto prefix = std::filesystem::path(path).filename().string() + ".tmp";
+        for (const auto& entry :
+             std::filesystem::directory_iterator(std::filesystem::path(path).parent_path())) {
+            if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void corrupt_byte(size_t offset) {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg(offset);
+        char c;
+        f.get(c);
+        f.seekp(offset);
+        f.put(static_cast<char>(c ^ 0x5A));
+    }
+
+    std::string path;
+    std::vector<std::vector<double>> chunks;
+};
+
+TEST_F(ChunkFileTest, ViewsPointIntoTheMapping) {
+    write_chunk_file(path, chunks);
+    MappedChunkFile<double> file(path);
+
+    ASSERT_EQ(file.size(), chunks.size());
+    EXPECT_EQ(file.value_count(), 1004);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(file.values().data()) % CHUNK_FILE_ALIGNMENT, 0);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        EXPECT_EQ(file[i].to_vector(), chunks[i]);
+    }
+    EXPECT_EQ(file.chunk(2).data(), file.values().data() + 3);
+    EXPECT_TRUE(file.chunk(1).empty());
+    EXPECT_EQ(file.to_vectors(), chunks);
+    EXPECT_THROW(file.chunk(4), std::out_of_range);
+
+    // Moving the file keeps views valid
+    auto view = file.chunk(0);
+    MappedChunkFile<double> moved(std::move(file));
+    EXPECT_EQ(view.data(), moved.chunk(0).data());
+}
+
+TEST_F(ChunkFileTest, StoresStatisticsAndCodecTags) {
+    std::vector<int64_t> timestamps(5000);
+    std::iota(timestamps.begin(), timestamps.end(), int64_t{1700000000000});
+    std::vector<std::vector<int64_t>> ints{{7, -3, 12}, timestamps, std::vector<int64_t>(800, 9)};
+    ChunkFileOptions options;
+    options.codec_tags = true;
+    write_chunk_file(path, ints, options);
+
+    MappedChunkFile<int64_t> file(path);
+    ASSERT_TRUE(file.has_statistics());
+    EXPECT_EQ(file.statistics(0).min, -3);
+    EXPECT_EQ(file.statistics(0).max, 12);
+    EXPECT_DOUBLE_EQ(file.statistics(0).sum, 16.0);
+    EXPECT_EQ(file.statistics(1).max, timestamps.back());
+
+    ASSERT_TRUE(file.has_codec_tags());
+    chunk_compression::AdaptiveCompressor<int64_t> adaptive;
+    for (size_t i = 0; i < ints.size(); ++i) {
+        EXPECT_EQ(file.codec(i), adaptive.choose(ints[i].data(), ints[i].size()));
+    }
+    EXPECT_EQ(file.codec(1), chunk_compression::Codec::DeltaBitPack);
+}
+
+TEST_F(ChunkFileTest, OptionalSectionsCanBeOmitted) {
+    ChunkFileOptions options;
+    options.statistics = false;
+    write_chunk_file(path, chunks, options);
+    MappedChunkFile<double> file(path);
+    EXPECT_FALSE(file.has_statistics());
+    EXPECT_FALSE(file.has_codec_tags());
+    EXPECT_THROW(file.statistics(0), std::logic_error);
+    EXPECT_EQ(file.to_vectors(), chunks);
+
+    write_chunk_file(path, std::vector<std::vector<double>>{});
+    EXPECT_TRUE(MappedChunkFile<double>(path).empty());
+}
+
+TEST_F(ChunkFileTest, StreamingWriterIsAtomic) {
+    {
+        ChunkFileWriter<float> writer(path);
+        writer.append(std::vector<float>{1.0f, 2.0f});
+        EXPECT_FALSE(std::filesystem::exists(path));
+        // Abandoned without finish(): no file, no temporary left behind
+    }
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_FALSE(temporary_left_behind());
+
+    ChunkFileWriter<float> writer(path);
+    for (int i = 0; i < 100; ++i) {
+        writer.append(std::vector<float>(static_cast<size_t>(i), static_cast<float>(i)));
+    }
+    writer.finish();
+    MappedChunkFile<float> file(path);
+    ASSERT_EQ(file.size(), 100);
+    EXPECT_EQ(file.chunk(42).size(), 42);
+    EXPECT_EQ(file.chunk(42)[41], 42.0f);
+}
+
+TEST_F(ChunkFileTest, DetectsCorruptionAndMismatches) {
+    write_chunk_file(path, chunks);
+    EXPECT_THROW(MappedChunkFile<float>{path}, SerializationError);
+
+    corrupt_byte(CHUNK_FILE_ALIGNMENT + 8);
+    EXPECT_THROW(MappedChunkFile<double>{path}, SerializationError);
+    // Without checksum verification the flipped value is read as is
+    EXPECT_NO_THROW(MappedChunkFile<double>(path, false));
+
+    write_chunk_file(path, chunks);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_THROW(MappedChunkFile<double>{path}, SerializationError);
+    EXPECT_THROW(MappedChunkFile<double>{path + ".missing"}, SerializationError);
+}
@@ -0,0 +1,176 @@
+#include "chunk_log.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace chunk_io;
+using chunk_processing::SerializationError;
+
+class ChunkLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = (std::filesystem::temp_directory_path() /
+                     ("chunk_log_" +
+                      std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name()))
+                        .string();
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::vector<std::filesystem::path> segments() const {
+        return detail::log_segments(directory);
+    }
+
+    static std::vector<double> chunk_for(uint64_t i) {
+        return std::vector<double>(static_cast<size_t>(i % 7), static_cast<double>(i));
+    }
+
+    std::string directory;
+};
+
+TEST_F(ChunkLogTest, AppendsAndReplaysInOrder) {
+    {
+        ChunkLog<double> log(directory);
+        for (uint64_t i = 0; i < 20; ++i) {
+            EXPECT_EQ(log.append(chunk_for(i)), i);
+        }
+        EXPECT_EQ(log.next_sequence(), 20);
+    }
+    auto chunks = read_chunk_log<double>(directory);
+    ASSERT_EQ(chunks.size(), 20);
+    for (uint64_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(chunks[i], chunk_for(i));
+    }
+
+    // Reopening continues the sequence in the same segment
+    ChunkLog<double> log(directory);
+    EXPECT_EQ(log.next_sequence(), 20);
+    EXPECT_EQ(log.append(std::vector<double>{1.0}), 20);
+    EXPECT_EQ(segments().size(), 1);
+    EXPECT_EQ(read_chunk_log<double>(directory).size(), 21);
+}
+
+TEST_F(ChunkLogTest, RollsSegments) {
+    ChunkLogOptions options;
+    options.segment_bytes = 1024;
+    {
+        ChunkLog<double> log(directory, options);
+        for (uint64_t i = 0; i < 100; ++i) {
+            log.append(std::vector<double>(20, static_cast<double>(i)));
+        }
+    }
+    const auto files = segments();
+    // 176-byte records, about six per 1 KiB segment
+    EXPECT_GE(files.size(), 15);
+    EXPECT_EQ(files.front().filename().string(), "00000000000000000000.clog");
+
+    uint64_t expected = 0;
+    replay_chunk_log<double>(directory, [&](uint64_t sequence, ChunkView<double> values) {
+        EXPECT_EQ(sequence, expected);
+        EXPECT_EQ(values.size(), 20);
+        EXPECT_EQ(values[19], static_cast<double>(expected));
+        ++expected;
+    });
+    EXPECT_EQ(expected, 100);
+}
+
+TEST_F(ChunkLogTest, ConcurrentAppendersShareCommits) {
+    ChunkLogOptions options;
+    options.commit_delay = std::chrono::milliseconds(2);
+    constexpr int threads = 8;
+    constexpr int per_thread = 50;
+    {
+        ChunkLog<int64_t> log(directory, options);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&log, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    log.append(std::vector<int64_t>{t, i});
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        EXPECT_EQ(log.next_sequence(), threads * per_thread);
+        EXPECT_LT(log.commit_count(), threads * per_thread);
+    }
+
+    // Each writer's records stay in its own order
+    std::vector<int64_t> next(threads, 0);
+    for (const auto& chunk : read_chunk_log<int64_t>(directory)) {
+        ASSERT_EQ(chunk.size(), 2);
+        EXPECT_EQ(chunk[1], next[static_cast<size_t>(chunk[0])]++);
+    }
+    EXPECT_EQ(next, std::vector<int64_t>(threads, per_thread));
+}
+
+TEST_F(ChunkLogTest, RecoversFromTornTail) {
+    ChunkLogOptions options;
+    options.segment_bytes = 512;
+    {
+        ChunkLog<double> log(directory, options);
+        for (uint64_t i = 0; i < 30; ++i) {
+            log.append(chunk_for(i));
+        }
+    }
+    const auto files = segments();
+    ASSERT_GT(files.size(), 2);
+
+    // Tear the last record of a middle segment and leave junk after it
+    const auto torn = files[1];
+    std::filesystem::resize_file(torn, std::filesystem::file_size(torn) - 3);
+    {
+        std::ofstream junk(torn, std::ios::binary | std::ios::app);
+        junk << "junk";
+    }
+    const size_t survivors = read_chunk_log<double>(directory).size();
+    EXPECT_LT(survivors, 30);
+
+    ChunkLog<double> log(directory, options);
+    EXPECT_EQ(log.next_sequence(), survivors);
+    EXPECT_EQ(segments().size(), 2);
+    EXPECT_EQ(log.append(std::vector<double>{42.0}), survivors);
+
+    auto chunks = read_chunk_log<double>(directory);
+    ASSERT_EQ(chunks.size(), survivors + 1);
+    for (size_t i = 0; i < survivors; ++i) {
+        EXPECT_EQ(chunks[i], chunk_for(i));
+    }
+    EXPECT_EQ(chunks.back(), std::vector<double>{42.0});
+
+    // A 4-byte record is padded to 8 bytes; cutting only the padding tears it too,
+    // and later appends must stay aligned so they survive the next recovery
+    std::filesystem::remove_all(directory);
+    {
+        ChunkLog<int32_t> ints(directory);
+        EXPECT_EQ(ints.append(std::vector<int32_t>{7}), 0);
+    }
+    const auto segment = segments().front();
+    std::filesystem::resize_file(segment, std::filesystem::file_size(segment) - 2);
+    {
+        ChunkLog<int32_t> ints(directory);
+        EXPECT_EQ(ints.next_sequence(), 0);
+        EXPECT_EQ(ints.append(std::vector<int32_t>{8}), 0);
+        EXPECT_EQ(ints.append(std::vector<int32_t>{9}), 1);
+    }
+    ChunkLog<int32_t> reopened(directory);
+    EXPECT_EQ(reopened.next_sequence(), 2);
+    EXPECT_EQ(read_chunk_log<int32_t>(directory),
+              (std::vector<std::vector<int32_t>>{{8}, {9}}));
+}
+
+TEST_F(ChunkLogTest, RejectsAnotherValueType) {
+    {
+        ChunkLog<double> log(directory);
+        log.append(std::vector<double>{1.0});
+    }
+    EXPECT_THROW(ChunkLog<float>{directory}, SerializationError);
+    EXPECT_TRUE(read_chunk_log<float>(directory).empty());
+}
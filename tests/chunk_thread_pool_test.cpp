@@ -0,0 +1,52 @@
+#include "chunk_thread_pool.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+using chunk_processing::ThreadPool;
+
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce) {
+    ThreadPool pool(3);
+    std::vector<int> hits(10007, 0);
+    pool.parallel_for(0, hits.size(), 100, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            ++hits[i];
+        }
+    });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), static_cast<long>(hits.size()));
+}
+
+TEST(ThreadPoolTest, RunsInlineWithoutWorkers) {
+    ThreadPool pool(0);
+    EXPECT_EQ(pool.concurrency(), 1);
+    size_t calls = 0;
+    pool.parallel_for(5, 50, 1, [&](size_t lo, size_t hi) {
+        ++calls;
+        EXPECT_EQ(lo, 5);
+        EXPECT_EQ(hi, 50);
+    });
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(ThreadPoolTest, PropagatesExceptions) {
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.parallel_for(0, 1000, 10,
+                                   [](size_t lo, size_t) {
+                                       if (lo == 0) {
+                                           throw std::runtime_error("block failed");
+                                       }
+                                   }),
+                 std::runtime_error);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock) {
+    ThreadPool pool(2);
+    std::atomic<size_t> total{0};
+    pool.parallel_for(0, 8, 1, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            pool.parallel_for(0, 100, 10, [&](size_t a, size_t b) { total += b - a; });
+        }
+    });
+    EXPECT_EQ(total.load(), 800);
+}
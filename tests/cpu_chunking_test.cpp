@@ -0,0 +1,172 @@
+#include "gpu_chunking.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace gpu_chunking;
+
+class CPUChunkingTest : public ::testing::Test {
+protected:
+    static std::vector<int> random_walk(size_t n, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> step(-20, 20);
+        std::uniform_int_distribution<int> jump(0, 50);
+        std::vector<int> data(n);
+        int value = 100;
+        for (auto& v : data) {
+            value += step(gen);
+            if (jump(gen) == 0) {
+                value += 200;
+            }
+            v = value;
+        }
+        return data;
+    }
+
+    /**
+     * @brief Check flags computed with sliding double sums against the reference
+     *
+     * Floating-point and 64-bit windows slide double sums, whose variance and
+     * mean differ from the reference's by rounding. A flag may therefore
+     * differ only where variance and threshold * mean are equal to within
+     * ROUNDING_TOLERANCE of the window's mean square, and only rarely.
+     */
+    template <typename T>
+    static void expect_within_rounding(const std::vector<T>& data, int window, float threshold,
+                                       const std::vector<uint8_t>& actual) {
+        constexpr double ROUNDING_TOLERANCE = 1e-9;
+        const auto expected = compute_boundaries_reference(data, window, threshold);
+        ASSERT_EQ(actual.size(), expected.size());
+        size_t mismatches = 0;
+        for (size_t idx = 0; idx < expected.size(); ++idx) {
+            if (actual[idx] == expected[idx]) {
+                continue;
+            }
+            ++mismatches;
+            double sum = 0.0;
+            double sum_sq = 0.0;
+            for (size_t j = idx; j < idx + static_cast<size_t>(window); ++j) {
+                sum += static_cast<double>(data[j]);
+                sum_sq += static_cast<double>(data[j]) * static_cast<double>(data[j]);
+            }
+            const double mean = sum / window;
+            const double variance = std::max(0.0, sum_sq / window - mean * mean);
+            EXPECT_LE(std::fabs(variance - threshold * mean),
+                      ROUNDING_TOLERANCE * (sum_sq / window + std::fabs(mean)))
+                << "window=" << window << " idx=" << idx;
+        }
+        EXPECT_LE(mismatches, expected.size() / 1000 + 1) << "window=" << window;
+    }
+
+    chunk_processing::ThreadPool pool{3};
+};
+
+TEST_F(CPUChunkingTest, MatchesReferenceAcrossWindowsAndThresholds) {
+    auto data = random_walk(5000, 42);
+    for (int window : {1, 2, 7, 32, 257}) {
+        for (float threshold : {0.05f, 0.1f, 0.5f, 0.9f}) {
+            auto expected = compute_boundaries_reference(data, window, threshold);
+            auto actual = compute_boundaries(data, window, threshold, &pool);
+            EXPECT_EQ(actual, expected) << "window=" << window << " threshold=" << threshold;
+        }
+    }
+}
+
+TEST_F(CPUChunkingTest, MatchesReferenceWhenSplitAcrossThreads) {
+    // Large enough that parallel_for splits the positions into several blocks
+    auto data = random_walk(200000, 7);
+    auto expected = compute_boundaries_reference(data, 16, 0.1f);
+    auto actual = compute_boundaries(data, 16, 0.1f, &pool);
+    EXPECT_EQ(actual, expected);
+    EXPECT_GT(std::count(actual.begin(), actual.end(), uint8_t{1}), 0);
+}
+
+TEST_F(CPUChunkingTest, MatchesReferenceForFloatingPoint) {
+    auto ints = random_walk(3000, 3);
+    std::vector<double> data(ints.begin(), ints.end());
+    expect_within_rounding(data, 9, 0.2f, compute_boundaries(data, 9, 0.2f, &pool));
+
+    // Fractional values and spikes whose rounding error would linger in plain sliding sums
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> fractional(50000);
+    for (auto& v : fractional) {
+        v = unit(gen);
+    }
+    fractional[1000] = 1e9;
+    fractional[30001] = -3e12;
+    for (int window : {1, 16, 300, 2000}) {
+        const auto sequential = compute_boundaries(fractional, window, 0.1f);
+        expect_within_rounding(fractional, window, 0.1f, sequential);
+        // Anchors sit at fixed positions, so splitting across threads changes nothing
+        EXPECT_EQ(compute_boundaries(fractional, window, 0.1f, &pool), sequential)
+            << "window=" << window;
+        for (auto backend : boundary_kernel<double>().available()) {
+            expect_within_rounding(fractional, window, 0.1f,
+                                   compute_boundaries(fractional, window, 0.1f, backend));
+        }
+    }
+
+    std::vector<float> single(fractional.begin(), fractional.end());
+    expect_within_rounding(single, 16, 0.1f, compute_boundaries(single, 16, 0.1f, &pool));
+}
+
+TEST_F(CPUChunkingTest, MatchesReferenceForLargeInt64) {
+    // Window sums and squares of these values overflow 64- and 128-bit integers
+    std::mt19937_64 gen(9);
+    std::vector<int64_t> data(3000);
+    for (auto& v : data) {
+        v = static_cast<int64_t>(gen());
+    }
+    expect_within_rounding(data, 32, 0.1f, compute_boundaries(data, 32, 0.1f, &pool));
+}
+
+TEST_F(CPUChunkingTest, ShortInputHasNoBoundaries) {
+    std::vector<int> data{1, 50, 2, 60};
+    auto flags = compute_boundaries(data, 4, 0.1f, &pool);
+    EXPECT_EQ(flags, std::vector<uint8_t>(4, 0));
+
+    CPUChunking<int> chunker(4, 0.1f, &pool);
+    auto chunks = chunker.chunk(data);
+    ASSERT_EQ(chunks.size(), 1);
+    EXPECT_EQ(chunks[0], data);
+    EXPECT_TRUE(chunker.chunk({}).empty());
+}
+
+TEST_F(CPUChunkingTest, ChunksFollowBoundaries) {
+    auto data = random_walk(2000, 11);
+    CPUChunking<int> chunker(8, 0.1f, &pool);
+    auto flags = chunker.boundaries(data);
+    auto chunks = chunker.chunk(data);
+
+    size_t expected_chunks = std::count(flags.begin(), flags.end() - 1, uint8_t{1}) + 1;
+    ASSERT_EQ(chunks.size(), expected_chunks);
+
+    std::vector<int> joined;
+    for (const auto& chunk : chunks) {
+        ASSERT_FALSE(chunk.empty());
+        joined.insert(joined.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(joined, data);
+}
+
+TEST_F(CPUChunkingTest, GPUChunkingFallsBackToCPU) {
+    GPUChunking<int> chunker(8, 0.1f);
+    auto data = random_walk(1000, 5);
+    if (!GPUChunking<int>::is_gpu_available()) {
+        EXPECT_EQ(chunker.chunk(data),
+                  split_at_boundaries(data, compute_boundaries_reference(data, 8, 0.1f)));
+    }
+    EXPECT_FALSE(GPUChunking<int>::get_gpu_info().empty());
+}
+
+TEST_F(CPUChunkingTest, ParameterValidation) {
+    CPUChunking<int> chunker;
+    EXPECT_EQ(chunker.get_window_size(), 32);
+    EXPECT_FLOAT_EQ(chunker.get_threshold(), 0.1f);
+    EXPECT_THROW(chunker.set_window_size(0), std::invalid_argument);
+    EXPECT_THROW(chunker.set_threshold(1.5f), std::invalid_argument);
+    EXPECT_THROW(compute_boundaries(std::vector<int>{1, 2, 3}, 0, 0.1f), std::invalid_argument);
+}
@@ -0,0 +1,124 @@
+#include "neural_model_format.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace neural_chunking;
+
+class NeuralModelFormatTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("neural_model_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                 "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin"))
+                   .string();
+        layers.emplace_back(4, 3);
+        layers.emplace_back(3, 1);
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void corrupt_byte(size_t offset) {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg(offset);
+        char c;
+        f.get(c);
+        f.seekp(offset);
+        f.put(static_cast<char>(c ^ 0x5A));
+    }
+
+    std::string path;
+    std::vector<Layer<double>> layers;
+    NeuralChunking<double> chunker{6, 0.75};
+};
+
+TEST_F(NeuralModelFormatTest, RoundTripBorrowsParameters) {
+    save_model(path, chunker, layers);
+    MappedNeuralModel<double> model(path);
+
+    ASSERT_EQ(model.layers().size(), 2);
+    EXPECT_EQ(model.window_size(), 6);
+    EXPECT_DOUBLE_EQ(model.threshold(), 0.75);
+
+    for (size_t i = 0; i < layers.size(); ++i) {
+        const auto& mapped = model.layers()[i];
+        EXPECT_TRUE(mapped.is_borrowed());
+        EXPECT_EQ(mapped.input_size(), layers[i].input_size());
+        EXPECT_EQ(mapped.output_size(), layers[i].output_size());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.weight_data()) % WEIGHT_FILE_ALIGNMENT, 0);
+        for (size_t j = 0; j < mapped.input_size() * mapped.output_size(); ++j) {
+            EXPECT_EQ(mapped.weight_data()[j], layers[i].weight_data()[j]);
+        }
+    }
+}
+
+TEST_F(NeuralModelFormatTest, ForwardMatchesOwnedLayers) {
+    save_model(path, chunker, layers);
+    MappedNeuralModel<double> model(path);
+
+    std::vector<double> input{0.5, -1.0, 2.0, 0.25};
+    auto expected = layers[1].forward(layers[0].forward(input));
+    EXPECT_EQ(model.forward(input), expected);
+}
+
+TEST_F(NeuralModelFormatTest, MakeChunkerUsesStoredConfiguration) {
+    save_model(path, chunker, layers);
+    MappedNeuralModel<double> model(path);
+    auto restored = model.make_chunker();
+
+    std::vector<double> data{1.0, 1.0, 1.0, 5.0, 5.0, 5.0, 9.0, 9.0};
+    EXPECT_EQ(restored.get_window_size(), chunker.get_window_size());
+    EXPECT_EQ(restored.chunk(data), chunker.chunk(data));
+}
+
+TEST_F(NeuralModelFormatTest, DetectsCorruption) {
+    save_model(path, chunker, layers);
+    corrupt_byte(std::filesystem::file_size(path) - 70);
+    EXPECT_THROW(MappedNeuralModel<double>{path}, chunk_processing::SerializationError);
+    EXPECT_NO_THROW((MappedNeuralModel<double>{path, false}));
+}
+
+TEST_F(NeuralModelFormatTest, ChecksumCoversHeader) {
+    save_model(path, chunker, layers);
+    corrupt_byte(offsetof(WeightFileHeader, threshold));
+    EXPECT_THROW(MappedNeuralModel<double>{path}, chunk_processing::SerializationError);
+}
+
+TEST_F(NeuralModelFormatTest, RejectsOverflowingLayerShape) {
+    save_model(path, chunker, layers);
+    // input * output wraps to a small count that would pass the bounds check
+    WeightLayerRecord record;
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.seekg(sizeof(WeightFileHeader));
+        in.read(reinterpret_cast<char*>(&record), sizeof(record));
+    }
+    record.input_size = uint64_t{1} << 32;
+    record.output_size = (uint64_t{1} << 32) + 1;
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(sizeof(WeightFileHeader));
+        f.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    EXPECT_THROW((MappedNeuralModel<double>{path, false}), chunk_processing::SerializationError);
+}
+
+TEST_F(NeuralModelFormatTest, RejectsTypeMismatchAndTruncation) {
+    save_model(path, chunker, layers);
+    EXPECT_THROW(MappedNeuralModel<float>{path}, chunk_processing::SerializationError);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_THROW(MappedNeuralModel<double>{path}, chunk_processing::SerializationError);
+}
+
+TEST_F(NeuralModelFormatTest, RejectsMismatchedLayerShapes) {
+    std::vector<Layer<double>> bad;
+    bad.emplace_back(4, 3);
+    bad.emplace_back(2, 1);
+    EXPECT_THROW(save_model(path, chunker, bad), std::invalid_argument);
+}
@@ -0,0 +1,253 @@
+#include "chunk_benchmark.hpp"
+#include "chunk_perf_counters.hpp"
+#include "chunk_strategy_implementations.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <new>
+#include <sstream>
+#include <vector>
+
+using namespace chunk_benchmark;
+
+namespace {
+
+// Allocates exactly `bytes` once per chunk set it produces
+class AllocatingStrategy : public chunk_processing::ChunkStrategy<int> {
+public:
+    explicit AllocatingStrategy(size_t bytes) : bytes_(bytes) {}
+    std::vector<std::vector<int>> apply(const std::vector<int>& data) const override {
+        std::vector<std::vector<int>> chunks(1);
+        chunks[0].reserve(bytes_ / sizeof(int));
+        chunks[0].assign(data.begin(), data.end());
+        return chunks;
+    }
+
+private:
+    size_t bytes_;
+};
+
+} // namespace
+
+TEST(BenchmarkHarnessTest, SummarizesSamples) {
+    BenchmarkResult result;
+    result.strategy_name = "fixed";
+    result.elements = 1000;
+    result.bytes = 4000;
+    for (int i = 1; i <= 100; ++i) {
+        result.samples_ns.push_back(i * 10.0);
+    }
+    summarize(result);
+    EXPECT_EQ(result.iterations, 100u);
+    EXPECT_DOUBLE_EQ(result.mean_ns, 505.0);
+    EXPECT_DOUBLE_EQ(result.median_ns, 505.0);
+    EXPECT_DOUBLE_EQ(result.p90_ns, 901.0);
+    EXPECT_NEAR(result.p99_ns, 990.1, 1e-9);
+    EXPECT_DOUBLE_EQ(result.min_ns, 10.0);
+    EXPECT_DOUBLE_EQ(result.max_ns, 1000.0);
+    EXPECT_NEAR(result.stddev_ns, 290.11, 0.01);
+    EXPECT_DOUBLE_EQ(result.execution_time_ms, 0.0505);
+    EXPECT_DOUBLE_EQ(result.elements_per_second, 1000 * 1e9 / 505.0);
+    EXPECT_DOUBLE_EQ(result.bytes_per_second, 4000 * 1e9 / 505.0);
+}
+
+TEST(BenchmarkHarnessTest, RunsNamedStrategiesWithWarmup) {
+    std::vector<int> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i % 10);
+    }
+    BenchmarkOptions options;
+    options.warmup_iterations = 2;
+    options.iterations = 7;
+    ChunkBenchmark<int> benchmark(data, options);
+    benchmark.add_strategy(std::make_shared<AllocatingStrategy>(1 << 20), "allocating");
+    benchmark.add_strategy(
+        std::make_shared<chunk_processing::SimilarityChunkingStrategy<int>>(0.5));
+    EXPECT_THROW(benchmark.add_strategy(nullptr), std::invalid_argument);
+
+    auto results = benchmark.benchmark_chunking();
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].strategy_name, "allocating");
+    EXPECT_NE(results[1].strategy_name.find("SimilarityChunkingStrategy"), std::string::npos);
+    for (const auto& result : results) {
+        EXPECT_EQ(result.iterations, 7u);
+        EXPECT_EQ(result.samples_ns.size(), 7u);
+        EXPECT_EQ(result.elements, 1000u);
+        EXPECT_EQ(result.bytes, 1000 * sizeof(int));
+        EXPECT_GT(result.median_ns, 0.0);
+        EXPECT_LE(result.median_ns, result.p90_ns);
+        EXPECT_LE(result.p90_ns, result.p99_ns);
+        EXPECT_GT(result.elements_per_second, 0.0);
+    }
+    EXPECT_EQ(results[0].num_chunks, 1u);
+
+    // The test runner links the allocation hooks, so peak heap growth is real
+    ASSERT_TRUE(AllocationTracker::installed());
+    EXPECT_TRUE(results[0].memory_tracked);
+    EXPECT_GE(results[0].memory_usage_bytes, size_t{1} << 20);
+    EXPECT_LT(results[0].memory_usage_bytes, size_t{1} << 21);
+}
+
+TEST(BenchmarkHarnessTest, TracksAllocations) {
+    const auto before = AllocationTracker::totals();
+    const int64_t baseline = AllocationTracker::reset_peak();
+    {
+        std::vector<char> block(100000);
+        void* aligned = ::operator new(4096, std::align_val_t(256));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0u);
+        EXPECT_GE(AllocationTracker::live_bytes() - baseline, 104096);
+        ::operator delete(aligned, std::align_val_t(256));
+    }
+    const auto after = AllocationTracker::totals();
+    EXPECT_GE(after.allocations - before.allocations, 2u);
+    EXPECT_GE(after.bytes_allocated - before.bytes_allocated, 100000u);
+    EXPECT_GE(AllocationTracker::peak_live_bytes() - baseline, 100000);
+    EXPECT_EQ(AllocationTracker::live_bytes(), baseline);
+
+    // Sizes whose block would wrap around fail instead of returning a short block
+    volatile size_t huge = SIZE_MAX - 8;
+    EXPECT_THROW(::operator delete(::operator new(huge)), std::bad_alloc);
+    EXPECT_THROW(::operator delete(::operator new(huge, std::align_val_t(256)),
+                                   std::align_val_t(256)),
+                 std::bad_alloc);
+    EXPECT_EQ(::operator new(huge, std::nothrow), nullptr);
+    EXPECT_EQ(AllocationTracker::live_bytes(), baseline);
+}
+
+TEST(BenchmarkHarnessTest, ScopedCounterNestsAndKeepsOuterPeak) {
+    ASSERT_TRUE(AllocationTracker::installed());
+    ScopedAllocationCounter outer;
+    { std::vector<char> large(1 << 20); }
+    {
+        ScopedAllocationCounter inner;
+        std::vector<char> small(1000);
+        const auto stats = inner.stats();
+        EXPECT_EQ(stats.allocations, 1u);
+        EXPECT_EQ(stats.deallocations, 0u);
+        EXPECT_EQ(stats.bytes_allocated, 1000u);
+        EXPECT_EQ(stats.peak_bytes, 1000u);
+    }
+    const auto stats = outer.stats();
+    EXPECT_EQ(stats.allocations, 2u);
+    EXPECT_EQ(stats.deallocations, 2u);
+    EXPECT_EQ(stats.bytes_allocated, (1u << 20) + 1000u);
+    EXPECT_EQ(stats.peak_bytes, 1u << 20);
+}
+
+TEST(BenchmarkHarnessTest, ReportsAllocationsPerRun) {
+    BenchmarkOptions options;
+    options.warmup_iterations = 1;
+    options.iterations = 4;
+    const auto result = run_benchmark(
+        "two_blocks", 1, 1,
+        [] {
+            std::vector<char> a(4096);
+            std::vector<char> b(1024);
+            return a.size() + b.size();
+        },
+        options);
+    ASSERT_TRUE(result.memory_tracked);
+    EXPECT_DOUBLE_EQ(result.allocations_per_run, 2.0);
+    EXPECT_DOUBLE_EQ(result.allocated_bytes_per_run, 5120.0);
+    EXPECT_EQ(result.memory_usage_bytes, 5120u);
+
+    std::ostringstream csv;
+    write_csv(csv, {result});
+    EXPECT_NE(csv.str().find(",peak_memory_bytes,allocations_per_run,allocated_bytes_per_run,"),
+              std::string::npos);
+    EXPECT_NE(csv.str().find(",5120,2,5120,"), std::string::npos) << csv.str();
+    std::ostringstream json;
+    write_json(json, {result});
+    EXPECT_NE(json.str().find("\"allocations_per_run\": 2, \"allocated_bytes_per_run\": 5120"),
+              std::string::npos);
+}
+
+TEST(BenchmarkHarnessTest, SavesCsvAndJson) {
+    std::vector<int> data(100, 1);
+    ChunkBenchmark<int> benchmark(data, 3);
+    benchmark.add_strategy(std::make_shared<AllocatingStrategy>(64), "a,\"b\"");
+    benchmark.benchmark_chunking();
+
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string csv = (dir / "chunk_benchmark_results.csv").string();
+    const std::string json = (dir / "chunk_benchmark_results.json").string();
+    benchmark.save_results(csv);
+    benchmark.save_results(json);
+
+    std::ifstream csv_in(csv);
+    std::string header, row;
+    std::getline(csv_in, header);
+    std::getline(csv_in, row);
+    EXPECT_EQ(header.rfind("name,iterations,elements,bytes,num_chunks,mean_ns", 0), 0u);
+    EXPECT_EQ(row.rfind("\"a,\"\"b\"\"\",3,100,400,1,", 0), 0u) << row;
+
+    std::stringstream json_text;
+    json_text << std::ifstream(json).rdbuf();
+    EXPECT_NE(json_text.str().find("\"name\": \"a,\\\"b\\\"\""), std::string::npos);
+    EXPECT_NE(json_text.str().find("\"samples_ns\": ["), std::string::npos);
+    std::remove(csv.c_str());
+    std::remove(json.c_str());
+
+    EXPECT_THROW(benchmark.save_results("/nonexistent-dir/results.csv"),
+                 chunk_processing::ChunkingError);
+}
+
+TEST(PerfCountersTest, CountsOrDegradesGracefully) {
+    PerfCounters counters;
+    counters.start();
+    volatile uint64_t sink = 0;
+    for (uint64_t i = 0; i < 1000000; ++i) {
+        sink = sink + i * i;
+    }
+    counters.stop();
+    const auto values = counters.read();
+
+    if (!counters.available()) {
+        // Typical in containers: no counters, NaN readings, a reason to report
+        EXPECT_FALSE(counters.error().empty());
+        for (double value : values.values) {
+            EXPECT_TRUE(std::isnan(value));
+        }
+        return;
+    }
+    // A group the PMU never scheduled reads NaN throughout rather than zero
+    const bool counted = std::any_of(values.values.begin(), values.values.end(),
+                                     [](double value) { return !std::isnan(value); });
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        const auto event = static_cast<PerfEvent>(e);
+        EXPECT_EQ(counted && counters.available(event), !std::isnan(values[event]))
+            << perf_event_name(event);
+    }
+    if (counted && counters.available(PerfEvent::Instructions)) {
+        EXPECT_GT(values[PerfEvent::Instructions], 1000000.0);
+    }
+}
+
+TEST(PerfCountersTest, HarnessReportsCountsPerElement) {
+    std::vector<int> data(4096, 3);
+    BenchmarkOptions options;
+    options.iterations = 5;
+    options.perf_counters = true;
+    ChunkBenchmark<int> benchmark(data, options);
+    benchmark.add_strategy(std::make_shared<AllocatingStrategy>(64), "copy");
+    const auto result = benchmark.benchmark_chunking().at(0);
+
+    const bool available = PerfCounters().available(PerfEvent::Cycles);
+    EXPECT_EQ(std::isnan(result.counters_per_element[PerfEvent::Cycles]), !available);
+    if (available) {
+        EXPECT_GT(result.counters_per_element[PerfEvent::Cycles], 0.0);
+    }
+
+    std::ostringstream csv;
+    write_csv(csv, {result});
+    EXPECT_NE(csv.str().find(",cycles_per_element,instructions_per_element,"), std::string::npos);
+
+    // Off by default
+    ChunkBenchmark<int> plain(data, 2);
+    plain.add_strategy(std::make_shared<AllocatingStrategy>(64), "copy");
+    EXPECT_TRUE(std::isnan(plain.benchmark_chunking()[0].counters_per_element[PerfEvent::Cycles]));
+}
@@ -1,6 +1,10 @@
 #include "chunk_metrics.hpp"
+#include <algorithm>
+#include <cmath>
 #include <gtest/gtest.h>
 #include <limits>
+#include <random>
+#include <thread>
 #include <vector>
 
 using namespace chunk_metrics;
@@ -81,4 +85,283 @@ TEST_F(ChunkMetricsTest, CacheClear) {
     analyzer.clear_cache();
     // Verify the function runs without errors
     EXPECT_NO_THROW(analyzer.compute_cohesion(well_separated_chunks));
-}
\ No newline at end of file
+}
+
+namespace {
+
+// Direct O(N^2) definition the fast path must reproduce
+template <typename T>
+double brute_force_silhouette(const std::vector<std::vector<T>>& chunks) {
+    double total = 0.0;
+    size_t points = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (T x : chunks[i]) {
+            double a = 0.0;
+            for (T y : chunks[i]) {
+                a += std::abs(static_cast<double>(x) - static_cast<double>(y));
+            }
+            a = chunks[i].size() > 1 ? a / (chunks[i].size() - 1) : 0.0;
+            double b = std::numeric_limits<double>::max();
+            for (size_t j = 0; j < chunks.size(); ++j) {
+                if (j == i || chunks[j].empty()) {
+                    continue;
+                }
+                double d = 0.0;
+                for (T y : chunks[j]) {
+                    d += std::abs(static_cast<double>(x) - static_cast<double>(y));
+                }
+                b = std::min(b, d / chunks[j].size());
+            }
+            const double m = std::max(a, b);
+            total += m > 0 ? (b - a) / m : 0.0;
+            ++points;
+        }
+    }
+    return total / points;
+}
+
+std::vector<std::vector<double>> random_chunks(size_t count, size_t max_size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 3.0);
+    std::uniform_int_distribution<size_t> size(0, max_size);
+    std::vector<std::vector<double>> chunks(count);
+    double level = 0.0;
+    for (auto& chunk : chunks) {
+        level += noise(rng);
+        chunk.resize(size(rng));
+        for (auto& v : chunk) {
+            v = std::round(level + noise(rng)); // Rounding creates ties
+        }
+    }
+    return chunks;
+}
+
+} // namespace
+
+TEST_F(ChunkMetricsTest, SilhouetteMatchesPairwiseDefinition) {
+    for (uint32_t seed = 1; seed <= 5; ++seed) {
+        auto chunks = random_chunks(40, 60, seed);
+        chunks.push_back({});
+        chunks.push_back({7.0});
+        EXPECT_NEAR(analyzer.compute_silhouette_score(chunks), brute_force_silhouette(chunks),
+                    1e-9);
+    }
+    EXPECT_NEAR(analyzer.compute_silhouette_score(mixed_cohesion_chunks),
+                brute_force_silhouette(mixed_cohesion_chunks), 1e-12);
+
+    // Unsigned differences must not wrap
+    ChunkQualityAnalyzer<unsigned> unsigned_analyzer;
+    std::vector<std::vector<unsigned>> unsigned_chunks{{1, 2, 3}, {10, 12}, {2, 40}};
+    EXPECT_NEAR(unsigned_analyzer.compute_silhouette_score(unsigned_chunks),
+                brute_force_silhouette(unsigned_chunks), 1e-12);
+}
+
+TEST_F(ChunkMetricsTest, SilhouetteScalesToMillionsOfPoints) {
+    std::vector<std::vector<double>> chunks(1000);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> noise(0.0, 1.0);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].resize(1000);
+        for (auto& v : chunks[i]) {
+            v = static_cast<double>(i) + noise(rng);
+        }
+    }
+    const double score = analyzer.compute_silhouette_score(chunks);
+    EXPECT_GT(score, 0.0);
+    EXPECT_LE(score, 1.0);
+}
+
+TEST_F(ChunkMetricsTest, SampledSilhouetteHonoursItsBound) {
+    auto chunks = random_chunks(200, 100, 11);
+    const double exact = analyzer.compute_silhouette_score(chunks);
+
+    SilhouetteEstimate estimate = analyzer.estimate_silhouette_score(chunks, 2000, 0.99);
+    EXPECT_FALSE(estimate.exact);
+    EXPECT_EQ(estimate.samples, 2000u);
+    EXPECT_NEAR(estimate.half_width, std::sqrt(2.0 * std::log(200.0) / 2000.0), 1e-12);
+    EXPECT_LE(std::abs(estimate.score - exact), estimate.half_width);
+
+    SilhouetteEstimate full = analyzer.estimate_silhouette_score(chunks, 1000000);
+    EXPECT_TRUE(full.exact);
+    EXPECT_DOUBLE_EQ(full.score, exact);
+    EXPECT_EQ(full.half_width, 0.0);
+
+    EXPECT_THROW(analyzer.estimate_silhouette_score(chunks, 0), std::invalid_argument);
+    EXPECT_THROW(analyzer.estimate_silhouette_score(chunks, 10, 1.0), std::invalid_argument);
+    std::vector<std::vector<double>> no_points{{}, {}};
+    EXPECT_THROW(analyzer.estimate_silhouette_score(no_points, 10), std::invalid_argument);
+}
+
+TEST_F(ChunkMetricsTest, StatisticsTableMatchesDirectComputation) {
+    auto chunks = random_chunks(300, 50, 3);
+    const auto stats = analyzer.compute_statistics(chunks);
+    ASSERT_EQ(stats.size(), chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const auto& chunk = chunks[i];
+        ASSERT_EQ(stats[i].count, chunk.size());
+        if (chunk.empty()) {
+            continue;
+        }
+        double mean = 0.0;
+        for (double v : chunk) {
+            mean += v;
+        }
+        mean /= chunk.size();
+        double m2 = 0.0;
+        for (double v : chunk) {
+            m2 += (v - mean) * (v - mean);
+        }
+        EXPECT_NEAR(stats[i].mean, mean, 1e-9);
+        EXPECT_NEAR(stats[i].m2, m2, 1e-6);
+        EXPECT_EQ(stats[i].min, *std::min_element(chunk.begin(), chunk.end()));
+        EXPECT_EQ(stats[i].max, *std::max_element(chunk.begin(), chunk.end()));
+    }
+
+    // Merging the parts of a split chunk gives the statistics of the whole
+    std::vector<double> whole{4.0, -1.0, 2.5, 9.0, 3.0, 3.0};
+    auto merged = ChunkStatistics::of(std::vector<double>(whole.begin(), whole.begin() + 2));
+    merged.merge(ChunkStatistics::of(std::vector<double>(whole.begin() + 2, whole.end())));
+    const auto direct = ChunkStatistics::of(whole);
+    EXPECT_EQ(merged.count, direct.count);
+    EXPECT_NEAR(merged.mean, direct.mean, 1e-12);
+    EXPECT_NEAR(merged.variance(), direct.variance(), 1e-12);
+    EXPECT_EQ(merged.min, -1.0);
+    EXPECT_EQ(merged.max, 9.0);
+}
+
+TEST_F(ChunkMetricsTest, SeparationMatchesAllPairs) {
+    auto chunks = random_chunks(120, 20, 5);
+    chunks.push_back({}); // Counts with mean 0
+    double total = 0.0;
+    size_t pairs = 0;
+    const auto stats = analyzer.compute_statistics(chunks);
+    for (size_t i = 0; i < stats.size(); ++i) {
+        for (size_t j = i + 1; j < stats.size(); ++j) {
+            total += std::abs(stats[i].mean - stats[j].mean);
+            ++pairs;
+        }
+    }
+    EXPECT_NEAR(analyzer.compute_separation(chunks), total / pairs, 1e-9);
+    EXPECT_DOUBLE_EQ(analyzer.compute_quality_score(chunks),
+                     (ChunkQualityAnalyzer<double>::cohesion_from_statistics(stats) +
+                      ChunkQualityAnalyzer<double>::separation_from_statistics(stats)) /
+                         2.0);
+    EXPECT_THROW(ChunkQualityAnalyzer<double>::separation_from_statistics({}),
+                 std::invalid_argument);
+}
+
+TEST_F(ChunkMetricsTest, StatisticsCacheReusesChunks) {
+    ChunkQualityAnalyzer<double> cached;
+    auto chunks = random_chunks(50, 400, 9);
+    for (auto& chunk : chunks) {
+        chunk.resize(100 + chunk.size()); // Above the default min_chunk_size
+    }
+    const double first = cached.compute_quality_score(chunks);
+    EXPECT_EQ(cached.cache_hits(), 0u);
+    EXPECT_EQ(cached.cache_misses(), 50u);
+    EXPECT_EQ(cached.cache_size(), 50u);
+
+    EXPECT_DOUBLE_EQ(cached.compute_quality_score(chunks), first);
+    EXPECT_EQ(cached.cache_hits(), 50u);
+
+    // A chunking that shares all but one chunk only computes the new one
+    chunks[7][3] += 1.0;
+    cached.compute_cohesion(chunks);
+    EXPECT_EQ(cached.cache_hits(), 99u);
+    EXPECT_EQ(cached.cache_misses(), 51u);
+
+    cached.clear_cache();
+    EXPECT_EQ(cached.cache_size(), 0u);
+}
+
+TEST_F(ChunkMetricsTest, StatisticsCacheIsBoundedAndThreadSafe) {
+    MetricsCacheOptions options;
+    options.max_entries = 32;
+    options.min_chunk_size = 1;
+    ChunkQualityAnalyzer<double> cached(nullptr, options);
+    auto chunks = random_chunks(500, 30, 13);
+    for (auto& chunk : chunks) {
+        chunk.push_back(1.0);
+    }
+    const double expected = analyzer.compute_separation(chunks);
+
+    std::vector<std::thread> threads;
+    std::vector<double> results(4);
+    for (size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&, t]() { results[t] = cached.compute_separation(chunks); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (double result : results) {
+        EXPECT_NEAR(result, expected, 1e-9);
+    }
+    EXPECT_LE(cached.cache_size(), 32u);
+
+    options.max_entries = 0;
+    ChunkQualityAnalyzer<double> uncached(nullptr, options);
+    uncached.compute_cohesion(chunks);
+    EXPECT_EQ(uncached.cache_size(), 0u);
+    EXPECT_EQ(uncached.cache_misses(), 0u);
+}
+
+TEST(MetricsFingerprintTest, DependsOnEveryByte) {
+    std::vector<uint8_t> bytes(257);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 7);
+    }
+    const uint64_t base = detail::fingerprint(bytes.data(), bytes.size());
+    EXPECT_EQ(detail::fingerprint(bytes.data(), bytes.size()), base);
+    EXPECT_NE(detail::fingerprint(bytes.data(), bytes.size() - 1), base);
+    for (size_t i = 0; i < bytes.size(); i += 13) {
+        bytes[i] ^= 1;
+        EXPECT_NE(detail::fingerprint(bytes.data(), bytes.size()), base) << i;
+        bytes[i] ^= 1;
+    }
+}
+
+TEST_F(ChunkMetricsTest, AccumulatorMatchesBatchMetrics) {
+    auto chunks = random_chunks(200, 40, 17);
+    chunks.push_back({});
+    ChunkMetricsAccumulator<double> online;
+    for (const auto& chunk : chunks) {
+        online(chunk);
+    }
+    ASSERT_EQ(online.chunk_count(), chunks.size());
+    EXPECT_TRUE(online.separation_is_exact());
+    EXPECT_NEAR(online.cohesion(), analyzer.compute_cohesion(chunks), 1e-12);
+    EXPECT_NEAR(online.separation(), analyzer.compute_separation(chunks), 1e-9);
+    EXPECT_NEAR(online.quality_score(), analyzer.compute_quality_score(chunks), 1e-9);
+
+    auto expected = analyzer.compute_size_metrics(chunks);
+    auto actual = online.size_metrics();
+    for (const auto& [name, value] : expected) {
+        EXPECT_NEAR(actual.at(name), value, 1e-9) << name;
+    }
+
+    size_t values = 0;
+    for (const auto& chunk : chunks) {
+        values += chunk.size();
+    }
+    EXPECT_EQ(online.value_statistics().count, values);
+
+    online.reset();
+    EXPECT_EQ(online.chunk_count(), 0u);
+    EXPECT_THROW(online.cohesion(), std::invalid_argument);
+    EXPECT_THROW(ChunkMetricsAccumulator<double>(1), std::invalid_argument);
+}
+
+TEST_F(ChunkMetricsTest, AccumulatorSamplesSeparationWithBoundedMemory) {
+    ChunkMetricsAccumulator<double> online(256);
+    std::vector<std::vector<double>> chunks;
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> level(0.0, 100.0);
+    for (size_t i = 0; i < 5000; ++i) {
+        chunks.push_back({level(rng), level(rng)});
+        online.add(chunks.back());
+    }
+    EXPECT_FALSE(online.separation_is_exact());
+    const double exact = analyzer.compute_separation(chunks);
+    EXPECT_NEAR(online.separation(), exact, 0.1 * exact);
+    EXPECT_NEAR(online.cohesion(), analyzer.compute_cohesion(chunks), 1e-9);
+}
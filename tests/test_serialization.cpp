@@ -1,5 +1,9 @@
 #include "chunk_serialization.hpp"
+#include <cmath>
+#include <cstdint>
 #include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
 
 class ChunkSerializerTest : public ::testing::Test {
 protected:
@@ -40,4 +44,206 @@ TEST_F(ChunkSerializerTest, MessagePackSerialization) {
 TEST_F(ChunkSerializerTest, EmptyChunks) {
     std::vector<std::vector<double>> empty_chunks;
     EXPECT_NO_THROW(serializer.to_json(empty_chunks));
-}
\ No newline at end of file
+}
+
+TEST_F(ChunkSerializerTest, MessagePackRoundTrip) {
+    std::string msgpack = serializer.to_msgpack(chunks);
+    // fixarray(3), then per chunk a fixarray header and 9-byte float64 values
+    ASSERT_EQ(msgpack.size(), 1 + 3 + 8 * 9);
+    EXPECT_EQ(static_cast<uint8_t>(msgpack[0]), 0x93);
+    EXPECT_EQ(static_cast<uint8_t>(msgpack[1]), 0x93);
+    EXPECT_EQ(static_cast<uint8_t>(msgpack[2]), 0xcb);
+    // 1.0 as a big-endian IEEE double
+    EXPECT_EQ(msgpack.substr(3, 8), std::string("\x3f\xf0\0\0\0\0\0\0", 8));
+    EXPECT_EQ(serializer.from_msgpack(msgpack), chunks);
+}
+
+TEST(MessagePackTest, IntegerEncodingAndLongArrays) {
+    chunk_serialization::ChunkSerializer<int> ints;
+    std::vector<std::vector<int>> chunks{{-2, 300}};
+    std::string bytes = ints.to_msgpack(chunks);
+    EXPECT_EQ(bytes, std::string("\x91\x92\xd2\xff\xff\xff\xfe\xd2\0\0\x01\x2c", 12));
+
+    std::vector<std::vector<int>> sizes{std::vector<int>(20, 1), std::vector<int>(70000, -1)};
+    for (size_t i = 0; i < sizes[1].size(); i += 7) {
+        sizes[1][i] = static_cast<int>(i);
+    }
+    bytes = ints.to_msgpack(sizes);
+    EXPECT_EQ(static_cast<uint8_t>(bytes[1]), 0xdc);
+    EXPECT_EQ(static_cast<uint8_t>(bytes[1 + 3 + 20 * 5]), 0xdd);
+    EXPECT_EQ(ints.from_msgpack(bytes), sizes);
+}
+
+TEST(MessagePackTest, StreamingMatchesBuffer) {
+    chunk_serialization::ChunkSerializer<float> floats;
+    std::vector<std::vector<float>> chunks{std::vector<float>(10000, 0.5f), {1.5f, -3.0f}};
+    std::ostringstream os;
+    floats.write_msgpack(os, chunks);
+    EXPECT_EQ(os.str(), floats.to_msgpack(chunks));
+    EXPECT_EQ(floats.from_msgpack(os.str()), chunks);
+}
+
+TEST(MessagePackTest, ReadsAnyNumericEncoding) {
+    // [[0, 127, -1, -32, uint8 200, int16 -300, uint32 70000, float32 2.5]]
+    const std::string bytes("\x91\x98\x00\x7f\xff\xe0\xcc\xc8\xd1\xfe\xd4\xce\x00\x01\x11\x70"
+                            "\xca\x40\x20\x00\x00",
+                            21);
+    auto chunks = chunk_serialization::ChunkSerializer<double>::from_msgpack(bytes);
+    EXPECT_EQ(chunks, (std::vector<std::vector<double>>{
+                          {0.0, 127.0, -1.0, -32.0, 200.0, -300.0, 70000.0, 2.5}}));
+
+    using Ints = chunk_serialization::ChunkSerializer<int>;
+    EXPECT_THROW(Ints::from_msgpack(bytes), chunk_processing::SerializationError);
+    EXPECT_EQ(Ints::from_msgpack(bytes.substr(0, 16).replace(1, 1, "\x97")),
+              (std::vector<std::vector<int>>{{0, 127, -1, -32, 200, -300, 70000}}));
+    // uint64 max does not fit in int
+    const std::string too_large("\x91\x91\xcf\xff\xff\xff\xff\xff\xff\xff\xff", 11);
+    EXPECT_THROW(Ints::from_msgpack(too_large), chunk_processing::SerializationError);
+}
+
+TEST(MessagePackTest, RejectsMalformedInput) {
+    using Doubles = chunk_serialization::ChunkSerializer<double>;
+    chunk_serialization::ChunkSerializer<double> serializer;
+    std::string bytes = serializer.to_msgpack({{1.0, 2.0}});
+    EXPECT_THROW(Doubles::from_msgpack(bytes.substr(0, bytes.size() - 1)),
+                 chunk_processing::SerializationError);
+    EXPECT_THROW(Doubles::from_msgpack(bytes + '\x01'), chunk_processing::SerializationError);
+    // A string where a number is expected
+    EXPECT_THROW(Doubles::from_msgpack(std::string("\x91\x91\xa1x", 4)),
+                 chunk_processing::SerializationError);
+    // An array length larger than the input
+    EXPECT_THROW(Doubles::from_msgpack(std::string("\xdd\xff\xff\xff\xff", 5)),
+                 chunk_processing::SerializationError);
+    EXPECT_TRUE(Doubles::from_msgpack(std::string("\x90", 1)).empty());
+}
+
+TEST_F(ChunkSerializerTest, ProtobufRoundTrip) {
+    std::string proto = serializer.to_protobuf(chunks);
+    // Per chunk: ChunkSet key, length, Chunk key 1 (packed double), length, 8-byte values
+    ASSERT_EQ(proto.size(), 28 + 20 + 28);
+    EXPECT_EQ(proto.substr(0, 4), std::string("\x0a\x1a\x0a\x18", 4));
+    EXPECT_EQ(serializer.from_protobuf(proto), chunks);
+}
+
+TEST(ProtobufTest, IntegerChunksUseZigzagVarints) {
+    chunk_serialization::ChunkSerializer<int> ints;
+    // sint64 zigzag: -2 -> 3, 300 -> 600 (0xd8 0x04)
+    EXPECT_EQ(ints.to_protobuf({{-2, 300}}), std::string("\x0a\x05\x1a\x03\x03\xd8\x04", 7));
+
+    std::vector<std::vector<int>> chunks{
+        {std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 0, -1}, {}};
+    chunks[1].resize(50000);
+    for (size_t i = 0; i < chunks[1].size(); ++i) {
+        chunks[1][i] = static_cast<int>(i * 7919) - 100000;
+    }
+    EXPECT_EQ(ints.from_protobuf(ints.to_protobuf(chunks)), chunks);
+}
+
+TEST(ProtobufTest, ReadsAnyValidChunkSetEncoding) {
+    // Chunk 1: unpacked double 1.5, unknown varint field 5, packed uint64 {1, 150}.
+    // Chunk 2: empty message.
+    const std::string bytes("\x0a\x10"
+                            "\x09\x00\x00\x00\x00\x00\x00\xf8\x3f"
+                            "\x28\x01"
+                            "\x22\x03\x01\x96\x01"
+                            "\x0a\x00",
+                            20);
+    auto chunks = chunk_serialization::ChunkSerializer<double>::from_protobuf(bytes);
+    EXPECT_EQ(chunks, (std::vector<std::vector<double>>{{1.5, 1.0, 150.0}, {}}));
+
+    using Ints = chunk_serialization::ChunkSerializer<int>;
+    EXPECT_THROW(Ints::from_protobuf(bytes), chunk_processing::SerializationError);
+    // Unpacked sint64 -1 and packed float {2.0f} read into float
+    const std::string mixed("\x0a\x08\x18\x01\x12\x04\x00\x00\x00\x40", 10);
+    EXPECT_EQ(chunk_serialization::ChunkSerializer<float>::from_protobuf(mixed),
+              (std::vector<std::vector<float>>{{-1.0f, 2.0f}}));
+    EXPECT_TRUE(Ints::from_protobuf(std::string()).empty());
+}
+
+TEST(ProtobufTest, RejectsMalformedInput) {
+    using Doubles = chunk_serialization::ChunkSerializer<double>;
+    chunk_serialization::ChunkSerializer<double> serializer;
+    std::string bytes = serializer.to_protobuf({{1.0, 2.0}});
+    EXPECT_THROW(Doubles::from_protobuf(bytes.substr(0, bytes.size() - 1)),
+                 chunk_processing::SerializationError);
+    // Packed double payload that is not a multiple of 8 bytes
+    EXPECT_THROW(Doubles::from_protobuf(std::string("\x0a\x05\x0a\x03\x00\x00\x00", 7)),
+                 chunk_processing::SerializationError);
+    // Deprecated group wire type
+    EXPECT_THROW(Doubles::from_protobuf(std::string("\x0b", 1)),
+                 chunk_processing::SerializationError);
+    // Varint longer than 10 bytes
+    EXPECT_THROW(Doubles::from_protobuf(std::string(11, '\xff')),
+                 chunk_processing::SerializationError);
+}
+
+TEST_F(ChunkSerializerTest, JsonCompactAndPrettyLayouts) {
+    EXPECT_EQ(serializer.to_json(chunks), "[[1.0,2.0,3.0],[4.0,5.0],[6.0,7.0,8.0]]");
+    chunk_serialization::JsonOptions pretty;
+    pretty.pretty = true;
+    EXPECT_EQ(serializer.to_json(chunks, pretty),
+              "[\n  [1.0, 2.0, 3.0],\n  [4.0, 5.0],\n  [6.0, 7.0, 8.0]\n]");
+    EXPECT_EQ(serializer.from_json(serializer.to_json(chunks, pretty)), chunks);
+}
+
+TEST(JsonTest, FloatsRoundTripExactly) {
+    chunk_serialization::ChunkSerializer<double> doubles;
+    std::vector<std::vector<double>> chunks{{0.1, 1e-300, 123456789.123456789, -2.5e22},
+                                            {std::numeric_limits<double>::max(),
+                                             std::numeric_limits<double>::denorm_min(), -0.0}};
+    std::string json = doubles.to_json(chunks);
+    EXPECT_NE(json.find("[0.1,1e-300,"), std::string::npos) << json;
+    EXPECT_EQ(doubles.from_json(json), chunks);
+
+    chunk_serialization::ChunkSerializer<float> floats;
+    EXPECT_EQ(floats.to_json({{0.1f, 3.0f}}), "[[0.1,3.0]]");
+
+    auto special = doubles.from_json(doubles.to_json(
+        {{std::nan(""), std::numeric_limits<double>::infinity(),
+          -std::numeric_limits<double>::infinity()}}));
+    EXPECT_TRUE(std::isnan(special[0][0]));
+    EXPECT_EQ(special[0][1], std::numeric_limits<double>::infinity());
+    EXPECT_EQ(special[0][2], -std::numeric_limits<double>::infinity());
+}
+
+TEST(JsonTest, StreamsAndCallerBuffers) {
+    chunk_serialization::ChunkSerializer<double> doubles;
+    std::vector<std::vector<double>> chunks(50, std::vector<double>(1000));
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (size_t j = 0; j < chunks[i].size(); ++j) {
+            chunks[i][j] = static_cast<double>(i * 1000 + j) / 7.0;
+        }
+    }
+    std::ostringstream os;
+    doubles.write_json(os, chunks);
+    const std::string json = os.str();
+    ASSERT_GT(json.size(), 1u << 16);
+    EXPECT_EQ(json, doubles.to_json(chunks));
+
+    std::istringstream is(json);
+    EXPECT_EQ(chunk_serialization::ChunkSerializer<double>::from_json(is), chunks);
+
+    std::vector<char> buffer(json.size());
+    EXPECT_EQ(doubles.write_json(buffer.data(), buffer.size(), chunks), json.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), json);
+    EXPECT_THROW(doubles.write_json(buffer.data(), buffer.size() - 1, chunks),
+                 std::invalid_argument);
+}
+
+TEST(JsonTest, IntegerChunksAcceptIntegralNumbers) {
+    using Ints = chunk_serialization::ChunkSerializer<int>;
+    Ints ints;
+    EXPECT_EQ(ints.to_json({{-3, 0, 2147483647}}), "[[-3,0,2147483647]]");
+    EXPECT_EQ(Ints::from_json(" [ [1, 2.0, 3e2] ,[ ] ]\n"),
+              (std::vector<std::vector<int>>{{1, 2, 300}, {}}));
+    EXPECT_THROW(Ints::from_json("[[1.5]]"), chunk_processing::SerializationError);
+    EXPECT_THROW(Ints::from_json("[[3000000000]]"), chunk_processing::SerializationError);
+}
+
+TEST(JsonTest, RejectsMalformedInput) {
+    using Doubles = chunk_serialization::ChunkSerializer<double>;
+    for (const char* bad : {"", "[[1,2]", "[[1,,2]]", "[[1]] x", "[[abc]]", "[1]", "{}"}) {
+        EXPECT_THROW(Doubles::from_json(bad), chunk_processing::SerializationError) << bad;
+    }
+    EXPECT_TRUE(Doubles::from_json("[]").empty());
+}